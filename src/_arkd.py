@@ -0,0 +1,672 @@
+###############################################################################
+#   Ark daemon: one host process that runs several sculptures, each with its
+#               own tone-row queue, composition pipeline, MIDI port and
+#               serial session, as `_main.py` runs one.
+#
+#   Sessions: each sculpture's session is a generator (`Sculpture._session`)
+#             that does what `Composition.play()` and `Drone` do, but never
+#             blocks: it writes a message with `Link.post()` and yields the
+#             time by which it expects an answer, and is resumed when its
+#             serial port has data, when that time comes, or when a tone
+#             row is submitted. Notes are paced by the microcontroller's
+#             events ("notify"), so the host needs no timer of its own while
+#             a composition plays. A session must expect to be resumed
+#             early; every wait rechecks its condition.
+#
+#   Workers: the sessions are shared among a small pool of `Worker`
+#            threads, each an event loop on one selector (serial ports and
+#            a self-pipe for wake-ups) and one heap of deadlines. A waiting
+#            sculpture costs a registered file descriptor and a heap entry,
+#            not a thread or a poll, so an idle installation uses no CPU and
+#            a busy one pays per message, whatever the number of sculptures.
+#            Since the GIL serializes Python anyway, more threads would not
+#            add throughput; a few (MAX_WORKERS) bound how long a busy
+#            sculpture can delay the others on its loop.
+#
+#   Faults: a sculpture whose serial session fails (no response, malformed
+#           frame, cable pulled) has its notes turned off and its port
+#           closed, and is reopened every `retry` seconds; the composition
+#           it was playing, if submitted, is played again from the start.
+#           The other sculptures are not affected. Unlike `_main.py`, the
+#           daemon does not restart the computer.
+#
+#   Web service: a `Feeder` thread polls each sculpture's `url` for tone
+#                rows (`GetNewToneRows`) and posts what was played
+#                (`UpdateToneRowByIds`, `NotifyCompositionEnd`), so that the
+#                workers never wait on the network.
+#
+#   Configuration (JSON):
+#
+#       {"workers": W,                          (optional)
+#        "sculptures": [{"name": N, "serial": DEVICE, "midi": PORT,
+#                        "url": ROOT_URL,        (optional)
+#                        "bpm": 102, "max_time_break": 300,
+#                        "n_max_time_break": 1, "latency_us": 0,
+#                        "crossfade_us": 0},    (all optional)
+#                       ...]}
+#
+#   Usage: python3 _arkd.py --config FILE
+#          python3 _arkd.py --test
+###############################################################################
+import argparse
+import heapq
+import itertools
+import json
+import os
+import selectors
+import sys
+import threading
+import time
+
+from collections import deque
+from time import perf_counter
+
+import _protocol as proto
+
+from _composition import Composition
+from _link import Link, LinkError
+from _midi_constants import NOTE_OFF, NOTE_ON
+from _tonerow import _random, parse_rows
+
+
+###############################################################################
+#   Logging
+###############################################################################
+import logging
+logger = logging.getLogger()
+
+
+###############################################################################
+#   Globals
+###############################################################################
+MAX_WORKERS = 4
+
+DRONE_ON = (NOTE_ON + 1, 24, 60)       # As the `Drone` of `_main.py`.
+DRONE_OFF = (NOTE_OFF + 1, 24, 0)
+
+
+###############################################################################
+#   Sculpture class: the state and session of one sculpture. `open_link()`
+#                    returns a new `Link` (it is called again after a fault)
+#                    and `open_midi()` a `MidiOut`-like object.
+###############################################################################
+class Sculpture:
+    channel = Composition.channel
+    velocity = Composition.velocity
+    beats_per_bar = Composition.beats_per_bar
+    quantize = Composition.quantize
+    lead_in = Composition.lead_in
+
+    def __init__(self, name, open_link, open_midi, *, bpm=102,
+                 max_time_break=300, n_max_time_break=1, latency_us=0,
+                 crossfade_us=0, retry=5, url=None):
+        self.name = name
+        self.open_link = open_link
+        self.midi = open_midi()
+        self.bpm = bpm
+        self.max_time_break = max_time_break
+        self.n_max_time_break = n_max_time_break
+        self.latency_us = latency_us
+        self.crossfade_us = crossfade_us
+        self.retry = retry
+        self.url = url
+
+        self.rows = deque()         # (id, tone row) submitted, not played.
+        self.link = None
+        self.worker = None          # Set by `Worker.add()`.
+        self.session = self._session()
+        self.time_lastPlayed = perf_counter()
+        self.drone_on = False
+        self.sounding = None        # MIDI note currently on, if any.
+
+        # Called as `on_play(sculpture, comp)` before and `on_end(sculpture,
+        # comp)` after each submitted composition (see `Feeder`).
+        self.on_play = self.on_end = None
+
+        # Counters.
+        self.played = 0             # Submitted compositions.
+        self.idle_played = 0        # Random compositions.
+        self.notes = 0
+        self.faults = 0
+
+    @property
+    def fd(self):
+        return None if self.link is None else self.link.fd
+
+    def submit(self, ID, row):
+        """Queues tone row `row` (12 pitch classes; None for one that was
+        invalid, which is replaced by a random one) as composition `ID`.
+        Thread-safe."""
+        self.rows.append((ID, row))
+        if self.worker is not None:
+            self.worker.wake(self)
+
+    ###########################################################################
+    #   Session: every `yield` hands the worker a deadline (None: none).
+    ###########################################################################
+    def _session(self):
+        try:
+            while True:
+                try:
+                    yield from self._connect()
+                    yield from self._serve()
+                except (LinkError, OSError) as err:
+                    self.faults += 1
+                    logger.critical(f"{self.name}: {err} Reopening in "
+                                    f"{self.retry} s.")
+                    self._hangup()
+                    deadline = perf_counter() + self.retry
+                    while perf_counter() < deadline:
+                        yield deadline
+        finally:
+            self._hangup()
+
+    def _connect(self):
+        self.link = self.open_link()
+        yield from self._send(proto.encode_notify(1))
+        yield from self._send(proto.encode_latency(self.latency_us))
+        yield from self._send(proto.encode_crossfade(self.crossfade_us))
+        logger.info(f"{self.name}: connected.")
+
+    def _serve(self):
+        while True:
+            if self.rows:
+                ID, row = self.rows[0]
+                if row is None:
+                    logger.critical(f"{self.name}: invalid tr. Creating "
+                                    f"random tr.")
+                    row = _random()
+                comp = Composition(row, bpm=self.bpm, ID=ID)
+                if self.on_play is not None:
+                    self.on_play(self, comp)
+                yield from self._drone(False)
+                yield from self._play(comp)
+                # Only now, so that a fault replays it.
+                self.rows.popleft()
+                self.played += 1
+                if self.on_end is not None:
+                    self.on_end(self, comp)
+            elif perf_counter() >= self.time_lastPlayed + self.max_time_break:
+                yield from self._drone(False)
+                for _ in range(self.n_max_time_break):
+                    yield from self._play(Composition.from_random(self.bpm))
+                    self.idle_played += 1
+            else:
+                yield from self._drone(True)
+                yield from self._wait(self.time_lastPlayed +
+                                      self.max_time_break)
+
+    def _play(self, comp):
+        link = self.link
+        beat0_us = link.device_time() + round(self.lead_in * 1_000_000)
+        yield from self._send(proto.encode_tempo(
+            round(self.bpm * 1000), beat0_us & 0xFFFFFFFF,
+            self.beats_per_bar, self.quantize, 1))
+        notes = [proto.encode_midi_note(note, self.velocity,
+                                        int(duration * 1_000_000), step)
+                 for note, duration, step in zip(comp.notes, comp.durations,
+                                                 comp.steps(self.quantize))]
+        ack = (yield from self._send(notes[0])) if notes else None
+        for k, (note, duration) in enumerate(zip(comp.notes,
+                                                 comp.durations)):
+            yield from self._event(ack.seq, proto.EVENT_STARTED, link.timeout)
+            self.midi.send_message((NOTE_ON + self.channel, note,
+                                    self.velocity))
+            self.sounding = note
+            # As in `Composition.play()`, the next note waits in the queue
+            # while this one sounds.
+            if k + 1 < len(notes):
+                next_ack = yield from self._send(notes[k + 1])
+            yield from self._event(ack.seq, proto.EVENT_FINISHED,
+                                   duration + link.timeout)
+            self.midi.send_message((NOTE_OFF + self.channel, note, 0))
+            self.sounding = None
+            self.notes += 1
+            if k + 1 < len(notes):
+                ack = next_ack
+        self.time_lastPlayed = perf_counter()
+
+    def _drone(self, on):
+        if self.drone_on != on:
+            yield from self._send(proto.encode_drone_on() if on else
+                                  proto.encode_drone_off())
+            self.midi.send_message(DRONE_ON if on else DRONE_OFF)
+            self.drone_on = on
+
+    def _wait(self, deadline):
+        """Suspends the session until `deadline`, data from the
+        microcontroller or `submit()`, whichever comes first. Returns the
+        acks received."""
+        yield deadline
+        return self.link.pump()
+
+    def _send(self, frame):
+        """Sends `frame` and returns its ack."""
+        self.link.post(frame)
+        deadline = perf_counter() + self.link.timeout
+        while True:
+            acks = yield from self._wait(deadline)
+            if acks:
+                return acks[-1]
+            if perf_counter() >= deadline:
+                raise LinkError("No response from microcontroller.")
+
+    def _event(self, seq, edge, timeout):
+        """Returns the `micros()` value of edge `edge` of message `seq`."""
+        events = self.link.events
+        deadline = perf_counter() + timeout
+        while (seq, edge) not in events:
+            if perf_counter() >= deadline:
+                raise LinkError("No event from microcontroller.")
+            yield from self._wait(deadline)
+        return events.pop((seq, edge))
+
+    def _hangup(self):
+        """Turns off whatever this sculpture has sounding and closes its
+        serial port."""
+        if self.sounding is not None:
+            self.midi.send_message((NOTE_OFF + self.channel, self.sounding,
+                                    0))
+            self.sounding = None
+        if self.drone_on:
+            self.midi.send_message(DRONE_OFF)
+            self.drone_on = False
+        if self.link is not None:
+            try:
+                self.link.ser.close()
+            except OSError:
+                pass
+            self.link = None
+
+
+###############################################################################
+#   Worker class: an event loop running the sessions of some sculptures.
+###############################################################################
+class Worker(threading.Thread):
+    def __init__(self, name):
+        super().__init__(name=name, daemon=True)
+        self.sculptures = []
+        self._selector = selectors.DefaultSelector()
+        self._timers = []           # Heap of (deadline, token, sculpture).
+        self._tokens = itertools.count()
+        self._armed = {}            # Sculpture -> token of its live timer.
+        self._watched = {}          # Sculpture -> registered fd.
+        self._kicked = deque()
+        self._stopping = False
+        self._rx, self._tx = os.pipe()
+        os.set_blocking(self._rx, False)
+        os.set_blocking(self._tx, False)
+        self._selector.register(self._rx, selectors.EVENT_READ, None)
+
+    def add(self, sculpture):
+        sculpture.worker = self
+        self.sculptures.append(sculpture)
+
+    def wake(self, sculpture=None):
+        """Resumes `sculpture` (None: just the loop) soon. Thread-safe."""
+        if sculpture is not None:
+            self._kicked.append(sculpture)
+        try:
+            os.write(self._tx, b"\0")
+        except BlockingIOError:
+            pass            # The loop has wake-ups pending already.
+
+    def stop(self):
+        self._stopping = True
+        self.wake()
+        self.join()
+
+    def cpu_time(self):
+        """Returns the CPU time, in seconds, this thread has used."""
+        return time.clock_gettime(time.pthread_getcpuclockid(self.ident))
+
+    def run(self):
+        for s in self.sculptures:
+            self._step(s)
+        while not self._stopping:
+            timers = self._timers
+            while timers and self._armed.get(timers[0][2]) != timers[0][1]:
+                heapq.heappop(timers)       # Superseded.
+            timeout = None
+            if timers:
+                timeout = max(0.0, timers[0][0] - perf_counter())
+            for key, _ in self._selector.select(timeout):
+                if key.data is None:
+                    try:
+                        while os.read(self._rx, 4096):
+                            pass
+                    except BlockingIOError:
+                        pass
+                    while self._kicked:
+                        self._step(self._kicked.popleft())
+                else:
+                    self._step(key.data)
+            now = perf_counter()
+            while timers and timers[0][0] <= now:
+                _, token, s = heapq.heappop(timers)
+                if self._armed.get(s) == token:
+                    self._step(s)
+        for s in self.sculptures:
+            if s.session is not None:
+                s.session.close()
+
+    def _step(self, s):
+        """Resumes the session of `s` and waits for what it asks for."""
+        if s.session is None:
+            return
+        try:
+            deadline = next(s.session)
+        except Exception:
+            # A bug, not a fault of the sculpture: stop it and carry on.
+            logger.critical(f"{s.name}: session failed.", exc_info=True)
+            s.session = None
+            deadline = None
+        self._armed.pop(s, None)
+        if deadline is not None:
+            token = next(self._tokens)
+            self._armed[s] = token
+            heapq.heappush(self._timers, (deadline, token, s))
+
+        fd = s.fd if s.session is not None else None
+        if self._watched.get(s) != fd:
+            if s in self._watched:
+                self._selector.unregister(self._watched.pop(s))
+            if fd is not None:
+                self._selector.register(fd, selectors.EVENT_READ, s)
+                self._watched[s] = fd
+
+
+###############################################################################
+#   Daemon class: shares the sculptures among the workers.
+###############################################################################
+class Daemon:
+    def __init__(self, sculptures, n_workers=None):
+        self.sculptures = list(sculptures)
+        if n_workers is None:
+            n_workers = min(len(self.sculptures), os.cpu_count() or 1,
+                            MAX_WORKERS)
+        self.workers = [Worker(f"arkd-{k}") for k in range(max(1, n_workers))]
+        for k, s in enumerate(self.sculptures):
+            self.workers[k % len(self.workers)].add(s)
+
+    def start(self):
+        for w in self.workers:
+            w.start()
+
+    def stop(self):
+        for w in self.workers:
+            w.stop()
+
+    def cpu_time(self):
+        return sum(w.cpu_time() for w in self.workers)
+
+    def serve_forever(self):
+        self.start()
+        try:
+            for w in self.workers:
+                w.join()
+        finally:
+            self.stop()
+
+
+###############################################################################
+#   Feeder class: the web service side of every sculpture that has a `url`.
+###############################################################################
+class Feeder(threading.Thread):
+    poll_interval = 1
+    timeout = (10, 15)
+
+    def __init__(self, sculptures, session):
+        super().__init__(name="arkd-feeder", daemon=True)
+        self.sculptures = [s for s in sculptures if s.url]
+        self.session = session          # `requests.Session`
+        self.outbox = deque()           # (url, kwargs) to post.
+        self.seen = {s: set() for s in self.sculptures}
+        for s in self.sculptures:
+            s.on_play, s.on_end = self._played, self._ended
+
+    def _played(self, s, comp):
+        self.outbox.append((s.url + "UpdateToneRowByIds", {"json": [{
+            "id": comp.id,
+            "playedOn": time.strftime("%Y-%m-%dT%H:%M:%S"),
+            "twelveToneMatrix": ("[" + repr(comp.notes) + ", " +
+                                 repr(comp.durations) + "]")}]}))
+
+    def _ended(self, s, comp):
+        self.outbox.append((s.url + "NotifyCompositionEnd",
+                            {"params": {"id": comp.id}}))
+
+    def run(self):
+        import requests
+
+        while True:
+            for s in self.sculptures:
+                try:
+                    r = self.session.get(s.url + "GetNewToneRows?type=user",
+                                         timeout=self.timeout)
+                    rows = parse_rows(r.content)
+                except (requests.exceptions.RequestException,
+                        ValueError) as err:
+                    logger.critical(f"{s.name}: {err}")
+                    continue
+                for ID, row in rows:
+                    if ID not in self.seen[s]:
+                        self.seen[s].add(ID)
+                        s.submit(ID, row)
+            while self.outbox:
+                url, kwargs = self.outbox[0]
+                try:
+                    self.session.post(url, timeout=self.timeout, **kwargs)
+                except requests.exceptions.RequestException as err:
+                    logger.critical(err)
+                    break       # Retried next round, in order.
+                self.outbox.popleft()
+            time.sleep(self.poll_interval)
+
+
+###############################################################################
+#   Test: sculptures on simulated microcontrollers (`_stress.SimDevice`,
+#         with events) and simulated MIDI ports, at a fast tempo. Each gets
+#         tone rows, one of them invalid, and must play them in order, fill
+#         the gaps with idle compositions and end with every note off. One
+#         microcontroller is unplugged mid-composition and replaced; its
+#         composition must be played again and the others must carry on.
+#         Then the CPU time of the workers is measured with 1, 4 and 16
+#         sculptures, idle (drone on) and playing.
+###############################################################################
+class SimMidi:
+    def __init__(self):
+        self.messages = []
+
+    def send_message(self, message):
+        self.messages.append(tuple(int(x) for x in message))
+
+    def balanced(self):
+        """Returns whether every note turned on was turned off."""
+        on = set()
+        for status, note, velocity in self.messages:
+            if status & 0xF0 == NOTE_ON and velocity:
+                on.add((status & 0x0F, note))
+            else:
+                on.discard((status & 0x0F, note))
+        return not on
+
+
+class SimPlug:
+    """Opens `Link`s to fresh simulated microcontrollers; `unplug()`
+    disconnects the current one."""
+
+    def __init__(self):
+        self.device = None
+        self.opened = 0
+
+    def __call__(self):
+        import serial
+
+        from _stress import open_sim
+
+        self.close()
+        slave, self.device = open_sim()
+        self.opened += 1
+        # As `main()`: "drone_off" is acked at the end of the drone's
+        # breath, up to 4.8 s later.
+        ser = serial.Serial(os.ttyname(slave), timeout=10, write_timeout=0)
+        os.close(slave)
+        return Link(ser)
+
+    def unplug(self):
+        self.close()
+
+    def close(self):
+        if self.device is not None:
+            self.device.stop()
+            os.close(self.device.fd)
+            self.device = None
+
+
+def make(n, **kwargs):
+    plugs = [SimPlug() for _ in range(n)]
+    sculptures = [Sculpture(f"ark{k}", plugs[k], SimMidi, retry=0.2,
+                            **kwargs) for k in range(n)]
+    return sculptures, plugs
+
+
+def wait_until(condition, timeout):
+    deadline = perf_counter() + timeout
+    while not condition():
+        if perf_counter() >= deadline:
+            return False
+        time.sleep(0.01)
+    return True
+
+
+def run_test():
+    failures = []
+    bpm = 6000      # A composition lasts about a quarter of a second.
+
+    # Function.
+    sculptures, plugs = make(6, bpm=bpm, max_time_break=0.4)
+    daemon = Daemon(sculptures, n_workers=2)
+    played = {s: [] for s in sculptures}
+    for s in sculptures:
+        s.on_end = lambda s, comp: played[s].append(comp.id)
+    daemon.start()
+    try:
+        for k, s in enumerate(sculptures):
+            for ID in range(4):
+                s.submit(100 * k + ID, None if ID == 2 else _random())
+        victim = sculptures[0]
+        wait_until(lambda: victim.notes >= 60, 10)
+        plugs[0].unplug()
+        wait_until(lambda: all(len(played[s]) == 4 and s.idle_played >= 1
+                               for s in sculptures), 20)
+    finally:
+        daemon.stop()
+        for p in plugs:
+            p.close()
+    for k, s in enumerate(sculptures):
+        print(f"{s.name}: {s.played} played, {s.idle_played} idle, "
+              f"{s.notes} notes, {s.faults} faults, "
+              f"{len(s.midi.messages)} MIDI messages.")
+        if played[s] != [100 * k + ID for ID in range(4)]:
+            failures.append(f"{s.name} played {played[s]}.")
+        if s.idle_played < 1:
+            failures.append(f"{s.name} played no idle composition.")
+        if not s.midi.balanced():
+            failures.append(f"{s.name} left notes on.")
+        if s.faults != (s is victim):
+            failures.append(f"{s.name}: {s.faults} faults.")
+    if plugs[0].opened < 2:
+        failures.append("The unplugged sculpture was not reopened.")
+
+    # CPU time of the workers, per second of wall time.
+    for n in (1, 4, 16):
+        sculptures, plugs = make(n, bpm=bpm, max_time_break=3600)
+        daemon = Daemon(sculptures)
+        daemon.start()
+        try:
+            wait_until(lambda: all(s.drone_on for s in sculptures), 10)
+            cpu, t = daemon.cpu_time(), perf_counter()
+            time.sleep(1)
+            idle = (daemon.cpu_time() - cpu) / (perf_counter() - t)
+
+            notes = sum(s.notes for s in sculptures)
+            for s in sculptures:
+                for ID in range(4):
+                    s.submit(ID, _random())
+            cpu, t = daemon.cpu_time(), perf_counter()
+            wait_until(lambda: all(s.played == 4 for s in sculptures), 60)
+            seconds = perf_counter() - t
+            busy = (daemon.cpu_time() - cpu) / seconds
+            per_note = (daemon.cpu_time() - cpu) / max(
+                1, sum(s.notes for s in sculptures) - notes)
+        finally:
+            daemon.stop()
+            for p in plugs:
+                p.close()
+        print(f"{n:2} sculptures, {len(daemon.workers)} workers: idle "
+              f"{idle * 100:5.2f}% CPU, playing {busy * 100:5.1f}% CPU "
+              f"({per_note * 1e6:.0f} us/note, "
+              f"{sum(s.notes for s in sculptures) - notes} notes in "
+              f"{seconds:.2f} s).")
+        if idle > 0.01:
+            failures.append(f"{n} idle sculptures use {idle:.1%} CPU.")
+        if not all(s.played == 4 for s in sculptures):
+            failures.append(f"{n} sculptures did not finish playing.")
+
+    if failures:
+        print("FAILED:\n    " + "\n    ".join(failures))
+        return 1
+    print("OK.")
+    return 0
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    parser = argparse.ArgumentParser(description="Ark daemon.")
+    parser.add_argument("--config")
+    parser.add_argument("--test", action="store_true")
+    args = parser.parse_args(argv)
+
+    if args.test:
+        return run_test()
+    if not args.config:
+        parser.error("no configuration.")
+
+    import logging.config
+
+    import requests
+    import serial
+
+    from _midiout import MidiOut
+
+    logging.config.fileConfig('_logging.conf')
+    with open(args.config) as fp:
+        config = json.load(fp)
+
+    sculptures = []
+    for c in config["sculptures"]:
+        # `serial.Serial` rather than `_serial.Serial`, which exits when a
+        # port cannot be opened: a sculpture that is unplugged must not stop
+        # the others.
+        def open_link(port=c["serial"]):
+            return Link(serial.Serial(port, baudrate=57_600, timeout=10,
+                                      write_timeout=0))
+        sculptures.append(Sculpture(
+            c["name"], open_link, lambda port=c.get("midi"): MidiOut(port),
+            **{k: c[k] for k in ("bpm", "max_time_break", "n_max_time_break",
+                                 "latency_us", "crossfade_us", "url")
+               if k in c}))
+
+    Feeder(sculptures, requests.Session()).start()
+    try:
+        Daemon(sculptures, config.get("workers")).serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
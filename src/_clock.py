@@ -0,0 +1,496 @@
+###############################################################################
+#   Clocks: the host's sense of time, behind one small interface so that it
+#           can be replaced. `Composition`, `Drone`, `Scheduler` and `main()`
+#           read the time, sleep and wait only through a clock:
+#
+#               now()              Seconds, monotonic (`perf_counter()`).
+#               wall()             The `datetime` at `now()`.
+#               sleep(seconds)     Blocks for `seconds`.
+#               wait(event, timeout)
+#                                  Blocks until `event` (a
+#                                  `threading.Event`) is set or `timeout`
+#                                  seconds have passed. Returns whether it
+#                                  is set.
+#
+#           `clock` is the real clock, shared by default. A `SimClock`
+#           instead keeps virtual time, which only moves when the program
+#           sleeps or waits, and moves there at once. Together with
+#           `SimFirmware`, which plays the microcontroller on the same
+#           virtual time, a day of operation (the 5-minute idle
+#           compositions, the 2-hourly OBS restart, the web service) is
+#           replayed in seconds.
+#
+#   Usage:
+#       python3 _clock.py --test    Replay a day of `_main.main()` on a
+#                                   `SimClock`, against `SimFirmware` and
+#                                   simulated MIDI, OBS and web service,
+#                                   and check its timing.
+###############################################################################
+import datetime
+import json
+import sys
+import time
+
+from time import perf_counter
+
+import _protocol as proto
+
+from _link import Link, LinkError
+
+
+###############################################################################
+#   Clock class: real time.
+###############################################################################
+class Clock:
+    def now(self):
+        return perf_counter()
+
+    def wall(self):
+        return datetime.datetime.now()
+
+    def sleep(self, seconds):
+        time.sleep(seconds)
+
+    def wait(self, event, timeout):
+        return event.wait(timeout)
+
+
+clock = Clock()
+
+
+###############################################################################
+#   SimClock class: virtual time, starting at `start` seconds on the wall
+#                   clock date `epoch`. Sleeping or waiting advances it by
+#                   the time slept; nothing else runs meanwhile, so a wait
+#                   for an event that is not already set lasts its whole
+#                   timeout. Once virtual time reaches `end` seconds (if
+#                   given), `SimulationEnd` is raised from the sleep or wait
+#                   that reached it, which unwinds whatever loop is being
+#                   simulated.
+###############################################################################
+class SimulationEnd(Exception):
+    pass
+
+
+class SimClock:
+    def __init__(self, start=0.0, end=None,
+                 epoch=datetime.datetime(2023, 6, 1)):
+        self.t = start
+        self.end = end
+        self.epoch = epoch
+
+    def now(self):
+        return self.t
+
+    def wall(self):
+        return self.epoch + datetime.timedelta(seconds=self.t)
+
+    def sleep(self, seconds):
+        self.advance(seconds)
+
+    def wait(self, event, timeout):
+        if event.is_set():
+            return True
+        if timeout is None:
+            raise SimulationEnd("Waiting forever.")
+        self.advance(timeout)
+        return event.is_set()
+
+    def advance(self, seconds):
+        self.t += max(0.0, seconds)
+        if self.end is not None and self.t >= self.end:
+            raise SimulationEnd(f"Reached {self.end} s.")
+
+
+###############################################################################
+#   SimFirmware class: stands in for `Link` and the microcontroller behind it
+#                      on the virtual time of a clock, as the host sees
+#                      them. Frames take `link_delay` seconds over USB
+#                      either way, and `processing` seconds to be parsed
+#                      and queued. The executor is `_hostfw.ExecutorModel`,
+#                      the firmware's timing: each message is acked when
+#                      it is taken off the queue, and its events are sent
+#                      at their edges. The send methods return when the ack
+#                      reaches the host, and `wait_event()` when the event
+#                      does. Until then the clock runs.
+#
+#                      `log` records `(t_us, what, arg)` for every note
+#                      (arg: `(note, start_us, finish_us, on_us, off_us)`,
+#                      its edges and the times its lights go on and off),
+#                      tempo (arg: `(bpm_milli, beat0_us, quantize)`) and
+#                      drone on or off (at the start of its first breath,
+#                      and at its end). No lights are rendered.
+###############################################################################
+class SimFirmware:
+    def __init__(self, clock, timeout=10, link_delay=0.001,
+                 processing=0.0001):
+        from _hostfw import ExecutorModel
+
+        self.clock = clock
+        self.timeout = timeout
+        self.link_us = round(link_delay * 1_000_000)
+        self.processing_us = round(processing * 1_000_000)
+        self.notifications = False
+        self.model = ExecutorModel()
+        self.events = {}    # (seq, edge) -> (micros64() at the edge, sent)
+        self.log = []
+
+        self._seq = 0
+        self._clock = None      # As `Link._clock`.
+
+    @property
+    def latency_us(self):
+        return self.model.latency_us
+
+    def micros64(self):
+        return round(self.clock.now() * 1_000_000)
+
+    # Link interface, as used by `_composition.py` and `_main.py`.
+    def send(self, frame):
+        return self._submit(proto.decode(frame), None)
+
+    def send_midi_note(self, note, velocity, duration_us,
+                       step=proto.NO_STEP):
+        return self._submit(proto.MidiNote(note, velocity, duration_us, step),
+                            note)
+
+    def set_tempo(self, bpm, beat0_us=None, beats_per_bar=0, quantize=0,
+                  drone_sync=False):
+        if beat0_us is None:
+            beat0_us = self.device_time()
+        return self.send(proto.encode_tempo(
+            round(bpm * 1000), beat0_us & 0xFFFFFFFF, beats_per_bar,
+            quantize, 1 if drone_sync else 0))
+
+    def set_notifications(self, enable):
+        return self.send(proto.encode_notify(1 if enable else 0))
+
+    def set_latency(self, offset_us):
+        return self.send(proto.encode_latency(offset_us))
+
+    def set_crossfade(self, duration_us):
+        return self.send(proto.encode_crossfade(duration_us))
+
+    def device_time(self, t=None):
+        if t is None:
+            t = self.clock.now()
+        if self._clock is None:
+            raise LinkError("No ack received yet.")
+        host_t, tx_us = self._clock
+        return (tx_us + round((t - host_t) * 1_000_000)) & 0xFFFFFFFF
+
+    def wait_event(self, seq, edge, timeout):
+        try:
+            t_us, sent = self.events.pop((seq, edge))
+        except KeyError:
+            raise LinkError(f"No event {edge} for {seq}.") from None
+        self._deliver(sent, timeout)
+        return t_us & 0xFFFFFFFF
+
+    def _submit(self, msg, note):
+        """Queues `msg` now, plays it on the executor model and returns its
+        ack once it reaches the host."""
+        seq = self._seq
+        self._seq = (seq + 1) & 0xFFFF
+        queued = self.micros64() + self.link_us + self.processing_us
+        step = self.model.submit(msg, seq, queued)
+        if isinstance(msg, proto.Notify):
+            self.notifications = bool(msg.enable)
+        if self.notifications:
+            for s, edge, t_us, sent in step.events:
+                self.events[(s, edge)] = (t_us, sent)
+                if len(self.events) > Link.max_events:
+                    del self.events[next(iter(self.events))]
+        if isinstance(msg, proto.MidiNote):
+            self.log.append((step.start, "note", (note, step.start,
+                                                  step.finish, step.on,
+                                                  step.off)))
+        elif isinstance(msg, proto.DroneOn):
+            self.log.append((step.start, "drone_on", None))
+        elif isinstance(msg, proto.DroneOff):
+            self.log.append((step.taken, "drone_off", None))
+        elif isinstance(msg, proto.Tempo):
+            m = self.model
+            self.log.append((step.taken, "tempo", (m.bpm_milli, m.beat0,
+                                                   m.quantize)))
+        self._deliver(step.taken, self.timeout)
+        self._clock = (self.clock.now(), step.taken & 0xFFFFFFFF)
+        return proto.Ack(seq, queued & 0xFFFFFFFF, step.taken & 0xFFFFFFFF,
+                         (seq + 1 + proto.CMD_QUEUE_LEN) & 0xFFFF)
+
+    def _deliver(self, sent, timeout):
+        """Runs the clock until a frame sent at `sent` reaches the host,
+        or raises LinkError after `timeout` seconds."""
+        wait = (sent + self.link_us) / 1_000_000 - self.clock.now()
+        if wait > timeout:
+            self.clock.sleep(timeout)
+            raise LinkError("No response from microcontroller.")
+        self.clock.sleep(wait)
+
+
+###############################################################################
+#   Test: replays a day of `_main.main()` on a `SimClock`. Its MIDI output,
+#         OBS, web service and microcontroller are simulations on the same
+#         clock: tone rows are submitted at random times between 9:00 and
+#         21:00, some several at once, and the internet is down from 13:00
+#         to 13:20. USB takes 2 ms either way and parsing 0.5 ms, and the
+#         latency offset is set to the 2 ms. Checked: every row is played
+#         once, in order, within a poll interval of being submitted (or of
+#         the system being free); an idle composition starts
+#         `max_time_break` after the last one ended; OBS restarts every 2
+#         hours; beat 0 of each composition is within `lead_in` of its
+#         start, and each note starts at its place on the grid from beat
+#         0 (the sum of the durations before it), lasts its duration and
+#         sounds exactly while its lights are on; and no note sounds over
+#         the drone.
+###############################################################################
+DAY = 24 * 60 * 60
+
+
+class SimMidiOut:
+    def __init__(self, clock):
+        self.clock = clock
+        self.sent = []      # (t, message)
+
+    def send_message(self, message):
+        self.sent.append((self.clock.now(), tuple(message)))
+
+
+class SimApps:
+    def __init__(self, clock):
+        self.clock = clock
+        self.closed = []    # Times at which the apps were closed.
+
+    def open(self):
+        pass
+
+    def close(self):
+        self.closed.append(self.clock.now())
+
+
+class SimWebService:
+    """`requests.Session` of the simulated web service. `rows` holds
+    `(t, id, noteRow)`, the times at which tone rows are submitted."""
+    def __init__(self, clock, rows, outages, exceptions):
+        self.clock = clock
+        self.rows = sorted(rows)
+        self.outages = outages
+        self.exceptions = exceptions
+        self.updates = []   # (t, id, playedOn)
+        self.ends = []      # (t, id)
+
+    def get(self, url, timeout=None):
+        self._check()
+        now = self.clock.now()
+        ready = [row for row in self.rows if row[0] <= now]
+        self.rows = self.rows[len(ready):]
+        data = [{"id": ID, "noteRow": repr(row)} for _, ID, row in ready]
+        return type("Response", (), {"content": json.dumps(data).encode()})()
+
+    def post(self, url, json=None, params=None, timeout=None):
+        self._check()
+        now = self.clock.now()
+        if url.endswith("UpdateToneRowByIds"):
+            self.updates.append((now, json[0]["id"], json[0]["playedOn"]))
+        else:
+            self.ends.append((now, params["id"]))
+
+    def _check(self):
+        now = self.clock.now()
+        if any(a <= now < b for a, b in self.outages):
+            raise self.exceptions.ConnectionError("Simulated outage.")
+
+
+def load_main(clock, web, **link):
+    """Imports `_main` with MIDI, the serial port, OBS and `requests`
+    replaced by simulations on `clock`, the microcontroller by a
+    `SimFirmware` with keyword arguments `link`. Returns `(_main,
+    firmware, midi, apps)`."""
+    import logging.config
+    import os
+    import types
+
+    firmware, midi, apps = SimFirmware(clock, **link), SimMidiOut(clock), \
+        SimApps(clock)
+
+    # No network, MIDI backend or log file.
+    requests = types.ModuleType("requests")
+    requests.Session = lambda: web
+    requests.exceptions = web.exceptions
+    sys.modules["requests"] = requests
+    midiout = types.ModuleType("_midiout")
+    midiout.MidiOut = lambda: midi
+    sys.modules["_midiout"] = midiout
+    logging.config.fileConfig = lambda *args, **kwargs: None
+    logging.getLogger().addHandler(logging.NullHandler())
+    os.environ.setdefault("TNA_ROOTURL", "http://sim/")
+
+    import _link
+    import _macapps
+    import _serial
+    _serial.Serial = lambda **kwargs: None
+    _link.Link = lambda ser: firmware
+    _macapps.MacApps = lambda names: apps
+
+    import _composition
+    import _main
+
+    def restart_computer():
+        raise AssertionError("Restart requested.")
+    _composition.restart_computer = restart_computer
+    return _main, firmware, midi, apps
+
+
+def run_test(seed=0):
+    import random
+    import types
+
+    from _hostfw import DRONE_MICROSEC_ITERATION
+    from _midi_constants import NOTE_ON
+    from _tonerow import _random
+
+    exceptions = types.SimpleNamespace()
+    exceptions.RequestException = type("RequestException", (OSError,), {})
+    exceptions.ConnectionError = type("ConnectionError",
+                                      (exceptions.RequestException,), {})
+    exceptions.JSONDecodeError = type("JSONDecodeError",
+                                      (exceptions.RequestException,), {})
+
+    rng = random.Random(seed)
+    random.seed(seed)       # Compositions draw from the global generator.
+    rows, ID = [], 1
+    for _ in range(60):
+        t = rng.uniform(9, 21) * 3600
+        for _ in range(rng.choice((1, 1, 1, 2, 3))):
+            rows.append((t, ID, tuple(_random())))
+            ID += 1
+    outage = (13 * 3600, 13 * 3600 + 20 * 60)
+
+    clock = SimClock(end=DAY)
+    web = SimWebService(clock, rows, [outage], exceptions)
+    _main, firmware, midi, apps = load_main(clock, web, link_delay=0.002,
+                                            processing=0.0005)
+    _main.latency_us = firmware.link_us
+
+    # Record every composition played: (start, end, id), and its durations.
+    plays, durations = [], []
+    play = _main.Composition.play
+
+    def recorded(self):
+        start = clock.now()
+        play(self)
+        plays.append((start, clock.now(), self.id))
+        durations.append(self.durations)
+    _main.Composition.play = recorded
+
+    start = perf_counter()
+    try:
+        _main.main(clock)
+    except SimulationEnd:
+        clock.end = None    # For the drone's `__del__()`, on the way out.
+    elapsed = perf_counter() - start
+
+    failures = []
+
+    def check(ok, message):
+        if not ok and len(failures) < 10:
+            failures.append(message)
+
+    # Turning the drone off before a composition waits for the end of its
+    # breath, or of the next one if it is in its last step.
+    drone_off = 2 * (DRONE_MICROSEC_ITERATION / 1e6 +
+                     60 / _main.Composition.bpm)
+
+    # Rows: once each, in order, promptly.
+    user = [p for p in plays if p[2] != -1]
+    check([p[2] for p in user] == [r[1] for r in sorted(rows)],
+          "rows not played once each, in order")
+    for (t, ID, _), (a, _, _) in zip(sorted(rows), user):
+        # Ready once the internet is back and the previous composition has
+        # ended.
+        ready = max(outage[1] if outage[0] <= t < outage[1] else t,
+                    max((p[1] for p in plays if p[1] <= a), default=0))
+        check(t <= a <= ready + _main.poll_interval + drone_off,
+              f"row {ID} submitted at {t:.2f} s played at {a:.2f} s")
+    check(len(web.updates) == len(user) and all(
+        u[2] == (clock.epoch + datetime.timedelta(seconds=p[0])).isoformat()
+        for u, p in zip(web.updates, user)), "wrong playedOn")
+    check([e[1] for e in web.ends] == [p[2] for p in user] and all(
+        e[0] >= p[1] for e, p in zip(web.ends, user)),
+        "NotifyCompositionEnd out of order")
+
+    # Idle compositions.
+    idle = 0
+    for prev, cur in zip(plays, plays[1:]):
+        gap = cur[0] - prev[1]
+        if cur[2] == -1:
+            idle += 1
+            check(_main.max_time_break - 1e-6 <= gap <=
+                  _main.max_time_break + _main.poll_interval + drone_off,
+                  f"idle composition {gap:.2f} s after the last one")
+        else:
+            check(gap <= _main.max_time_break + _main.poll_interval +
+                  drone_off,
+                  f"{gap:.2f} s without a composition")
+
+    # OBS restarts, delayed at most by a composition.
+    longest = max(b - a for a, b, _ in plays)
+    expected = list(range(7200, DAY, 7200))
+    check(len(apps.closed) == len(expected) and all(
+        e <= t <= e + longest + _main.poll_interval + drone_off
+        for t, e in zip(apps.closed, expected)),
+        f"OBS restarted at {[round(t) for t in apps.closed]}")
+
+    # Notes: each composition's on its grid from beat 0, sounding exactly
+    # while lit, never over the drone.
+    notes, beats = [], []
+    for t, what, arg in firmware.log:
+        if what == "tempo":
+            beats.append(arg[1])
+        elif what == "note":
+            notes.append(arg)
+    check(len(beats) == len(plays), "not one tempo per composition")
+    k = 0
+    for beat0, (start, _, _), lengths in zip(beats, plays, durations):
+        lead_in = round(_main.Composition.lead_in * 1e6)
+        check(0 <= beat0 - round(start * 1e6) <= lead_in,
+              f"beat 0 at {beat0} us for a composition at {start:.6f} s")
+        t = 0.0
+        for duration, (_, a, b, on, off) in zip(lengths, notes[k:]):
+            grid = beat0 + t * 1e6
+            check(abs(a - grid) <= 1 and b - a == int(duration * 1e6),
+                  f"note at {a} us, grid {grid:.0f} us, lasting {b - a} us")
+            check(on == a + firmware.latency_us and
+                  off == b + firmware.latency_us,
+                  f"note at {a} us lit from {on} us to {off} us")
+            t += duration
+        k += len(lengths)
+    check(k == len(notes), "notes and compositions differ")
+    sounds = [(t, m) for t, m in midi.sent if m[0] & 0x0F == 0]
+    ons = [t for t, m in sounds if m[0] == NOTE_ON]
+    offs = [t for t, m in sounds if m[0] != NOTE_ON]
+    check(len(ons) == len(offs) == len(notes), "notes and sounds differ")
+    for (note, a, b, lit, dark), on, off in zip(notes, ons, offs):
+        check(abs(on - lit / 1e6) < 1e-6 and abs(off - dark / 1e6) < 1e-6,
+              f"note lit from {lit} us to {dark} us sounded from "
+              f"{on:.6f} s to {off:.6f} s")
+    drone = False
+    for t, what, arg in sorted(firmware.log, key=lambda x: x[0]):
+        if what == "note":
+            check(not drone, f"note at {t} us over the drone")
+        elif what != "tempo":
+            drone = what == "drone_on"
+
+    print(f"Replayed {DAY // 3600} h in {elapsed:.2f} s: {len(plays)} "
+          f"compositions ({len(user)} submitted, {idle} idle), "
+          f"{len(notes)} notes, {len(apps.closed)} OBS restarts.")
+    if failures:
+        print("FAILED:\n    " + "\n    ".join(failures))
+        return 1
+    print("OK.")
+    return 0
+
+
+if __name__ == '__main__':
+    if "--test" in sys.argv[1:]:
+        sys.exit(run_test())
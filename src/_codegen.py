@@ -0,0 +1,1133 @@
+###############################################################################
+#   Codec generator: reads the message schema in `_protocol_schema.py` and
+#                    writes the matched C++ and Python codecs.
+#
+#   Usage:
+#       python3 _codegen.py           Regenerate `_protocol.h` and
+#                                     `_protocol.py`.
+#       python3 _codegen.py --check   Fail if the generated files are stale.
+#       python3 _codegen.py --test    Cross-language round trip: frames
+#                                     encoded in Python are decoded and
+#                                     re-encoded by the C++ codec (compiled
+#                                     with the host C++ compiler) and
+#                                     compared byte for byte, after which
+#                                     both self-tests and encode/decode
+#                                     benchmarks are run.
+###############################################################################
+###############################################################################
+#   Imports
+###############################################################################
+import os
+import random
+import re
+import subprocess
+import sys
+import tempfile
+import textwrap
+
+from collections import namedtuple
+
+import _protocol_schema as schema
+
+
+###############################################################################
+#   Globals
+###############################################################################
+HERE = os.path.dirname(os.path.abspath(__file__))
+HEADER_PATH = os.path.join(HERE, "_protocol.h")
+MODULE_PATH = os.path.join(HERE, "_protocol.py")
+
+BANNER = "/" * 79
+PY_BANNER = "#" * 79
+
+# Number of golden vectors emitted per message: all-minimum, all-maximum and
+# one random set of field values.
+N_VECTORS = 3
+
+# name: (C type, struct code, width, minimum, maximum)
+INT_TYPES = {
+    "u8":  ("uint8_t",  "B", 1, 0, 0xFF),
+    "u16": ("uint16_t", "H", 2, 0, 0xFFFF),
+    "u32": ("uint32_t", "I", 4, 0, 0xFFFFFFFF),
+    "i8":  ("int8_t",   "b", 1, -0x80, 0x7F),
+    "i16": ("int16_t",  "h", 2, -0x8000, 0x7FFF),
+    "i32": ("int32_t",  "i", 4, -0x80000000, 0x7FFFFFFF),
+}
+
+# kind : "int", "dec" or "pad".
+# base : key into `INT_TYPES` for "int"; None otherwise.
+# count: number of array elements; None for scalars.
+# size : number of bytes in the frame.
+FieldType = namedtuple("FieldType", "kind base count size")
+
+
+###############################################################################
+#   Schema helpers
+###############################################################################
+def parse_type(t):
+    m = re.fullmatch(r"(u8|u16|u32|i8|i16|i32)(?:\[(\d+)\])?", t)
+    if m:
+        base, count = m.group(1), m.group(2)
+        count = int(count) if count else None
+        return FieldType("int", base, count,
+                         INT_TYPES[base][2] * (count or 1))
+    m = re.fullmatch(r"dec(\d)", t)
+    if m:
+        return FieldType("dec", None, None, int(m.group(1)))
+    m = re.fullmatch(r"pad(\d+)", t)
+    if m:
+        return FieldType("pad", None, None, int(m.group(1)))
+    raise ValueError(f"Unknown field type {t!r}.")
+
+
+def frame_len(msg):
+    return 3 + sum(parse_type(f.type).size for f in msg.fields)
+
+
+def value_fields(msg):
+    """Fields that carry a value (i.e. all fields except padding)."""
+    return [f for f in msg.fields if parse_type(f.type).kind != "pad"]
+
+
+def camel(name):
+    return "".join(part.capitalize() for part in name.split("_"))
+
+
+def validate():
+    names, opcodes = set(), set()
+    for msg in schema.MESSAGES:
+        if msg.name in names or msg.opcode in opcodes:
+            raise ValueError(f"Duplicate message {msg.name!r}/"
+                             f"{msg.opcode!r}.")
+        if len(msg.opcode) != 1 or msg.opcode in (schema.SOF, schema.EOF):
+            raise ValueError(f"Invalid opcode for {msg.name!r}.")
+        names.add(msg.name)
+        opcodes.add(msg.opcode)
+        for f in msg.fields:
+            t = parse_type(f.type)
+            if t.kind == "dec" and t.size > 9:
+                raise ValueError("decN fields must have N <= 9.")
+
+
+def field_range(t):
+    if t.kind == "dec":
+        return 0, 10 ** t.size - 1
+    return INT_TYPES[t.base][3], INT_TYPES[t.base][4]
+
+
+def vectors(msg):
+    """Golden field values for `msg`, as lists of Python values."""
+    rng = random.Random(msg.name)
+    result = []
+    for k in range(N_VECTORS):
+        values = []
+        for f in value_fields(msg):
+            t = parse_type(f.type)
+            lo, hi = field_range(t)
+            pick = (lambda: lo) if k == 0 else \
+                   (lambda: hi) if k == 1 else \
+                   (lambda: rng.randint(lo, hi))
+            if t.count is None:
+                values.append(pick())
+            else:
+                values.append([pick() for _ in range(t.count)])
+        result.append(values)
+    return result
+
+
+###############################################################################
+#   Reference encoder: a direct, unoptimized transcription of the schema used
+#                      to produce the golden vectors that both generated
+#                      codecs are checked against.
+###############################################################################
+def reference_encode(msg, values):
+    out = bytearray([ord(schema.SOF), ord(msg.opcode)])
+    it = iter(values)
+    for f in msg.fields:
+        t = parse_type(f.type)
+        if t.kind == "pad":
+            out += bytes(t.size)
+        elif t.kind == "dec":
+            out += str(next(it)).encode().ljust(t.size, b"\0")
+        else:
+            v = next(it)
+            width = INT_TYPES[t.base][2]
+            signed = t.base.startswith("i")
+            for x in (v if t.count is not None else [v]):
+                out += x.to_bytes(width, "little", signed=signed)
+    out.append(ord(schema.EOF))
+    assert len(out) == frame_len(msg)
+    return bytes(out)
+
+
+###############################################################################
+#   C++ generator
+###############################################################################
+def c_char(ch):
+    return "'\\0'" if ch == "\0" else repr(ch)
+
+
+def c_member(f):
+    t = parse_type(f.type)
+    ctype = "uint32_t" if t.kind == "dec" else INT_TYPES[t.base][0]
+    suffix = f"[{t.count}]" if t.count is not None else ""
+    return f"{ctype} {f.name}{suffix};", f.doc
+
+
+def c_literal(v):
+    if isinstance(v, list):
+        return "{" + ", ".join(c_literal(x) for x in v) + "}"
+    if v == -0x80000000:
+        return "(-2147483647 - 1)"
+    return f"{v}" if v < 0x80000000 else f"{v}u"
+
+
+def c_put(f, off):
+    t = parse_type(f.type)
+    if t.kind == "pad":
+        return [f"    memset(&buf[{off}], 0, {t.size});"]
+    if t.kind == "dec":
+        return [f"    if (!proto_put_dec(&buf[{off}], m->{f.name}, "
+                f"{t.size}))",
+                "        return 0;"]
+    width = INT_TYPES[t.base][2]
+    bits = width * 8
+    if t.count is None:
+        if width == 1:
+            return [f"    buf[{off}] = (uint8_t) m->{f.name};"]
+        return [f"    proto_put_u{bits}(&buf[{off}], "
+                f"(uint{bits}_t) m->{f.name});"]
+    if width == 1:
+        return [f"    memcpy(&buf[{off}], m->{f.name}, {t.count});"]
+    return [f"    for (size_t i = 0; i < {t.count}; i++)",
+            f"        proto_put_u{bits}(&buf[{off} + {width} * i], "
+            f"(uint{bits}_t) m->{f.name}[i]);"]
+
+
+def c_get(f, off):
+    t = parse_type(f.type)
+    if t.kind == "pad":
+        return []
+    if t.kind == "dec":
+        return [f"    if (!proto_get_dec(&buf[{off}], {t.size}, "
+                f"&m->{f.name}))",
+                "        return 0;"]
+    ctype, _, width = INT_TYPES[t.base][:3]
+    bits = width * 8
+    get = (f"buf[{off}]" if width == 1 else
+           f"proto_get_u{bits}(&buf[{off}])")
+    if t.count is None:
+        return [f"    m->{f.name} = ({ctype}) {get};"]
+    if width == 1:
+        return [f"    memcpy(m->{f.name}, &buf[{off}], {t.count});"]
+    return [f"    for (size_t i = 0; i < {t.count}; i++)",
+            f"        m->{f.name}[i] = ({ctype}) "
+            f"proto_get_u{bits}(&buf[{off} + {width} * i]);"]
+
+
+def c_message(msg):
+    up = msg.name.upper()
+    n = frame_len(msg)
+    fields = value_fields(msg)
+    lines = [BANNER]
+    lines += textwrap.wrap(f"{msg.name} ({msg.direction}): {msg.doc}",
+                           width=79, initial_indent="//  ",
+                           subsequent_indent="//  ")
+    lines += [
+        BANNER,
+        f"#define OP_{up} {c_char(msg.opcode)}",
+        f"#define MSG_{up}_LEN {n}",
+        "",
+    ]
+    if fields:
+        lines.append(f"struct msg_{msg.name} {{")
+        for f in fields:
+            member, doc = c_member(f)
+            lines += textwrap.wrap(f"/* {doc} */", width=79,
+                                   initial_indent="    ",
+                                   subsequent_indent="       ")
+            lines.append(f"    {member}")
+        lines += ["};", ""]
+        arg = f", const struct msg_{msg.name} *m"
+        darg = f", struct msg_{msg.name} *m"
+    else:
+        arg = darg = ""
+
+    lines += [
+        "static inline size_t",
+        f"encode_{msg.name}(uint8_t *buf{arg})",
+        "{",
+        "    buf[0] = PROTO_SOF;",
+        f"    buf[1] = OP_{up};",
+    ]
+    off = 2
+    for f in msg.fields:
+        lines += c_put(f, off)
+        off += parse_type(f.type).size
+    lines += [
+        f"    buf[{off}] = PROTO_EOF;",
+        f"    return MSG_{up}_LEN;",
+        "}",
+        "",
+        "",
+        "static inline int",
+        f"decode_{msg.name}(const uint8_t *buf{darg})",
+        "{",
+        f"    if (buf[0] != PROTO_SOF || buf[1] != OP_{up} ||",
+        f"        buf[{n - 1}] != PROTO_EOF)",
+        "        return 0;",
+    ]
+    off = 2
+    for f in msg.fields:
+        lines += c_get(f, off)
+        off += parse_type(f.type).size
+    lines += [
+        "    return 1;",
+        "}",
+        "",
+        "",
+    ]
+    return lines
+
+
+def c_selftest():
+    lines = [
+        BANNER,
+        "//  Golden vectors produced by the schema's reference encoder. The",
+        "//  generated Python codec is checked against the same bytes.",
+        "//  Compile with -DPROTO_SELFTEST to include them.",
+        BANNER,
+        "#ifdef PROTO_SELFTEST",
+    ]
+    body = []
+    for msg in schema.MESSAGES:
+        up = msg.name.upper()
+        fields = value_fields(msg)
+        for k, values in enumerate(vectors(msg)):
+            frame = reference_encode(msg, values)
+            lines.append(f"static const uint8_t proto_vec_{msg.name}_{k}"
+                         f"[MSG_{up}_LEN] = {{")
+            hexes = [f"0x{b:02X}" for b in frame]
+            for i in range(0, len(hexes), 12):
+                lines.append("    " + ", ".join(hexes[i:i + 12]) + ",")
+            lines.append("};")
+            if fields:
+                lines += wrap_initializer(
+                    f"static const struct msg_{msg.name} "
+                    f"proto_val_{msg.name}_{k} = ",
+                    f"{{{', '.join(c_literal(v) for v in values)}}};")
+            body.append((msg, k, fields))
+        lines.append("")
+
+    lines += [
+        "",
+        "/*****************************************************************"
+        "************",
+        " *  proto_selftest: Decodes every golden vector, compares the "
+        "fields, then",
+        " *                  re-encodes them and compares the bytes. Returns "
+        "the",
+        " *                  number of failures.",
+        " *****************************************************************"
+        "************/",
+        "static inline int",
+        "proto_selftest(void)",
+        "{",
+        "    uint8_t buf[PROTO_MAX_FRAME];",
+        "    int failures = 0;",
+        "",
+    ]
+    for msg, k, fields in body:
+        up = msg.name.upper()
+        vec = f"proto_vec_{msg.name}_{k}"
+        if fields:
+            val = f"proto_val_{msg.name}_{k}"
+            lines += [
+                "    {",
+                f"        struct msg_{msg.name} m;",
+                f"        if (!decode_{msg.name}({vec}, &m) ||",
+            ]
+            conds = []
+            for f in fields:
+                t = parse_type(f.type)
+                if t.count is None:
+                    conds.append(f"m.{f.name} != {val}.{f.name}")
+                else:
+                    conds.append(f"memcmp(m.{f.name}, {val}.{f.name}, "
+                                 f"sizeof m.{f.name}) != 0")
+            for i, c in enumerate(conds):
+                end = " ||" if i < len(conds) - 1 else ")"
+                if len(c) + len(end) + 12 <= 79:
+                    lines.append(f"            {c}{end}")
+                else:
+                    head, tail = c.split(", sizeof ")
+                    lines.append(f"            {head},")
+                    lines.append(f"                   sizeof {tail}{end}")
+            lines += [
+                "            failures++;",
+                f"        if (encode_{msg.name}(buf, &{val}) !=",
+                f"                MSG_{up}_LEN ||",
+            ]
+            cmp = f"memcmp(buf, {vec}, MSG_{up}_LEN) != 0)"
+            if len(cmp) + 12 <= 79:
+                lines.append(f"            {cmp}")
+            else:
+                lines.append(f"            memcmp(buf, {vec},")
+                lines.append(f"                   MSG_{up}_LEN) != 0)")
+            lines += [
+                "            failures++;",
+                "    }",
+            ]
+        else:
+            lines += [
+                f"    if (!decode_{msg.name}({vec}) ||",
+                f"        encode_{msg.name}(buf) != MSG_{up}_LEN ||",
+                f"        memcmp(buf, {vec}, MSG_{up}_LEN) != 0)",
+                "        failures++;",
+            ]
+    lines += [
+        "",
+        "    return failures;",
+        "}",
+        "#endif  /* PROTO_SELFTEST */",
+        "",
+    ]
+    return lines
+
+
+def c_constants():
+    if not schema.CONSTANTS:
+        return []
+    lines = [BANNER, "//  Constants", BANNER]
+    for const in schema.CONSTANTS:
+        lines += textwrap.wrap(f"/* {const.doc} */", width=79,
+                               subsequent_indent="   ")
+        lines.append(f"#define {const.name} {const.value}")
+    return lines + ["", ""]
+
+
+def gen_header():
+    max_len = max(frame_len(m) for m in schema.MESSAGES)
+    lines = [
+        BANNER,
+        "//  Generated by _codegen.py from _protocol_schema.py. Do not edit.",
+        "//",
+        "//  Header-only, allocation-free codec for the USB-serial protocol. "
+        "Every",
+        "//  `encode_*` function writes a complete frame into `buf` (which "
+        "must hold",
+        "//  at least `MSG_*_LEN` bytes) and returns its length, or 0 if a "
+        "field is",
+        "//  out of range. Every `decode_*` function reads a complete frame "
+        "from",
+        "//  `buf` and returns 1 on success, 0 if the frame is malformed.",
+        BANNER,
+        "#ifndef TNA_PROTOCOL_H",
+        "#define TNA_PROTOCOL_H",
+        "",
+        "#include <stddef.h>  /* size_t */",
+        "#include <stdint.h>  /* uintN_t, intN_t */",
+        "#include <string.h>  /* memcpy, memset, memcmp */",
+        "",
+        "",
+        BANNER,
+        "//  Framing",
+        BANNER,
+        f"#define PROTO_SOF {c_char(schema.SOF)}",
+        f"#define PROTO_EOF {c_char(schema.EOF)}",
+        f"#define PROTO_MAX_FRAME {max_len}",
+        "",
+        "",
+    ]
+    lines += c_constants()
+    lines += [
+        BANNER,
+        "//  Field helpers",
+        BANNER,
+        "static inline void",
+        "proto_put_u16(uint8_t *p, uint16_t v)",
+        "{",
+        "    p[0] = (uint8_t) v;",
+        "    p[1] = (uint8_t) (v >> 8);",
+        "}",
+        "",
+        "",
+        "static inline void",
+        "proto_put_u32(uint8_t *p, uint32_t v)",
+        "{",
+        "    p[0] = (uint8_t) v;",
+        "    p[1] = (uint8_t) (v >> 8);",
+        "    p[2] = (uint8_t) (v >> 16);",
+        "    p[3] = (uint8_t) (v >> 24);",
+        "}",
+        "",
+        "",
+        "static inline uint16_t",
+        "proto_get_u16(const uint8_t *p)",
+        "{",
+        "    return (uint16_t) (p[0] | (p[1] << 8));",
+        "}",
+        "",
+        "",
+        "static inline uint32_t",
+        "proto_get_u32(const uint8_t *p)",
+        "{",
+        "    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |",
+        "           ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);",
+        "}",
+        "",
+        "",
+        "/* Writes `v` as at most `width` ASCII digits padded with '\\0'. "
+        "Returns 0",
+        "   if `v` does not fit. */",
+        "static inline int",
+        "proto_put_dec(uint8_t *p, uint32_t v, size_t width)",
+        "{",
+        "    uint8_t tmp[10];",
+        "    size_t n = 0;",
+        "",
+        "    do {",
+        "        tmp[n++] = (uint8_t) ('0' + v % 10);",
+        "        v /= 10;",
+        "    } while (v > 0);",
+        "    if (n > width)",
+        "        return 0;",
+        "    for (size_t i = 0; i < width; i++)",
+        "        p[i] = (i < n) ? tmp[n - 1 - i] : '\\0';",
+        "    return 1;",
+        "}",
+        "",
+        "",
+        "/* Reads ASCII digits followed only by '\\0' padding. Returns 0 on "
+        "any other",
+        "   byte. */",
+        "static inline int",
+        "proto_get_dec(const uint8_t *p, size_t width, uint32_t *v)",
+        "{",
+        "    uint32_t acc = 0;",
+        "    size_t i = 0;",
+        "",
+        "    for (; i < width && p[i] >= '0' && p[i] <= '9'; i++)",
+        "        acc = acc * 10 + (uint32_t) (p[i] - '0');",
+        "    for (; i < width; i++)",
+        "        if (p[i] != '\\0')",
+        "            return 0;",
+        "    *v = acc;",
+        "    return 1;",
+        "}",
+        "",
+        "",
+    ]
+    for msg in schema.MESSAGES:
+        lines += c_message(msg)
+
+    lines += [
+        BANNER,
+        "//  Dispatch",
+        BANNER,
+        "/* Returns the length of a frame with opcode `op`, or 0 if `op` is "
+        "unknown. */",
+        "static inline size_t",
+        "proto_frame_len(uint8_t op)",
+        "{",
+        "    switch (op)",
+        "    {",
+    ]
+    for msg in schema.MESSAGES:
+        up = msg.name.upper()
+        lines.append(f"    case OP_{up}: return MSG_{up}_LEN;")
+    lines += [
+        "    default: return 0;",
+        "    }",
+        "}",
+        "",
+        "",
+    ]
+    lines += c_selftest()
+    lines += ["#endif  /* TNA_PROTOCOL_H */", ""]
+    return "\n".join(lines)
+
+
+###############################################################################
+#   Python generator
+###############################################################################
+def py_struct(msg):
+    fmt = "<BB"
+    for f in msg.fields:
+        t = parse_type(f.type)
+        if t.kind == "pad":
+            fmt += f"{t.size}x"
+        elif t.kind == "dec":
+            fmt += f"{t.size}s"
+        elif t.count is None:
+            fmt += INT_TYPES[t.base][1]
+        elif t.base == "u8":
+            fmt += f"{t.count}s"
+        else:
+            fmt += f"{t.count}{INT_TYPES[t.base][1]}"
+    return fmt + "B"
+
+
+def py_call(head, args, indent):
+    """Formats the call `head(args...)` over as many lines as needed to
+    stay within 79 columns, aligning continuation lines after `(`."""
+    lines = [" " * indent + head + "("]
+    cont = " " * len(lines[0])
+    for i, arg in enumerate(args):
+        arg += ")" if i == len(args) - 1 else ","
+        if len(lines[-1]) + 1 + len(arg) > 79 and \
+           not lines[-1].endswith("("):
+            lines.append(cont + arg)
+        else:
+            sep = "" if lines[-1].endswith("(") else " "
+            lines[-1] += sep + arg
+    return lines
+
+
+def py_docstring(text, indent=4):
+    lines = textwrap.wrap(f'"""{text}"""', width=79,
+                          initial_indent=" " * indent,
+                          subsequent_indent=" " * indent)
+    return lines
+
+
+def py_message(msg):
+    up = msg.name.upper()
+    cls = camel(msg.name)
+    fields = value_fields(msg)
+    names = [f.name for f in fields]
+    s = f"_{msg.name}"
+
+    # Arguments to `pack` after SOF and opcode, and checks done first.
+    pack_args, checks = [], []
+    for f in fields:
+        t = parse_type(f.type)
+        if t.kind == "dec":
+            pack_args.append(f"_put_dec({f.name}, {t.size})")
+        elif t.count is not None and t.base == "u8":
+            checks.append(f"    if len({f.name}) != {t.count}:\n"
+                          f"        raise ProtocolError(\"`{f.name}` must "
+                          f"have {t.count} elements.\")")
+            pack_args.append(f"bytes({f.name})")
+        elif t.count is not None:
+            pack_args.append(f"*{f.name}")
+        else:
+            pack_args.append(f.name)
+    pack_args = [f"OP_{up}"] + pack_args + ["EOF"]
+
+    # Expressions building the fields from the unpacked tuple `v`.
+    unpacked, idx = [], 2
+    for f in fields:
+        t = parse_type(f.type)
+        if t.kind == "dec":
+            unpacked.append(f"_get_dec(v[{idx}])")
+            idx += 1
+        elif t.count is not None and t.base != "u8":
+            unpacked.append(f"v[{idx}:{idx + t.count}]")
+            idx += t.count
+        else:
+            unpacked.append(f"v[{idx}]")
+            idx += 1
+
+    lines = [
+        PY_BANNER,
+        f"#   {msg.name} ({msg.direction})",
+        "#",
+    ]
+    for f in msg.fields:
+        lines += textwrap.wrap(f"{f.name:<14}: {f.type:<7} {f.doc}",
+                               width=79, initial_indent="#       ",
+                               subsequent_indent="#" + " " * 31)
+    lines += [
+        PY_BANNER,
+        f"OP_{up} = 0x{ord(msg.opcode):02X}",
+        f"{up}_LEN = {frame_len(msg)}",
+    ]
+    head = f"{cls} = namedtuple(\"{cls}\", "
+    chunks = textwrap.wrap(" ".join(names), width=77 - len(head),
+                           drop_whitespace=False) or [""]
+    for i, chunk in enumerate(chunks):
+        end = ")" if i == len(chunks) - 1 else ""
+        lines.append(f"{head if i == 0 else ' ' * len(head)}\"{chunk}\"{end}")
+    lines += [
+        f"{s} = struct.Struct(\"{py_struct(msg)}\")",
+        "",
+        "",
+    ]
+    if names:
+        lines += py_call(f"def encode_{msg.name}", names, 0)
+        lines[-1] += ":"
+    else:
+        lines += [f"def encode_{msg.name}():"]
+    lines += py_docstring(f"Returns the frame for: {msg.doc}")
+    lines += checks
+    lines += ["    try:"]
+    lines += py_call(f"return {s}.pack", ["SOF"] + pack_args, 8)
+    lines += [
+        "    except struct.error as err:",
+        "        raise ProtocolError(err) from None",
+        "",
+        "",
+    ]
+    lines += py_call(f"def encode_{msg.name}_into",
+                     ["buf", "offset"] + names, 0)
+    lines[-1] += ":"
+    lines += [
+        "    \"\"\"Writes the frame into `buf` at `offset`. Returns the "
+        "offset",
+        "    just past the frame.\"\"\"",
+    ]
+    lines += checks
+    lines += ["    try:"]
+    lines += py_call(f"{s}.pack_into", ["buf", "offset", "SOF"] + pack_args,
+                     8)
+    lines += [
+        "    except struct.error as err:",
+        "        raise ProtocolError(err) from None",
+        f"    return offset + {up}_LEN",
+        "",
+        "",
+        f"def decode_{msg.name}(frame, offset=0):",
+        f"    \"\"\"Returns the fields of a `{msg.name}` frame as a "
+        f"`{cls}`.\"\"\"",
+        "    try:",
+        f"        v = {s}.unpack_from(frame, offset)",
+        "    except struct.error as err:",
+        "        raise ProtocolError(err) from None",
+        f"    if v[0] != SOF or v[1] != OP_{up} or v[-1] != EOF:",
+        f"        raise ProtocolError(\"Malformed `{msg.name}` frame.\")",
+        f"    return {cls}({', '.join(unpacked)})",
+        "",
+        "",
+    ]
+    return lines
+
+
+def py_vectors():
+    lines = ["    VECTORS = ("]
+    for msg in schema.MESSAGES:
+        for values in vectors(msg):
+            frame = reference_encode(msg, values)
+            lines += wrap_initializer(f"        (\"{msg.name}\", ",
+                                      f"{tuple_repr(values)},", indent=9)
+            frame = bytes(frame)
+            for i in range(0, len(frame), 16):
+                end = ")," if i + 16 >= len(frame) else ""
+                lines.append(f"         {frame[i:i + 16]!r}{end}")
+    lines.append("    )")
+    return lines
+
+
+def wrap_initializer(head, body, indent=4):
+    """Returns `head + body` as one line if it fits in 79 columns, otherwise
+    with `body` wrapped at its commas, continuation lines indented by
+    `indent` spaces."""
+    if len(head) + len(body) <= 79:
+        return [head + body]
+    return [head.rstrip()] + textwrap.wrap(
+        body, width=79, initial_indent=" " * indent,
+        subsequent_indent=" " * indent, break_long_words=False,
+        break_on_hyphens=False)
+
+
+def tuple_repr(values):
+    return "(" + "".join(
+        (repr(tuple(v)) if isinstance(v, list) else repr(v)) + ", "
+        for v in values).rstrip(" ") + ")"
+
+
+def py_constants():
+    if not schema.CONSTANTS:
+        return []
+    lines = [PY_BANNER, "#   Constants", PY_BANNER]
+    for const in schema.CONSTANTS:
+        lines += textwrap.wrap(const.doc, width=79, initial_indent="# ",
+                               subsequent_indent="# ")
+        lines.append(f"{const.name} = {const.value}")
+    return lines + ["", ""]
+
+
+def gen_module():
+    max_len = max(frame_len(m) for m in schema.MESSAGES)
+    lines = [
+        PY_BANNER,
+        "#   Generated by _codegen.py from _protocol_schema.py. Do not edit.",
+        "#",
+        "#   Python codec for the USB-serial protocol; `_protocol.h` is the "
+        "matching",
+        "#   C++ codec. `encode_*` returns a complete frame as `bytes`,",
+        "#   `encode_*_into` writes it into a preallocated buffer, and "
+        "`decode_*`",
+        "#   returns the fields as a namedtuple. Malformed frames and "
+        "out-of-range",
+        "#   fields raise `ProtocolError`.",
+        PY_BANNER,
+        PY_BANNER,
+        "#   Imports",
+        PY_BANNER,
+        "import struct",
+        "",
+        "from collections import namedtuple",
+        "",
+        "",
+        PY_BANNER,
+        "#   Exceptions",
+        PY_BANNER,
+        "class ProtocolError(Exception):",
+        "    pass",
+        "",
+        "",
+        PY_BANNER,
+        "#   Framing",
+        PY_BANNER,
+        f"SOF = 0x{ord(schema.SOF):02X}",
+        f"EOF = 0x{ord(schema.EOF):02X}",
+        f"MAX_FRAME = {max_len}",
+        "",
+        "",
+    ]
+    lines += py_constants()
+    lines += [
+        "def _put_dec(value, width):",
+        "    digits = str(value).encode()",
+        "    if value < 0 or len(digits) > width:",
+        "        raise ProtocolError(f\"{value} does not fit in {width} "
+        "digits.\")",
+        "    return digits",
+        "",
+        "",
+        "def _get_dec(raw):",
+        "    digits, _, rest = raw.partition(b\"\\0\")",
+        "    if (digits and not digits.isdigit()) or rest.count(0) != "
+        "len(rest):",
+        "        raise ProtocolError(f\"Invalid decimal field {raw!r}.\")",
+        "    return int(digits) if digits else 0",
+        "",
+        "",
+    ]
+    for msg in schema.MESSAGES:
+        lines += py_message(msg)
+
+    lines += [
+        PY_BANNER,
+        "#   Dispatch",
+        PY_BANNER,
+        "FRAME_LEN = {",
+    ]
+    for msg in schema.MESSAGES:
+        up = msg.name.upper()
+        lines.append(f"    OP_{up}: {up}_LEN,")
+    lines += [
+        "}",
+        "",
+        "_decoders = {",
+    ]
+    for msg in schema.MESSAGES:
+        lines.append(f"    OP_{msg.name.upper()}: decode_{msg.name},")
+    lines += [
+        "}",
+        "",
+        "",
+        "def frame_len(op):",
+        "    \"\"\"Returns the length of a frame with opcode `op`, or 0 "
+        "if",
+        "    `op` is unknown.\"\"\"",
+        "    return FRAME_LEN.get(op, 0)",
+        "",
+        "",
+        "def decode(frame, offset=0):",
+        "    \"\"\"Decodes the frame at `offset`, whatever its opcode.\"\"\"",
+        "    try:",
+        "        decoder = _decoders[frame[offset + 1]]",
+        "    except (KeyError, IndexError):",
+        "        raise ProtocolError(\"Unknown opcode.\") from None",
+        "    return decoder(frame, offset)",
+        "",
+        "",
+        PY_BANNER,
+        "#   Test: golden vectors shared with `_protocol.h`, followed by "
+        "encode/",
+        "#         decode benchmarks.",
+        PY_BANNER,
+        "if __name__ == '__main__':",
+        "    from time import perf_counter",
+        "",
+    ]
+    lines += py_vectors()
+    lines += [
+        "",
+        "    failures = 0",
+        "    for name, values, frame in VECTORS:",
+        "        encode = globals()[\"encode_\" + name]",
+        "        got = tuple(tuple(v) if isinstance(v, bytes) else v",
+        "                    for v in decode(frame))",
+        "        if got != values or encode(*values) != frame:",
+        "            print(f\"FAIL: {name} {values}\")",
+        "            failures += 1",
+        "    print(f\"{len(VECTORS) - failures}/{len(VECTORS)} vectors "
+        "passed.\")",
+        "",
+        "    n = 100_000",
+        "    buf = bytearray(MAX_FRAME)",
+        "    for name, values, frame in VECTORS[2::3]:",
+        "        encode_into = globals()[\"encode_\" + name + \"_into\"]",
+        "        decoder = globals()[\"decode_\" + name]",
+        "        start = perf_counter()",
+        "        for _ in range(n):",
+        "            encode_into(buf, 0, *values)",
+        "        t_enc = (perf_counter() - start) / n",
+        "        start = perf_counter()",
+        "        for _ in range(n):",
+        "            decoder(frame)",
+        "        t_dec = (perf_counter() - start) / n",
+        "        print(f\"{name:<16} encode {t_enc * 1e9:7.0f} ns   \"",
+        "              f\"decode {t_dec * 1e9:7.0f} ns\")",
+        "",
+        "    raise SystemExit(1 if failures else 0)",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+###############################################################################
+#   Cross-language round trip
+###############################################################################
+def gen_harness():
+    """C++ program that reads frames from stdin, decodes and re-encodes each
+    with the generated codec, and writes one line per frame:
+
+        <name> <field values...> <re-encoded frame as hex>
+
+    With the argument `bench`, it instead times encode/decode of every
+    message, rotating through its golden vectors. The inputs pass through
+    `opaque()` and the outputs through `clobber()`, so that the compiler
+    can neither fold a call into a constant nor hoist it out of the loop."""
+    lines = [
+        "#define PROTO_SELFTEST",
+        '#include "_protocol.h"',
+        "#include <chrono>",
+        "#include <cstdio>",
+        "#include <cstring>",
+        "",
+        "static void",
+        "hex(const uint8_t *p, size_t n)",
+        "{",
+        "    for (size_t i = 0; i < n; i++)",
+        "        printf(\"%02x\", p[i]);",
+        "    printf(\"\\n\");",
+        "}",
+        "",
+        "template <typename T>",
+        "static inline T *",
+        "opaque(T *p)",
+        "{",
+        "    __asm__ volatile(\"\" : \"+r\"(p));",
+        "    return p;",
+        "}",
+        "",
+        "static inline void",
+        "clobber(void *p)",
+        "{",
+        "    __asm__ volatile(\"\" : : \"r\"(p) : \"memory\");",
+        "}",
+        "",
+        "template <typename F>",
+        "static double",
+        "bench(F f)",
+        "{",
+        "    const int n = 10000000;",
+        "    auto start = std::chrono::steady_clock::now();",
+        "    for (int i = 0; i < n; i++)",
+        f"        f(i % {N_VECTORS});",
+        "    std::chrono::duration<double> d =",
+        "        std::chrono::steady_clock::now() - start;",
+        "    return d.count() / n * 1e9;",
+        "}",
+        "",
+        "int",
+        "main(int argc, char **argv)",
+        "{",
+        "    static uint8_t in[1 << 20];",
+        "    uint8_t out[PROTO_MAX_FRAME];",
+        "    volatile size_t sink = 0;",
+        "",
+        "    if (argc > 1 && strcmp(argv[1], \"bench\") == 0)",
+        "    {",
+    ]
+    for msg in schema.MESSAGES:
+        fields = value_fields(msg)
+        vecs = ", ".join(f"proto_vec_{msg.name}_{k}"
+                         for k in range(N_VECTORS))
+        lines += [
+            "        {",
+            f"            static const uint8_t *const vecs[] = {{{vecs}}};",
+        ]
+        if fields:
+            vals = ", ".join(f"&proto_val_{msg.name}_{k}"
+                             for k in range(N_VECTORS))
+            lines += [
+                f"            static const struct msg_{msg.name} *const "
+                f"vals[] = {{{vals}}};",
+                f"            struct msg_{msg.name} m;",
+                f"            double e = bench([&](int k) {{ sink += "
+                f"encode_{msg.name}(out, opaque(vals[k])); clobber(out); }});",
+                f"            double d = bench([&](int k) {{ sink += "
+                f"decode_{msg.name}(opaque(vecs[k]), &m); clobber(&m); }});",
+            ]
+        else:
+            lines += [
+                f"            double e = bench([&](int) {{ sink += "
+                f"encode_{msg.name}(out); clobber(out); }});",
+                f"            double d = bench([&](int k) {{ sink += "
+                f"decode_{msg.name}(opaque(vecs[k])); }});",
+            ]
+        lines += [
+            "            printf(\"%-16s encode %7.1f ns   \"",
+            "                   \"decode %7.1f ns\\n\",",
+            f"                   \"{msg.name}\", e, d);",
+            "        }",
+        ]
+    lines += [
+        "        return 0;",
+        "    }",
+        "",
+        "    if (proto_selftest() != 0)",
+        "    {",
+        "        fprintf(stderr, \"proto_selftest failed\\n\");",
+        "        return 1;",
+        "    }",
+        "",
+        "    size_t n = fread(in, 1, sizeof in, stdin);",
+        "    for (size_t i = 0; i + 1 < n; )",
+        "    {",
+        "        size_t len = proto_frame_len(in[i + 1]);",
+        "        if (len == 0 || i + len > n)",
+        "            return 2;",
+        "        switch (in[i + 1])",
+        "        {",
+    ]
+    for msg in schema.MESSAGES:
+        up = msg.name.upper()
+        fields = value_fields(msg)
+        lines.append(f"        case OP_{up}:")
+        lines.append("        {")
+        if fields:
+            lines += [
+                f"            struct msg_{msg.name} m;",
+                f"            if (!decode_{msg.name}(&in[i], &m) ||",
+                f"                encode_{msg.name}(out, &m) != len)",
+                "                return 3;",
+                f"            printf(\"{msg.name} \");",
+            ]
+            for f in fields:
+                t = parse_type(f.type)
+                signed = t.kind == "int" and t.base.startswith("i")
+                fmt, cast = ("%ld ", "long") if signed else \
+                            ("%lu ", "unsigned long")
+                if t.count is None:
+                    lines.append(f"            printf(\"{fmt}\", "
+                                 f"({cast}) m.{f.name});")
+                else:
+                    lines += [
+                        f"            for (size_t k = 0; k < {t.count}; "
+                        "k++)",
+                        f"                printf(\"{fmt}\", "
+                        f"({cast}) m.{f.name}[k]);",
+                    ]
+        else:
+            lines += [
+                f"            if (!decode_{msg.name}(&in[i]) ||",
+                f"                encode_{msg.name}(out) != len)",
+                "                return 3;",
+                f"            printf(\"{msg.name} \");",
+            ]
+        lines += [
+            "            hex(out, len);",
+            "            break;",
+            "        }",
+        ]
+    lines += [
+        "        default:",
+        "            return 2;",
+        "        }",
+        "        i += len;",
+        "    }",
+        "    return 0;",
+        "}",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def run_test():
+    import _protocol
+
+    rng = random.Random(0)
+    frames, expected = [], []
+    for _ in range(2000):
+        msg = rng.choice(schema.MESSAGES)
+        values = []
+        for f in value_fields(msg):
+            t = parse_type(f.type)
+            lo, hi = field_range(t)
+            if t.count is None:
+                values.append(rng.randint(lo, hi))
+            else:
+                values.append([rng.randint(lo, hi) for _ in range(t.count)])
+        frame = getattr(_protocol, "encode_" + msg.name)(*values)
+        assert frame == reference_encode(msg, values), msg.name
+        frames.append(frame)
+        flat = []
+        for v in values:
+            flat += v if isinstance(v, list) else [v]
+        expected.append(f"{msg.name} " + "".join(f"{x} " for x in flat) +
+                        frame.hex())
+
+    cxx = os.environ.get("CXX", "c++")
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "harness.cpp")
+        exe = os.path.join(tmp, "harness")
+        with open(src, "w") as fp:
+            fp.write(gen_harness())
+        subprocess.run([cxx, "-std=c++14", "-O2", "-Wall", "-Wextra",
+                        "-Werror", "-I", HERE, src, "-o", exe], check=True)
+        out = subprocess.run([exe], input=b"".join(frames),
+                             capture_output=True, check=True)
+        got = out.stdout.decode().splitlines()
+        if got != expected:
+            bad = next(i for i, (a, b) in enumerate(zip(got, expected))
+                       if a != b) if len(got) == len(expected) else -1
+            print(f"Cross-language round trip FAILED at frame {bad}.")
+            return 1
+        print(f"Cross-language round trip: {len(frames)} frames OK.")
+
+        subprocess.run([sys.executable, MODULE_PATH], check=True)
+        subprocess.run([exe, "bench"], check=True)
+    return 0
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    validate()
+    outputs = ((HEADER_PATH, gen_header()), (MODULE_PATH, gen_module()))
+
+    if "--check" in argv:
+        stale = [path for path, text in outputs
+                 if not os.path.exists(path) or open(path).read() != text]
+        for path in stale:
+            print(f"{os.path.basename(path)} is stale; run _codegen.py.")
+        return 1 if stale else 0
+
+    for path, text in outputs:
+        with open(path, "w") as fp:
+            fp.write(text)
+
+    if "--test" in argv:
+        return run_test()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
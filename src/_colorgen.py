@@ -0,0 +1,294 @@
+###############################################################################
+#   Color ramp generator: writes `_colors.h`, the table of crossfades between
+#                         the note colors used by `_lights.cpp`.
+#
+#   For every ordered pair of pitch classes (from, to), `color_ramp[from][to]`
+#   holds COLOR_RAMP_N colors going from `map_cs_to_color[from]` to
+#   `map_cs_to_color[to]` in equal steps of OKLab (Björn Ottosson's
+#   perceptual color space). Interpolating the RGB values directly would
+#   pass through greys (e.g. red to violet); in OKLab, lightness and chroma
+#   change evenly. Everything is computed here in double precision, so the
+#   microcontroller's per-frame cost is two table lookups and a fixed-point
+#   blend of the adjacent entries (`color_ramp_at()`).
+#
+#   The colors are read from `map_cs_to_color` in `_lights.cpp`, which stays
+#   the one place where they are defined, and treated as sRGB.
+#
+#   Usage:
+#       python3 _colorgen.py           Regenerate `_colors.h`.
+#       python3 _colorgen.py --check   Fail if `_colors.h` is stale.
+#       python3 _colorgen.py --test    Accuracy test: every crossfade, as
+#                                      computed by `color_ramp_at()`
+#                                      (compiled with the host C++ compiler)
+#                                      at every frame of crossfades of 1 to
+#                                      32 frames, against the double
+#                                      precision OKLab reference.
+###############################################################################
+###############################################################################
+#   Imports
+###############################################################################
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+import numpy as np
+
+
+###############################################################################
+#   Globals
+###############################################################################
+HERE = os.path.dirname(os.path.abspath(__file__))
+SKETCH_PATH = os.path.join(HERE, "_lights.cpp")
+HEADER_PATH = os.path.join(HERE, "_colors.h")
+
+BANNER = "/" * 79
+
+N_COLORS = 12
+RAMP_N = 32         # Colors per crossfade, endpoints included.
+MAX_FRAMES = 32     # Longest crossfade tested, in frames.
+
+# Largest OKLab distance tolerated between a looked-up color and the
+# reference: about the error of rounding to 8 bits, and a quarter of a
+# just-noticeable difference.
+MAX_DELTA_E = 0.005
+
+
+###############################################################################
+#   OKLab (https://bottosson.github.io/posts/oklab/)
+###############################################################################
+M1 = np.array(((0.4122214708, 0.5363325363, 0.0514459929),
+               (0.2119034982, 0.6806995451, 0.1073969566),
+               (0.0883024619, 0.2817188376, 0.6299787005)))
+M2 = np.array(((0.2104542553, 0.7936177850, -0.0040720468),
+               (1.9779984951, -2.4285922050, 0.4505937099),
+               (0.0259040371, 0.7827717662, -0.8086757660)))
+
+
+def srgb_to_linear(c):
+    return np.where(c <= 0.04045, c / 12.92, ((c + 0.055) / 1.055) ** 2.4)
+
+
+def linear_to_srgb(c):
+    c = np.clip(c, 0.0, 1.0)
+    return np.where(c <= 0.0031308, 12.92 * c,
+                    1.055 * c ** (1 / 2.4) - 0.055)
+
+
+def rgb_to_oklab(rgb):
+    """`rgb`: (..., 3) array of 8-bit sRGB values."""
+    lms = srgb_to_linear(np.asarray(rgb, dtype=float) / 255) @ M1.T
+    return np.cbrt(lms) @ M2.T
+
+
+def oklab_to_rgb(lab):
+    """Returns (..., 3) sRGB values in [0, 255], not rounded."""
+    lms = (lab @ np.linalg.inv(M2).T) ** 3
+    return 255 * linear_to_srgb(lms @ np.linalg.inv(M1).T)
+
+
+def unpack(color):
+    return ((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF)
+
+
+def read_colors():
+    """Returns `map_cs_to_color` from `_lights.cpp`."""
+    with open(SKETCH_PATH) as fp:
+        text = fp.read()
+    body = re.search(r"map_cs_to_color\[\] = \{(.*?)\};", text, re.S)
+    colors = [int(x, 16) for x in re.findall(r"0x([0-9A-Fa-f]{6})",
+                                             body.group(1))]
+    if len(colors) != N_COLORS:
+        raise SystemExit(f"Expected {N_COLORS} colors in map_cs_to_color.")
+    return colors
+
+
+def reference(colors, a, b, t):
+    """Returns the color a fraction `t` of the way from `colors[a]` to
+    `colors[b]`, in OKLab, as unrounded sRGB."""
+    lab_a, lab_b = rgb_to_oklab(unpack(colors[a])), rgb_to_oklab(
+        unpack(colors[b]))
+    return oklab_to_rgb(lab_a + (lab_b - lab_a) * np.asarray(t)[..., None])
+
+
+def ramps(colors):
+    """Returns the (12, 12, RAMP_N, 3) table of rounded ramp colors."""
+    t = np.linspace(0, 1, RAMP_N)
+    table = np.empty((N_COLORS, N_COLORS, RAMP_N, 3), dtype=np.uint8)
+    for a in range(N_COLORS):
+        for b in range(N_COLORS):
+            table[a, b] = np.rint(reference(colors, a, b, t))
+            # Endpoints are the note colors exactly.
+            table[a, b, 0] = unpack(colors[a])
+            table[a, b, -1] = unpack(colors[b])
+    return table
+
+
+###############################################################################
+#   C++ header
+###############################################################################
+def gen_header():
+    colors = read_colors()
+    table = ramps(colors)
+    lines = [
+        BANNER,
+        "//  Generated by _colorgen.py from map_cs_to_color in _lights.cpp. "
+        "Do not",
+        "//  edit.",
+        "//",
+        "//  `color_ramp[from][to]` holds COLOR_RAMP_N colors (0xRRGGBB) "
+        "going from",
+        "//  the color of pitch class `from` to that of `to` in equal steps "
+        "of",
+        "//  OKLab.",
+        BANNER,
+        "#ifndef TNA_COLORS_H",
+        "#define TNA_COLORS_H",
+        "",
+        "#include <stdint.h>  /* uint32_t */",
+        "",
+        f"#define COLOR_RAMP_N {RAMP_N}",
+        "",
+        "static const uint32_t color_ramp[12][12][COLOR_RAMP_N] = {",
+    ]
+    for a in range(N_COLORS):
+        lines.append("    {")
+        for b in range(N_COLORS):
+            words = [f"0x{r:02X}{g:02X}{bl:02X}" for r, g, bl in table[a, b]]
+            lines.append("        {")
+            for i in range(0, RAMP_N, 6):
+                chunk = ", ".join(words[i:i + 6])
+                end = "," if i + 6 < RAMP_N else ""
+                lines.append(f"            {chunk}{end}")
+            lines.append("        }," if b < N_COLORS - 1 else "        }")
+        lines.append("    }," if a < N_COLORS - 1 else "    }")
+    lines += [
+        "};",
+        "",
+        "/* Returns the color of frame `k` of a crossfade of `n` frames from "
+        "pitch",
+        "   class `from` to `to`: `from` at frame 0, `to` at frame `n`. "
+        "Between",
+        "   entries of the ramp, the two nearest are blended with an 8-bit "
+        "weight. */",
+        "static inline uint32_t",
+        "color_ramp_at(uint8_t from, uint8_t to, uint32_t k, uint32_t n)",
+        "{",
+        "    const uint32_t *ramp = color_ramp[from][to];",
+        "    uint32_t pos, w, a, b, out = 0;",
+        "",
+        "    if (k >= n)",
+        "        return ramp[COLOR_RAMP_N - 1];",
+        "    pos = (k * (COLOR_RAMP_N - 1) << 8) / n;  /* 24.8 fixed point */",
+        "    w = pos & 0xFF;",
+        "    a = ramp[pos >> 8];",
+        "    b = ramp[(pos >> 8) + 1];",
+        "    for (int shift = 0; shift < 24; shift += 8)",
+        "    {",
+        "        uint32_t ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;",
+        "",
+        "        out |= ((ca * (256 - w) + cb * w + 128) >> 8) << shift;",
+        "    }",
+        "    return out;",
+        "}",
+        "",
+        "#endif  /* TNA_COLORS_H */",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+###############################################################################
+#   Test
+###############################################################################
+HARNESS = r"""
+#include <stdio.h>
+#include "_colors.h"
+
+int
+main(void)
+{
+    for (int a = 0; a < 12; a++)
+        for (int b = 0; b < 12; b++)
+            for (unsigned n = 1; n <= %d; n++)
+                for (unsigned k = 0; k <= n; k++)
+                    printf("%%06X\n", (unsigned) color_ramp_at(a, b, k, n));
+    return 0;
+}
+"""
+
+
+def run_test():
+    colors = read_colors()
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "harness.cpp")
+        exe = os.path.join(tmp, "harness")
+        with open(src, "w") as fp:
+            fp.write(HARNESS % MAX_FRAMES)
+        subprocess.run(["c++", "-O2", "-Wall", "-Wextra", "-I", HERE,
+                        "-o", exe, src], check=True)
+        out = subprocess.run([exe], check=True, capture_output=True,
+                             text=True).stdout.split()
+    device = np.array([unpack(int(x, 16)) for x in out], dtype=float)
+
+    # Reference at the same frames, in the same order.
+    t = np.concatenate([np.arange(n + 1) / n
+                        for n in range(1, MAX_FRAMES + 1)])
+    ref = np.concatenate([reference(colors, a, b, t)
+                          for a in range(N_COLORS) for b in range(N_COLORS)])
+
+    delta_e = np.linalg.norm(rgb_to_oklab(device) - rgb_to_oklab(ref),
+                             axis=-1)
+    rgb_err = np.abs(device - ref).max()
+    print(f"{len(device)} crossfade frames: max OKLab error "
+          f"{delta_e.max():.4f} (mean {delta_e.mean():.4f}), max RGB error "
+          f"{rgb_err:.1f}.")
+
+    # For comparison: the chroma at the middle of each crossfade, in OKLab
+    # and with a plain RGB lerp.
+    mid_ok, mid_rgb = [], []
+    for a in range(N_COLORS):
+        for b in range(N_COLORS):
+            lab = rgb_to_oklab(reference(colors, a, b, 0.5))
+            ends = (rgb_to_oklab(unpack(colors[a])),
+                    rgb_to_oklab(unpack(colors[b])))
+            lerp = rgb_to_oklab((np.array(unpack(colors[a])) +
+                                 np.array(unpack(colors[b]))) / 2)
+            mean = (np.hypot(*ends[0][1:]) + np.hypot(*ends[1][1:])) / 2
+            if mean:
+                mid_ok.append(np.hypot(*lab[1:]) / mean)
+                mid_rgb.append(np.hypot(*lerp[1:]) / mean)
+    print(f"Mid-crossfade chroma, relative to the endpoints: OKLab "
+          f"{min(mid_ok):.2f} min, RGB lerp {min(mid_rgb):.2f} min.")
+
+    if delta_e.max() > MAX_DELTA_E:
+        print(f"FAILED: OKLab error above {MAX_DELTA_E}.")
+        return 1
+    print("OK.")
+    return 0
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    text = gen_header()
+
+    if "--check" in argv:
+        if not os.path.exists(HEADER_PATH) or \
+                open(HEADER_PATH).read() != text:
+            print("_colors.h is stale; run _colorgen.py.")
+            return 1
+        return 0
+
+    with open(HEADER_PATH, "w") as fp:
+        fp.write(text)
+
+    if "--test" in argv:
+        return run_test()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
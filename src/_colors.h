@@ -0,0 +1,1219 @@
+///////////////////////////////////////////////////////////////////////////////
+//  Generated by _colorgen.py from map_cs_to_color in _lights.cpp. Do not
+//  edit.
+//
+//  `color_ramp[from][to]` holds COLOR_RAMP_N colors (0xRRGGBB) going from
+//  the color of pitch class `from` to that of `to` in equal steps of
+//  OKLab.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef TNA_COLORS_H
+#define TNA_COLORS_H
+
+#include <stdint.h>  /* uint32_t */
+
+#define COLOR_RAMP_N 32
+
+static const uint32_t color_ramp[12][12][COLOR_RAMP_N] = {
+    {
+        {
+            0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000,
+            0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000,
+            0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000,
+            0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000,
+            0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000,
+            0xFF0000, 0xFF0000
+        },
+        {
+            0xFF0000, 0xFE191C, 0xFD272B, 0xFC3137, 0xFB3941, 0xF9404B,
+            0xF84653, 0xF74C5B, 0xF65163, 0xF4566B, 0xF35A72, 0xF25F79,
+            0xF06380, 0xEF6787, 0xED6A8E, 0xEC6E95, 0xEA719C, 0xE975A2,
+            0xE778A9, 0xE57BB0, 0xE47EB6, 0xE281BD, 0xE084C4, 0xDE86CA,
+            0xDC89D1, 0xDA8CD7, 0xD98EDE, 0xD791E5, 0xD493EB, 0xD295F2,
+            0xD098F8, 0xCE9AFF
+        },
+        {
+            0xFF0000, 0xFF2100, 0xFF3200, 0xFF3E00, 0xFF4900, 0xFF5300,
+            0xFF5C00, 0xFF6400, 0xFF6C00, 0xFF7400, 0xFF7B00, 0xFF8200,
+            0xFF8900, 0xFF9000, 0xFF9600, 0xFF9D00, 0xFFA300, 0xFFAA00,
+            0xFFB000, 0xFFB600, 0xFFBD00, 0xFFC300, 0xFFC900, 0xFFCF00,
+            0xFFD500, 0xFFDB00, 0xFFE100, 0xFFE700, 0xFFED00, 0xFFF300,
+            0xFFF900, 0xFFFF00
+        },
+        {
+            0xFF0000, 0xFA1615, 0xF62221, 0xF12B2A, 0xED3132, 0xE83738,
+            0xE33C3E, 0xDF4044, 0xDA4449, 0xD5474D, 0xD14A52, 0xCC4D56,
+            0xC7505A, 0xC2525E, 0xBE5462, 0xB95666, 0xB45869, 0xAF5A6D,
+            0xAA5B70, 0xA55D74, 0xA05E77, 0x9B5F7A, 0x96607E, 0x916181,
+            0x8C6284, 0x876387, 0x81638A, 0x7C648D, 0x766490, 0x716593,
+            0x6B6596, 0x656599
+        },
+        {
+            0xFF0000, 0xFF2218, 0xFF3326, 0xFF4031, 0xFF4B3B, 0xFF5444,
+            0xFF5D4C, 0xFF6654, 0xFF6D5C, 0xFF7563, 0xFF7C6B, 0xFF8372,
+            0xFF8A79, 0xFF9080, 0xFF9787, 0xFF9D8E, 0xFFA495, 0xFEAA9C,
+            0xFDB0A3, 0xFCB6AA, 0xFBBCB1, 0xFAC2B8, 0xF8C8BF, 0xF6CEC7,
+            0xF5D3CE, 0xF3D9D5, 0xF1DFDC, 0xEEE4E3, 0xECEAEA, 0xE9F0F1,
+            0xE6F5F8, 0xE3FBFF
+        },
+        {
+            0xFF0000, 0xFC0200, 0xF90400, 0xF70600, 0xF40800, 0xF10A00,
+            0xEE0C00, 0xEC0D00, 0xE90E00, 0xE61000, 0xE41100, 0xE11200,
+            0xDE1300, 0xDB1400, 0xD91400, 0xD61500, 0xD31600, 0xD11700,
+            0xCE1700, 0xCB1800, 0xC91800, 0xC61900, 0xC31900, 0xC11A00,
+            0xBE1A00, 0xBC1A00, 0xB91B00, 0xB61B00, 0xB41B00, 0xB11C00,
+            0xAF1C00, 0xAC1C00
+        },
+        {
+            0xFF0000, 0xFC231C, 0xF9342B, 0xF64036, 0xF24B40, 0xEF5349,
+            0xEB5B52, 0xE8635A, 0xE46962, 0xE06F69, 0xDC7571, 0xD87B78,
+            0xD4807F, 0xCF8586, 0xCA8A8D, 0xC68F94, 0xC0949B, 0xBB98A1,
+            0xB59CA8, 0xAFA1AF, 0xA9A5B6, 0xA2A9BC, 0x9BACC3, 0x93B0CA,
+            0x8BB4D0, 0x82B8D7, 0x77BBDE, 0x6CBFE4, 0x5EC2EB, 0x4EC5F2,
+            0x37C9F8, 0x00CCFF
+        },
+        {
+            0xFF0000, 0xFF0C00, 0xFF1400, 0xFF1B00, 0xFF2000, 0xFF2500,
+            0xFF2900, 0xFF2D00, 0xFF3000, 0xFF3300, 0xFF3600, 0xFF3900,
+            0xFF3C00, 0xFF3F00, 0xFF4100, 0xFF4400, 0xFF4600, 0xFF4900,
+            0xFF4B00, 0xFF4D00, 0xFF4F00, 0xFF5200, 0xFF5400, 0xFF5600,
+            0xFF5800, 0xFF5A00, 0xFF5C00, 0xFF5E00, 0xFF5F00, 0xFF6100,
+            0xFF6300, 0xFF6500
+        },
+        {
+            0xFF0000, 0xFF091E, 0xFF112E, 0xFF163A, 0xFE1A44, 0xFE1E4E,
+            0xFE2056, 0xFE235F, 0xFE2566, 0xFE276E, 0xFE2875, 0xFE2A7C,
+            0xFE2B83, 0xFE2B8A, 0xFE2C91, 0xFD2D98, 0xFD2D9E, 0xFD2DA5,
+            0xFD2DAC, 0xFE2CB2, 0xFE2CB9, 0xFE2BBF, 0xFE29C6, 0xFE28CC,
+            0xFE26D2, 0xFE24D9, 0xFE21DF, 0xFE1EE5, 0xFE1AEC, 0xFF14F2,
+            0xFF0CF9, 0xFF00FF
+        },
+        {
+            0xFF0000, 0xFC2202, 0xF93305, 0xF63F07, 0xF24909, 0xEF510C,
+            0xEB590E, 0xE86010, 0xE46712, 0xE06D14, 0xDC7316, 0xD87917,
+            0xD47E19, 0xCF831B, 0xCB881C, 0xC68D1E, 0xC1911F, 0xBC9621,
+            0xB79A22, 0xB19E23, 0xABA325, 0xA5A726, 0x9EAB27, 0x97AF29,
+            0x8FB32A, 0x87B62B, 0x7EBA2D, 0x74BE2E, 0x68C12F, 0x5BC531,
+            0x4AC832, 0x33CC33
+        },
+        {
+            0xFF0000, 0xFC1911, 0xF9261B, 0xF62F23, 0xF3372A, 0xEF3D30,
+            0xEC4335, 0xE9483A, 0xE64D3E, 0xE35143, 0xDF5547, 0xDC594B,
+            0xD85D4F, 0xD56053, 0xD26356, 0xCE665A, 0xCA695D, 0xC76C61,
+            0xC36F64, 0xBF7167, 0xBC746B, 0xB8766E, 0xB47871, 0xB07B74,
+            0xAC7D77, 0xA87F7A, 0xA3817D, 0x9F8380, 0x9A8583, 0x968786,
+            0x918889, 0x8C8A8C
+        },
+        {
+            0xFF0000, 0xF81C23, 0xF02934, 0xE93241, 0xE1394C, 0xDA3E56,
+            0xD3435E, 0xCB4667, 0xC44A6F, 0xBD4C76, 0xB54E7D, 0xAE5084,
+            0xA6518B, 0x9F5292, 0x975398, 0x90539F, 0x8853A5, 0x8152AB,
+            0x7951B1, 0x7250B7, 0x6A4FBD, 0x624DC3, 0x5B4AC9, 0x5348CF,
+            0x4A44D5, 0x4240DB, 0x3A3CE1, 0x3136E7, 0x272FED, 0x1D26F2,
+            0x111AF8, 0x0000FE
+        }
+    },
+    {
+        {
+            0xCE9AFF, 0xD098F8, 0xD295F2, 0xD493EB, 0xD791E5, 0xD98EDE,
+            0xDA8CD7, 0xDC89D1, 0xDE86CA, 0xE084C4, 0xE281BD, 0xE47EB6,
+            0xE57BB0, 0xE778A9, 0xE975A2, 0xEA719C, 0xEC6E95, 0xED6A8E,
+            0xEF6787, 0xF06380, 0xF25F79, 0xF35A72, 0xF4566B, 0xF65163,
+            0xF74C5B, 0xF84653, 0xF9404B, 0xFB3941, 0xFC3137, 0xFD272B,
+            0xFE191C, 0xFF0000
+        },
+        {
+            0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF,
+            0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF,
+            0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF,
+            0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF,
+            0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF, 0xCE9AFF,
+            0xCE9AFF, 0xCE9AFF
+        },
+        {
+            0xCE9AFF, 0xCF9EFB, 0xD0A2F7, 0xD2A6F3, 0xD3AAEE, 0xD4AEEA,
+            0xD6B1E6, 0xD7B5E1, 0xD8B9DD, 0xDABCD8, 0xDBBFD3, 0xDDC3CF,
+            0xDEC6CA, 0xE0C9C5, 0xE1CDBF, 0xE3D0BA, 0xE5D3B4, 0xE6D6AF,
+            0xE8D9A9, 0xEADCA2, 0xEBDF9C, 0xEDE295, 0xEFE58E, 0xF0E886,
+            0xF2EB7E, 0xF4EE75, 0xF6F16B, 0xF8F461, 0xF9F754, 0xFBF945,
+            0xFDFC30, 0xFFFF00
+        },
+        {
+            0xCE9AFF, 0xCA98FC, 0xC797F8, 0xC495F5, 0xC093F1, 0xBD91EE,
+            0xB990EB, 0xB68EE7, 0xB28CE4, 0xAF8AE0, 0xAB89DD, 0xA887DA,
+            0xA485D6, 0xA184D3, 0x9E82D0, 0x9A80CC, 0x977EC9, 0x947DC6,
+            0x907BC3, 0x8D79BF, 0x8978BC, 0x8676B9, 0x8374B6, 0x7F73B2,
+            0x7C71AF, 0x796FAC, 0x756DA9, 0x726CA6, 0x6F6AA2, 0x6C689F,
+            0x68679C, 0x656599
+        },
+        {
+            0xCE9AFF, 0xCF9DFF, 0xD0A1FF, 0xD0A4FF, 0xD1A7FF, 0xD2AAFF,
+            0xD3AEFF, 0xD3B1FF, 0xD4B4FF, 0xD5B7FF, 0xD6BAFF, 0xD6BDFF,
+            0xD7C1FF, 0xD8C4FF, 0xD9C7FF, 0xD9CAFF, 0xDACDFF, 0xDBD0FF,
+            0xDBD3FF, 0xDCD6FF, 0xDDD9FF, 0xDDDCFF, 0xDEE0FF, 0xDEE3FF,
+            0xDFE6FF, 0xE0E9FF, 0xE0ECFF, 0xE1EFFF, 0xE1F2FF, 0xE2F5FF,
+            0xE2F8FF, 0xE3FBFF
+        },
+        {
+            0xCE9AFF, 0xCD97F7, 0xCD94F0, 0xCC91E8, 0xCB8DE1, 0xCA8AD9,
+            0xC987D2, 0xC884CA, 0xC880C3, 0xC77DBC, 0xC67AB4, 0xC576AD,
+            0xC473A6, 0xC36F9E, 0xC26C97, 0xC16890, 0xC06589, 0xBE6181,
+            0xBD5D7A, 0xBC5973, 0xBB556B, 0xBA5164, 0xB84D5C, 0xB74955,
+            0xB6454D, 0xB54045, 0xB33B3D, 0xB23635, 0xB0312C, 0xAF2B21,
+            0xAD2414, 0xAC1C00
+        },
+        {
+            0xCE9AFF, 0xCB9CFF, 0xC89EFF, 0xC4A0FF, 0xC1A2FF, 0xBEA4FF,
+            0xBAA5FF, 0xB7A7FF, 0xB3A9FF, 0xB0ABFF, 0xACACFF, 0xA8AEFF,
+            0xA4B0FF, 0xA0B1FF, 0x9CB3FF, 0x98B5FF, 0x93B6FF, 0x8EB8FF,
+            0x8AB9FF, 0x85BBFF, 0x7FBCFF, 0x7ABEFF, 0x74BFFF, 0x6DC1FF,
+            0x67C2FF, 0x5FC4FF, 0x57C5FF, 0x4EC7FF, 0x44C8FF, 0x37C9FF,
+            0x26CBFF, 0x00CCFF
+        },
+        {
+            0xCE9AFF, 0xD099F9, 0xD198F3, 0xD397ED, 0xD596E7, 0xD795E0,
+            0xD894DA, 0xDA93D4, 0xDC92CE, 0xDD91C8, 0xDF90C2, 0xE18EBB,
+            0xE28DB5, 0xE48BAF, 0xE58AA8, 0xE788A2, 0xE9879B, 0xEA8595,
+            0xEC838E, 0xED8187, 0xEF7F80, 0xF07D79, 0xF27B72, 0xF3796A,
+            0xF57762, 0xF6755A, 0xF87251, 0xF97048, 0xFB6D3D, 0xFC6B31,
+            0xFE6820, 0xFF6500
+        },
+        {
+            0xCE9AFF, 0xD097FF, 0xD295FF, 0xD492FF, 0xD68FFF, 0xD88DFF,
+            0xDA8AFF, 0xDC87FF, 0xDD84FF, 0xDF81FF, 0xE17EFF, 0xE37BFF,
+            0xE478FF, 0xE675FF, 0xE871FF, 0xE96EFF, 0xEB6BFF, 0xEC67FF,
+            0xEE63FF, 0xEF5FFF, 0xF15BFF, 0xF257FF, 0xF352FF, 0xF54EFF,
+            0xF648FF, 0xF743FF, 0xF93DFF, 0xFA36FF, 0xFB2EFF, 0xFD25FF,
+            0xFE18FF, 0xFF00FF
+        },
+        {
+            0xCE9AFF, 0xCB9DFA, 0xC79FF5, 0xC4A2EF, 0xC0A4EA, 0xBDA6E5,
+            0xB9A9DF, 0xB5ABDA, 0xB2ADD5, 0xAEAFCF, 0xAAB1CA, 0xA6B2C4,
+            0xA2B4BF, 0x9EB6B9, 0x9AB7B3, 0x96B9AE, 0x91BBA8, 0x8DBCA2,
+            0x89BD9C, 0x84BF96, 0x7FC090, 0x7AC189, 0x75C383, 0x70C47C,
+            0x6AC575, 0x64C66D, 0x5EC766, 0x57C85E, 0x50C955, 0x47CA4B,
+            0x3ECB40, 0x33CC33
+        },
+        {
+            0xCE9AFF, 0xCC9AFB, 0xCA99F7, 0xC799F4, 0xC599F0, 0xC398EC,
+            0xC198E8, 0xBF97E5, 0xBD97E1, 0xBA97DD, 0xB896DA, 0xB696D6,
+            0xB495D2, 0xB295CE, 0xB094CB, 0xAD94C7, 0xAB93C3, 0xA993C0,
+            0xA792BC, 0xA592B8, 0xA391B5, 0xA190B1, 0x9F90AD, 0x9D8FAA,
+            0x9A8FA6, 0x988EA2, 0x968D9E, 0x948D9B, 0x928C97, 0x908B93,
+            0x8E8B90, 0x8C8A8C
+        },
+        {
+            0xCE9AFF, 0xC797FF, 0xC195FF, 0xBA92FF, 0xB48FFF, 0xAD8DFF,
+            0xA78AFF, 0xA187FF, 0x9A84FF, 0x9481FF, 0x8D7EFF, 0x877BFF,
+            0x8177FF, 0x7A74FF, 0x7471FF, 0x6E6DFF, 0x676AFF, 0x6166FF,
+            0x5B62FF, 0x545EFF, 0x4E5AFF, 0x4855FF, 0x4151FF, 0x3B4CFF,
+            0x3447FF, 0x2E41FF, 0x273BFF, 0x2034FF, 0x192DFF, 0x1123FF,
+            0x0817FE, 0x0000FE
+        }
+    },
+    {
+        {
+            0xFFFF00, 0xFFF900, 0xFFF300, 0xFFED00, 0xFFE700, 0xFFE100,
+            0xFFDB00, 0xFFD500, 0xFFCF00, 0xFFC900, 0xFFC300, 0xFFBD00,
+            0xFFB600, 0xFFB000, 0xFFAA00, 0xFFA300, 0xFF9D00, 0xFF9600,
+            0xFF9000, 0xFF8900, 0xFF8200, 0xFF7B00, 0xFF7400, 0xFF6C00,
+            0xFF6400, 0xFF5C00, 0xFF5300, 0xFF4900, 0xFF3E00, 0xFF3200,
+            0xFF2100, 0xFF0000
+        },
+        {
+            0xFFFF00, 0xFDFC30, 0xFBF945, 0xF9F754, 0xF8F461, 0xF6F16B,
+            0xF4EE75, 0xF2EB7E, 0xF0E886, 0xEFE58E, 0xEDE295, 0xEBDF9C,
+            0xEADCA2, 0xE8D9A9, 0xE6D6AF, 0xE5D3B4, 0xE3D0BA, 0xE1CDBF,
+            0xE0C9C5, 0xDEC6CA, 0xDDC3CF, 0xDBBFD3, 0xDABCD8, 0xD8B9DD,
+            0xD7B5E1, 0xD6B1E6, 0xD4AEEA, 0xD3AAEE, 0xD2A6F3, 0xD0A2F7,
+            0xCF9EFB, 0xCE9AFF
+        },
+        {
+            0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00,
+            0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00,
+            0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00,
+            0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00,
+            0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00, 0xFFFF00,
+            0xFFFF00, 0xFFFF00
+        },
+        {
+            0xFFFF00, 0xF9FA26, 0xF4F537, 0xEEF043, 0xE9EB4D, 0xE4E655,
+            0xDEE15C, 0xD9DC62, 0xD3D767, 0xCED26C, 0xC9CE70, 0xC4C974,
+            0xBEC478, 0xB9BF7C, 0xB4BA7F, 0xAFB581, 0xAAB084, 0xA5AB87,
+            0xA0A689, 0x9BA18B, 0x969C8D, 0x92978E, 0x8D9390, 0x888E91,
+            0x838993, 0x7F8494, 0x7A7F95, 0x767A96, 0x727597, 0x6D6F98,
+            0x696A98, 0x656599
+        },
+        {
+            0xFFFF00, 0xFEFF2A, 0xFDFF3D, 0xFCFF4B, 0xFBFF56, 0xFAFF61,
+            0xF9FF6A, 0xF8FF73, 0xF7FF7B, 0xF6FF83, 0xF5FF8A, 0xF4FF91,
+            0xF3FF97, 0xF2FF9E, 0xF1FFA4, 0xF1FFAA, 0xF0FFB0, 0xEFFFB6,
+            0xEEFEBC, 0xEDFEC1, 0xECFEC7, 0xEBFECC, 0xEAFED2, 0xE9FDD7,
+            0xE9FDDC, 0xE8FDE1, 0xE7FDE6, 0xE6FCEB, 0xE5FCF0, 0xE5FCF5,
+            0xE4FBFA, 0xE3FBFF
+        },
+        {
+            0xFFFF00, 0xFDF800, 0xFCF100, 0xFAEA00, 0xF8E300, 0xF6DC00,
+            0xF4D600, 0xF2CF00, 0xF0C800, 0xEDC100, 0xEBBA00, 0xE9B300,
+            0xE6AD00, 0xE4A600, 0xE19F00, 0xDF9800, 0xDC9100, 0xD98B00,
+            0xD68400, 0xD37D00, 0xD07600, 0xCD6F00, 0xCA6800, 0xC76100,
+            0xC45A00, 0xC15200, 0xBE4B00, 0xBA4300, 0xB73B00, 0xB33200,
+            0xB02800, 0xAC1C00
+        },
+        {
+            0xFFFF00, 0xF9FE2F, 0xF4FD43, 0xEEFC52, 0xE9FA5F, 0xE3F96A,
+            0xDDF873, 0xD7F67C, 0xD1F584, 0xCCF48C, 0xC6F293, 0xC0F19A,
+            0xBAEFA1, 0xB4EEA7, 0xADECAD, 0xA7EBB3, 0xA1E9B8, 0x9AE8BE,
+            0x94E6C3, 0x8DE4C8, 0x86E2CD, 0x7FE1D2, 0x78DFD7, 0x70DDDC,
+            0x68DBE0, 0x60D9E5, 0x57D7EA, 0x4DD5EE, 0x42D3F2, 0x35D0F7,
+            0x23CEFB, 0x00CCFF
+        },
+        {
+            0xFFFF00, 0xFFFA00, 0xFFF600, 0xFFF100, 0xFFEC00, 0xFFE800,
+            0xFFE300, 0xFFDE00, 0xFFDA00, 0xFFD500, 0xFFD000, 0xFFCC00,
+            0xFFC700, 0xFFC200, 0xFFBD00, 0xFFB900, 0xFFB400, 0xFFAF00,
+            0xFFAA00, 0xFFA500, 0xFFA000, 0xFF9B00, 0xFF9600, 0xFF9100,
+            0xFF8C00, 0xFF8700, 0xFF8100, 0xFF7C00, 0xFF7600, 0xFF7100,
+            0xFF6B00, 0xFF6500
+        },
+        {
+            0xFFFF00, 0xFFFA33, 0xFFF548, 0xFFF058, 0xFFEB65, 0xFFE670,
+            0xFFE17A, 0xFFDC83, 0xFFD78C, 0xFFD193, 0xFFCC9A, 0xFFC6A1,
+            0xFFC1A8, 0xFFBBAE, 0xFFB6B3, 0xFFB0B9, 0xFFAABE, 0xFFA4C4,
+            0xFF9EC9, 0xFF97CD, 0xFF90D2, 0xFF89D7, 0xFF82DB, 0xFF7BE0,
+            0xFF73E4, 0xFF6AE8, 0xFF61EC, 0xFF56F0, 0xFF4BF4, 0xFF3CF8,
+            0xFF29FB, 0xFF00FF
+        },
+        {
+            0xFFFF00, 0xFAFD06, 0xF4FC0B, 0xEFFA0F, 0xEAF913, 0xE4F716,
+            0xDFF618, 0xDAF41B, 0xD4F21D, 0xCFF11F, 0xC9EF20, 0xC4EE22,
+            0xBEEC24, 0xB8EA25, 0xB3E926, 0xADE727, 0xA7E629, 0xA1E42A,
+            0x9BE22B, 0x95E12B, 0x8FDF2C, 0x88DD2D, 0x82DC2E, 0x7BDA2F,
+            0x74D82F, 0x6DD630, 0x65D531, 0x5DD331, 0x54D132, 0x4BD032,
+            0x40CE33, 0x33CC33
+        },
+        {
+            0xFFFF00, 0xFBFB1F, 0xF7F72E, 0xF3F438, 0xEFF041, 0xEBEC48,
+            0xE7E84E, 0xE3E454, 0xE0E059, 0xDCDD5D, 0xD8D961, 0xD4D565,
+            0xD0D169, 0xCCCE6C, 0xC9CA6F, 0xC5C672, 0xC1C274, 0xBEBE77,
+            0xBABB79, 0xB6B77B, 0xB3B37D, 0xAFAF7F, 0xABAC81, 0xA8A882,
+            0xA4A484, 0xA1A185, 0x9D9D87, 0x9A9988, 0x969589, 0x93928A,
+            0x8F8E8B, 0x8C8A8C
+        },
+        {
+            0xFFFF00, 0xF5FA3A, 0xECF552, 0xE2F063, 0xD9EB71, 0xCFE67C,
+            0xC5E087, 0xBCDB90, 0xB2D698, 0xA9D0A0, 0xA0CBA7, 0x96C5AE,
+            0x8DC0B4, 0x83BAB9, 0x7AB4BF, 0x70AEC4, 0x67A8C9, 0x5DA2CE,
+            0x549CD2, 0x4A95D6, 0x408EDA, 0x3687DE, 0x2C80E2, 0x2078E5,
+            0x1370E9, 0x0268EC, 0x005EEF, 0x0054F3, 0x0048F6, 0x003AF8,
+            0x0028FB, 0x0000FE
+        }
+    },
+    {
+        {
+            0x656599, 0x6B6596, 0x716593, 0x766490, 0x7C648D, 0x81638A,
+            0x876387, 0x8C6284, 0x916181, 0x96607E, 0x9B5F7A, 0xA05E77,
+            0xA55D74, 0xAA5B70, 0xAF5A6D, 0xB45869, 0xB95666, 0xBE5462,
+            0xC2525E, 0xC7505A, 0xCC4D56, 0xD14A52, 0xD5474D, 0xDA4449,
+            0xDF4044, 0xE33C3E, 0xE83738, 0xED3132, 0xF12B2A, 0xF62221,
+            0xFA1615, 0xFF0000
+        },
+        {
+            0x656599, 0x68679C, 0x6C689F, 0x6F6AA2, 0x726CA6, 0x756DA9,
+            0x796FAC, 0x7C71AF, 0x7F73B2, 0x8374B6, 0x8676B9, 0x8978BC,
+            0x8D79BF, 0x907BC3, 0x947DC6, 0x977EC9, 0x9A80CC, 0x9E82D0,
+            0xA184D3, 0xA485D6, 0xA887DA, 0xAB89DD, 0xAF8AE0, 0xB28CE4,
+            0xB68EE7, 0xB990EB, 0xBD91EE, 0xC093F1, 0xC495F5, 0xC797F8,
+            0xCA98FC, 0xCE9AFF
+        },
+        {
+            0x656599, 0x696A98, 0x6D6F98, 0x727597, 0x767A96, 0x7A7F95,
+            0x7F8494, 0x838993, 0x888E91, 0x8D9390, 0x92978E, 0x969C8D,
+            0x9BA18B, 0xA0A689, 0xA5AB87, 0xAAB084, 0xAFB581, 0xB4BA7F,
+            0xB9BF7C, 0xBEC478, 0xC4C974, 0xC9CE70, 0xCED26C, 0xD3D767,
+            0xD9DC62, 0xDEE15C, 0xE4E655, 0xE9EB4D, 0xEEF043, 0xF4F537,
+            0xF9FA26, 0xFFFF00
+        },
+        {
+            0x656599, 0x656599, 0x656599, 0x656599, 0x656599, 0x656599,
+            0x656599, 0x656599, 0x656599, 0x656599, 0x656599, 0x656599,
+            0x656599, 0x656599, 0x656599, 0x656599, 0x656599, 0x656599,
+            0x656599, 0x656599, 0x656599, 0x656599, 0x656599, 0x656599,
+            0x656599, 0x656599, 0x656599, 0x656599, 0x656599, 0x656599,
+            0x656599, 0x656599
+        },
+        {
+            0x656599, 0x696A9C, 0x6C6EA0, 0x7073A3, 0x7477A6, 0x787CA9,
+            0x7C81AD, 0x7F85B0, 0x838AB3, 0x878FB7, 0x8B93BA, 0x8F98BD,
+            0x939DC0, 0x97A2C4, 0x9BA6C7, 0x9FABCA, 0xA3B0CE, 0xA7B5D1,
+            0xACBAD4, 0xB0BFD7, 0xB4C4DB, 0xB8C9DE, 0xBCCEE1, 0xC0D3E5,
+            0xC5D8E8, 0xC9DDEB, 0xCDE2EE, 0xD2E7F2, 0xD6ECF5, 0xDAF1F8,
+            0xDFF6FC, 0xE3FBFF
+        },
+        {
+            0x656599, 0x686495, 0x6B6391, 0x6E628E, 0x71608A, 0x745F86,
+            0x765E82, 0x795C7E, 0x7C5B7A, 0x7E5977, 0x815873, 0x83566F,
+            0x86556B, 0x885367, 0x8A5163, 0x8C4F5F, 0x8F4D5B, 0x914B57,
+            0x934953, 0x95474E, 0x97454A, 0x994246, 0x9B3F41, 0x9D3D3C,
+            0x9F3A38, 0xA13732, 0xA3332D, 0xA53027, 0xA72C20, 0xA82719,
+            0xAA220F, 0xAC1C00
+        },
+        {
+            0x656599, 0x65689C, 0x656B9F, 0x646FA2, 0x6472A6, 0x6375A9,
+            0x6378AC, 0x627CAF, 0x617FB2, 0x6082B6, 0x5F86B9, 0x5E89BC,
+            0x5D8CBF, 0x5C8FC3, 0x5A93C6, 0x5996C9, 0x5799CC, 0x559DD0,
+            0x53A0D3, 0x51A3D6, 0x4EA7DA, 0x4CAADD, 0x48ADE0, 0x45B1E4,
+            0x41B4E7, 0x3DB8EB, 0x38BBEE, 0x32BEF1, 0x2CC2F5, 0x23C5F8,
+            0x17C9FC, 0x00CCFF
+        },
+        {
+            0x656599, 0x6A6697, 0x706794, 0x756892, 0x7A698F, 0x7F698C,
+            0x846A8A, 0x896B87, 0x8E6B84, 0x936C81, 0x986C7F, 0x9D6C7C,
+            0xA26D79, 0xA76D75, 0xAC6D72, 0xB16D6F, 0xB66D6B, 0xBB6D68,
+            0xBF6D64, 0xC46D60, 0xC96D5C, 0xCE6C58, 0xD36C54, 0xD86C4F,
+            0xDD6B4A, 0xE26B44, 0xE76A3E, 0xEB6937, 0xF0682F, 0xF56726,
+            0xFA6619, 0xFF6500
+        },
+        {
+            0x656599, 0x6B659C, 0x70649F, 0x7664A3, 0x7B63A6, 0x8062A9,
+            0x8661AC, 0x8B61AF, 0x9060B3, 0x955FB6, 0x9A5DB9, 0x9F5CBC,
+            0xA45BC0, 0xA959C3, 0xAE58C6, 0xB356C9, 0xB754CD, 0xBC52D0,
+            0xC150D3, 0xC64ED7, 0xCB4BDA, 0xCF49DD, 0xD446E1, 0xD942E4,
+            0xDE3EE7, 0xE33AEB, 0xE735EE, 0xEC30F1, 0xF129F5, 0xF621F8,
+            0xFA16FC, 0xFF00FF
+        },
+        {
+            0x656599, 0x656997, 0x646C96, 0x637094, 0x637492, 0x627790,
+            0x627B8E, 0x617E8C, 0x60828A, 0x5F8588, 0x5E8886, 0x5D8C84,
+            0x5C8F81, 0x5B927F, 0x5A967D, 0x59997A, 0x579C77, 0x56A074,
+            0x55A372, 0x53A66E, 0x51A96B, 0x4FAC68, 0x4DB064, 0x4BB360,
+            0x49B65C, 0x47B958, 0x44BC53, 0x41BF4E, 0x3EC349, 0x3BC642,
+            0x37C93B, 0x33CC33
+        },
+        {
+            0x656599, 0x666699, 0x676798, 0x696998, 0x6A6A98, 0x6B6B97,
+            0x6C6C97, 0x6D6E97, 0x6F6F96, 0x707096, 0x717196, 0x727395,
+            0x737495, 0x757594, 0x767694, 0x777794, 0x797893, 0x7A7A93,
+            0x7B7B92, 0x7C7C92, 0x7E7D91, 0x7F7E91, 0x808091, 0x818190,
+            0x838290, 0x84838F, 0x85848F, 0x87858E, 0x88878E, 0x89888D,
+            0x8B898D, 0x8C8A8C
+        },
+        {
+            0x656599, 0x62649C, 0x5F63A0, 0x5C62A3, 0x5861A7, 0x5560AA,
+            0x525FAD, 0x4F5EB1, 0x4C5DB4, 0x485BB7, 0x455ABB, 0x4258BE,
+            0x3E57C1, 0x3B55C4, 0x3853C8, 0x3451CB, 0x314FCE, 0x2E4DD1,
+            0x2A4BD5, 0x2748D8, 0x2346DB, 0x2043DE, 0x1C40E1, 0x183CE5,
+            0x1539E8, 0x1135EB, 0x0D30EE, 0x092BF1, 0x0525F4, 0x031DF8,
+            0x0112FB, 0x0000FE
+        }
+    },
+    {
+        {
+            0xE3FBFF, 0xE6F5F8, 0xE9F0F1, 0xECEAEA, 0xEEE4E3, 0xF1DFDC,
+            0xF3D9D5, 0xF5D3CE, 0xF6CEC7, 0xF8C8BF, 0xFAC2B8, 0xFBBCB1,
+            0xFCB6AA, 0xFDB0A3, 0xFEAA9C, 0xFFA495, 0xFF9D8E, 0xFF9787,
+            0xFF9080, 0xFF8A79, 0xFF8372, 0xFF7C6B, 0xFF7563, 0xFF6D5C,
+            0xFF6654, 0xFF5D4C, 0xFF5444, 0xFF4B3B, 0xFF4031, 0xFF3326,
+            0xFF2218, 0xFF0000
+        },
+        {
+            0xE3FBFF, 0xE2F8FF, 0xE2F5FF, 0xE1F2FF, 0xE1EFFF, 0xE0ECFF,
+            0xE0E9FF, 0xDFE6FF, 0xDEE3FF, 0xDEE0FF, 0xDDDCFF, 0xDDD9FF,
+            0xDCD6FF, 0xDBD3FF, 0xDBD0FF, 0xDACDFF, 0xD9CAFF, 0xD9C7FF,
+            0xD8C4FF, 0xD7C1FF, 0xD6BDFF, 0xD6BAFF, 0xD5B7FF, 0xD4B4FF,
+            0xD3B1FF, 0xD3AEFF, 0xD2AAFF, 0xD1A7FF, 0xD0A4FF, 0xD0A1FF,
+            0xCF9DFF, 0xCE9AFF
+        },
+        {
+            0xE3FBFF, 0xE4FBFA, 0xE5FCF5, 0xE5FCF0, 0xE6FCEB, 0xE7FDE6,
+            0xE8FDE1, 0xE9FDDC, 0xE9FDD7, 0xEAFED2, 0xEBFECC, 0xECFEC7,
+            0xEDFEC1, 0xEEFEBC, 0xEFFFB6, 0xF0FFB0, 0xF1FFAA, 0xF1FFA4,
+            0xF2FF9E, 0xF3FF97, 0xF4FF91, 0xF5FF8A, 0xF6FF83, 0xF7FF7B,
+            0xF8FF73, 0xF9FF6A, 0xFAFF61, 0xFBFF56, 0xFCFF4B, 0xFDFF3D,
+            0xFEFF2A, 0xFFFF00
+        },
+        {
+            0xE3FBFF, 0xDFF6FC, 0xDAF1F8, 0xD6ECF5, 0xD2E7F2, 0xCDE2EE,
+            0xC9DDEB, 0xC5D8E8, 0xC0D3E5, 0xBCCEE1, 0xB8C9DE, 0xB4C4DB,
+            0xB0BFD7, 0xACBAD4, 0xA7B5D1, 0xA3B0CE, 0x9FABCA, 0x9BA6C7,
+            0x97A2C4, 0x939DC0, 0x8F98BD, 0x8B93BA, 0x878FB7, 0x838AB3,
+            0x7F85B0, 0x7C81AD, 0x787CA9, 0x7477A6, 0x7073A3, 0x6C6EA0,
+            0x696A9C, 0x656599
+        },
+        {
+            0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF,
+            0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF,
+            0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF,
+            0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF,
+            0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF, 0xE3FBFF,
+            0xE3FBFF, 0xE3FBFF
+        },
+        {
+            0xE3FBFF, 0xE3F4F7, 0xE2EEEF, 0xE2E7E7, 0xE1E0DF, 0xE0DAD7,
+            0xDFD3D0, 0xDFCDC8, 0xDDC6C0, 0xDCBFB8, 0xDBB9B1, 0xDAB2A9,
+            0xD8ACA2, 0xD7A59A, 0xD59F93, 0xD3988B, 0xD29184, 0xD08B7C,
+            0xCE8475, 0xCC7D6D, 0xC97766, 0xC7705E, 0xC56957, 0xC2624F,
+            0xC05B47, 0xBD5340, 0xBB4C38, 0xB8442F, 0xB53B27, 0xB2321D,
+            0xAF2811, 0xAC1C00
+        },
+        {
+            0xE3FBFF, 0xDEFAFF, 0xDAF8FF, 0xD5F7FF, 0xD0F5FF, 0xCBF4FF,
+            0xC6F3FF, 0xC1F1FF, 0xBCF0FF, 0xB7EEFF, 0xB2EDFF, 0xADEBFF,
+            0xA8EAFF, 0xA3E8FF, 0x9DE7FF, 0x98E5FF, 0x92E4FF, 0x8DE2FF,
+            0x87E1FF, 0x81DFFF, 0x7BDEFF, 0x75DCFF, 0x6EDAFF, 0x67D9FF,
+            0x60D7FF, 0x59D6FF, 0x50D4FF, 0x47D3FF, 0x3DD1FF, 0x31CFFF,
+            0x21CEFF, 0x00CCFF
+        },
+        {
+            0xE3FBFF, 0xE5F7F8, 0xE7F2F2, 0xEAEEEB, 0xEBEAE4, 0xEDE5DE,
+            0xEFE1D7, 0xF1DDD0, 0xF2D8CA, 0xF3D4C3, 0xF5CFBC, 0xF6CBB6,
+            0xF7C6AF, 0xF8C2A8, 0xF9BDA2, 0xFAB99B, 0xFBB494, 0xFCAF8D,
+            0xFCAA86, 0xFDA67F, 0xFDA178, 0xFE9C71, 0xFE976A, 0xFF9262,
+            0xFF8D5A, 0xFF8752, 0xFF824A, 0xFF7D40, 0xFF7736, 0xFF712B,
+            0xFF6B1C, 0xFF6500
+        },
+        {
+            0xE3FBFF, 0xE5F6FF, 0xE8F0FF, 0xEAEBFF, 0xECE6FF, 0xEEE0FF,
+            0xEFDBFF, 0xF1D6FF, 0xF3D0FF, 0xF4CAFF, 0xF5C5FF, 0xF7BFFF,
+            0xF8B9FF, 0xF9B4FF, 0xFAAEFF, 0xFBA8FF, 0xFBA2FF, 0xFC9CFF,
+            0xFD95FF, 0xFD8FFF, 0xFE88FF, 0xFE81FF, 0xFF7AFF, 0xFF72FF,
+            0xFF6BFF, 0xFF62FF, 0xFF59FF, 0xFF4FFF, 0xFF44FF, 0xFF37FF,
+            0xFF25FF, 0xFF00FF
+        },
+        {
+            0xE3FBFF, 0xDEFAF9, 0xDAF8F3, 0xD5F7EE, 0xD0F6E8, 0xCBF4E2,
+            0xC6F3DC, 0xC2F2D6, 0xBDF0D0, 0xB8EFCA, 0xB3EEC5, 0xAEECBF,
+            0xA9EBB9, 0xA4E9B3, 0x9FE8AD, 0x9AE6A7, 0x95E5A1, 0x90E39B,
+            0x8AE294, 0x85E08E, 0x7FDE88, 0x7ADD81, 0x74DB7B, 0x6EDA74,
+            0x68D86D, 0x62D666, 0x5BD55F, 0x55D358, 0x4DD150, 0x45CF47,
+            0x3DCE3E, 0x33CC33
+        },
+        {
+            0xE3FBFF, 0xE0F7FB, 0xDDF3F7, 0xDAF0F3, 0xD7ECEF, 0xD5E8EC,
+            0xD2E4E8, 0xCFE0E4, 0xCCDDE0, 0xC9D9DC, 0xC6D5D9, 0xC3D2D5,
+            0xC1CED1, 0xBECACD, 0xBBC6CA, 0xB8C3C6, 0xB5BFC2, 0xB3BCBE,
+            0xB0B8BB, 0xADB4B7, 0xAAB1B3, 0xA7ADB0, 0xA5AAAC, 0xA2A6A8,
+            0x9FA2A5, 0x9C9FA1, 0x9A9B9E, 0x97989A, 0x949497, 0x919193,
+            0x8F8D90, 0x8C8A8C
+        },
+        {
+            0xE3FBFF, 0xDBF5FF, 0xD2F0FF, 0xCAEAFF, 0xC1E4FF, 0xB9DFFF,
+            0xB1D9FF, 0xA8D3FF, 0xA0CDFF, 0x98C7FF, 0x90C1FF, 0x88BBFF,
+            0x7FB5FF, 0x77AFFF, 0x6FA9FF, 0x67A3FF, 0x5F9DFF, 0x5796FF,
+            0x4F90FF, 0x4789FF, 0x3F82FF, 0x377BFF, 0x2F74FF, 0x266CFF,
+            0x1D65FF, 0x145CFF, 0x0A53FF, 0x014AFF, 0x003FFF, 0x0032FF,
+            0x0022FF, 0x0000FE
+        }
+    },
+    {
+        {
+            0xAC1C00, 0xAF1C00, 0xB11C00, 0xB41B00, 0xB61B00, 0xB91B00,
+            0xBC1A00, 0xBE1A00, 0xC11A00, 0xC31900, 0xC61900, 0xC91800,
+            0xCB1800, 0xCE1700, 0xD11700, 0xD31600, 0xD61500, 0xD91400,
+            0xDB1400, 0xDE1300, 0xE11200, 0xE41100, 0xE61000, 0xE90E00,
+            0xEC0D00, 0xEE0C00, 0xF10A00, 0xF40800, 0xF70600, 0xF90400,
+            0xFC0200, 0xFF0000
+        },
+        {
+            0xAC1C00, 0xAD2414, 0xAF2B21, 0xB0312C, 0xB23635, 0xB33B3D,
+            0xB54045, 0xB6454D, 0xB74955, 0xB84D5C, 0xBA5164, 0xBB556B,
+            0xBC5973, 0xBD5D7A, 0xBE6181, 0xC06589, 0xC16890, 0xC26C97,
+            0xC36F9E, 0xC473A6, 0xC576AD, 0xC67AB4, 0xC77DBC, 0xC880C3,
+            0xC884CA, 0xC987D2, 0xCA8AD9, 0xCB8DE1, 0xCC91E8, 0xCD94F0,
+            0xCD97F7, 0xCE9AFF
+        },
+        {
+            0xAC1C00, 0xB02800, 0xB33200, 0xB73B00, 0xBA4300, 0xBE4B00,
+            0xC15200, 0xC45A00, 0xC76100, 0xCA6800, 0xCD6F00, 0xD07600,
+            0xD37D00, 0xD68400, 0xD98B00, 0xDC9100, 0xDF9800, 0xE19F00,
+            0xE4A600, 0xE6AD00, 0xE9B300, 0xEBBA00, 0xEDC100, 0xF0C800,
+            0xF2CF00, 0xF4D600, 0xF6DC00, 0xF8E300, 0xFAEA00, 0xFCF100,
+            0xFDF800, 0xFFFF00
+        },
+        {
+            0xAC1C00, 0xAA220F, 0xA82719, 0xA72C20, 0xA53027, 0xA3332D,
+            0xA13732, 0x9F3A38, 0x9D3D3C, 0x9B3F41, 0x994246, 0x97454A,
+            0x95474E, 0x934953, 0x914B57, 0x8F4D5B, 0x8C4F5F, 0x8A5163,
+            0x885367, 0x86556B, 0x83566F, 0x815873, 0x7E5977, 0x7C5B7A,
+            0x795C7E, 0x765E82, 0x745F86, 0x71608A, 0x6E628E, 0x6B6391,
+            0x686495, 0x656599
+        },
+        {
+            0xAC1C00, 0xAF2811, 0xB2321D, 0xB53B27, 0xB8442F, 0xBB4C38,
+            0xBD5340, 0xC05B47, 0xC2624F, 0xC56957, 0xC7705E, 0xC97766,
+            0xCC7D6D, 0xCE8475, 0xD08B7C, 0xD29184, 0xD3988B, 0xD59F93,
+            0xD7A59A, 0xD8ACA2, 0xDAB2A9, 0xDBB9B1, 0xDCBFB8, 0xDDC6C0,
+            0xDFCDC8, 0xDFD3D0, 0xE0DAD7, 0xE1E0DF, 0xE2E7E7, 0xE2EEEF,
+            0xE3F4F7, 0xE3FBFF
+        },
+        {
+            0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00,
+            0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00,
+            0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00,
+            0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00,
+            0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00, 0xAC1C00,
+            0xAC1C00, 0xAC1C00
+        },
+        {
+            0xAC1C00, 0xAC2814, 0xAB3220, 0xAB3B2B, 0xAA4234, 0xA9493C,
+            0xA85044, 0xA7564C, 0xA55C54, 0xA4625C, 0xA26863, 0xA16D6A,
+            0x9F7272, 0x9C7879, 0x9A7D80, 0x988288, 0x95878F, 0x928C96,
+            0x8E909E, 0x8A95A5, 0x869AAC, 0x829FB4, 0x7DA3BB, 0x77A8C3,
+            0x71ACCA, 0x6AB1D2, 0x63B6D9, 0x59BAE1, 0x4FBFE8, 0x41C3F0,
+            0x2DC8F7, 0x00CCFF
+        },
+        {
+            0xAC1C00, 0xAF1F00, 0xB12200, 0xB42400, 0xB62700, 0xB92A00,
+            0xBC2C00, 0xBE2F00, 0xC13100, 0xC43400, 0xC63600, 0xC93800,
+            0xCC3B00, 0xCE3D00, 0xD13F00, 0xD44100, 0xD64400, 0xD94600,
+            0xDC4800, 0xDE4A00, 0xE14D00, 0xE44F00, 0xE65100, 0xE95300,
+            0xEC5600, 0xEF5800, 0xF15A00, 0xF45C00, 0xF75E00, 0xFA6100,
+            0xFC6300, 0xFF6500
+        },
+        {
+            0xAC1C00, 0xAE1E16, 0xB12023, 0xB3222E, 0xB62437, 0xB82540,
+            0xBB2748, 0xBD2850, 0xC02958, 0xC22A5F, 0xC52B67, 0xC72B6E,
+            0xCA2C75, 0xCD2C7C, 0xCF2D84, 0xD22D8B, 0xD52D92, 0xD72D99,
+            0xDA2CA0, 0xDD2CA8, 0xDF2BAF, 0xE22AB6, 0xE529BD, 0xE827C4,
+            0xEB25CC, 0xEE23D3, 0xF020DA, 0xF31DE2, 0xF619E9, 0xF913F0,
+            0xFC0BF8, 0xFF00FF
+        },
+        {
+            0xAC1C00, 0xAC2801, 0xAB3103, 0xAA3A04, 0xAA4106, 0xA94808,
+            0xA84E0A, 0xA7540C, 0xA65A0E, 0xA4600F, 0xA36611, 0xA16B13,
+            0x9F7015, 0x9D7616, 0x9B7B18, 0x99801A, 0x96851B, 0x938A1D,
+            0x908F1F, 0x8D9320, 0x899822, 0x859D23, 0x81A225, 0x7CA726,
+            0x77AB28, 0x71B02A, 0x6AB52B, 0x63B92D, 0x5ABE2E, 0x50C330,
+            0x44C731, 0x33CC33
+        },
+        {
+            0xAC1C00, 0xAC230B, 0xAB2914, 0xAB2F1B, 0xAA3420, 0xAA3926,
+            0xA93D2B, 0xA9412F, 0xA84534, 0xA84938, 0xA74C3C, 0xA65041,
+            0xA55345, 0xA55649, 0xA45A4C, 0xA35D50, 0xA26054, 0xA16358,
+            0xA0665C, 0x9F6960, 0x9D6C63, 0x9C6F67, 0x9B726B, 0x9A746E,
+            0x987772, 0x977A76, 0x957D7A, 0x937F7D, 0x928281, 0x908585,
+            0x8E8788, 0x8C8A8C
+        },
+        {
+            0xAC1C00, 0xA8241A, 0xA32A28, 0x9F2F33, 0x9A343D, 0x963746,
+            0x913A4E, 0x8D3D56, 0x883F5E, 0x834165, 0x7F436D, 0x7A4474,
+            0x75457B, 0x704682, 0x6C4689, 0x674690, 0x624697, 0x5D469E,
+            0x5845A5, 0x5245AB, 0x4D43B2, 0x4842B9, 0x4240C0, 0x3D3EC7,
+            0x373BCE, 0x3138D5, 0x2B34DB, 0x242FE2, 0x1D29E9, 0x1521F0,
+            0x0B16F7, 0x0000FE
+        }
+    },
+    {
+        {
+            0x00CCFF, 0x37C9F8, 0x4EC5F2, 0x5EC2EB, 0x6CBFE4, 0x77BBDE,
+            0x82B8D7, 0x8BB4D0, 0x93B0CA, 0x9BACC3, 0xA2A9BC, 0xA9A5B6,
+            0xAFA1AF, 0xB59CA8, 0xBB98A1, 0xC0949B, 0xC68F94, 0xCA8A8D,
+            0xCF8586, 0xD4807F, 0xD87B78, 0xDC7571, 0xE06F69, 0xE46962,
+            0xE8635A, 0xEB5B52, 0xEF5349, 0xF24B40, 0xF64036, 0xF9342B,
+            0xFC231C, 0xFF0000
+        },
+        {
+            0x00CCFF, 0x26CBFF, 0x37C9FF, 0x44C8FF, 0x4EC7FF, 0x57C5FF,
+            0x5FC4FF, 0x67C2FF, 0x6DC1FF, 0x74BFFF, 0x7ABEFF, 0x7FBCFF,
+            0x85BBFF, 0x8AB9FF, 0x8EB8FF, 0x93B6FF, 0x98B5FF, 0x9CB3FF,
+            0xA0B1FF, 0xA4B0FF, 0xA8AEFF, 0xACACFF, 0xB0ABFF, 0xB3A9FF,
+            0xB7A7FF, 0xBAA5FF, 0xBEA4FF, 0xC1A2FF, 0xC4A0FF, 0xC89EFF,
+            0xCB9CFF, 0xCE9AFF
+        },
+        {
+            0x00CCFF, 0x23CEFB, 0x35D0F7, 0x42D3F2, 0x4DD5EE, 0x57D7EA,
+            0x60D9E5, 0x68DBE0, 0x70DDDC, 0x78DFD7, 0x7FE1D2, 0x86E2CD,
+            0x8DE4C8, 0x94E6C3, 0x9AE8BE, 0xA1E9B8, 0xA7EBB3, 0xADECAD,
+            0xB4EEA7, 0xBAEFA1, 0xC0F19A, 0xC6F293, 0xCCF48C, 0xD1F584,
+            0xD7F67C, 0xDDF873, 0xE3F96A, 0xE9FA5F, 0xEEFC52, 0xF4FD43,
+            0xF9FE2F, 0xFFFF00
+        },
+        {
+            0x00CCFF, 0x17C9FC, 0x23C5F8, 0x2CC2F5, 0x32BEF1, 0x38BBEE,
+            0x3DB8EB, 0x41B4E7, 0x45B1E4, 0x48ADE0, 0x4CAADD, 0x4EA7DA,
+            0x51A3D6, 0x53A0D3, 0x559DD0, 0x5799CC, 0x5996C9, 0x5A93C6,
+            0x5C8FC3, 0x5D8CBF, 0x5E89BC, 0x5F86B9, 0x6082B6, 0x617FB2,
+            0x627CAF, 0x6378AC, 0x6375A9, 0x6472A6, 0x646FA2, 0x656B9F,
+            0x65689C, 0x656599
+        },
+        {
+            0x00CCFF, 0x21CEFF, 0x31CFFF, 0x3DD1FF, 0x47D3FF, 0x50D4FF,
+            0x59D6FF, 0x60D7FF, 0x67D9FF, 0x6EDAFF, 0x75DCFF, 0x7BDEFF,
+            0x81DFFF, 0x87E1FF, 0x8DE2FF, 0x92E4FF, 0x98E5FF, 0x9DE7FF,
+            0xA3E8FF, 0xA8EAFF, 0xADEBFF, 0xB2EDFF, 0xB7EEFF, 0xBCF0FF,
+            0xC1F1FF, 0xC6F3FF, 0xCBF4FF, 0xD0F5FF, 0xD5F7FF, 0xDAF8FF,
+            0xDEFAFF, 0xE3FBFF
+        },
+        {
+            0x00CCFF, 0x2DC8F7, 0x41C3F0, 0x4FBFE8, 0x59BAE1, 0x63B6D9,
+            0x6AB1D2, 0x71ACCA, 0x77A8C3, 0x7DA3BB, 0x829FB4, 0x869AAC,
+            0x8A95A5, 0x8E909E, 0x928C96, 0x95878F, 0x988288, 0x9A7D80,
+            0x9C7879, 0x9F7272, 0xA16D6A, 0xA26863, 0xA4625C, 0xA55C54,
+            0xA7564C, 0xA85044, 0xA9493C, 0xAA4234, 0xAB3B2B, 0xAB3220,
+            0xAC2814, 0xAC1C00
+        },
+        {
+            0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF,
+            0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF,
+            0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF,
+            0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF,
+            0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF, 0x00CCFF,
+            0x00CCFF, 0x00CCFF
+        },
+        {
+            0x00CCFF, 0x32CAF9, 0x48C8F3, 0x58C6EC, 0x65C3E6, 0x70C1E0,
+            0x7ABFDA, 0x83BCD4, 0x8BBACD, 0x93B7C7, 0x9AB5C1, 0xA1B2BA,
+            0xA7AFB4, 0xADADAE, 0xB3AAA7, 0xB9A7A1, 0xBEA49A, 0xC4A193,
+            0xC99D8D, 0xCE9A86, 0xD2977F, 0xD79378, 0xDB8F70, 0xE08B69,
+            0xE48761, 0xE88359, 0xEC7F50, 0xF07A47, 0xF4753C, 0xF87030,
+            0xFB6B20, 0xFF6500
+        },
+        {
+            0x00CCFF, 0x34C9FF, 0x4BC5FF, 0x5BC2FF, 0x68BEFF, 0x73BBFF,
+            0x7DB7FF, 0x86B4FF, 0x8FB0FF, 0x96ACFF, 0x9EA8FF, 0xA4A4FF,
+            0xABA0FF, 0xB19CFF, 0xB798FF, 0xBC93FF, 0xC18FFF, 0xC78AFF,
+            0xCB85FF, 0xD080FF, 0xD57BFF, 0xD975FF, 0xDD6FFF, 0xE269FF,
+            0xE663FF, 0xE95BFF, 0xED53FF, 0xF14BFF, 0xF541FF, 0xF834FF,
+            0xFC23FF, 0xFF00FF
+        },
+        {
+            0x00CCFF, 0x00CCFA, 0x00CDF4, 0x00CDEF, 0x00CDEA, 0x00CEE4,
+            0x00CEDF, 0x00CED9, 0x00CED4, 0x00CFCE, 0x00CFC9, 0x02CFC3,
+            0x05CFBE, 0x08CFB8, 0x0BCFB2, 0x0ECFAD, 0x11CFA7, 0x13CFA1,
+            0x16CF9B, 0x19CF95, 0x1BCF8E, 0x1DCE88, 0x20CE81, 0x22CE7B,
+            0x24CE74, 0x27CE6C, 0x29CD65, 0x2BCD5D, 0x2DCD54, 0x2FCD4A,
+            0x31CC40, 0x33CC33
+        },
+        {
+            0x00CCFF, 0x1CCAFB, 0x2AC8F7, 0x34C6F4, 0x3CC4F0, 0x43C2EC,
+            0x49C0E8, 0x4EBEE5, 0x53BBE1, 0x57B9DD, 0x5BB7D9, 0x5FB5D6,
+            0x63B3D2, 0x66B1CE, 0x69AFCA, 0x6CADC7, 0x6FABC3, 0x72A9BF,
+            0x74A6BC, 0x77A4B8, 0x79A2B4, 0x7BA0B1, 0x7D9EAD, 0x7F9CA9,
+            0x8199A6, 0x8397A2, 0x84959E, 0x86939B, 0x889197, 0x898E93,
+            0x8B8C90, 0x8C8A8C
+        },
+        {
+            0x00CCFF, 0x00C8FF, 0x00C3FF, 0x00BFFF, 0x00BAFF, 0x00B6FF,
+            0x00B1FF, 0x00ADFF, 0x00A8FF, 0x00A3FF, 0x009FFF, 0x009AFF,
+            0x0095FF, 0x0091FF, 0x008CFF, 0x0087FF, 0x0082FF, 0x007CFF,
+            0x0077FF, 0x0072FF, 0x006CFF, 0x0067FF, 0x0061FF, 0x005BFF,
+            0x0054FF, 0x004DFF, 0x0046FF, 0x003EFF, 0x0035FF, 0x002AFF,
+            0x001BFE, 0x0000FE
+        }
+    },
+    {
+        {
+            0xFF6500, 0xFF6300, 0xFF6100, 0xFF5F00, 0xFF5E00, 0xFF5C00,
+            0xFF5A00, 0xFF5800, 0xFF5600, 0xFF5400, 0xFF5200, 0xFF4F00,
+            0xFF4D00, 0xFF4B00, 0xFF4900, 0xFF4600, 0xFF4400, 0xFF4100,
+            0xFF3F00, 0xFF3C00, 0xFF3900, 0xFF3600, 0xFF3300, 0xFF3000,
+            0xFF2D00, 0xFF2900, 0xFF2500, 0xFF2000, 0xFF1B00, 0xFF1400,
+            0xFF0C00, 0xFF0000
+        },
+        {
+            0xFF6500, 0xFE6820, 0xFC6B31, 0xFB6D3D, 0xF97048, 0xF87251,
+            0xF6755A, 0xF57762, 0xF3796A, 0xF27B72, 0xF07D79, 0xEF7F80,
+            0xED8187, 0xEC838E, 0xEA8595, 0xE9879B, 0xE788A2, 0xE58AA8,
+            0xE48BAF, 0xE28DB5, 0xE18EBB, 0xDF90C2, 0xDD91C8, 0xDC92CE,
+            0xDA93D4, 0xD894DA, 0xD795E0, 0xD596E7, 0xD397ED, 0xD198F3,
+            0xD099F9, 0xCE9AFF
+        },
+        {
+            0xFF6500, 0xFF6B00, 0xFF7100, 0xFF7600, 0xFF7C00, 0xFF8100,
+            0xFF8700, 0xFF8C00, 0xFF9100, 0xFF9600, 0xFF9B00, 0xFFA000,
+            0xFFA500, 0xFFAA00, 0xFFAF00, 0xFFB400, 0xFFB900, 0xFFBD00,
+            0xFFC200, 0xFFC700, 0xFFCC00, 0xFFD000, 0xFFD500, 0xFFDA00,
+            0xFFDE00, 0xFFE300, 0xFFE800, 0xFFEC00, 0xFFF100, 0xFFF600,
+            0xFFFA00, 0xFFFF00
+        },
+        {
+            0xFF6500, 0xFA6619, 0xF56726, 0xF0682F, 0xEB6937, 0xE76A3E,
+            0xE26B44, 0xDD6B4A, 0xD86C4F, 0xD36C54, 0xCE6C58, 0xC96D5C,
+            0xC46D60, 0xBF6D64, 0xBB6D68, 0xB66D6B, 0xB16D6F, 0xAC6D72,
+            0xA76D75, 0xA26D79, 0x9D6C7C, 0x986C7F, 0x936C81, 0x8E6B84,
+            0x896B87, 0x846A8A, 0x7F698C, 0x7A698F, 0x756892, 0x706794,
+            0x6A6697, 0x656599
+        },
+        {
+            0xFF6500, 0xFF6B1C, 0xFF712B, 0xFF7736, 0xFF7D40, 0xFF824A,
+            0xFF8752, 0xFF8D5A, 0xFF9262, 0xFE976A, 0xFE9C71, 0xFDA178,
+            0xFDA67F, 0xFCAA86, 0xFCAF8D, 0xFBB494, 0xFAB99B, 0xF9BDA2,
+            0xF8C2A8, 0xF7C6AF, 0xF6CBB6, 0xF5CFBC, 0xF3D4C3, 0xF2D8CA,
+            0xF1DDD0, 0xEFE1D7, 0xEDE5DE, 0xEBEAE4, 0xEAEEEB, 0xE7F2F2,
+            0xE5F7F8, 0xE3FBFF
+        },
+        {
+            0xFF6500, 0xFC6300, 0xFA6100, 0xF75E00, 0xF45C00, 0xF15A00,
+            0xEF5800, 0xEC5600, 0xE95300, 0xE65100, 0xE44F00, 0xE14D00,
+            0xDE4A00, 0xDC4800, 0xD94600, 0xD64400, 0xD44100, 0xD13F00,
+            0xCE3D00, 0xCC3B00, 0xC93800, 0xC63600, 0xC43400, 0xC13100,
+            0xBE2F00, 0xBC2C00, 0xB92A00, 0xB62700, 0xB42400, 0xB12200,
+            0xAF1F00, 0xAC1C00
+        },
+        {
+            0xFF6500, 0xFB6B20, 0xF87030, 0xF4753C, 0xF07A47, 0xEC7F50,
+            0xE88359, 0xE48761, 0xE08B69, 0xDB8F70, 0xD79378, 0xD2977F,
+            0xCE9A86, 0xC99D8D, 0xC4A193, 0xBEA49A, 0xB9A7A1, 0xB3AAA7,
+            0xADADAE, 0xA7AFB4, 0xA1B2BA, 0x9AB5C1, 0x93B7C7, 0x8BBACD,
+            0x83BCD4, 0x7ABFDA, 0x70C1E0, 0x65C3E6, 0x58C6EC, 0x48C8F3,
+            0x32CAF9, 0x00CCFF
+        },
+        {
+            0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500,
+            0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500,
+            0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500,
+            0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500,
+            0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500, 0xFF6500,
+            0xFF6500, 0xFF6500
+        },
+        {
+            0xFF6500, 0xFF6522, 0xFF6433, 0xFE6440, 0xFE634B, 0xFE6255,
+            0xFE625E, 0xFE6166, 0xFD606E, 0xFD5F76, 0xFD5E7D, 0xFD5D84,
+            0xFD5B8B, 0xFD5A91, 0xFD5898, 0xFD579F, 0xFD55A5, 0xFD53AB,
+            0xFD51B1, 0xFD4FB8, 0xFD4CBE, 0xFD49C4, 0xFD46CA, 0xFD43D0,
+            0xFD3FD6, 0xFE3BDC, 0xFE36E2, 0xFE31E8, 0xFE2AED, 0xFE22F3,
+            0xFF16F9, 0xFF00FF
+        },
+        {
+            0xFF6500, 0xFB6A03, 0xF86F06, 0xF47408, 0xF0790B, 0xEC7D0E,
+            0xE88110, 0xE48512, 0xE08914, 0xDC8D16, 0xD79018, 0xD3941A,
+            0xCE971B, 0xCA9B1D, 0xC59E1E, 0xC0A120, 0xBBA421, 0xB5A722,
+            0xB0AA24, 0xAAAD25, 0xA4B026, 0x9EB328, 0x97B529, 0x90B82A,
+            0x88BB2B, 0x80BD2C, 0x77C02D, 0x6EC22F, 0x63C530, 0x56C731,
+            0x47CA32, 0x33CC33
+        },
+        {
+            0xFF6500, 0xFC6714, 0xF8691F, 0xF56B28, 0xF16D2F, 0xEE6F35,
+            0xEB713A, 0xE7723F, 0xE47444, 0xE07548, 0xDD774C, 0xD97850,
+            0xD67A54, 0xD27B58, 0xCE7C5B, 0xCB7D5F, 0xC77E62, 0xC37F65,
+            0xC08068, 0xBC816B, 0xB8826E, 0xB58371, 0xB18474, 0xAD8577,
+            0xA9867A, 0xA5867C, 0xA1877F, 0x9D8882, 0x998884, 0x958987,
+            0x908989, 0x8C8A8C
+        },
+        {
+            0xFF6500, 0xF76728, 0xEF693A, 0xE76A48, 0xE06B53, 0xD86C5E,
+            0xD06D67, 0xC86D6F, 0xC06E77, 0xB96E7F, 0xB16D86, 0xA96D8D,
+            0xA16C93, 0x996B9A, 0x926AA0, 0x8A69A6, 0x8267AC, 0x7A65B2,
+            0x7263B8, 0x6A60BE, 0x625EC3, 0x5B5AC9, 0x5257CE, 0x4A53D4,
+            0x424FD9, 0x3A4ADF, 0x3144E4, 0x293DE9, 0x2035EE, 0x162BF4,
+            0x0B1DF9, 0x0000FE
+        }
+    },
+    {
+        {
+            0xFF00FF, 0xFF0CF9, 0xFF14F2, 0xFE1AEC, 0xFE1EE5, 0xFE21DF,
+            0xFE24D9, 0xFE26D2, 0xFE28CC, 0xFE29C6, 0xFE2BBF, 0xFE2CB9,
+            0xFE2CB2, 0xFD2DAC, 0xFD2DA5, 0xFD2D9E, 0xFD2D98, 0xFE2C91,
+            0xFE2B8A, 0xFE2B83, 0xFE2A7C, 0xFE2875, 0xFE276E, 0xFE2566,
+            0xFE235F, 0xFE2056, 0xFE1E4E, 0xFE1A44, 0xFF163A, 0xFF112E,
+            0xFF091E, 0xFF0000
+        },
+        {
+            0xFF00FF, 0xFE18FF, 0xFD25FF, 0xFB2EFF, 0xFA36FF, 0xF93DFF,
+            0xF743FF, 0xF648FF, 0xF54EFF, 0xF352FF, 0xF257FF, 0xF15BFF,
+            0xEF5FFF, 0xEE63FF, 0xEC67FF, 0xEB6BFF, 0xE96EFF, 0xE871FF,
+            0xE675FF, 0xE478FF, 0xE37BFF, 0xE17EFF, 0xDF81FF, 0xDD84FF,
+            0xDC87FF, 0xDA8AFF, 0xD88DFF, 0xD68FFF, 0xD492FF, 0xD295FF,
+            0xD097FF, 0xCE9AFF
+        },
+        {
+            0xFF00FF, 0xFF29FB, 0xFF3CF8, 0xFF4BF4, 0xFF56F0, 0xFF61EC,
+            0xFF6AE8, 0xFF73E4, 0xFF7BE0, 0xFF82DB, 0xFF89D7, 0xFF90D2,
+            0xFF97CD, 0xFF9EC9, 0xFFA4C4, 0xFFAABE, 0xFFB0B9, 0xFFB6B3,
+            0xFFBBAE, 0xFFC1A8, 0xFFC6A1, 0xFFCC9A, 0xFFD193, 0xFFD78C,
+            0xFFDC83, 0xFFE17A, 0xFFE670, 0xFFEB65, 0xFFF058, 0xFFF548,
+            0xFFFA33, 0xFFFF00
+        },
+        {
+            0xFF00FF, 0xFA16FC, 0xF621F8, 0xF129F5, 0xEC30F1, 0xE735EE,
+            0xE33AEB, 0xDE3EE7, 0xD942E4, 0xD446E1, 0xCF49DD, 0xCB4BDA,
+            0xC64ED7, 0xC150D3, 0xBC52D0, 0xB754CD, 0xB356C9, 0xAE58C6,
+            0xA959C3, 0xA45BC0, 0x9F5CBC, 0x9A5DB9, 0x955FB6, 0x9060B3,
+            0x8B61AF, 0x8661AC, 0x8062A9, 0x7B63A6, 0x7664A3, 0x70649F,
+            0x6B659C, 0x656599
+        },
+        {
+            0xFF00FF, 0xFF25FF, 0xFF37FF, 0xFF44FF, 0xFF4FFF, 0xFF59FF,
+            0xFF62FF, 0xFF6BFF, 0xFF72FF, 0xFF7AFF, 0xFE81FF, 0xFE88FF,
+            0xFD8FFF, 0xFD95FF, 0xFC9CFF, 0xFBA2FF, 0xFBA8FF, 0xFAAEFF,
+            0xF9B4FF, 0xF8B9FF, 0xF7BFFF, 0xF5C5FF, 0xF4CAFF, 0xF3D0FF,
+            0xF1D6FF, 0xEFDBFF, 0xEEE0FF, 0xECE6FF, 0xEAEBFF, 0xE8F0FF,
+            0xE5F6FF, 0xE3FBFF
+        },
+        {
+            0xFF00FF, 0xFC0BF8, 0xF913F0, 0xF619E9, 0xF31DE2, 0xF020DA,
+            0xEE23D3, 0xEB25CC, 0xE827C4, 0xE529BD, 0xE22AB6, 0xDF2BAF,
+            0xDD2CA8, 0xDA2CA0, 0xD72D99, 0xD52D92, 0xD22D8B, 0xCF2D84,
+            0xCD2C7C, 0xCA2C75, 0xC72B6E, 0xC52B67, 0xC22A5F, 0xC02958,
+            0xBD2850, 0xBB2748, 0xB82540, 0xB62437, 0xB3222E, 0xB12023,
+            0xAE1E16, 0xAC1C00
+        },
+        {
+            0xFF00FF, 0xFC23FF, 0xF834FF, 0xF541FF, 0xF14BFF, 0xED53FF,
+            0xE95BFF, 0xE663FF, 0xE269FF, 0xDD6FFF, 0xD975FF, 0xD57BFF,
+            0xD080FF, 0xCB85FF, 0xC78AFF, 0xC18FFF, 0xBC93FF, 0xB798FF,
+            0xB19CFF, 0xABA0FF, 0xA4A4FF, 0x9EA8FF, 0x96ACFF, 0x8FB0FF,
+            0x86B4FF, 0x7DB7FF, 0x73BBFF, 0x68BEFF, 0x5BC2FF, 0x4BC5FF,
+            0x34C9FF, 0x00CCFF
+        },
+        {
+            0xFF00FF, 0xFF16F9, 0xFE22F3, 0xFE2AED, 0xFE31E8, 0xFE36E2,
+            0xFE3BDC, 0xFD3FD6, 0xFD43D0, 0xFD46CA, 0xFD49C4, 0xFD4CBE,
+            0xFD4FB8, 0xFD51B1, 0xFD53AB, 0xFD55A5, 0xFD579F, 0xFD5898,
+            0xFD5A91, 0xFD5B8B, 0xFD5D84, 0xFD5E7D, 0xFD5F76, 0xFD606E,
+            0xFE6166, 0xFE625E, 0xFE6255, 0xFE634B, 0xFE6440, 0xFF6433,
+            0xFF6522, 0xFF6500
+        },
+        {
+            0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF,
+            0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF,
+            0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF,
+            0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF,
+            0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF, 0xFF00FF,
+            0xFF00FF, 0xFF00FF
+        },
+        {
+            0xFF00FF, 0xFB29FA, 0xF73BF5, 0xF348F0, 0xEF53EB, 0xEB5CE6,
+            0xE764E1, 0xE36CDC, 0xDF72D7, 0xDA79D1, 0xD67ECC, 0xD184C7,
+            0xCD89C1, 0xC88EBC, 0xC392B6, 0xBE97B1, 0xB99BAB, 0xB39FA5,
+            0xAEA39F, 0xA8A799, 0xA2AB93, 0x9BAE8D, 0x95B186, 0x8EB57F,
+            0x86B878, 0x7EBB71, 0x76BE69, 0x6CC161, 0x61C457, 0x55C74D,
+            0x47C941, 0x33CC33
+        },
+        {
+            0xFF00FF, 0xFC1BFB, 0xF829F8, 0xF533F4, 0xF13BF0, 0xEE42ED,
+            0xEB47E9, 0xE74DE5, 0xE452E2, 0xE056DE, 0xDD5ADB, 0xD95ED7,
+            0xD661D3, 0xD265D0, 0xCF68CC, 0xCB6BC8, 0xC76DC5, 0xC470C1,
+            0xC072BD, 0xBC75B9, 0xB977B6, 0xB579B2, 0xB17BAE, 0xAD7DAB,
+            0xA97FA7, 0xA581A3, 0xA1829F, 0x9D849B, 0x998698, 0x958794,
+            0x908990, 0x8C8A8C
+        },
+        {
+            0xFF00FF, 0xF811FF, 0xF11BFF, 0xE922FF, 0xE227FF, 0xDB2BFF,
+            0xD42EFF, 0xCD31FF, 0xC533FF, 0xBE34FF, 0xB736FF, 0xB037FF,
+            0xA937FF, 0xA238FF, 0x9B38FF, 0x9338FF, 0x8C37FF, 0x8537FF,
+            0x7E36FF, 0x7735FF, 0x6F34FF, 0x6832FF, 0x6030FF, 0x592EFF,
+            0x512BFF, 0x4928FF, 0x4125FF, 0x3821FF, 0x2E1CFF, 0x2316FE,
+            0x160DFE, 0x0000FE
+        }
+    },
+    {
+        {
+            0x33CC33, 0x4AC832, 0x5BC531, 0x68C12F, 0x74BE2E, 0x7EBA2D,
+            0x87B62B, 0x8FB32A, 0x97AF29, 0x9EAB27, 0xA5A726, 0xABA325,
+            0xB19E23, 0xB79A22, 0xBC9621, 0xC1911F, 0xC68D1E, 0xCB881C,
+            0xCF831B, 0xD47E19, 0xD87917, 0xDC7316, 0xE06D14, 0xE46712,
+            0xE86010, 0xEB590E, 0xEF510C, 0xF24909, 0xF63F07, 0xF93305,
+            0xFC2202, 0xFF0000
+        },
+        {
+            0x33CC33, 0x3ECB40, 0x47CA4B, 0x50C955, 0x57C85E, 0x5EC766,
+            0x64C66D, 0x6AC575, 0x70C47C, 0x75C383, 0x7AC189, 0x7FC090,
+            0x84BF96, 0x89BD9C, 0x8DBCA2, 0x91BBA8, 0x96B9AE, 0x9AB7B3,
+            0x9EB6B9, 0xA2B4BF, 0xA6B2C4, 0xAAB1CA, 0xAEAFCF, 0xB2ADD5,
+            0xB5ABDA, 0xB9A9DF, 0xBDA6E5, 0xC0A4EA, 0xC4A2EF, 0xC79FF5,
+            0xCB9DFA, 0xCE9AFF
+        },
+        {
+            0x33CC33, 0x40CE33, 0x4BD032, 0x54D132, 0x5DD331, 0x65D531,
+            0x6DD630, 0x74D82F, 0x7BDA2F, 0x82DC2E, 0x88DD2D, 0x8FDF2C,
+            0x95E12B, 0x9BE22B, 0xA1E42A, 0xA7E629, 0xADE727, 0xB3E926,
+            0xB8EA25, 0xBEEC24, 0xC4EE22, 0xC9EF20, 0xCFF11F, 0xD4F21D,
+            0xDAF41B, 0xDFF618, 0xE4F716, 0xEAF913, 0xEFFA0F, 0xF4FC0B,
+            0xFAFD06, 0xFFFF00
+        },
+        {
+            0x33CC33, 0x37C93B, 0x3BC642, 0x3EC349, 0x41BF4E, 0x44BC53,
+            0x47B958, 0x49B65C, 0x4BB360, 0x4DB064, 0x4FAC68, 0x51A96B,
+            0x53A66E, 0x55A372, 0x56A074, 0x579C77, 0x59997A, 0x5A967D,
+            0x5B927F, 0x5C8F81, 0x5D8C84, 0x5E8886, 0x5F8588, 0x60828A,
+            0x617E8C, 0x627B8E, 0x627790, 0x637492, 0x637094, 0x646C96,
+            0x656997, 0x656599
+        },
+        {
+            0x33CC33, 0x3DCE3E, 0x45CF47, 0x4DD150, 0x55D358, 0x5BD55F,
+            0x62D666, 0x68D86D, 0x6EDA74, 0x74DB7B, 0x7ADD81, 0x7FDE88,
+            0x85E08E, 0x8AE294, 0x90E39B, 0x95E5A1, 0x9AE6A7, 0x9FE8AD,
+            0xA4E9B3, 0xA9EBB9, 0xAEECBF, 0xB3EEC5, 0xB8EFCA, 0xBDF0D0,
+            0xC2F2D6, 0xC6F3DC, 0xCBF4E2, 0xD0F6E8, 0xD5F7EE, 0xDAF8F3,
+            0xDEFAF9, 0xE3FBFF
+        },
+        {
+            0x33CC33, 0x44C731, 0x50C330, 0x5ABE2E, 0x63B92D, 0x6AB52B,
+            0x71B02A, 0x77AB28, 0x7CA726, 0x81A225, 0x859D23, 0x899822,
+            0x8D9320, 0x908F1F, 0x938A1D, 0x96851B, 0x99801A, 0x9B7B18,
+            0x9D7616, 0x9F7015, 0xA16B13, 0xA36611, 0xA4600F, 0xA65A0E,
+            0xA7540C, 0xA84E0A, 0xA94808, 0xAA4106, 0xAA3A04, 0xAB3103,
+            0xAC2801, 0xAC1C00
+        },
+        {
+            0x33CC33, 0x31CC40, 0x2FCD4A, 0x2DCD54, 0x2BCD5D, 0x29CD65,
+            0x27CE6C, 0x24CE74, 0x22CE7B, 0x20CE81, 0x1DCE88, 0x1BCF8E,
+            0x19CF95, 0x16CF9B, 0x13CFA1, 0x11CFA7, 0x0ECFAD, 0x0BCFB2,
+            0x08CFB8, 0x05CFBE, 0x02CFC3, 0x00CFC9, 0x00CFCE, 0x00CED4,
+            0x00CED9, 0x00CEDF, 0x00CEE4, 0x00CDEA, 0x00CDEF, 0x00CDF4,
+            0x00CCFA, 0x00CCFF
+        },
+        {
+            0x33CC33, 0x47CA32, 0x56C731, 0x63C530, 0x6EC22F, 0x77C02D,
+            0x80BD2C, 0x88BB2B, 0x90B82A, 0x97B529, 0x9EB328, 0xA4B026,
+            0xAAAD25, 0xB0AA24, 0xB5A722, 0xBBA421, 0xC0A120, 0xC59E1E,
+            0xCA9B1D, 0xCE971B, 0xD3941A, 0xD79018, 0xDC8D16, 0xE08914,
+            0xE48512, 0xE88110, 0xEC7D0E, 0xF0790B, 0xF47408, 0xF86F06,
+            0xFB6A03, 0xFF6500
+        },
+        {
+            0x33CC33, 0x47C941, 0x55C74D, 0x61C457, 0x6CC161, 0x76BE69,
+            0x7EBB71, 0x86B878, 0x8EB57F, 0x95B186, 0x9BAE8D, 0xA2AB93,
+            0xA8A799, 0xAEA39F, 0xB39FA5, 0xB99BAB, 0xBE97B1, 0xC392B6,
+            0xC88EBC, 0xCD89C1, 0xD184C7, 0xD67ECC, 0xDA79D1, 0xDF72D7,
+            0xE36CDC, 0xE764E1, 0xEB5CE6, 0xEF53EB, 0xF348F0, 0xF73BF5,
+            0xFB29FA, 0xFF00FF
+        },
+        {
+            0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33,
+            0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33,
+            0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33,
+            0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33,
+            0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33, 0x33CC33,
+            0x33CC33, 0x33CC33
+        },
+        {
+            0x33CC33, 0x3ACA39, 0x40C83E, 0x46C643, 0x4AC447, 0x4FC24B,
+            0x53C04F, 0x57BE53, 0x5BBC56, 0x5EBA5A, 0x61B85D, 0x64B660,
+            0x67B463, 0x6AB265, 0x6CAF68, 0x6FAD6B, 0x71AB6D, 0x74A970,
+            0x76A772, 0x78A574, 0x7AA376, 0x7CA179, 0x7E9E7B, 0x7F9C7D,
+            0x819A7F, 0x839881, 0x859583, 0x869385, 0x889187, 0x898F88,
+            0x8B8C8A, 0x8C8A8C
+        },
+        {
+            0x33CC33, 0x29C945, 0x1EC552, 0x0CC25E, 0x00BE68, 0x00BA71,
+            0x00B779, 0x00B381, 0x00AF88, 0x00AB8F, 0x00A796, 0x00A39C,
+            0x009FA2, 0x009BA8, 0x0097AE, 0x0092B3, 0x008EB9, 0x0089BE,
+            0x0084C3, 0x007FC8, 0x007ACD, 0x0074D1, 0x006ED6, 0x0068DB,
+            0x0062DF, 0x005AE4, 0x0053E8, 0x004AED, 0x0040F1, 0x0034F5,
+            0x0023FA, 0x0000FE
+        }
+    },
+    {
+        {
+            0x8C8A8C, 0x918889, 0x968786, 0x9A8583, 0x9F8380, 0xA3817D,
+            0xA87F7A, 0xAC7D77, 0xB07B74, 0xB47871, 0xB8766E, 0xBC746B,
+            0xBF7167, 0xC36F64, 0xC76C61, 0xCA695D, 0xCE665A, 0xD26356,
+            0xD56053, 0xD85D4F, 0xDC594B, 0xDF5547, 0xE35143, 0xE64D3E,
+            0xE9483A, 0xEC4335, 0xEF3D30, 0xF3372A, 0xF62F23, 0xF9261B,
+            0xFC1911, 0xFF0000
+        },
+        {
+            0x8C8A8C, 0x8E8B90, 0x908B93, 0x928C97, 0x948D9B, 0x968D9E,
+            0x988EA2, 0x9A8FA6, 0x9D8FAA, 0x9F90AD, 0xA190B1, 0xA391B5,
+            0xA592B8, 0xA792BC, 0xA993C0, 0xAB93C3, 0xAD94C7, 0xB094CB,
+            0xB295CE, 0xB495D2, 0xB696D6, 0xB896DA, 0xBA97DD, 0xBD97E1,
+            0xBF97E5, 0xC198E8, 0xC398EC, 0xC599F0, 0xC799F4, 0xCA99F7,
+            0xCC9AFB, 0xCE9AFF
+        },
+        {
+            0x8C8A8C, 0x8F8E8B, 0x93928A, 0x969589, 0x9A9988, 0x9D9D87,
+            0xA1A185, 0xA4A484, 0xA8A882, 0xABAC81, 0xAFAF7F, 0xB3B37D,
+            0xB6B77B, 0xBABB79, 0xBEBE77, 0xC1C274, 0xC5C672, 0xC9CA6F,
+            0xCCCE6C, 0xD0D169, 0xD4D565, 0xD8D961, 0xDCDD5D, 0xE0E059,
+            0xE3E454, 0xE7E84E, 0xEBEC48, 0xEFF041, 0xF3F438, 0xF7F72E,
+            0xFBFB1F, 0xFFFF00
+        },
+        {
+            0x8C8A8C, 0x8B898D, 0x89888D, 0x88878E, 0x87858E, 0x85848F,
+            0x84838F, 0x838290, 0x818190, 0x808091, 0x7F7E91, 0x7E7D91,
+            0x7C7C92, 0x7B7B92, 0x7A7A93, 0x797893, 0x777794, 0x767694,
+            0x757594, 0x737495, 0x727395, 0x717196, 0x707096, 0x6F6F96,
+            0x6D6E97, 0x6C6C97, 0x6B6B97, 0x6A6A98, 0x696998, 0x676798,
+            0x666699, 0x656599
+        },
+        {
+            0x8C8A8C, 0x8F8D90, 0x919193, 0x949497, 0x97989A, 0x9A9B9E,
+            0x9C9FA1, 0x9FA2A5, 0xA2A6A8, 0xA5AAAC, 0xA7ADB0, 0xAAB1B3,
+            0xADB4B7, 0xB0B8BB, 0xB3BCBE, 0xB5BFC2, 0xB8C3C6, 0xBBC6CA,
+            0xBECACD, 0xC1CED1, 0xC3D2D5, 0xC6D5D9, 0xC9D9DC, 0xCCDDE0,
+            0xCFE0E4, 0xD2E4E8, 0xD5E8EC, 0xD7ECEF, 0xDAF0F3, 0xDDF3F7,
+            0xE0F7FB, 0xE3FBFF
+        },
+        {
+            0x8C8A8C, 0x8E8788, 0x908585, 0x928281, 0x937F7D, 0x957D7A,
+            0x977A76, 0x987772, 0x9A746E, 0x9B726B, 0x9C6F67, 0x9D6C63,
+            0x9F6960, 0xA0665C, 0xA16358, 0xA26054, 0xA35D50, 0xA45A4C,
+            0xA55649, 0xA55345, 0xA65041, 0xA74C3C, 0xA84938, 0xA84534,
+            0xA9412F, 0xA93D2B, 0xAA3926, 0xAA3420, 0xAB2F1B, 0xAB2914,
+            0xAC230B, 0xAC1C00
+        },
+        {
+            0x8C8A8C, 0x8B8C90, 0x898E93, 0x889197, 0x86939B, 0x84959E,
+            0x8397A2, 0x8199A6, 0x7F9CA9, 0x7D9EAD, 0x7BA0B1, 0x79A2B4,
+            0x77A4B8, 0x74A6BC, 0x72A9BF, 0x6FABC3, 0x6CADC7, 0x69AFCA,
+            0x66B1CE, 0x63B3D2, 0x5FB5D6, 0x5BB7D9, 0x57B9DD, 0x53BBE1,
+            0x4EBEE5, 0x49C0E8, 0x43C2EC, 0x3CC4F0, 0x34C6F4, 0x2AC8F7,
+            0x1CCAFB, 0x00CCFF
+        },
+        {
+            0x8C8A8C, 0x908989, 0x958987, 0x998884, 0x9D8882, 0xA1877F,
+            0xA5867C, 0xA9867A, 0xAD8577, 0xB18474, 0xB58371, 0xB8826E,
+            0xBC816B, 0xC08068, 0xC37F65, 0xC77E62, 0xCB7D5F, 0xCE7C5B,
+            0xD27B58, 0xD67A54, 0xD97850, 0xDD774C, 0xE07548, 0xE47444,
+            0xE7723F, 0xEB713A, 0xEE6F35, 0xF16D2F, 0xF56B28, 0xF8691F,
+            0xFC6714, 0xFF6500
+        },
+        {
+            0x8C8A8C, 0x908990, 0x958794, 0x998698, 0x9D849B, 0xA1829F,
+            0xA581A3, 0xA97FA7, 0xAD7DAB, 0xB17BAE, 0xB579B2, 0xB977B6,
+            0xBC75B9, 0xC072BD, 0xC470C1, 0xC76DC5, 0xCB6BC8, 0xCF68CC,
+            0xD265D0, 0xD661D3, 0xD95ED7, 0xDD5ADB, 0xE056DE, 0xE452E2,
+            0xE74DE5, 0xEB47E9, 0xEE42ED, 0xF13BF0, 0xF533F4, 0xF829F8,
+            0xFC1BFB, 0xFF00FF
+        },
+        {
+            0x8C8A8C, 0x8B8C8A, 0x898F88, 0x889187, 0x869385, 0x859583,
+            0x839881, 0x819A7F, 0x7F9C7D, 0x7E9E7B, 0x7CA179, 0x7AA376,
+            0x78A574, 0x76A772, 0x74A970, 0x71AB6D, 0x6FAD6B, 0x6CAF68,
+            0x6AB265, 0x67B463, 0x64B660, 0x61B85D, 0x5EBA5A, 0x5BBC56,
+            0x57BE53, 0x53C04F, 0x4FC24B, 0x4AC447, 0x46C643, 0x40C83E,
+            0x3ACA39, 0x33CC33
+        },
+        {
+            0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C,
+            0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C,
+            0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C,
+            0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C,
+            0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C, 0x8C8A8C,
+            0x8C8A8C, 0x8C8A8C
+        },
+        {
+            0x8C8A8C, 0x878891, 0x828795, 0x7E8599, 0x79839E, 0x7482A2,
+            0x6F80A6, 0x6A7EAA, 0x657CAE, 0x6179B2, 0x5C77B6, 0x5775B9,
+            0x5272BD, 0x4D70C1, 0x486DC4, 0x436BC8, 0x3E68CC, 0x3965CF,
+            0x3461D3, 0x2F5ED6, 0x2A5ADA, 0x2457DD, 0x1F52E0, 0x1A4EE4,
+            0x1449E7, 0x0E44EA, 0x083EEE, 0x0338F1, 0x0030F4, 0x0026F8,
+            0x0019FB, 0x0000FE
+        }
+    },
+    {
+        {
+            0x0000FE, 0x111AF8, 0x1D26F2, 0x272FED, 0x3136E7, 0x3A3CE1,
+            0x4240DB, 0x4A44D5, 0x5348CF, 0x5B4AC9, 0x624DC3, 0x6A4FBD,
+            0x7250B7, 0x7951B1, 0x8152AB, 0x8853A5, 0x90539F, 0x975398,
+            0x9F5292, 0xA6518B, 0xAE5084, 0xB54E7D, 0xBD4C76, 0xC44A6F,
+            0xCB4667, 0xD3435E, 0xDA3E56, 0xE1394C, 0xE93241, 0xF02934,
+            0xF81C23, 0xFF0000
+        },
+        {
+            0x0000FE, 0x0817FE, 0x1123FF, 0x192DFF, 0x2034FF, 0x273BFF,
+            0x2E41FF, 0x3447FF, 0x3B4CFF, 0x4151FF, 0x4855FF, 0x4E5AFF,
+            0x545EFF, 0x5B62FF, 0x6166FF, 0x676AFF, 0x6E6DFF, 0x7471FF,
+            0x7A74FF, 0x8177FF, 0x877BFF, 0x8D7EFF, 0x9481FF, 0x9A84FF,
+            0xA187FF, 0xA78AFF, 0xAD8DFF, 0xB48FFF, 0xBA92FF, 0xC195FF,
+            0xC797FF, 0xCE9AFF
+        },
+        {
+            0x0000FE, 0x0028FB, 0x003AF8, 0x0048F6, 0x0054F3, 0x005EEF,
+            0x0268EC, 0x1370E9, 0x2078E5, 0x2C80E2, 0x3687DE, 0x408EDA,
+            0x4A95D6, 0x549CD2, 0x5DA2CE, 0x67A8C9, 0x70AEC4, 0x7AB4BF,
+            0x83BAB9, 0x8DC0B4, 0x96C5AE, 0xA0CBA7, 0xA9D0A0, 0xB2D698,
+            0xBCDB90, 0xC5E087, 0xCFE67C, 0xD9EB71, 0xE2F063, 0xECF552,
+            0xF5FA3A, 0xFFFF00
+        },
+        {
+            0x0000FE, 0x0112FB, 0x031DF8, 0x0525F4, 0x092BF1, 0x0D30EE,
+            0x1135EB, 0x1539E8, 0x183CE5, 0x1C40E1, 0x2043DE, 0x2346DB,
+            0x2748D8, 0x2A4BD5, 0x2E4DD1, 0x314FCE, 0x3451CB, 0x3853C8,
+            0x3B55C4, 0x3E57C1, 0x4258BE, 0x455ABB, 0x485BB7, 0x4C5DB4,
+            0x4F5EB1, 0x525FAD, 0x5560AA, 0x5861A7, 0x5C62A3, 0x5F63A0,
+            0x62649C, 0x656599
+        },
+        {
+            0x0000FE, 0x0022FF, 0x0032FF, 0x003FFF, 0x014AFF, 0x0A53FF,
+            0x145CFF, 0x1D65FF, 0x266CFF, 0x2F74FF, 0x377BFF, 0x3F82FF,
+            0x4789FF, 0x4F90FF, 0x5796FF, 0x5F9DFF, 0x67A3FF, 0x6FA9FF,
+            0x77AFFF, 0x7FB5FF, 0x88BBFF, 0x90C1FF, 0x98C7FF, 0xA0CDFF,
+            0xA8D3FF, 0xB1D9FF, 0xB9DFFF, 0xC1E4FF, 0xCAEAFF, 0xD2F0FF,
+            0xDBF5FF, 0xE3FBFF
+        },
+        {
+            0x0000FE, 0x0B16F7, 0x1521F0, 0x1D29E9, 0x242FE2, 0x2B34DB,
+            0x3138D5, 0x373BCE, 0x3D3EC7, 0x4240C0, 0x4842B9, 0x4D43B2,
+            0x5245AB, 0x5845A5, 0x5D469E, 0x624697, 0x674690, 0x6C4689,
+            0x704682, 0x75457B, 0x7A4474, 0x7F436D, 0x834165, 0x883F5E,
+            0x8D3D56, 0x913A4E, 0x963746, 0x9A343D, 0x9F2F33, 0xA32A28,
+            0xA8241A, 0xAC1C00
+        },
+        {
+            0x0000FE, 0x001BFE, 0x002AFF, 0x0035FF, 0x003EFF, 0x0046FF,
+            0x004DFF, 0x0054FF, 0x005BFF, 0x0061FF, 0x0067FF, 0x006CFF,
+            0x0072FF, 0x0077FF, 0x007CFF, 0x0082FF, 0x0087FF, 0x008CFF,
+            0x0091FF, 0x0095FF, 0x009AFF, 0x009FFF, 0x00A3FF, 0x00A8FF,
+            0x00ADFF, 0x00B1FF, 0x00B6FF, 0x00BAFF, 0x00BFFF, 0x00C3FF,
+            0x00C8FF, 0x00CCFF
+        },
+        {
+            0x0000FE, 0x0B1DF9, 0x162BF4, 0x2035EE, 0x293DE9, 0x3144E4,
+            0x3A4ADF, 0x424FD9, 0x4A53D4, 0x5257CE, 0x5B5AC9, 0x625EC3,
+            0x6A60BE, 0x7263B8, 0x7A65B2, 0x8267AC, 0x8A69A6, 0x926AA0,
+            0x996B9A, 0xA16C93, 0xA96D8D, 0xB16D86, 0xB96E7F, 0xC06E77,
+            0xC86D6F, 0xD06D67, 0xD86C5E, 0xE06B53, 0xE76A48, 0xEF693A,
+            0xF76728, 0xFF6500
+        },
+        {
+            0x0000FE, 0x160DFE, 0x2316FE, 0x2E1CFF, 0x3821FF, 0x4125FF,
+            0x4928FF, 0x512BFF, 0x592EFF, 0x6030FF, 0x6832FF, 0x6F34FF,
+            0x7735FF, 0x7E36FF, 0x8537FF, 0x8C37FF, 0x9338FF, 0x9B38FF,
+            0xA238FF, 0xA937FF, 0xB037FF, 0xB736FF, 0xBE34FF, 0xC533FF,
+            0xCD31FF, 0xD42EFF, 0xDB2BFF, 0xE227FF, 0xE922FF, 0xF11BFF,
+            0xF811FF, 0xFF00FF
+        },
+        {
+            0x0000FE, 0x0023FA, 0x0034F5, 0x0040F1, 0x004AED, 0x0053E8,
+            0x005AE4, 0x0062DF, 0x0068DB, 0x006ED6, 0x0074D1, 0x007ACD,
+            0x007FC8, 0x0084C3, 0x0089BE, 0x008EB9, 0x0092B3, 0x0097AE,
+            0x009BA8, 0x009FA2, 0x00A39C, 0x00A796, 0x00AB8F, 0x00AF88,
+            0x00B381, 0x00B779, 0x00BA71, 0x00BE68, 0x0CC25E, 0x1EC552,
+            0x29C945, 0x33CC33
+        },
+        {
+            0x0000FE, 0x0019FB, 0x0026F8, 0x0030F4, 0x0338F1, 0x083EEE,
+            0x0E44EA, 0x1449E7, 0x1A4EE4, 0x1F52E0, 0x2457DD, 0x2A5ADA,
+            0x2F5ED6, 0x3461D3, 0x3965CF, 0x3E68CC, 0x436BC8, 0x486DC4,
+            0x4D70C1, 0x5272BD, 0x5775B9, 0x5C77B6, 0x6179B2, 0x657CAE,
+            0x6A7EAA, 0x6F80A6, 0x7482A2, 0x79839E, 0x7E8599, 0x828795,
+            0x878891, 0x8C8A8C
+        },
+        {
+            0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE,
+            0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE,
+            0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE,
+            0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE,
+            0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE, 0x0000FE,
+            0x0000FE, 0x0000FE
+        }
+    }
+};
+
+/* Returns the color of frame `k` of a crossfade of `n` frames from pitch
+   class `from` to `to`: `from` at frame 0, `to` at frame `n`. Between
+   entries of the ramp, the two nearest are blended with an 8-bit weight. */
+static inline uint32_t
+color_ramp_at(uint8_t from, uint8_t to, uint32_t k, uint32_t n)
+{
+    const uint32_t *ramp = color_ramp[from][to];
+    uint32_t pos, w, a, b, out = 0;
+
+    if (k >= n)
+        return ramp[COLOR_RAMP_N - 1];
+    pos = (k * (COLOR_RAMP_N - 1) << 8) / n;  /* 24.8 fixed point */
+    w = pos & 0xFF;
+    a = ramp[pos >> 8];
+    b = ramp[(pos >> 8) + 1];
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        uint32_t ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;
+
+        out |= ((ca * (256 - w) + cb * w + 128) >> 8) << shift;
+    }
+    return out;
+}
+
+#endif  /* TNA_COLORS_H */
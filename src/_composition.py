@@ -2,17 +2,19 @@
 #   Imports
 ###############################################################################
 import os
-import time
 
 import numpy as np
 
 from itertools import chain
 from random import choice, randint, randrange, shuffle
-from time import perf_counter
 
-from _midiout import MidiOut
-from _midi_constants import MAX_VELOCITY, MIDI_NOTE_NAMES, MIN_VELOCITY,      \
-                            NOTE_OFF, NOTE_ON, N_PITCHES, N_PKEYS
+from _clock import clock
+from _eventlog import EV_DRONE_DEL, EV_DRONE_OFF, EV_DRONE_ON, eventlog
+from _link import Link, LinkError
+from _midi_constants import MAX_VELOCITY, MIN_VELOCITY, NOTE_OFF, NOTE_ON,   \
+                            N_PITCHES, N_PKEYS
+from _protocol import EVENT_FINISHED, EVENT_STARTED, NO_STEP,          \
+                      encode_drone_off, encode_drone_on
 from _serial import Serial
 from _tonerow import N_TONEROW, variations, _random
 
@@ -46,6 +48,13 @@ logger = logging.getLogger()
 #                         writing attempts to write all message bytes but
 #                         does not try again (returns immediately). One
 #                         drone iteration is 4.800 seconds.
+#
+#   link                : shared `Link` instance on top of `ser`. Sends
+#                         messages and awaits their acks.
+#
+#   All three are opened by `open_devices()`, so that importing this module
+#   touches neither the MIDI backend nor the serial port (e.g. to generate
+#   compositions for other sculptures; see `_arkd.py`).
 ###############################################################################
 map_0to87_to_0to127 = np.array(range(21, 109), dtype=np.uint8)
 
@@ -68,32 +77,62 @@ map_0to127_to_0to11[23] = 11
 for i in range(N_PKEYS - 3):
     map_0to127_to_0to11[24 + i] = i % N_TONEROW
 
-midiout = MidiOut()
+midiout = None
+
+ser = None
 
-ser = Serial(baudrate=57_600, timeout=10, write_timeout=0)
+link = None
 
 
 ###############################################################################
 #   Handlers
 ###############################################################################
+def open_devices():
+    """Opens the MIDI port and the serial port, and makes them those of
+    `Composition` and `Drone`."""
+    global midiout, ser, link
+    from _midiout import MidiOut
+
+    midiout = MidiOut()
+    ser = Serial(baudrate=57_600, timeout=10, write_timeout=0)
+    link = Link(ser)
+    for cls in (Composition, Drone):
+        cls.midiout, cls.ser, cls.link = midiout, ser, link
+
+
 def restart_computer():
     pwd = os.environ["TNAPWD"]
     os.system(f"echo {pwd} | sudo -S shutdown -r now")
 
 
+def send_or_restart(send, *args):
+    """Calls `send(*args)`, one of the `Link` send methods, and returns the
+    ack(s). If communication with the microcontroller is not as expected,
+    restarts the computer."""
+    try:
+        return send(*args)
+    except LinkError as err:
+        logger.critical(f"{err} Restarting.")
+        restart_computer()
+
+
 ###############################################################################
 #   Composition class
 ###############################################################################
 class Composition:
     midiout = midiout                                   # MidiOut instance
     ser = ser                                           # Serial instance
+    link = link                                         # Link instance
     channel = 0                                         # Default channel
     velocity = int((MIN_VELOCITY + MAX_VELOCITY) / 2)   # Default velocity
     bpm = 102                                           # Default bpm
-    timer = perf_counter                                # Timer
+    beats_per_bar = 4                                   # Accented beats
+    quantize = 6                                        # Grid per beat
+    lead_in = 0.1                                       # Seconds to beat 0
+    clock = clock                                       # Clock (`_clock`)
 
     # Records time at which last composition was played.
-    time_lastPlayed = timer()
+    time_lastPlayed = clock.now()
 
     def __init__(self, tonerow, bpm, ID=-1):
         """Default initializer."""
@@ -207,66 +246,84 @@ class Composition:
                 # Quarter or half note for last note of a variation.
                 self.durations.append(choice(self.dur_eov))
 
+    def steps(self, quantize):
+        """Returns the point of a grid of `quantize` points per beat,
+        counted from the start of the composition, at which each note
+        starts, or NO_STEP for every note if `quantize` is 0."""
+        if not quantize:
+            return [NO_STEP] * len(self.durations)
+        per_second = self.bpm * quantize / 60
+        step, steps = 0, []
+        for duration in self.durations:
+            steps.append(step)
+            step += round(duration * per_second)
+        return steps
+
     def play(self):
-        for note, duration in zip(self.notes, self.durations):
-            logger.info(f"({MIDI_NOTE_NAMES[note]:7},"
-                        f" {duration:.3})")
-
-            # Send serial message to output lights.
-            message = self.serial_message_builder(note, duration)
-            n = self.ser.write(message)
-            if n < len(message):
-                logger.critical("Not all bytes written through USB-Serial. "
-                                "Restarting.")
-                restart_computer()
-
-            # Receive a response from microcontroller or restart otherwise.
-            self.receive_response()
-
-            # Play `note` for duration `duration`.
+        # Hand the tempo to the microcontroller, with beat 0 `lead_in` from
+        # now (time for the first note to get there), so that note starts
+        # are locked to the grid of eighth and triplet-eighth notes (sixths
+        # of a beat) rather than accumulating rounding and latency,
+        # downbeats are accented and the drone breathes on the beat. Each
+        # note names its grid point, so that one that arrives late is still
+        # placed on it and does not delay the rest.
+        beat0_us = self.link.device_time() + round(self.lead_in * 1_000_000)
+        send_or_restart(self.link.set_tempo, self.bpm, beat0_us,
+                        self.beats_per_bar, self.quantize, True)
+
+        notes = list(zip(self.notes, self.durations,
+                         self.steps(self.quantize)))
+        ack = self._send_note(*notes[0]) if notes else None
+        for k, (note, duration, _) in enumerate(notes):
+            following = notes[k + 1] if k + 1 < len(notes) else None
+
+            # Play `note` for duration `duration`. If the microcontroller
+            # reports events, start the note when its lights actually go on
+            # and end it when they go off, rather than after our own
+            # estimate of `duration`. The next note is sent as soon as this
+            # one has started: it waits in the microcontroller's queue (its
+            # ack comes when it is taken off, as this one finishes), so it
+            # is on time rather than a round trip late.
+            notify = ack is not None and self.link.notifications
+            if notify:
+                send_or_restart(self.link.wait_event, ack.seq, EVENT_STARTED,
+                                self.link.timeout)
             self.__class__.midiout.send_message(
                 (NOTE_ON + self.channel, note, self.velocity))
-            time.sleep(duration)
+            if notify:
+                next_ack = self._send_note(*following) if following else None
+                send_or_restart(self.link.wait_event, ack.seq, EVENT_FINISHED,
+                                duration + self.link.timeout)
+            else:
+                self.clock.sleep(duration)
             self.__class__.midiout.send_message(
                 (NOTE_OFF + self.channel, note, 0))
+            if not notify:
+                next_ack = self._send_note(*following) if following else None
+            ack = next_ack
 
         # Record time at which last composition completed.
-        self.__class__.time_lastPlayed = self.__class__.timer()
+        self.__class__.time_lastPlayed = self.__class__.clock.now()
 
-    @staticmethod
-    def serial_message_builder(note: int, duration: float):
-        # Convert MIDI note number to an integer in [0, 11].
-        note = map_0to127_to_0to11[note]
-        # Convert seconds to microseconds, dropping any fractional part.
-        duration = int(duration * 1_000_000)
-
-        # Create an 11-element zero-filled bytearray.
-        message = bytearray(11)
-
-        # Message starts with character '%'.
-        message[0] = ord("%")
-        # Determines the "mode".
-        message[1] = ord("2")
-        # Determines the "note".
-        message[2] = note
-        # Determines the "duration".
-        for idx, ch in enumerate(str(duration), start=3):
-            message[idx] = ord(ch)
-        # Message ends with character '&'.
-        message[10] = ord("&")
-
-        return message
+    def _send_note(self, note, duration, step):
+        # Binary record only; formatting and I/O happen on the `eventlog`
+        # writer thread.
+        eventlog.note(note, duration)
+
+        # Send serial message to output lights and receive a response from
+        # microcontroller, or restart otherwise. The full MIDI note and
+        # velocity are sent, so that the microcontroller can place the note
+        # by octave and light it by velocity. The duration is converted to
+        # microseconds, dropping any fractional part.
+        return send_or_restart(self.link.send_midi_note, note, self.velocity,
+                               int(duration * 1_000_000), step)
 
     @classmethod
-    def receive_response(cls):
-        # Because a read timeout is set, this call will return immediately once
-        # one byte (the requested number) is available; otherwise, wait until
-        # the timeout expires. A timeout exception is not raised in the event
-        # of a timeout.
-        m = cls.ser.read(size=1)
-        if not m:
-            logger.critical("No response from microcontroller. Restarting.")
-            restart_computer()
+    def set_clock(cls, clock):
+        """Makes compositions keep time with `clock` (e.g. a `SimClock`),
+        counting the time since the last composition from now."""
+        cls.clock = clock
+        cls.time_lastPlayed = clock.now()
 
     @classmethod
     def time_elapsed(cls):
@@ -274,7 +331,15 @@ class Composition:
         Returns the number of seconds (float) since the last composition was
         played.
         """
-        return cls.timer() - cls.time_lastPlayed
+        return cls.clock.now() - cls.time_lastPlayed
+
+    @classmethod
+    def idle_deadline(cls, seconds):
+        """
+        Returns the time, in `clock` units, at which `seconds` seconds will
+        have elapsed since a composition was last played.
+        """
+        return cls.time_lastPlayed + seconds
 
     @classmethod
     def is_time(cls, seconds) -> bool:
@@ -302,13 +367,11 @@ class Drone:
     """Drone object."""
     midiout = midiout
     ser = ser
-    timer = perf_counter
+    link = link
+    clock = clock
 
-    serial_on_message = b"%1" + b"\0" * 8 + b"&"
-    serial_off_message = b"%0" + b"\0" * 8 + b"&"
-    serial_n = 11
-
-    assert len(serial_on_message) == len(serial_off_message) == serial_n
+    serial_on_message = encode_drone_on()
+    serial_off_message = encode_drone_off()
 
     def __init__(self, *, channel, note, velocity):
         """
@@ -327,49 +390,28 @@ class Drone:
     def on(self):
         """Turns on the drone."""
         if not self.is_on:
-            n = self.ser.write(self.serial_on_message)
-            if n < self.serial_n:
-                logger.critical("on(): Not all 'drone on' message bytes "
-                                "written through USB-Serial. Restarting.")
-                restart_computer()
-
-            # Receive a response from microcontroller or restart otherwise.
-            self.receive_response()
+            # Send 'drone on' message and receive a response from
+            # microcontroller, or restart otherwise.
+            send_or_restart(self.link.send, self.serial_on_message)
 
             self.midiout.send_message(self.on_message)
             self.is_on = True
 
-            logger.info("Drone on.")
+            eventlog.log(EV_DRONE_ON)
 
     def off(self):
         """Turns off the drone."""
         if self.is_on:
-            n = self.ser.write(self.serial_off_message)
-            if n < self.serial_n:
-                logger.critical("off(): not all 'drone off' message bytes "
-                                "written through USB-Serial. Restarting.")
-                restart_computer()
-
-            # Receive a response from microcontroller or restart otherwise.
-            self.receive_response()
+            # Send 'drone off' message and receive a response from
+            # microcontroller, or restart otherwise.
+            send_or_restart(self.link.send, self.serial_off_message)
 
             self.midiout.send_message(self.off_message)
             self.is_on = False
 
-            logger.info("Drone off.")
+            eventlog.log(EV_DRONE_OFF)
 
     def __del__(self):
         """Turns off the drone."""
-        logger.info("Drone destructor. Turning drone off.")
+        eventlog.log(EV_DRONE_DEL)
         self.off()
-
-    @classmethod
-    def receive_response(cls):
-        # Because a read timeout is set, this call will return immediately once
-        # one byte (the requested number) is available; otherwise, wait until
-        # the timeout expires. A timeout exception is not raised in the event
-        # of a timeout.
-        m = cls.ser.read(size=1)
-        if not m:
-            logger.critical("No response from microcontroller. Restarting.")
-            restart_computer()
@@ -0,0 +1,383 @@
+###############################################################################
+#   Envelope follower: analyzes the audio actually played (the sampler's
+#                      notes with their decays, the drone swell, the reverb
+#                      tails) and streams the envelope of BANDS_N frequency
+#                      bands to the microcontroller in "bands" messages,
+#                      which modulate the brightness of the lights (see
+#                      "Audio bands" in `_lights.cpp`).
+#
+#   Analysis: every HOP_S (10 ms), the last `n` samples (the power of two at
+#             or above one hop: 512 at 48 kHz) are windowed (Hann) and
+#             transformed with numpy's FFT, whose kernels are vectorized
+#             for the host CPU's SIMD units. The power of the bins of each
+#             band (EDGES_HZ) is summed with one matrix product, taken in
+#             dB relative to a full-scale sine, and mapped linearly from
+#             FLOOR_DB (0) to 0 dBFS (255). Each level then follows an
+#             attack / release envelope: it rises within a hop (ATTACK_S)
+#             and falls with RELEASE_S, so decays and tails are seen as
+#             such rather than flickering with the waveform. A whole file
+#             is analyzed in one batch (`Follower.analyze()`: every window
+#             as one 2-D array, one FFT call); live audio hop by hop
+#             (`Follower.push()`).
+#
+#   Latency: a sound reaches the lights after the rest of its block has
+#            been captured (at most one hop), the analysis (tens of
+#            microseconds), one 8-byte frame over USB, and the loop
+#            iteration of the microcontroller that parses it and presents
+#            the frame with the new gains at once. The test measures all but
+#            the last step, in real time through a pseudo-terminal; the
+#            budget is 20 ms.
+#
+#   Sources: a loopback capture of the audio output (`--capture`, with the
+#            `sounddevice` package, e.g. from a BlackHole or Soundflower
+#            device on macOS, or a PulseAudio monitor on Linux) or, as a
+#            local stand-in, a WAV file played back in real time.
+#
+#   Usage:
+#       python3 _envelope.py FILE.wav [--port PORT] [--depth D]
+#                                       Streams the envelope of FILE as it
+#                                       would be played (without a port,
+#                                       prints the levels instead).
+#       python3 _envelope.py --capture [--device DEV] [--port PORT]
+#                                       [--depth D]
+#                                       Streams the envelope of live audio.
+#       python3 _envelope.py --test     Checks the bands, the envelopes and
+#                                       the end-to-end latency on the
+#                                       simulated microcontroller.
+###############################################################################
+import argparse
+import os
+import sys
+import time
+import wave
+
+from time import perf_counter
+
+import numpy as np
+
+import _protocol as proto
+
+
+###############################################################################
+#   Globals
+###############################################################################
+HOP_S = 0.010                           # One "bands" message per hop.
+EDGES_HZ = (0, 250, 1000, 4000, None)   # Band edges; None: Nyquist.
+FLOOR_DB = -60.0                        # Level 0.
+ATTACK_S = 0.005
+RELEASE_S = 0.150
+LATENCY_BUDGET_S = 0.020
+
+
+###############################################################################
+#   Follower class
+###############################################################################
+class Follower:
+    def __init__(self, rate, hop_s=HOP_S, edges=EDGES_HZ, floor_db=FLOOR_DB,
+                 attack_s=ATTACK_S, release_s=RELEASE_S):
+        self.rate = rate
+        self.hop = round(rate * hop_s)
+        self.n = 1 << (self.hop - 1).bit_length()
+        self.window = np.hanning(self.n)
+        self.floor_db = floor_db
+
+        # Band of each bin, as a (BANDS_N, bins) matrix of 0s and 1s.
+        freqs = np.fft.rfftfreq(self.n, 1 / rate)
+        top = [rate / 2 + 1 if e is None else e for e in edges]
+        self.weights = np.array([(freqs >= lo) & (freqs < hi)
+                                 for lo, hi in zip(top, top[1:])],
+                                dtype=np.float64)
+        if len(self.weights) != proto.BANDS_N:
+            raise ValueError(f"{proto.BANDS_N} bands are sent.")
+
+        # Power, summed over the positive bins, of a full-scale sine.
+        self.ref = self.n * np.sum(self.window ** 2) / 4
+
+        self.attack = 1 - np.exp(-hop_s / attack_s)
+        self.release = 1 - np.exp(-hop_s / release_s)
+        self.level = np.zeros(proto.BANDS_N)   # Envelope, in [0, 1].
+        self._buf = np.zeros(self.n)
+        self._fill = 0      # Samples since the last hop.
+
+    def raw(self, frames):
+        """Returns the level, in [0, 1], of each band in each row of
+        `frames`, a (k, n) array of windows."""
+        spec = np.fft.rfft(frames * self.window, axis=-1)
+        power = (spec.real ** 2 + spec.imag ** 2) @ self.weights.T
+        db = 10 * np.log10(power / self.ref + 1e-12)
+        return np.clip(1 - db / self.floor_db, 0, 1)
+
+    def smooth(self, raw):
+        """Runs the attack / release envelopes over `raw`, one row per hop.
+        Returns the levels to send, as a (k, BANDS_N) array of bytes."""
+        out = np.empty(raw.shape)
+        level = self.level
+        for k, x in enumerate(raw):
+            level = level + np.where(x > level, self.attack,
+                                     self.release) * (x - level)
+            out[k] = level
+        self.level = level
+        return np.rint(out * 255).astype(np.uint8)
+
+    def analyze(self, samples):
+        """Returns the levels of every hop of `samples` (mono, floats in
+        [-1, 1]), analyzed in one batch."""
+        x = np.concatenate((np.zeros(self.n - self.hop), samples))
+        frames = np.lib.stride_tricks.sliding_window_view(
+            x, self.n)[::self.hop]
+        return self.smooth(self.raw(frames))
+
+    def push(self, samples):
+        """Feeds live samples (any number). Returns the levels of the hops
+        they complete, as in `analyze()`."""
+        out = []
+        samples = np.asarray(samples, dtype=np.float64)
+        while len(samples):
+            k = min(self.hop - self._fill, len(samples))
+            self._buf = np.roll(self._buf, -k)
+            self._buf[-k:] = samples[:k]
+            self._fill += k
+            samples = samples[k:]
+            if self._fill == self.hop:
+                self._fill = 0
+                out.append(self.smooth(self.raw(self._buf[None]))[0])
+        return out
+
+
+###############################################################################
+#   Sources
+###############################################################################
+def read_wav(path):
+    """Returns `(rate, samples)`: the contents of a PCM WAV file, mixed down
+    to mono floats in [-1, 1]."""
+    with wave.open(path) as wav:
+        rate, width, channels = (wav.getframerate(), wav.getsampwidth(),
+                                 wav.getnchannels())
+        data = wav.readframes(wav.getnframes())
+    if width == 1:
+        x = np.frombuffer(data, np.uint8).astype(np.float64) - 128
+    elif width == 3:
+        b = np.frombuffer(data, np.uint8).reshape(-1, 3).astype(np.int32)
+        x = ((b[:, 0] | b[:, 1] << 8 | b[:, 2] << 16) << 8 >> 8).astype(
+            np.float64)
+    else:
+        x = np.frombuffer(data, f"<i{width}").astype(np.float64)
+    x /= 2.0 ** (8 * width - 1)
+    return rate, x.reshape(-1, channels).mean(axis=1)
+
+
+def play_wav(follower, samples, send, block=None):
+    """Feeds `samples` to `follower` in blocks of `block` samples (default:
+    one hop), each when it would have been captured if playback had started
+    now, and calls `send(levels)` for every hop. Returns the start time
+    (`perf_counter()`)."""
+    block = block or follower.hop
+    t0 = perf_counter()
+    for k in range(0, len(samples), block):
+        due = t0 + (k + block) / follower.rate
+        delay = due - perf_counter()
+        if delay > 0:
+            time.sleep(delay)
+        for levels in follower.push(samples[k:k + block]):
+            send(levels)
+    return t0
+
+
+def capture(follower, send, device=None):
+    """Streams the envelope of live audio from input `device` (e.g. a
+    loopback of the output) until interrupted."""
+    import sounddevice
+
+    def callback(indata, frames, time_info, status):
+        for levels in follower.push(indata.mean(axis=1)):
+            send(levels)
+
+    with sounddevice.InputStream(device=device, samplerate=follower.rate,
+                                 blocksize=follower.hop, channels=2,
+                                 callback=callback):
+        while True:
+            time.sleep(1)
+
+
+###############################################################################
+#   Test
+###############################################################################
+def tone(rate, seconds, freq, amp=1.0, t60=None):
+    """Returns a sine, decaying by 60 dB over `t60` seconds if given."""
+    t = np.arange(round(rate * seconds)) / rate
+    x = amp * np.sin(2 * np.pi * freq * t)
+    if t60:
+        x *= 10 ** (-3 * t / t60)
+    return x
+
+
+def run_test():
+    import random
+    import tempfile
+
+    import serial
+
+    from _link import Link
+    from _stress import open_sim
+
+    failures = []
+    rate = 48_000
+    follower = Follower(rate)
+    print(f"{rate} Hz: hop {follower.hop} samples, window {follower.n}, "
+          f"bands {EDGES_HZ[:-1]} Hz and up.")
+
+    # Each band responds to its own frequencies.
+    for band, freq in enumerate((60, 500, 2000, 8000)):
+        levels = Follower(rate).analyze(tone(rate, 0.3, freq))[-1].astype(int)
+        print(f"    {freq:5} Hz full scale: {levels.tolist()}")
+        others = np.delete(levels, band)
+        if levels[band] < 250 or others.max() > levels[band] // 2:
+            failures.append(f"{freq} Hz gives {levels.tolist()}.")
+
+    # Silence is 0; a decay of 60 dB/s falls steadily at 255 levels/s (but
+    # for a level of ripple, as the phase of the tone moves in the window);
+    # a cut falls at the release rate.
+    silent = Follower(rate).analyze(np.zeros(rate))
+    if silent.any():
+        failures.append("Silence is not 0.")
+    tail = Follower(rate).analyze(tone(rate, 1.0, 500, t60=1.0))[:, 1].astype(
+        int)
+    slope = np.polyfit(np.arange(20, 80) * HOP_S, tail[20:80], 1)[0]
+    print(f"    Tail of T60 1 s: {slope:.0f} levels/s.")
+    if not -290 < slope < -220 or np.any(np.diff(tail[5:]) > 1):
+        failures.append(f"Tail falls at {slope:.0f} levels/s.")
+    cut = Follower(rate).analyze(np.concatenate(
+        (tone(rate, 0.2, 500), np.zeros(rate // 2))))[:, 1]
+    k = int(0.2 / HOP_S) + round(RELEASE_S / HOP_S)
+    if not 0.25 < cut[k] / cut[k - round(RELEASE_S / HOP_S) - 1] < 0.5:
+        failures.append(f"Release after a cut: {cut[18:40].tolist()}.")
+
+    # WAV files, as the audio they hold.
+    x = tone(rate, 0.1, 440, 0.5)
+    for width in (2, 3):
+        with tempfile.NamedTemporaryFile(suffix=".wav") as fp:
+            with wave.open(fp.name, "wb") as wav:
+                wav.setnchannels(2)
+                wav.setsampwidth(width)
+                wav.setframerate(rate)
+                q = np.rint(x * 2.0 ** (8 * width - 1)).astype(np.int64)
+                wav.writeframes(b"".join(int(v).to_bytes(width, "little",
+                                                          signed=True) * 2
+                                         for v in q))
+            got_rate, y = read_wav(fp.name)
+        if got_rate != rate or np.abs(y - x).max() > 2.0 ** (1 - 8 * width):
+            failures.append(f"{8 * width}-bit WAV read wrong.")
+
+    # Batch analysis against hop by hop, and their cost.
+    rng = np.random.default_rng(1)
+    noise = rng.standard_normal(rate * 10) * 0.1
+    t = perf_counter()
+    batch = Follower(rate).analyze(noise)
+    t_batch = (perf_counter() - t) / len(batch)
+    live, f = [], Follower(rate)
+    t = perf_counter()
+    for k in range(0, len(noise), f.hop):
+        live += f.push(noise[k:k + f.hop])
+    t_live = (perf_counter() - t) / len(live)
+    print(f"    Analysis: {t_batch * 1e6:.1f} us/hop in a batch, "
+          f"{t_live * 1e6:.1f} us/hop live.")
+    if not np.array_equal(np.array(live), batch):
+        failures.append("Live and batch analyses differ.")
+
+    # End to end, in real time: notes at random times over a drone, played
+    # back block by block, analyzed and sent to the simulated
+    # microcontroller; latency from each onset to the first level received
+    # at half its rise.
+    random.seed(2)
+    seconds = 6
+    audio = 0.1 * tone(rate, seconds, 32.7)         # The drone.
+    onsets = [0.3 + 0.45 * k + random.uniform(0, 0.1) for k in range(12)]
+    for t in onsets:
+        k = round(t * rate)
+        note = tone(rate, seconds - t, 2000, 0.5, t60=0.3)
+        audio[k:] += note[:len(audio) - k]
+
+    slave, device = open_sim()
+    ser = serial.Serial(os.ttyname(slave), timeout=1, write_timeout=0)
+    link = Link(ser)
+    try:
+        t0 = play_wav(Follower(rate), audio, link.send_bands)
+        time.sleep(0.05)
+        received = list(device.bands)
+    finally:
+        ser.close()
+        os.close(slave)
+        device.stop()
+        os.close(device.fd)
+
+    latencies = []
+    for t in onsets:
+        before = [lv[2] for at, lv in received if at < t0 + t - 0.02]
+        base = before[-1] if before else 0
+        peak = max(lv[2] for at, lv in received
+                   if t0 + t <= at < t0 + t + 0.1)
+        at = next(at for at, lv in received
+                  if at >= t0 + t and lv[2] >= (base + peak) / 2)
+        latencies.append(at - (t0 + t))
+    latencies.sort()
+    print(f"    {len(received)} \"bands\" frames in {seconds} s; onset "
+          f"to lights: median {latencies[len(latencies) // 2] * 1e3:.1f} "
+          f"ms, max {latencies[-1] * 1e3:.1f} ms over {len(latencies)} "
+          f"notes.")
+    if latencies[-1] >= LATENCY_BUDGET_S:
+        failures.append(f"Latency {latencies[-1] * 1e3:.1f} ms.")
+    if abs(len(received) - seconds / HOP_S) > 2:
+        failures.append(f"{len(received)} frames in {seconds} s.")
+
+    if failures:
+        print("FAILED:\n    " + "\n    ".join(failures))
+        return 1
+    print("OK.")
+    return 0
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    parser = argparse.ArgumentParser(description="Envelope follower.")
+    parser.add_argument("file", nargs="?")
+    parser.add_argument("--capture", action="store_true")
+    parser.add_argument("--device")
+    parser.add_argument("--rate", type=int, default=48_000)
+    parser.add_argument("--port")
+    parser.add_argument("--depth", type=int, default=255)
+    parser.add_argument("--test", action="store_true")
+    args = parser.parse_args(argv)
+
+    if args.test:
+        return run_test()
+    if not args.file and not args.capture:
+        parser.error("no WAV file and no --capture.")
+
+    if args.port:
+        from _link import Link
+        from _serial import Serial
+
+        link = Link(Serial(args.port, baudrate=57_600, timeout=10,
+                           write_timeout=0))
+
+        def send(levels):
+            link.send_bands(levels, args.depth)
+    else:
+        def send(levels):
+            print(" ".join(f"{x:3}" for x in levels))
+
+    if args.capture:
+        try:
+            capture(Follower(args.rate), send, args.device)
+        except KeyboardInterrupt:
+            pass
+        return 0
+    rate, samples = read_wav(args.file)
+    play_wav(Follower(rate), samples, send)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
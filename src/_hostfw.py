@@ -0,0 +1,628 @@
+###############################################################################
+#   Host build of the firmware: compiles `_lights.cpp` with the host C++
+#                               compiler, against stand-ins for the Teensy
+#                               core and OctoWS2811, and runs its `loop()`
+#                               on a simulated clock, so that the timing of
+#                               the executor can be checked without the
+#                               sculpture.
+#
+#   A run is a script of frames, each written to the USB serial port at a
+#   given time (in microseconds since `setup()`). `micros()` advances by
+#   STEP_US per pass of `loop()`, and everything the firmware writes back
+#   ("ack", "event", ...) is returned with the time it was written, along
+#   with every frame handed to OctoWS2811 and the number of LEDs it lights.
+#
+#   As with the Arduino builder, the firmware's functions are declared ahead
+#   of the sketch from their definitions, which `_lights.cpp` writes as
+#
+#       type
+#       name(parameters)
+#       {
+#
+#   The rendering, the codec and the executor are the firmware's own; only
+#   the time it takes to run them is not (every pass of `loop()` takes
+#   STEP_US).
+#
+#   `ExecutorModel` computes the same timing in closed form, for the
+#   simulations of the microcontroller that run on other clocks.
+#
+#   Usage:
+#       python3 _hostfw.py --test     Plays notes and chords back to back
+#                                     with no, a positive and a negative
+#                                     latency offset, and notes sent after
+#                                     their grid point, and checks their
+#                                     events and light onsets against the
+#                                     beat grid. Checks `ExecutorModel`
+#                                     against these runs and drones ended
+#                                     by a note and by "drone_off". Also
+#                                     checks that "bands" are parsed while
+#                                     the command queue is full, and that
+#                                     a note clears the pixels a streamed
+#                                     frame or a light program drew before
+#                                     it.
+###############################################################################
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import zlib
+
+from collections import namedtuple
+
+import _protocol as proto
+
+from _vmasm import assemble
+
+
+###############################################################################
+#   Globals
+###############################################################################
+HERE = os.path.dirname(os.path.abspath(__file__))
+SKETCH_PATH = os.path.join(HERE, "_lights.cpp")
+
+STEP_US = 10    # Simulated time per pass of `loop()`.
+N_LEDS = 88     # N_LEDS of `_lights.cpp`.
+
+_definition = re.compile(r"^((?:static\s+)?[A-Za-z_][\w \*]*)\n"
+                         r"([A-Za-z_]\w*)\(([^)]*)\)\n\{", re.M)
+
+OCTOWS2811_H = """\
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+#define WS2811_RGB    0
+#define WS2811_800kHz 0
+#define DMAMEM
+
+class OctoWS2811 {
+public:
+    OctoWS2811(uint32_t n, void *, void *, uint8_t) : lit(8 * n) {}
+    void begin() {}
+    void setPixel(uint32_t i, uint8_t r, uint8_t g, uint8_t b)
+    {
+        lit[i] = (r | g | b) != 0;
+    }
+    void show();
+private:
+    std::vector<uint8_t> lit;
+};
+"""
+
+SOFTWARE_SERIAL_H = """\
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+
+uint32_t micros(void);
+void delayMicroseconds(uint32_t us);
+
+class HostSerial {
+public:
+    std::deque<uint8_t> in;
+    void begin(long) {}
+    int available() { return (int) in.size(); }
+    int read() { int c = in.front(); in.pop_front(); return c; }
+    size_t write(const uint8_t *buf, size_t n);
+    void send_now() {}
+};
+
+extern HostSerial Serial;
+"""
+
+HARNESS = """\
+#define _Static_assert static_assert
+#include "prototypes.h"
+#include "_lights.cpp"
+
+#include <stdio.h>
+#include <string>
+#include <utility>
+
+static uint64_t sim_us = 0;
+HostSerial Serial;
+
+uint32_t micros(void) { return (uint32_t) sim_us; }
+void delayMicroseconds(uint32_t us) { sim_us += us; }
+
+size_t
+HostSerial::write(const uint8_t *buf, size_t n)
+{
+    printf("rx %llu ", (unsigned long long) sim_us);
+    for (size_t i = 0; i < n; i++)
+        printf("%02x", buf[i]);
+    printf("\\n");
+    return n;
+}
+
+void
+OctoWS2811::show()
+{
+    size_t n = 0;
+
+    for (uint8_t on : lit)
+        n += on;
+    printf("show %llu %zu\\n", (unsigned long long) sim_us, n);
+}
+
+/* stdin: "at T HEX" lines, in order of T, then "end T". */
+int
+main()
+{
+    std::vector<std::pair<uint64_t, std::string>> script;
+    unsigned long long t, end = 0;
+    char word[8], hex[1024];
+    size_t k = 0;
+
+    while (scanf("%7s %llu", word, &t) == 2)
+    {
+        if (word[0] == 'e')
+        {
+            end = t;
+            break;
+        }
+        if (scanf("%1023s", hex) != 1)
+            return 1;
+        script.emplace_back(t, hex);
+    }
+    setup();
+    for (sim_us = 0; sim_us < end; sim_us += STEP_US)
+    {
+        for (; k < script.size() && script[k].first <= sim_us; k++)
+        {
+            const std::string &h = script[k].second;
+            for (size_t i = 0; i + 1 < h.size(); i += 2)
+                Serial.in.push_back(std::stoi(h.substr(i, 2), nullptr, 16));
+        }
+        loop();
+    }
+    return 0;
+}
+"""
+
+
+###############################################################################
+#   Build and run
+###############################################################################
+def prototypes(sketch):
+    """Returns declarations of the functions defined in `sketch`."""
+    lines = ["#include <stddef.h>", "#include <stdint.h>"]
+    defs = _definition.findall(sketch)
+    structs = sorted(set(re.findall(r"struct (\w+)",
+                                    " ".join(r + a for r, _, a in defs))))
+    lines += [f"struct {name};" for name in structs]
+    lines += [f"{ret.strip()} {name}({params});"
+              for ret, name, params in defs]
+    lines += ["void setup(void);", "void loop(void);"]
+    return "\n".join(lines) + "\n"
+
+
+class HostFirmware:
+    """The firmware built for the host, in a temporary directory."""
+
+    def __init__(self):
+        self._tmp = tempfile.TemporaryDirectory()
+        tmp = self._tmp.name
+        with open(SKETCH_PATH) as fp:
+            sketch = fp.read()
+        files = {"OctoWS2811.h": OCTOWS2811_H,
+                 "SoftwareSerial.h": SOFTWARE_SERIAL_H,
+                 "prototypes.h": prototypes(sketch),
+                 "harness.cpp": HARNESS}
+        for name, text in files.items():
+            with open(os.path.join(tmp, name), "w") as fp:
+                fp.write(text)
+        self.exe = os.path.join(tmp, "harness")
+        cxx = os.environ.get("CXX", "c++")
+        subprocess.run([cxx, "-std=gnu++17", "-O2", f"-DSTEP_US={STEP_US}",
+                        "-I", tmp, "-I", HERE,
+                        os.path.join(tmp, "harness.cpp"), "-o", self.exe],
+                       check=True)
+
+    def close(self):
+        self._tmp.cleanup()
+
+    def run(self, script, end_us):
+        """Writes each `(t_us, frame)` of `script` (in order of `t_us`) at
+        its time and runs until `end_us`. Returns `(frames, shows)`: the
+        decoded frames written by the firmware as `(t_us, frame)`, and the
+        frames shown as `(t_us, lit)`, where `lit` is the number of LEDs
+        lit."""
+        stdin = "".join(f"at {t} {bytes(frame).hex()}\n"
+                        for t, frame in script) + f"end {end_us}\n"
+        out = subprocess.run([self.exe], input=stdin.encode(),
+                             capture_output=True, check=True).stdout
+        frames, shows, rx = [], [], bytearray()
+        for line in out.decode().splitlines():
+            kind, t, arg = line.split()
+            if kind == "show":
+                shows.append((int(t), int(arg)))
+                continue
+            rx += bytes.fromhex(arg)
+            while len(rx) >= 2 and len(rx) >= proto.frame_len(rx[1]):
+                n = proto.frame_len(rx[1])
+                frames.append((int(t), proto.decode(bytes(rx[:n]))))
+                del rx[:n]
+        return frames, shows
+
+
+def onsets(shows):
+    """Returns the times at which the LEDs went from dark to lit."""
+    out, prev = [], 0
+    for t, lit in shows:
+        if lit and not prev:
+            out.append(t)
+        prev = lit
+    return out
+
+
+def edges(frames, edge):
+    """Returns the times of the `edge` events in `frames`, by sequence
+    number."""
+    return {f.seq: f.t_us for _, f in frames
+            if isinstance(f, proto.Event) and f.edge == edge}
+
+
+def grid_time(beat0, bpm_milli, quantize, n):
+    """`tempo_grid_time()` of `_lights.cpp`."""
+    q = bpm_milli * quantize
+    return beat0 + (n * US_PER_MILLIBEAT + q - 1) // q
+
+
+###############################################################################
+#   ExecutorModel class: the timing of the executor of `_lights.cpp` in
+#                        closed form, for the simulations that play the
+#                        microcontroller on a clock of their own
+#                        (`_clock.SimFirmware`, `_stress.SimDevice`). The
+#                        test below holds it to the firmware built here.
+#
+#                        `submit(msg, seq, queued)` takes the next message
+#                        of the command queue, queued at `queued` (in
+#                        micros64()), and returns its `Step`:
+#
+#                          - `taken`: when `execute()` takes it off the
+#                            queue and acks it: once the lights of the one
+#                            before are done and, unless it is a note or
+#                            chord behind a note or chord (carried, see
+#                            `edge_carry()`), that one's events are sent. A
+#                            running drone ends at the end of its breath
+#                            once a message is queued;
+#                          - `events`: `(seq, edge, t_us, sent_us)` of the
+#                            events it causes, the time of the edge and the
+#                            time the frame is written; this includes the
+#                            EVENT_FINISHED of a drone it ends;
+#                          - for a note or chord, `start` and `finish`, its
+#                            edges, and `on` and `off`, the times its lights
+#                            go on and off (see "Latency compensation" in
+#                            `_lights.cpp`); for "drone_on", `start`, the
+#                            start of its first breath.
+#
+#                        Crossfades, afterglow and light programs take no
+#                        time here.
+###############################################################################
+Step = namedtuple("Step", "taken events start finish on off")
+
+US_PER_MILLIBEAT = 60_000_000_000
+DRONE_BRIGHTNESS_N = 100
+DRONE_MICROSEC_UP = 3_350_000
+DRONE_MICROSEC_ITERATION = 4_800_000
+
+
+class ExecutorModel:
+    def __init__(self):
+        self.latency_us = 0
+        self.bpm_milli = 0
+        self.beat0 = 0
+        self.quantize = 0
+        self.drone_sync = False
+
+        self._free = 0          # Lights of the last message done.
+        self._finish = 0        # EVENT_FINISHED of the last note.
+        self._drone = None      # `(seq, taken, t0, length)` of a drone.
+
+    def submit(self, msg, seq, queued):
+        events = []
+        if self._drone is not None:
+            events.append(self._drone_end(queued))
+        if isinstance(msg, (proto.Note, proto.MidiNote, proto.Chord)):
+            return self._note(msg, seq, queued, events)
+
+        taken = max(queued, self._free, self._finish)
+        start = None
+        if isinstance(msg, proto.DroneOn):
+            events.append((seq, proto.EVENT_STARTED, taken, taken))
+            start, length = self._breath(taken)
+            self._drone = (seq, taken, start, length)
+        elif isinstance(msg, proto.DroneOff):
+            events += [(seq, proto.EVENT_STARTED, taken, taken),
+                       (seq, proto.EVENT_FINISHED, taken, taken)]
+        elif isinstance(msg, proto.Tempo):
+            self.bpm_milli = msg.bpm_milli
+            # As `tempo_set()`: `beat0_us` is within 35 minutes of now.
+            delta = (msg.beat0_us - taken) & 0xFFFFFFFF
+            self.beat0 = taken + (delta - (1 << 32) if delta >> 31 else
+                                  delta)
+            self.quantize = msg.quantize
+            self.drone_sync = bool(msg.drone_sync)
+        elif isinstance(msg, proto.Latency):
+            self.latency_us = msg.offset_us
+        return Step(taken, events, start, None, None, None)
+
+    def _note(self, msg, seq, queued, events):
+        if isinstance(msg, proto.Chord):
+            duration_us = max(msg.duration_us[:msg.n_notes], default=0)
+        else:
+            duration_us = msg.duration_us
+        step = msg.step if isinstance(msg, proto.MidiNote) else \
+            proto.NO_STEP
+        L = self.latency_us
+
+        taken = max(queued, self._free)
+        if taken < self._finish:
+            # Behind a note whose events are still due: carried, and placed
+            # at its EVENT_FINISHED.
+            t = self._finish
+        else:
+            t = taken + max(0, -L)
+        start = self.note_start(t, step)
+        finish = start + duration_us
+        on = max(taken, start + L)
+        off = max(on, finish + L)
+        self._free = max(on, finish + min(0, L))
+        self._finish = finish
+        events += [(seq, proto.EVENT_STARTED, start, max(start, taken)),
+                   (seq, proto.EVENT_FINISHED, finish, max(finish, taken))]
+        return Step(taken, events, start, finish, on, off)
+
+    def quantized_start(self, t):
+        if self.bpm_milli == 0 or self.quantize == 0:
+            return t
+        if t <= self.beat0:
+            return self.beat0
+        n = self._grid_index(t, self.quantize)
+        a = self._grid_time(n, self.quantize)
+        b = self._grid_time(n + 1, self.quantize)
+        return t if t - a <= b - t else b
+
+    def note_start(self, t, step):
+        """`tempo_note_start()`: a point that has passed is kept, not
+        moved."""
+        if step == proto.NO_STEP or self.bpm_milli == 0 or \
+                self.quantize == 0:
+            return self.quantized_start(t)
+        return self._grid_time(step, self.quantize)
+
+    def _grid_time(self, n, div):
+        return grid_time(self.beat0, self.bpm_milli, div, n)
+
+    def _grid_index(self, t, div):
+        return (t - self.beat0) * self.bpm_milli * div // US_PER_MILLIBEAT
+
+    def _next(self, t, div):
+        if t <= self.beat0:
+            return self.beat0
+        g = self._grid_time(self._grid_index(t, div), div)
+        return g if g == t else self._grid_time(
+            self._grid_index(t, div) + 1, div)
+
+    def _breath(self, t):
+        """`drone_breath()`: returns `(t0, length)` of the breath from
+        `t`."""
+        if self.bpm_milli == 0 or not self.drone_sync:
+            return t, DRONE_MICROSEC_ITERATION
+        beat_us = US_PER_MILLIBEAT // self.bpm_milli
+        n_beats = max(1, (DRONE_MICROSEC_ITERATION + beat_us // 2) //
+                      beat_us)
+        L = self.latency_us
+        beat = self._next(t - L if L < 0 or t > L else 0, 1)
+        return beat + L, self._grid_time(self._grid_index(beat, 1) +
+                                         n_beats, 1) - beat
+
+    def _drone_end(self, queued):
+        """Ends the drone, with a message queued at `queued`: right away
+        if it was queued before the drone was taken (`drone_start()`),
+        else at the end of the breath in which it takes its next step
+        (`drone_step()`). Returns its EVENT_FINISHED."""
+        seq, end, t0, length = self._drone
+        self._drone = None
+        while queued >= end:
+            up = length * DRONE_MICROSEC_UP // DRONE_MICROSEC_ITERATION
+            down = length - up
+            last = t0 + up + (DRONE_BRIGHTNESS_N - 1) * down // \
+                DRONE_BRIGHTNESS_N
+            if queued <= last:
+                end = t0 + length
+                break
+            t0, length = self._breath(t0 + length)
+        self._free = end
+        return (seq, proto.EVENT_FINISHED, end, end)
+
+
+###############################################################################
+#   Test
+###############################################################################
+
+
+def paced(frames):
+    """Returns a script writing `frames` one per pass of `loop()` from 0,
+    so that the firmware can take each as soon as it is written."""
+    return [(k * STEP_US, frame) for k, frame in enumerate(frames)]
+
+
+# Lights every LED white, then halts.
+FILL = """
+        li    r1, 88
+        li    r2, 0xFFFFFF
+fill:   addi  r1, -1
+        pixel r1, r2
+        jnz   r1, fill
+        show
+        halt
+"""
+
+
+def run_test():
+    failures = []
+    bpm_milli, quantize, beat0 = 120_000, 6, 100_000
+    steps = [6, 3, 3, 2, 2, 2, 6, 12]           # In sixths of a beat.
+    starts = [sum(steps[:k]) for k in range(len(steps) + 1)]
+    grid = [grid_time(beat0, bpm_milli, quantize, n) for n in starts]
+    durations = [grid[k + 1] - grid[k] for k in range(len(steps))]
+    setup = [proto.encode_notify(1),
+             proto.encode_tempo(bpm_milli, beat0, 4, quantize, 0)]
+
+    def check_cleared(label, shows, t_us):
+        before = [lit for t, lit in shows if t < t_us]
+        after = [lit for t, lit in shows if t >= t_us]
+        print(f"{label}: {before[-1] if before else None} LEDs lit, then "
+              f"{after[0] if after else None}.")
+        if not before or before[-1] != N_LEDS or not after or \
+                not 0 < after[0] < N_LEDS:
+            failures.append(f"{label}: earlier pixels left on.")
+
+    def check_model(label, script, frames, shows):
+        # Each acked message of `script` on an ExecutorModel, queued when
+        # the firmware says it was: it must be taken, report its edges and
+        # light its LEDs when the firmware does, within the pass of `loop()`
+        # or two the firmware takes per message.
+        acks = {f.seq: f for _, f in frames if isinstance(f, proto.Ack)}
+        sent = {(f.seq, f.edge): (t, f.t_us) for t, f in frames
+                if isinstance(f, proto.Event)}
+        msgs = [proto.decode(bytes(f)) for _, f in script
+                if f[1] not in (proto.OP_STREAM_FRAME, proto.OP_BANDS)]
+        lit = onsets(shows)
+        model, worst = ExecutorModel(), 0
+        for seq, msg in enumerate(msgs):
+            if seq not in acks:
+                failures.append(f"{label}: message {seq} not acked.")
+                return
+            step = model.submit(msg, seq, acks[seq].rx_us)
+            errors = [acks[seq].tx_us - step.taken]
+            for s, edge, t_us, sent_us in step.events:
+                if (s, edge) not in sent:
+                    failures.append(f"{label}: no event {edge} for {s}.")
+                    return
+                t, got = sent[(s, edge)]
+                errors += [got - t_us, t - sent_us]
+            if step.on is not None and step.on < step.off:
+                errors.append(min((t - step.on for t in lit), key=abs))
+            worst = max([worst] + [abs(e) for e in errors])
+        print(f"{label}: model within {worst} us of the firmware.")
+        if worst > 2 * STEP_US:
+            failures.append(f"{label}: model off by {worst} us.")
+
+    def check(label, script, frames, shows, offset_us, first_seq):
+        started = edges(frames, proto.EVENT_STARTED)
+        got = [started.get(first_seq + k) for k in range(len(steps))]
+        late = [None if g is None else g - e for g, e in zip(got, grid)]
+        lights = onsets(shows)
+        lights_late = [t - e - offset_us for t, e in zip(lights, grid)]
+        print(f"{label}: events {late} us, lights "
+              f"{lights_late} us off the grid.")
+        if any(d is None or abs(d) > STEP_US for d in late):
+            failures.append(f"{label}: events off the grid.")
+        if len(lights) != len(steps) or \
+                any(abs(d) > 2 * STEP_US for d in lights_late):
+            failures.append(f"{label}: lights off the grid.")
+        end = shows[-1]
+        if end[1] or abs(end[0] - grid[-1] - offset_us) > 2 * STEP_US:
+            failures.append(f"{label}: last lights off at {end}.")
+        check_model(label, script, frames, shows)
+
+    fw = HostFirmware()
+    try:
+        for offset_us in (0, 40_000, -40_000):
+            # Notes written all at once, placed by the firmware.
+            script = paced(setup + [proto.encode_latency(offset_us)] + [
+                proto.encode_midi_note(60 + k, 100, d, proto.NO_STEP)
+                for k, d in enumerate(durations)])
+            frames, shows = fw.run(script, grid[-1] + 600_000)
+            check(f"Notes, offset {offset_us / 1000:+.0f} ms", script,
+                  frames, shows, offset_us, 3)
+
+            # Chords of one note, likewise.
+            script = paced(setup + [proto.encode_latency(offset_us)] + [
+                proto.encode_chord(1, [k % 12] + [0] * 11,
+                                   [d] + [0] * 11)
+                for k, d in enumerate(durations)])
+            frames, shows = fw.run(script, grid[-1] + 600_000)
+            check(f"Chords, offset {offset_us / 1000:+.0f} ms", script,
+                  frames, shows, offset_us, 3)
+
+        # Notes naming their grid point, each written 3 ms after it (as
+        # `Composition.play()` does, once the previous note has finished).
+        script = paced(setup + [proto.encode_latency(20_000)])
+        script += [(grid[k] + 3000, proto.encode_midi_note(60 + k, 100, d,
+                                                           starts[k]))
+                   for k, d in enumerate(durations)]
+        frames, shows = fw.run(script, grid[-1] + 600_000)
+        check("Late notes on their grid points, offset +20 ms", script,
+              frames, shows, 20_000, 3)
+
+        # A drone breathing on the beat ended by a note, a crossfade
+        # behind the note, a drone ended as it starts by the "drone_off"
+        # queued behind it, and the model's timing of all three.
+        script = paced([proto.encode_notify(1),
+                        proto.encode_tempo(bpm_milli, beat0, 4, quantize, 1),
+                        proto.encode_latency(-40_000),
+                        proto.encode_drone_on()])
+        script += [(7_000_000, proto.encode_midi_note(60, 100, 200_000,
+                                                      proto.NO_STEP)),
+                   (7_000_000, proto.encode_crossfade(0)),
+                   (7_000_000, proto.encode_drone_on()),
+                   (9_000_000, proto.encode_drone_off())]
+        frames, shows = fw.run(script, 12_000_000)
+        check_model("Drones", script, frames, shows)
+
+        # A "bands" message written while the queue is full (one note lit,
+        # CMD_QUEUE_LEN queued) is still parsed at once: with every level
+        # at 0 and full depth, it darkens the lit note.
+        bands_t = 50_000
+        script = [(0, proto.encode_midi_note(60 + k, 100, 200_000,
+                                             proto.NO_STEP))
+                  for k in range(1 + proto.CMD_QUEUE_LEN)]
+        script.append((bands_t, proto.encode_bands([0] * proto.BANDS_N,
+                                                   255)))
+        frames, shows = fw.run(script, 100_000)
+        dark = [t for t, lit in shows if t >= bands_t and not lit]
+        late = dark[0] - bands_t if dark else None
+        print(f"Bands behind a full queue: lights dark {late} us after.")
+        if late is None or late > 2 * STEP_US:
+            failures.append("Bands behind a full queue: not applied.")
+
+        # A note drawn over a streamed frame with every LED lit clears it.
+        script = [(0, proto.encode_stream_frame([255] * 3 * N_LEDS)),
+                  (20_000, proto.encode_note(0, 100_000))]
+        frames, shows = fw.run(script, 40_000)
+        check_cleared("Note after a streamed frame", shows, 20_000)
+
+        # Likewise over the pixels a light program left on when it halted.
+        code = assemble(FILL)
+        script = [(0, proto.encode_program_load(
+                      k, code[k:k + 64].ljust(64, b"\0")))
+                  for k in range(0, len(code), 64)]
+        script += [(0, proto.encode_program_run(len(code), zlib.crc32(code),
+                                                0)),
+                   (20_000, proto.encode_note(0, 100_000))]
+        frames, shows = fw.run(script, 40_000)
+        check_cleared("Note after a light program", shows, 20_000)
+    finally:
+        fw.close()
+
+    if failures:
+        print("FAILED:\n    " + "\n    ".join(failures))
+        return 1
+    print("OK.")
+    return 0
+
+
+###############################################################################
+#   Main
+###############################################################################
+if __name__ == '__main__':
+    if sys.argv[1:] != ["--test"]:
+        print(__doc__ or "Usage: python3 _hostfw.py --test")
+        sys.exit(2)
+    sys.exit(run_test())
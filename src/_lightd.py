@@ -0,0 +1,518 @@
+###############################################################################
+#   Light daemon: owns the serial link to the microcontroller, and lets any
+#                 number of local producers (the composition player, a
+#                 manual override, a maintenance test pattern, a scheduled
+#                 show) drive the lights through it, each in its own
+#                 process, without editing `_main.py`.
+#
+#   Control plane: a Unix stream socket (SOCKET_PATH). A client sends one
+#                  JSON request per line and gets one JSON reply per line:
+#
+#                      {"op": "hello", "name": N, "priority": P}
+#                          -> {"ring": SHM_NAME, "slots": S}
+#                      {"op": "stats"}
+#                          -> {"clients": [{"name", "priority", "sent",
+#                                           "rejected", "pending"}, ...]}
+#
+#                  An empty line is a doorbell: "my ring has new frames".
+#
+#   Data plane: every client gets its own `Ring`, a single-producer /
+#               single-consumer ring of protocol frames in shared memory
+#               (`multiprocessing.shared_memory`). The client encodes each
+#               frame straight into a slot with the generated codec's
+#               `encode_*_into()` (see `Client.reserve()`), and the daemon
+#               hands the slot to `os.write()` through the `Link`, so frames
+#               are never copied between the two processes or on the way to
+#               the serial port. As in `EventLog`, the producer only writes
+#               `head` and the consumer only writes `tail`, and a slot is
+#               filled before `head` is advanced. The doorbell that follows
+#               a batch is a system call on both sides, which orders the
+#               slot writes before the daemon's reads on weakly ordered CPUs
+#               too, and wakes the daemon only once per batch.
+#
+#   Arbitration: frames go out one at a time over the single link, from the
+#                non-empty ring of highest priority (ties served in turn).
+#                The daemon looks for new requests and doorbells between
+#                frames, so a higher priority producer waits for at most the
+#                frame in flight. A client may also claim the lights
+#                ("exclusive": true in its hello): while it is connected,
+#                rings of lower priority are held rather than sent. Frames
+#                that are not a well-formed host -> device message are
+#                dropped and counted, so no producer can desynchronize the
+#                microcontroller.
+#
+#   Usage: python3 _lightd.py [--socket PATH]
+#          python3 _lightd.py --test
+###############################################################################
+import argparse
+import json
+import os
+import select
+import socket
+import struct
+import sys
+
+from multiprocessing import resource_tracker, shared_memory
+
+import _protocol as proto
+import _protocol_schema as schema
+
+
+###############################################################################
+#   Logging
+###############################################################################
+import logging
+logger = logging.getLogger()
+
+
+###############################################################################
+#   Globals
+###############################################################################
+SOCKET_PATH = "/tmp/thenewark-lightd.sock"
+N_SLOTS = 64        # Frames per ring.
+
+# Opcodes a client may send.
+HOST_OPS = frozenset(ord(m.opcode) for m in schema.MESSAGES
+                     if m.direction == schema.HOST_TO_DEVICE)
+
+
+###############################################################################
+#   Ring class: SPSC ring of frames in shared memory. Layout:
+#
+#                   [0, 8)      head: u64, frames published (producer).
+#                   [64, 72)    tail: u64, frames consumed (consumer).
+#                   [128, ...)  `n_slots` slots of SLOT bytes: the length of
+#                               the frame (u16), then the frame.
+#
+#               `head` and `tail` are on separate cache lines, and only ever
+#               grow.
+###############################################################################
+class Ring:
+    HEADER = 128
+    SLOT = (2 + proto.MAX_FRAME + 15) // 16 * 16
+    _index = struct.Struct("<Q")
+    _len = struct.Struct("<H")
+
+    def __init__(self, shm, n_slots):
+        self.shm = shm
+        self.buf = shm.buf
+        self.n_slots = n_slots
+
+    @classmethod
+    def create(cls, n_slots=N_SLOTS):
+        shm = shared_memory.SharedMemory(
+            create=True, size=cls.HEADER + n_slots * cls.SLOT)
+        shm.buf[:cls.HEADER] = bytes(cls.HEADER)
+        return cls(shm, n_slots)
+
+    @classmethod
+    def attach(cls, name, n_slots):
+        shm = shared_memory.SharedMemory(name=name)
+        # The daemon owns the segment; keep this process's resource tracker
+        # from unlinking it when the client exits.
+        resource_tracker.unregister(shm._name, "shared_memory")
+        return cls(shm, n_slots)
+
+    @property
+    def head(self):
+        return self._index.unpack_from(self.buf, 0)[0]
+
+    @property
+    def tail(self):
+        return self._index.unpack_from(self.buf, 64)[0]
+
+    def __len__(self):
+        return self.head - self.tail
+
+    # Producer side.
+    def reserve(self):
+        """Returns `offset` such that a frame encoded into `self.buf` at
+        `offset` is in the next free slot (see `publish()`), or None if the
+        ring is full."""
+        head = self.head
+        if head - self.tail >= self.n_slots:
+            return None
+        return self.HEADER + (head % self.n_slots) * self.SLOT + 2
+
+    def publish(self, end):
+        """Publishes the frame encoded at the offset returned by `reserve()`,
+        given the offset just past it (as returned by `encode_*_into()`)."""
+        head = self.head
+        start = self.HEADER + (head % self.n_slots) * self.SLOT
+        self._len.pack_into(self.buf, start, end - start - 2)
+        self._index.pack_into(self.buf, 0, head + 1)
+
+    def push(self, frame):
+        """Copies the encoded `frame` into the ring. Returns False if the
+        ring is full."""
+        offset = self.reserve()
+        if offset is None:
+            return False
+        self.buf[offset:offset + len(frame)] = frame
+        self.publish(offset + len(frame))
+        return True
+
+    # Consumer side.
+    def peek(self):
+        """Returns the oldest frame, as a view into the ring, or None."""
+        tail = self.tail
+        if tail == self.head:
+            return None
+        start = self.HEADER + (tail % self.n_slots) * self.SLOT
+        n = min(self._len.unpack_from(self.buf, start)[0], proto.MAX_FRAME)
+        return self.buf[start + 2:start + 2 + n]
+
+    def pop(self):
+        self._index.pack_into(self.buf, 64, self.tail + 1)
+
+    def close(self, unlink=False):
+        self.buf = None
+        self.shm.close()
+        if unlink:
+            self.shm.unlink()
+
+
+###############################################################################
+#   Client class: a producer's end of the daemon.
+###############################################################################
+class Client:
+    def __init__(self, name, priority=0, exclusive=False, path=SOCKET_PATH):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self._in = self.sock.makefile("rb")
+        reply = self.request(op="hello", name=name, priority=priority,
+                             exclusive=exclusive)
+        self.ring = Ring.attach(reply["ring"], reply["slots"])
+
+    def request(self, **req):
+        self.sock.sendall(json.dumps(req).encode() + b"\n")
+        return json.loads(self._in.readline())
+
+    def reserve(self):
+        """See `Ring.reserve()`. Encode into `self.ring.buf`."""
+        return self.ring.reserve()
+
+    def publish(self, end):
+        self.ring.publish(end)
+
+    def submit(self, frame):
+        """Queues an encoded frame. Returns False if the ring is full."""
+        return self.ring.push(frame)
+
+    def note(self, pitch_class, duration_us):
+        """Queues a "note" message, encoded in place. Returns False if the
+        ring is full."""
+        offset = self.reserve()
+        if offset is None:
+            return False
+        self.publish(proto.encode_note_into(self.ring.buf, offset,
+                                            pitch_class, duration_us))
+        return True
+
+    def kick(self):
+        """Rings the doorbell: call once after queuing a batch."""
+        self.sock.sendall(b"\n")
+
+    def stats(self):
+        return self.request(op="stats")["clients"]
+
+    def close(self):
+        self.ring.close()
+        self._in.close()
+        self.sock.close()
+
+
+###############################################################################
+#   Daemon class
+###############################################################################
+class Peer:
+    """The daemon's view of a client."""
+    def __init__(self, sock, order):
+        self.sock = sock
+        self.rx = b""
+        self.name = None
+        self.priority = 0
+        self.exclusive = False
+        self.ring = None
+        self.order = order      # Turn, among clients of equal priority.
+        self.sent = 0
+        self.rejected = 0
+
+
+class Daemon:
+    def __init__(self, link, path=SOCKET_PATH, n_slots=N_SLOTS):
+        self.link = link
+        self.path = path
+        self.n_slots = n_slots
+        if os.path.exists(path):
+            os.unlink(path)
+        self.server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.server.bind(path)
+        self.server.listen()
+        self.peers = {}         # fd -> Peer.
+        self.draining = []      # Disconnected peers with frames left.
+        self._turn = 0
+        self._poll = select.poll()
+        self._poll.register(self.server, select.POLLIN)
+
+    def serve_forever(self):
+        try:
+            while True:
+                self.step(None)
+        finally:
+            self.close()
+
+    def step(self, timeout):
+        """Waits up to `timeout` seconds (None: forever) for requests and
+        doorbells, then sends queued frames until the rings are empty.
+        Between frames, takes new requests and doorbells without waiting."""
+        self._service(timeout)
+        while self._send_one():
+            self._service(0)
+
+    def close(self):
+        for fd in list(self.peers):
+            self._hangup(fd)
+        for peer in self.draining:
+            self._release(peer)
+        self.server.close()
+        if os.path.exists(self.path):
+            os.unlink(self.path)
+
+    def _service(self, timeout):
+        ms = None if timeout is None else int(timeout * 1000)
+        for fd, _ in self._poll.poll(ms):
+            if fd == self.server.fileno():
+                sock, _ = self.server.accept()
+                self._turn += 1
+                self.peers[sock.fileno()] = Peer(sock, self._turn)
+                self._poll.register(sock, select.POLLIN)
+                continue
+            peer = self.peers[fd]
+            data = peer.sock.recv(4096)
+            if not data:
+                self._hangup(fd)
+                continue
+            peer.rx += data
+            while b"\n" in peer.rx:
+                line, peer.rx = peer.rx.split(b"\n", 1)
+                if line:
+                    self._request(peer, line)
+
+    def _request(self, peer, line):
+        try:
+            req = json.loads(line)
+            op = req["op"]
+        except (ValueError, KeyError, TypeError):
+            reply = {"error": "bad request"}
+        else:
+            if op == "hello" and peer.ring is None:
+                peer.name = str(req.get("name", ""))
+                peer.priority = int(req.get("priority", 0))
+                peer.exclusive = bool(req.get("exclusive", False))
+                peer.ring = Ring.create(self.n_slots)
+                reply = {"ring": peer.ring.shm.name, "slots": self.n_slots}
+                logger.info(f"lightd: {peer.name} connected (priority "
+                            f"{peer.priority}).")
+            elif op == "stats":
+                reply = {"clients": [
+                    {"name": p.name, "priority": p.priority, "sent": p.sent,
+                     "rejected": p.rejected,
+                     "pending": len(p.ring) if p.ring else 0}
+                    for p in self.peers.values()]}
+            else:
+                reply = {"error": f"bad op {op!r}"}
+        peer.sock.sendall(json.dumps(reply).encode() + b"\n")
+
+    def _hangup(self, fd):
+        """Closes the connection of a client. Frames it queued before
+        disconnecting are still sent."""
+        peer = self.peers.pop(fd)
+        self._poll.unregister(fd)
+        peer.sock.close()
+        if peer.ring is not None and len(peer.ring):
+            self.draining.append(peer)
+        else:
+            self._release(peer)
+
+    def _release(self, peer):
+        if peer.ring is not None:
+            peer.ring.close(unlink=True)
+            logger.info(f"lightd: {peer.name} disconnected.")
+
+    def _next(self):
+        """Returns the peer whose frame goes next, or None."""
+        floor = max((p.priority for p in self.peers.values() if p.exclusive),
+                    default=None)
+        best = None
+        for p in (*self.peers.values(), *self.draining):
+            if p.ring is None or not len(p.ring) or \
+                    (floor is not None and p.priority < floor):
+                continue
+            if best is None or (p.priority, -p.order) > \
+                    (best.priority, -best.order):
+                best = p
+        return best
+
+    def _send_one(self):
+        """Sends the next frame. Returns False if there was none."""
+        peer = self._next()
+        if peer is None:
+            return False
+        frame = peer.ring.peek()
+        op = frame[1] if len(frame) > 1 else None
+        if op not in HOST_OPS or frame[0] != proto.SOF or \
+                len(frame) != proto.frame_len(op) or frame[-1] != proto.EOF:
+            peer.rejected += 1
+        elif op == proto.OP_STREAM_FRAME:
+            self.link.send_frame(frame[2:-1])
+            peer.sent += 1
+        elif op == proto.OP_BANDS:
+            self.link.send_bands(*proto.decode(frame))
+            peer.sent += 1
+        else:
+            self.link.send(frame)
+            peer.sent += 1
+        frame.release()
+        peer.ring.pop()
+        if peer in self.draining and not len(peer.ring):
+            self.draining.remove(peer)
+            self._release(peer)
+        # Served: go to the back of its priority level.
+        self._turn += 1
+        peer.order = self._turn
+        return True
+
+
+###############################################################################
+#   Test: a fake microcontroller on a pty acks every frame and records the
+#         pitch classes of the notes it receives. A producer process connects
+#         a low priority client, which queues notes of pitch class 0, and a
+#         high priority one, which queues notes of pitch class 11 and a
+#         malformed frame; the high priority notes must go out first, the
+#         malformed frame must be dropped, and nothing may be lost or
+#         reordered within a client. The producer then streams BURST notes
+#         through one ring.
+###############################################################################
+BURST = 6400
+
+
+def producer(path):
+    from time import sleep
+
+    while not os.path.exists(path):
+        sleep(0.01)
+    low = Client("low", priority=0, path=path)
+    high = Client("high", priority=10, path=path)
+    while low.note(0, 1000):
+        pass
+    for _ in range(8):
+        high.note(11, 1000)
+    high.submit(b"%Z&")
+    low.kick()
+    high.kick()
+    while any(s["pending"] for s in low.stats()):
+        sleep(0.001)
+
+    for _ in range(BURST):
+        while not low.note(5, 1000):
+            low.kick()
+            sleep(0.0001)
+    low.kick()
+    low.close()
+    high.close()
+
+
+def run_test():
+    import pty
+    import threading
+    import tty
+    from time import perf_counter
+
+    import serial
+
+    from _link import Link
+
+    # Fork the producer before any thread is started.
+    path = f"/tmp/lightd-test-{os.getpid()}.sock"
+    pid = os.fork()
+    if pid == 0:
+        producer(path)
+        os._exit(0)
+
+    received = []
+
+    def device(fd):
+        seq, buf = 0, b""
+        while True:
+            try:
+                data = os.read(fd, 4096)
+            except OSError:
+                return
+            buf += data
+            out = b""
+            while len(buf) >= 2 and len(buf) >= proto.frame_len(buf[1]):
+                n = proto.frame_len(buf[1])
+                if buf[1] == proto.OP_NOTE:
+                    received.append(buf[2])
+                buf = buf[n:]
+                now = int(perf_counter() * 1e6) & 0xFFFFFFFF
+                out += proto.encode_ack(
+                    seq, now, now, (seq + 1 + proto.CMD_QUEUE_LEN) & 0xFFFF)
+                seq = (seq + 1) & 0xFFFF
+            os.write(fd, out)
+
+    master, slave = pty.openpty()
+    tty.setraw(master)
+    tty.setraw(slave)
+    threading.Thread(target=device, args=(master,), daemon=True).start()
+    link = Link(serial.Serial(os.ttyname(slave), timeout=10,
+                              write_timeout=0))
+    daemon = Daemon(link, path)
+
+    n = N_SLOTS + 8
+    while len(received) < n:
+        daemon.step(1)
+    stats = {p.name: (p.sent, p.rejected) for p in daemon.peers.values()}
+    ok = (received == [11] * 8 + [0] * N_SLOTS and
+          stats == {"low": (N_SLOTS, 0), "high": (8, 1)})
+    print(f"Order: {''.join('H' if x == 11 else 'L' for x in received)}")
+
+    del received[:]
+    start = perf_counter()
+    while len(received) < BURST or daemon.peers or daemon.draining:
+        daemon.step(1)
+    elapsed = perf_counter() - start
+    os.waitpid(pid, 0)
+    daemon.close()
+    ok = ok and received == [5] * BURST
+    print(f"{BURST} notes from another process in {elapsed * 1e3:.1f} ms "
+          f"({elapsed / BURST * 1e6:.1f} us/note, including the acks).")
+    print("OK." if ok else "FAILED.")
+    return 0 if ok else 1
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    parser = argparse.ArgumentParser(description="Light daemon.")
+    parser.add_argument("--socket", default=SOCKET_PATH)
+    parser.add_argument("--test", action="store_true")
+    args = parser.parse_args(argv)
+
+    if args.test:
+        return run_test()
+
+    from _link import Link
+    from _serial import Serial
+
+    logging.basicConfig(level=logging.INFO)
+    link = Link(Serial(baudrate=57_600, timeout=10, write_timeout=0))
+    link.set_notifications(True)
+    Daemon(link, args.socket).serve_forever()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
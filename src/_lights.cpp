@@ -40,8 +40,15 @@
 #include <stdlib.h>  /* void srand(unsigned int seed);
                         int rand(void); rand() generates a pseudo-random
                         integer in [0, RAND_MAX]. */
+#include <string.h>  /* void *memcpy(void *dest, const void *src, size_t n);
+                        void *memset(void *s, int c, size_t n); */
+#if defined(__ARM_FEATURE_SIMD32) && defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>  /* __uxtb16, __smulbb, __usub8, __sel, ... */
+#endif
 #include <OctoWS2811.h>
 #include <SoftwareSerial.h>
+#include "_protocol.h"  /* USB-serial codec generated by _codegen.py. */
+#include "_colors.h"    /* Color ramps generated by _colorgen.py. */
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -105,6 +112,21 @@ const uint8_t group_lr[3][4] = {
     {68, 69, 70, 71}
 };
 
+/* Top */
+const uint8_t group_top[2][4] = {
+    {80, 81, 82, 83},
+    {84, 85, 86, 87}
+};
+
+/* Groups, in the order used by the "afterglow" message. */
+#define GROUP_F   0
+#define GROUP_B   1
+#define GROUP_LL  2
+#define GROUP_LR  3
+#define GROUP_RL  4
+#define GROUP_RR  5
+#define GROUP_TOP 6
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //  Color-related constants
@@ -137,6 +159,29 @@ const uint32_t map_cs_to_color[] = {
     0x0000FE    // B    "Similar to E"
 };
 
+/* Brightness of a "midi_note" message, out of 256, as a function of its
+   velocity: quadratic from VELOCITY_FLOOR at velocity 1 to 256 at velocity
+   127 (see `velocity_init()`). Velocity 0 is dark. */
+#define VELOCITY_FLOOR 48
+
+struct placement {
+    uint8_t n_lower;    /* Lower groups of panels lit, in [0, 6]. */
+    uint8_t n_top;      /* Groups of 4 LEDs of "Top" lit, in [0, 2]. */
+};
+
+/* Indexed by MIDI note number / 12, i.e. octave + 1 (C4 is 60). */
+static const struct placement octave_placement[11] = {
+    {6, 0}, {6, 0}, {6, 0},     /* C-1 to B1 */
+    {5, 0},                     /* C2 to B2 */
+    {5, 1},                     /* C3 to B3 */
+    {4, 1},                     /* C4 to B4 */
+    {3, 1},                     /* C5 to B5 */
+    {3, 2},                     /* C6 to B6 */
+    {2, 2}, {2, 2}, {2, 2}      /* C7 to G9 */
+};
+
+static uint16_t velocity_level[128];    /* Brightness, out of 256. */
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //  Drone-related constants
@@ -149,9 +194,6 @@ const uint32_t map_cs_to_color[] = {
 _Static_assert((DRONE_MICROSEC_UP + DRONE_MICROSEC_DOWN) ==
                 DRONE_MICROSEC_ITERATION, "Invalid drone times.");
 
-static uint32_t drone_delay_up = DRONE_MICROSEC_UP / DRONE_BRIGHTNESS_N;
-static uint32_t drone_delay_down = DRONE_MICROSEC_DOWN / DRONE_BRIGHTNESS_N;
-
 struct color drone_color = {255, 0, 0};
 static struct color *drone_brightness;
 
@@ -164,306 +206,2785 @@ const int config = WS2811_RGB | WS2811_800kHz;
 DMAMEM int displayMemory[N_LEDS_PER_STRIP * 6];
 int drawingMemory[N_LEDS_PER_STRIP * 6];
 
-OctoWS2811 leds(N_LEDS_PER_STRIP, displayMemory, drawingMemory, config);
+OctoWS2811 leds(N_LEDS_PER_STRIP, displayMemory, drawingMemory, config);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Framebuffer. Renderers (notes, the drone, the frame mailbox) draw into
+//               `fb_target` and call `fb_commit()`, which computes the
+//               frame to show into `fb_shown` and hands it to OctoWS2811.
+//               Both are structure-of-arrays: separate R, G and B planes of
+//               FB_PLANE bytes, LED `i` at byte `i` of each plane, the 88
+//               LEDs padded to 96 so that each plane is a whole number of
+//               32-byte cache lines. A word of a plane is one channel of 4
+//               LEDs, so every pass (afterglow, recoloring) processes 4 LEDs
+//               per instruction whatever the channel, and the padding LEDs
+//               stay black. Only `fb_commit()` converts to the packed layout
+//               in address order (`fb_packed`), once per frame, for
+//               OctoWS2811 and for the frame hash.
+//
+//               Afterglow: when enabled by the "afterglow" message, each
+//               committed frame is
+//
+//                   shown = max(target, shown * decay / 256)
+//
+//               byte by byte, with a decay factor per group and channel, and
+//               `loop()` commits a frame every AFTERGLOW_FRAME_US while
+//               anything is still fading. Notes therefore leave trails
+//               without any host streaming or per-note bookkeeping.
+//
+//               On the Cortex-M7 the passes use the DSP extension: UXTB16
+//               splits a word into two 16-bit lanes of bytes, each lane is
+//               multiplied by its factor (SMULBB/SMULTT), and USUB8/SEL take
+//               bytewise maxima and masks. Elsewhere portable loops compute
+//               the same results. The cycles spent in the last commit, up to
+//               the hand-off to OctoWS2811, are reported by "telemetry".
+//
+//               Adaptive refresh: the WS2811 LEDs hold their color until told
+//               otherwise, so a committed frame is only handed to OctoWS2811
+//               (`fb_show()`) if it differs from the one on the LEDs, which
+//               the packing pass finds at no extra cost. Fast transitions
+//               are thus shown at the rate they are committed, while e.g. a
+//               sustained note, or the 19 of the 200 steps of a drone
+//               breath whose 8-bit red repeats the step before (9 each way
+//               at the dim end of its quadratic curve, and the peak), cost
+//               no transfer. While nothing changes, `loop()` re-sends the
+//               frame every FB_KEEPALIVE_US, in case an LED picked up noise.
+//               Event edges are driven by the clock (see "Executor"), not by
+//               shows, so skipping a show never delays one; the transfer
+//               itself runs by DMA. Shows, skipped shows and the time spent
+//               in the driver are counted for "telemetry".
+//
+//               Audio modulation: the packing pass scales each LED by the
+//               gain of its group, `fb_gain` (out of 256), which "bands"
+//               messages set from the envelope of the audio (see "Audio
+//               bands"). Only the packed frame is scaled, so the afterglow
+//               and every renderer work on unmodulated levels, and with all
+//               gains at 256 the frame shown is exactly the one committed.
+//               A change of gains alone is shown by `fb_present()`, which
+//               packs `fb_shown` again without an afterglow step.
+///////////////////////////////////////////////////////////////////////////////
+#define FB_PLANE 96                     /* Bytes per plane. */
+#define FB_PLANE_WORDS (FB_PLANE / 4)
+#define FB_WORDS (3 * FB_PLANE_WORDS)
+#define FB_R 0                          /* Offsets of the planes. */
+#define FB_G FB_PLANE
+#define FB_B (2 * FB_PLANE)
+#define FB_BYTES (N_LEDS * 3)           /* Packed frame. */
+#define FB_KEEPALIVE_US 1000000         /* Longest time between shows. */
+
+_Static_assert(FB_PLANE % 32 == 0 && FB_PLANE >= N_LEDS,
+               "Framebuffer planes are not padded to cache lines.");
+
+#ifdef ARM_DWT_CYCCNT
+#define CYCLE_COUNT() ARM_DWT_CYCCNT
+#else
+#define CYCLE_COUNT() 0
+#endif
+
+/* Frame drawn by the renderers, and frame last shown. */
+static uint32_t fb_target_w[FB_WORDS] __attribute__((aligned(32)));
+static uint32_t fb_shown_w[FB_WORDS] __attribute__((aligned(32)));
+static uint8_t *const fb_target = (uint8_t *) fb_target_w;
+static uint8_t *const fb_shown = (uint8_t *) fb_shown_w;
+static uint8_t fb_packed[FB_BYTES];      /* `fb_shown` in address order. */
+static uint32_t fb_commit_cycles = 0;    /* Cycles of the last commit. */
+static uint32_t fb_shows = 0;            /* Frames handed to OctoWS2811. */
+static uint32_t fb_shows_skipped = 0;    /* Commits of the frame shown. */
+static uint32_t fb_show_us = 0;          /* Time spent in `fb_show()`. */
+static uint32_t fb_show_t0 = 0;          /* micros() at the last show. */
+
+/* Decay factors of bytes 0 and 2 (`fb_decay_02`) and 1 and 3
+   (`fb_decay_13`) of each word, as 16-bit lanes. */
+static uint32_t fb_decay_02[FB_WORDS];
+static uint32_t fb_decay_13[FB_WORDS];
+
+static uint8_t led_group[N_LEDS];        /* Group of each LED. */
+static uint16_t fb_gain[7];              /* Per group, out of 256. */
+static uint8_t fb_gain_changed = 0;     /* Since the last present? */
+static uint8_t afterglow_enabled = 0;
+static uint8_t afterglow_active = 0;     /* Is anything still fading? */
+static uint32_t afterglow_t0 = 0;        /* micros() at the last commit. */
+
+
+/*****************************************************************************
+ *  fb_init_groups: Initializes `led_group` from the `group_*` arrays.
+ *****************************************************************************/
+void
+fb_init_groups(void)
+{
+    int j, k;
+
+    for (j = 0; j < 4; j++)
+    {
+        for (k = 0; k < 4; k++)
+        {
+            led_group[group_f[j][k]] = GROUP_F;
+            led_group[group_b[j][k]] = GROUP_B;
+        }
+    }
+    for (j = 0; j < 3; j++)
+    {
+        for (k = 0; k < 4; k++)
+        {
+            led_group[group_ll[j][k]] = GROUP_LL;
+            led_group[group_lr[j][k]] = GROUP_LR;
+            led_group[group_rl[j][k]] = GROUP_RL;
+            led_group[group_rr[j][k]] = GROUP_RR;
+        }
+    }
+    for (j = 80; j < 88; j++)
+    {
+        led_group[j] = GROUP_TOP;
+    }
+    for (j = 0; j < 7; j++)
+    {
+        fb_gain[j] = 256;
+    }
+}
+
+
+/*****************************************************************************
+ *  fb_set_pixel: Sets LED `i` of the target frame to `color` (0xRRGGBB).
+ *****************************************************************************/
+void
+fb_set_pixel(size_t i, uint32_t color)
+{
+    fb_target[FB_R + i] = color >> 16;
+    fb_target[FB_G + i] = color >> 8;
+    fb_target[FB_B + i] = color;
+}
+
+
+/*****************************************************************************
+ *  fb_set_pixel_rgb: Sets LED `i` of the target frame to
+ *                    (`red`, `green`, `blue`).
+ *****************************************************************************/
+void
+fb_set_pixel_rgb(size_t i, uint8_t red, uint8_t green, uint8_t blue)
+{
+    fb_target[FB_R + i] = red;
+    fb_target[FB_G + i] = green;
+    fb_target[FB_B + i] = blue;
+}
+
+
+/*****************************************************************************
+ *  fb_set_packed: Sets the target frame from `rgb`, the R, G and B of each
+ *                 LED in address order.
+ *****************************************************************************/
+void
+fb_set_packed(const uint8_t *rgb)
+{
+    for (size_t i = 0; i < N_LEDS; i++, rgb += 3)
+    {
+        fb_set_pixel_rgb(i, rgb[0], rgb[1], rgb[2]);
+    }
+}
+
+
+/*****************************************************************************
+ *  fb_clear: Sets every LED of the target frame to black.
+ *****************************************************************************/
+void
+fb_clear(void)
+{
+    memset(fb_target_w, 0, sizeof fb_target_w);
+}
+
+
+/*****************************************************************************
+ *  fb_recolor: Sets every lit LED of the target frame to `color`.
+ *****************************************************************************/
+void
+fb_recolor(uint32_t color)
+{
+    uint32_t *r = &fb_target_w[0];
+    uint32_t *g = &fb_target_w[FB_PLANE_WORDS];
+    uint32_t *b = &fb_target_w[2 * FB_PLANE_WORDS];
+
+#if defined(__ARM_FEATURE_SIMD32) && defined(__ARM_FEATURE_DSP)
+    uint32_t fill_r = 0x01010101 * (color >> 16 & 0xFF);
+    uint32_t fill_g = 0x01010101 * (color >> 8 & 0xFF);
+    uint32_t fill_b = 0x01010101 * (color & 0xFF);
+
+    for (size_t w = 0; w < FB_PLANE_WORDS; w++)
+    {
+        /* GE flags set where 0 >= r | g | b, i.e. where the LED is off. */
+        __usub8(0, r[w] | g[w] | b[w]);
+        r[w] = __sel(r[w], fill_r);
+        g[w] = __sel(g[w], fill_g);
+        b[w] = __sel(b[w], fill_b);
+    }
+#else
+    uint8_t *r8 = (uint8_t *) r, *g8 = (uint8_t *) g, *b8 = (uint8_t *) b;
+
+    for (size_t i = 0; i < N_LEDS; i++)
+    {
+        if (r8[i] | g8[i] | b8[i])
+        {
+            r8[i] = color >> 16;
+            g8[i] = color >> 8;
+            b8[i] = color;
+        }
+    }
+#endif
+}
+
+
+/*****************************************************************************
+ *  fb_show: Hands the packed frame to OctoWS2811.
+ *****************************************************************************/
+void
+fb_show(void)
+{
+    uint32_t t0 = micros();
+    const uint8_t *p = fb_packed;
+
+    for (size_t i = 0; i < N_LEDS; i++, p += 3)
+    {
+        leds.setPixel(i, p[0], p[1], p[2]);
+    }
+    leds.show();
+    fb_show_t0 = micros();
+    fb_show_us += fb_show_t0 - t0;
+    fb_shows++;
+}
+
+
+/*****************************************************************************
+ *  fb_commit: Computes the frame to show from the target frame and shows
+ *             it, unless it is already on the LEDs.
+ *****************************************************************************/
+void
+fb_commit(void)
+{
+    uint32_t t0 = CYCLE_COUNT();
+
+    if (afterglow_enabled)
+    {
+        afterglow_active = (afterglow_pass() != 0);
+    }
+    else
+    {
+        memcpy(fb_shown_w, fb_target_w, sizeof fb_shown_w);
+    }
+    fb_present(t0);
+    afterglow_t0 = micros();
+}
+
+
+/*****************************************************************************
+ *  fb_present: Packs `fb_shown`, scaled by the group gains, and shows it
+ *              unless it is already on the LEDs. `t0` is the cycle count at
+ *              which the frame's computation started.
+ *****************************************************************************/
+void
+fb_present(uint32_t t0)
+{
+    uint8_t *p = fb_packed;
+    uint8_t changed = 0;
+    uint32_t hash;
+
+    for (size_t i = 0; i < N_LEDS; i++, p += 3)
+    {
+        uint32_t gain = fb_gain[led_group[i]];
+        uint8_t r = (fb_shown[FB_R + i] * gain) >> 8;
+        uint8_t g = (fb_shown[FB_G + i] * gain) >> 8;
+        uint8_t b = (fb_shown[FB_B + i] * gain) >> 8;
+
+        changed |= (p[0] ^ r) | (p[1] ^ g) | (p[2] ^ b);
+        p[0] = r;
+        p[1] = g;
+        p[2] = b;
+    }
+    hash = crc32(fb_packed, FB_BYTES);
+    fb_commit_cycles = CYCLE_COUNT() - t0;
+    if (changed)
+    {
+        fb_show();
+    }
+    else
+    {
+        fb_shows_skipped++;
+    }
+    fb_gain_changed = 0;
+    frame_hash_record(hash, micros());
+}
+
+
+/*****************************************************************************
+ *  afterglow_set: Executes an "afterglow" message.
+ *****************************************************************************/
+void
+afterglow_set(const struct msg_afterglow *afterglow)
+{
+    uint8_t f[4];
+    size_t w, j, byte, led;
+
+    afterglow_enabled = 0;
+    for (j = 0; j < sizeof afterglow->decay; j++)
+    {
+        afterglow_enabled |= (afterglow->decay[j] != 0);
+    }
+    afterglow_active = afterglow_enabled;
+
+    for (w = 0; w < FB_WORDS; w++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            byte = 4 * w + j;
+            led = byte % FB_PLANE;
+            f[j] = (led < N_LEDS) ?
+                   afterglow->decay[3 * led_group[led] + byte / FB_PLANE] : 0;
+        }
+        fb_decay_02[w] = f[0] | ((uint32_t) f[2] << 16);
+        fb_decay_13[w] = f[1] | ((uint32_t) f[3] << 16);
+    }
+}
+
+
+/*****************************************************************************
+ *  afterglow_pass: Computes `fb_shown` as max(target, shown * decay / 256)
+ *                  byte by byte. Returns nonzero if the result differs from
+ *                  the target (i.e. something is still fading).
+ *****************************************************************************/
+uint32_t
+afterglow_pass(void)
+{
+    uint32_t fading = 0;
+
+#if defined(__ARM_FEATURE_SIMD32) && defined(__ARM_FEATURE_DSP)
+    for (size_t w = 0; w < FB_WORDS; w++)
+    {
+        uint32_t shown = fb_shown_w[w];
+        uint32_t target = fb_target_w[w];
+        uint32_t s02 = __uxtb16(shown);            /* Bytes 0 and 2. */
+        uint32_t s13 = __uxtb16(__ror(shown, 8));  /* Bytes 1 and 3. */
+        uint32_t p02, p13, decayed, out;
+
+        /* Products fit in 16 bits; keep their high bytes in place. */
+        p02 = (uint32_t) __smulbb(s02, fb_decay_02[w]) |
+              ((uint32_t) __smultt(s02, fb_decay_02[w]) << 16);
+        p13 = (uint32_t) __smulbb(s13, fb_decay_13[w]) |
+              ((uint32_t) __smultt(s13, fb_decay_13[w]) << 16);
+        decayed = ((p02 >> 8) & 0x00FF00FF) | (p13 & 0xFF00FF00);
+
+        /* Bytewise max: GE flags set where target >= decayed. */
+        __usub8(target, decayed);
+        out = __sel(target, decayed);
+
+        fb_shown_w[w] = out;
+        fading |= out ^ target;
+    }
+#else
+    for (size_t w = 0; w < FB_WORDS; w++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            uint32_t f = ((j & 1) ? fb_decay_13[w] : fb_decay_02[w]) >>
+                         ((j & 2) ? 16 : 0) & 0xFF;
+            uint8_t *shown = &fb_shown[4 * w + j];
+            uint8_t target = fb_target[4 * w + j];
+            uint8_t decayed = (*shown * f) >> 8;
+
+            *shown = (target >= decayed) ? target : decayed;
+            fading |= *shown ^ target;
+        }
+    }
+#endif
+    return fading;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Frame hashes. Every committed frame is hashed with CRC-32 (the same CRC as
+//                zlib's `crc32()`, so the Python program can compute it for
+//                the frames it expects), and the hashes of the last
+//                FRAME_HASH_N frames are kept with the time at which each
+//                was shown. "get_hashes" reads them back.
+//
+//                The CRC is computed a byte at a time with a 1 KB table
+//                built at startup: one lookup per byte, a few microseconds
+//                per 264-byte frame.
+///////////////////////////////////////////////////////////////////////////////
+static uint32_t crc_table[256];
+static uint32_t frame_hash_crc[FRAME_HASH_N];
+static uint32_t frame_hash_t_us[FRAME_HASH_N];
+static uint32_t frame_hash_count = 0;    /* Frames committed so far. */
+
+
+/*****************************************************************************
+ *  crc32_init: Builds the table for the reflected CRC-32 polynomial
+ *              0xEDB88320.
+ *****************************************************************************/
+void
+crc32_init(void)
+{
+    for (uint32_t n = 0; n < 256; n++)
+    {
+        uint32_t c = n;
+
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        }
+        crc_table[n] = c;
+    }
+}
+
+
+/*****************************************************************************
+ *  crc32: Returns the CRC-32 of the `len` bytes at `buf`.
+ *****************************************************************************/
+uint32_t
+crc32(const uint8_t *buf, size_t len)
+{
+    uint32_t c = 0xFFFFFFFF;
+
+    while (len--)
+    {
+        c = crc_table[(c ^ *buf++) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFF;
+}
+
+
+/*****************************************************************************
+ *  frame_hash_record: Records that a frame with CRC `crc` was shown at
+ *                     `t_us`.
+ *****************************************************************************/
+void
+frame_hash_record(uint32_t crc, uint32_t t_us)
+{
+    size_t i = frame_hash_count++ % FRAME_HASH_N;
+
+    frame_hash_crc[i] = crc;
+    frame_hash_t_us[i] = t_us;
+}
+
+
+/*****************************************************************************
+ *  send_hashes: Stages a "hashes" frame, newest hash first.
+ *****************************************************************************/
+void
+send_hashes(void)
+{
+    uint8_t buf[MSG_HASHES_LEN];
+    struct msg_hashes hashes;
+    uint32_t n = (frame_hash_count < FRAME_HASH_N) ? frame_hash_count
+                                                   : FRAME_HASH_N;
+
+    memset(&hashes, 0, sizeof hashes);
+    hashes.count = frame_hash_count;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        size_t i = (frame_hash_count - 1 - k) % FRAME_HASH_N;
+
+        hashes.crc[k] = frame_hash_crc[i];
+        hashes.t_us[k] = frame_hash_t_us[i];
+    }
+    tx_stage(buf, encode_hashes(buf, &hashes));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Executor. Notes and the drone are rendered without blocking, so that
+//            `parse()` keeps accepting commands while the lights are on.
+//            `exec_begin()` starts a timed step and `exec_step()`, called on
+//            every pass of `loop()`, ends it once its time has elapsed.
+//
+//            The "event" edges of notes and chords are scheduled separately
+//            from their lights (see "Latency compensation") and sent by
+//            `edge_poll()` when due. A message whose lights are done but
+//            whose edges are not waits in EXEC_EDGES, so that events stay
+//            in order, unless the next message is a note or chord: its
+//            edges come after them, so they are carried (`edge_carry()`)
+//            and sent ahead of its own, and it starts at once.
+///////////////////////////////////////////////////////////////////////////////
+#define EXEC_IDLE       0   /* Ready for the next command. */
+#define EXEC_NOTE       1   /* A note is lit. */
+#define EXEC_DRONE      2   /* The drone is running. */
+#define EXEC_NOTE_WAIT  3   /* A note waits for its quantized start. */
+#define EXEC_CHORD      4   /* A chord is lit. */
+#define EXEC_CHORD_WAIT 5   /* A chord waits for its quantized start. */
+#define EXEC_EDGES      6   /* Lights done; events still due. */
+#define EXEC_FADE       7   /* A note is crossfading into its color. */
+#define EXEC_PROGRAM    8   /* A light program is waiting. */
+
+static uint8_t exec_state = EXEC_IDLE;
+static uint32_t exec_t0 = 0;             /* micros() at the current step. */
+static uint32_t exec_wait = 0;           /* Length of the current step. */
+
+static uint64_t edge_t[2];               /* micros64() of each edge. */
+static uint8_t edge_pending = 0;         /* Bit `edge`: not sent yet. */
+static uint16_t carry_seq;               /* Message whose edges are */
+static uint64_t carry_t[2];              /* carried, as `edge_t` and */
+static uint8_t carry_pending = 0;        /* `edge_pending`. */
+
+static uint32_t note_color;              /* Note being executed. */
+static uint32_t note_duration_us;
+static int8_t note_octave = -1;          /* -1 for a "note" message. */
+static uint8_t note_pc;                  /* Pitch class. */
+static uint16_t note_level;              /* Brightness, out of 256. */
+static uint64_t note_end_t;              /* micros64() at which the note's
+                                            step ends. */
+
+
+/*****************************************************************************
+ *  exec_begin: Enters state `state` for `microsec` microseconds.
+ *****************************************************************************/
+void
+exec_begin(uint8_t state, uint32_t microsec)
+{
+    exec_state = state;
+    exec_t0 = micros();
+    exec_wait = microsec;
+}
+
+
+/*****************************************************************************
+ *  exec_end: Ends the message being executed once its lights are done.
+ *****************************************************************************/
+void
+exec_end(void)
+{
+    exec_state = edge_pending ? EXEC_EDGES : EXEC_IDLE;
+}
+
+
+/*****************************************************************************
+ *  exec_step: Sends the edges that are due, and ends the current step once
+ *             its time has elapsed.
+ *****************************************************************************/
+void
+exec_step(void)
+{
+    edge_poll();
+    if (exec_state == EXEC_EDGES)
+    {
+        if (!edge_pending || edge_carry())
+        {
+            exec_state = EXEC_IDLE;
+        }
+        return;
+    }
+    if ((uint32_t) (micros() - exec_t0) < exec_wait)
+    {
+        return;
+    }
+
+    switch (exec_state)
+    {
+    case EXEC_NOTE:
+        note_finish();
+        break;
+    case EXEC_DRONE:
+        drone_step();
+        break;
+    case EXEC_NOTE_WAIT:
+        note_start();
+        break;
+    case EXEC_CHORD:
+        chord_step();
+        break;
+    case EXEC_CHORD_WAIT:
+        chord_start();
+        break;
+    case EXEC_FADE:
+        xfade_step();
+        break;
+    case EXEC_PROGRAM:
+        vm_step();
+        break;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Tempo clock. The Python program derives every duration from a tempo
+//               (`60 / bpm`, `30 / bpm`, `20 / bpm`), and the "tempo"
+//               message hands that tempo to the microcontroller, together
+//               with the time of beat 0. Effects are then locked to the
+//               musical grid without any per-beat message.
+//
+//               Times are kept in 64-bit microseconds (`micros64()`), and
+//               the time of point n of a grid of `div` points per beat is
+//               computed from n directly,
+//
+//                   beat0 + ceil(n * 60e9 / (bpm_milli * div)),
+//
+//               so rounding never accumulates from one beat to the next.
+//               All products fit in 64 bits for about 19 hours after beat 0.
+///////////////////////////////////////////////////////////////////////////////
+#define US_PER_MILLIBEAT 60000000000ull  /* Microseconds per beat at
+                                            bpm_milli == 1. */
+
+static uint32_t tempo_bpm_milli = 0;     /* 0 if there is no tempo. */
+static uint64_t tempo_beat0 = 0;         /* micros64() at beat 0. */
+static uint8_t tempo_beats_per_bar = 0;  /* 0 for no accents. */
+static uint8_t tempo_quantize = 0;       /* Grid points per beat, or 0. */
+static uint8_t tempo_drone_sync = 0;     /* Lock the drone to the beat? */
+
+
+/*****************************************************************************
+ *  micros64: Returns micros() extended to 64 bits. Must be called at least
+ *            once every 71 minutes, which `loop()` does.
+ *****************************************************************************/
+uint64_t
+micros64(void)
+{
+    static uint32_t last = 0;
+    static uint64_t high = 0;
+    uint32_t now = micros();
+
+    if (now < last)
+    {
+        high += 1ull << 32;
+    }
+    last = now;
+    return high | now;
+}
+
+
+/*****************************************************************************
+ *  tempo_set: Executes a "tempo" message.
+ *****************************************************************************/
+void
+tempo_set(const struct msg_tempo *tempo)
+{
+    uint64_t now = micros64();
+
+    tempo_bpm_milli = tempo->bpm_milli;
+    /* `beat0_us` is within 35 minutes of now, either way. */
+    tempo_beat0 = now + (int32_t) (tempo->beat0_us - (uint32_t) now);
+    tempo_beats_per_bar = tempo->beats_per_bar;
+    tempo_quantize = tempo->quantize;
+    tempo_drone_sync = tempo->drone_sync;
+}
+
+
+/*****************************************************************************
+ *  tempo_grid_time: Returns the time of point `n` of a grid of `div` points
+ *                   per beat.
+ *****************************************************************************/
+uint64_t
+tempo_grid_time(uint64_t n, uint32_t div)
+{
+    uint64_t q = (uint64_t) tempo_bpm_milli * div;
+
+    return tempo_beat0 + (n * US_PER_MILLIBEAT + q - 1) / q;
+}
+
+
+/*****************************************************************************
+ *  tempo_grid_index: Returns the index of the last point of a grid of `div`
+ *                    points per beat at or before time `t` >= beat 0.
+ *****************************************************************************/
+uint64_t
+tempo_grid_index(uint64_t t, uint32_t div)
+{
+    return (t - tempo_beat0) * tempo_bpm_milli * div / US_PER_MILLIBEAT;
+}
+
+
+/*****************************************************************************
+ *  tempo_next: Returns the time of the first point of a grid of `div`
+ *              points per beat at or after time `t`.
+ *****************************************************************************/
+uint64_t
+tempo_next(uint64_t t, uint32_t div)
+{
+    uint64_t n, g;
+
+    if (t <= tempo_beat0)
+    {
+        return tempo_beat0;
+    }
+    n = tempo_grid_index(t, div);
+    g = tempo_grid_time(n, div);
+    return (g == t) ? g : tempo_grid_time(n + 1, div);
+}
+
+
+/*****************************************************************************
+ *  tempo_quantized_start: Returns the time at which a note taken off the
+ *                         queue at time `t` starts: the nearest point of the
+ *                         quantization grid, or `t` if that point has
+ *                         already passed.
+ *****************************************************************************/
+uint64_t
+tempo_quantized_start(uint64_t t)
+{
+    uint64_t n, a, b;
+
+    if (tempo_bpm_milli == 0 || tempo_quantize == 0)
+    {
+        return t;
+    }
+    if (t <= tempo_beat0)
+    {
+        return tempo_beat0;
+    }
+    n = tempo_grid_index(t, tempo_quantize);
+    a = tempo_grid_time(n, tempo_quantize);
+    b = tempo_grid_time(n + 1, tempo_quantize);
+    return (t - a <= b - t) ? t : b;
+}
+
+
+/*****************************************************************************
+ *  tempo_note_start: Returns the time at which a note taken off the queue
+ *                    at time `t` starts: point `step` of the quantization
+ *                    grid, even if it has already passed, so that a note
+ *                    that arrives late does not shift the ones after it.
+ *                    Without a grid, or for NO_STEP, the note starts as
+ *                    `tempo_quantized_start()` places it.
+ *****************************************************************************/
+uint64_t
+tempo_note_start(uint64_t t, uint16_t step)
+{
+    if (step == NO_STEP || tempo_bpm_milli == 0 || tempo_quantize == 0)
+    {
+        return tempo_quantized_start(t);
+    }
+    return tempo_grid_time(step, tempo_quantize);
+}
+
+
+/*****************************************************************************
+ *  tempo_is_downbeat: Returns 1 if time `t` is within an eighth of a beat
+ *                     of the first beat of a bar, 0 otherwise (or if
+ *                     accents are off).
+ *****************************************************************************/
+int
+tempo_is_downbeat(uint64_t t)
+{
+    uint64_t u, eighths;
+
+    if (tempo_bpm_milli == 0 || tempo_beats_per_bar == 0)
+    {
+        return 0;
+    }
+    /* Shift by an eighth of a beat, so that the window around each beat
+       is [0, 2) eighths. */
+    u = t + US_PER_MILLIBEAT / 8 / tempo_bpm_milli;
+    if (u < tempo_beat0)
+    {
+        return 0;
+    }
+    eighths = tempo_grid_index(u, 8);
+    return (eighths % 8 < 2) && ((eighths / 8) % tempo_beats_per_bar == 0);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Latency compensation. The lights and the sound reach the audience through
+//                        different paths: USB, parsing and the WS2811 data
+//                        (about 0.5 ms per 16 LEDs, plus the reset) on one
+//                        side; the host's MIDI output, the sampler and the
+//                        sound card buffer on the other. The host starts
+//                        each sound on the "event" of its note, so the
+//                        "latency" message shifts the lights of notes and
+//                        chords by `latency_us` relative to their events.
+//
+//                        A note taken off the queue at `now` is scheduled
+//                        to start at its (quantized, or given) start N, at
+//                        which EVENT_STARTED is sent; its lights go on at
+//                        N + `latency_us` and stay on for its duration, and
+//                        EVENT_FINISHED is sent at N plus its duration.
+//                        When the offset is negative, a quantized N is
+//                        chosen no earlier than now - `latency_us`, so that
+//                        the lights can still go on ahead of the event.
+//
+//                        The next message is taken off the queue at the
+//                        EVENT_FINISHED edge, so that its schedule depends
+//                        only on the edges. When the offset is positive,
+//                        the lights are then still on for `latency_us`:
+//                        they finish as a "tail" (`tail_poll()`), going
+//                        off just as the next note's lights go on, unless
+//                        another message takes over the lights first. When
+//                        it is negative, the lights are done before the
+//                        edge: a note or chord queued behind is taken off
+//                        the queue then, with the edges carried, and placed
+//                        at the carried EVENT_FINISHED instead.
+///////////////////////////////////////////////////////////////////////////////
+#define TAIL_NONE  0    /* No lights outlast their message. */
+#define TAIL_NOTE  1    /* A note's lights go off at `tail_t`. */
+#define TAIL_CHORD 2    /* A chord's next note goes off at `tail_t`. */
+
+static int32_t latency_us = 0;
+static uint8_t tail = TAIL_NONE;
+static uint64_t tail_t = 0;              /* micros64() of the tail's next
+                                            step. */
+
+
+/*****************************************************************************
+ *  latency_set: Executes a "latency" message. Returns 0 if the offset is
+ *               out of range.
+ *****************************************************************************/
+int
+latency_set(const struct msg_latency *latency)
+{
+    if (latency->offset_us > LATENCY_MAX_US ||
+        latency->offset_us < -LATENCY_MAX_US)
+    {
+        return 0;
+    }
+    latency_us = latency->offset_us;
+    return 1;
+}
+
+
+/*****************************************************************************
+ *  latency_schedule: Schedules the edges of a note or chord taken off the
+ *                    queue now, lasting `duration_us` and starting on grid
+ *                    point `step` (see `tempo_note_start()`). Returns the
+ *                    time at which its lights go on.
+ *****************************************************************************/
+uint64_t
+latency_schedule(uint32_t duration_us, uint16_t step)
+{
+    uint64_t t = micros64();
+    uint64_t start;
+
+    if (carry_pending & (1 << EVENT_FINISHED))
+    {
+        t = carry_t[EVENT_FINISHED];
+    }
+    else if (latency_us < 0)
+    {
+        t += (uint64_t) -latency_us;
+    }
+    start = tempo_note_start(t, step);
+
+    edge_schedule(EVENT_STARTED, start);
+    edge_schedule(EVENT_FINISHED, start + duration_us);
+    return start + latency_us;
+}
+
+
+/*****************************************************************************
+ *  tail_poll: Turns off the lights of an ended message that are due.
+ *****************************************************************************/
+void
+tail_poll(void)
+{
+    uint64_t now;
+
+    if (tail == TAIL_NONE || (now = micros64()) < tail_t)
+    {
+        return;
+    }
+    if (tail == TAIL_NOTE)
+    {
+        all_lights_off();
+        tail = TAIL_NONE;
+        return;
+    }
+    tail_t = chord_lights_off(now);
+    if (tail_t == UINT64_MAX)
+    {
+        tail = TAIL_NONE;
+    }
+}
+
+
+/*****************************************************************************
+ *  tail_finish: Turns off the lights of an ended message still on, before
+ *               a message that draws its own.
+ *****************************************************************************/
+void
+tail_finish(void)
+{
+    if (tail == TAIL_NOTE)
+    {
+        all_lights_off();
+    }
+    else if (tail == TAIL_CHORD)
+    {
+        chord_lights_off(UINT64_MAX);
+    }
+    tail = TAIL_NONE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Crossfades. Consecutive notes jump from one color of `map_cs_to_color` to
+//              the next, with a moment of black in between. When enabled by
+//              the "crossfade" message, a note instead starts in the color
+//              of the previous note and glides into its own over
+//              `xfade_us` (at most half the note), one frame every
+//              AFTERGLOW_FRAME_US. The colors come from the ramps of
+//              `_colors.h`, interpolated in OKLab by `_colorgen.py`, so
+//              that e.g. red to violet does not pass through grey; each
+//              frame costs two table lookups and a blend. Only consecutive
+//              notes crossfade; a chord or the drone in between starts
+//              afresh.
+///////////////////////////////////////////////////////////////////////////////
+#define NO_PC 0xFF
+
+static uint32_t xfade_us = 0;            /* 0: crossfades off. */
+static uint8_t xfade_from = NO_PC;       /* Pitch class of the last note. */
+static uint8_t xfade_src;                /* Pitch class faded from. */
+static uint32_t xfade_k = 0;             /* Frame of the crossfade. */
+static uint32_t xfade_n = 0;             /* Frames in the crossfade. */
+static uint32_t xfade_t0 = 0;            /* micros() when the note went on. */
+
+
+/*****************************************************************************
+ *  xfade_begin: Sets up the crossfade into the note being executed, if any,
+ *               and returns the color in which it starts.
+ *****************************************************************************/
+uint32_t
+xfade_begin(void)
+{
+    uint32_t fade_us = xfade_us;
+    uint8_t from = xfade_from;
+    uint64_t now = micros64(), left;
+
+    xfade_from = note_pc;
+    xfade_n = 0;
+    xfade_t0 = micros();
+    if (from == NO_PC || from == note_pc)
+    {
+        return note_color;
+    }
+    if (fade_us > note_duration_us / 2)
+    {
+        fade_us = note_duration_us / 2;
+    }
+    /* The fade must be over by the end of the note's step. */
+    left = (note_end_t > now) ? note_end_t - now : 0;
+    if (fade_us > left)
+    {
+        fade_us = left;
+    }
+    xfade_n = fade_us / AFTERGLOW_FRAME_US;
+    if (xfade_n == 0)
+    {
+        return note_color;
+    }
+    xfade_k = 0;
+    xfade_src = from;
+    return scale_color(color_ramp_at(from, note_pc, 0, xfade_n), note_level);
+}
+
+
+/*****************************************************************************
+ *  xfade_step: Shows the next frame of the crossfade. After the last one,
+ *              the note stays lit for the rest of its duration.
+ *****************************************************************************/
+void
+xfade_step(void)
+{
+    uint32_t color;
+    int32_t left;
+
+    xfade_k++;
+    color = color_ramp_at(xfade_src, note_pc, xfade_k, xfade_n);
+    fb_recolor(scale_color(color, note_level));
+    fb_commit();
+    exec_t0 += AFTERGLOW_FRAME_US;
+    if (xfade_k < xfade_n)
+    {
+        return;
+    }
+    left = (int32_t) ((uint32_t) note_end_t - exec_t0);
+    exec_state = EXEC_NOTE;
+    exec_wait = (left > 0) ? left : 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Parser. The Python program sends USB-serial messages to the program
+//          uploaded on the microcontroller. Every message is a frame
+//          starting with the character '%' and ending with the character
+//          '&'; message[1] is the opcode, which determines the length of the
+//          frame. The messages, their opcodes and their fields are defined
+//          in `_protocol_schema.py`, from which `_codegen.py` generates the
+//          codec in `_protocol.h` (and the matching Python codec). Do not
+//          hand-code frame layouts here.
+//
+//          The original messages are 11 bytes long:
+//              "drone off" message <==> "%0\0\0\0\0\0\0\0\0&"
+//              "drone on" message  <==> "%1\0\0\0\0\0\0\0\0&"
+//              "note" message      <==> "%2" + pitch class (integer in
+//                                       [0, 11]) + up to 7 ASCII digits
+//                                       giving the duration in
+//                                       microseconds, '\0'-padded + "&"
+//
+//          The Python program sets a timeout of 0, which means that an
+//          attempt will be made to ask the OS to write the full message
+//          through the serial port but it is possible that the call fails to
+//          write the full message. Because the timeout is set to 0, the
+//          Python program does not attempt to write the rest of the message.
+//          The return value of the OS call the Python program makes ends up
+//          being the number of bytes actually written. The Python program
+//          can therefore detect in advance whether or not the write was
+//          fully successful. If it was not fully successful, the Python
+//          program will restart the computer (==> restarting the micro-contr.
+//          as well).
+//
+//          The Python program expects an "ack" frame from the microcontroller
+//          for every message, carrying the message's sequence number and the
+//          time at which it was accepted. If it does not receive a response,
+//          the Python program will restart the computer.
+//
+//          Frames are received incrementally: a frame may arrive across
+//          several calls to `parse()`, and several frames may arrive at once
+//          (the Python program can send a batch in a single write). Bytes
+//          that cannot start a frame are skipped until the next '%'.
+//
+//          Complete frames are accepted into a queue of CMD_QUEUE_LEN slots
+//          and executed in order by `loop()`; the ack is sent when a message
+//          is taken off the queue. Nothing is ever discarded for lack of
+//          space: while the queue is full, `parse()` stops reading at the
+//          opcode of a command frame, holding it back until a slot frees,
+//          and the ack carries a credit limit (messages accepted so far plus
+//          free slots) beyond which the Python program does not send. Since
+//          slots are only freed when messages are taken off the queue, every
+//          credit update rides on an ack. Frames are assembled in `rx_frame`
+//          and copied into their slot once complete, so that a full queue
+//          does not hold back the frames that bypass it.
+//
+//          "stream_frame" messages bypass the queue: see "Frame mailbox".
+//          So do "bands" messages: see "Audio bands".
+//
+//          In other words, if communication between the Python program and the
+//          microcontroller is ever not as expected, the computer restarts.
+//          However, the Python program has never had to restart the computer.
+///////////////////////////////////////////////////////////////////////////////
+struct command
+{
+    uint8_t frame[PROTO_MAX_FRAME];  /* Complete frame. */
+    uint32_t rx_us;                  /* micros() when it was accepted. */
+    uint16_t seq;                    /* Its sequence number. */
+};
+
+static struct command cmd_queue[CMD_QUEUE_LEN];
+static size_t cmd_head = 0;              /* Oldest queued command. */
+static size_t cmd_count = 0;             /* Number of queued commands. */
+
+static uint8_t rx_frame[PROTO_MAX_FRAME]; /* Frame being received. */
+static size_t rx_idx = 0;                /* Its bytes received so far. */
+static size_t rx_len = 0;                /* Its length, once known. */
+static uint16_t rx_seq = 0;              /* Next sequence number. */
+static uint16_t exec_seq = 0;            /* Sequence number of the message
+                                            being executed. */
+
+#define TX_BUF_SIZE 128  /* Two full-speed USB bulk packets. Must hold the
+                            largest frame sent to the Python program. */
+
+_Static_assert(MSG_ACK_LEN <= TX_BUF_SIZE &&
+               MSG_EVENT_LEN <= TX_BUF_SIZE &&
+               MSG_PROGRAM_STATUS_LEN <= TX_BUF_SIZE &&
+               MSG_HASHES_LEN <= TX_BUF_SIZE &&
+               MSG_TELEMETRY_LEN <= TX_BUF_SIZE,
+               "Every outgoing frame must fit in `tx_buf`.");
+
+static uint8_t tx_buf[TX_BUF_SIZE];      /* Staged outgoing frames. */
+static size_t tx_len = 0;                /* Bytes staged so far. */
+static uint8_t notify_enabled = 0;       /* Send "event" frames? */
+
+
+/*****************************************************************************
+ *  parse: Consumes available bytes, accepting every complete command frame
+ *         into the queue and handing "stream_frame" and "bands" frames to
+ *         their mailboxes. While the queue is full, stops at the opcode of
+ *         a command frame. Returns the number of frames accepted.
+ *****************************************************************************/
+int
+parse(void)
+{
+    int accepted = 0;
+
+    while (Serial.available() > 0)
+    {
+        struct command *cmd;
+        uint8_t c;
+
+        if (rx_idx == 2 && cmd_count == CMD_QUEUE_LEN &&
+            rx_frame[1] != OP_STREAM_FRAME && rx_frame[1] != OP_BANDS)
+        {
+            /* A command, and no slot for it yet. */
+            break;
+        }
+        c = Serial.read();
+        if (rx_idx == 0 && c != PROTO_SOF)
+            continue;
+        rx_frame[rx_idx++] = c;
+
+        if (rx_idx == 2 && (rx_len = proto_frame_len(c)) == 0)
+        {
+            /* Unknown opcode: resynchronize on the next '%'. */
+            rx_idx = (c == PROTO_SOF) ? 1 : 0;
+            continue;
+        }
+        if (rx_idx > 2 && rx_idx == rx_len)
+        {
+            rx_idx = 0;
+            if (rx_frame[1] == OP_STREAM_FRAME)
+            {
+                mailbox_post(rx_frame);
+                continue;
+            }
+            if (rx_frame[1] == OP_BANDS)
+            {
+                bands_post(rx_frame);
+                continue;
+            }
+            cmd = &cmd_queue[(cmd_head + cmd_count) % CMD_QUEUE_LEN];
+            memcpy(cmd->frame, rx_frame, rx_len);
+            cmd->rx_us = micros();
+            cmd->seq = rx_seq++;
+            cmd_count++;
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+
+/*****************************************************************************
+ *  execute_next: Takes the oldest command off the queue and starts
+ *                executing it. Returns 1 if it was well-formed, 0 otherwise.
+ *****************************************************************************/
+int
+execute_next(void)
+{
+    struct command *cmd = &cmd_queue[cmd_head];
+
+    cmd_head = (cmd_head + 1) % CMD_QUEUE_LEN;
+    cmd_count--;
+    return execute(cmd->frame, cmd->seq, cmd->rx_us);
+}
+
+
+/*****************************************************************************
+ *  execute: Decodes the complete frame in `buf`, with sequence number `seq`
+ *           and accepted at time `rx_us`, and starts executing it. The ack
+ *           is sent before rendering. Notes and the drone are rendered by
+ *           `exec_step()`.
+ *****************************************************************************/
+int
+execute(const uint8_t *buf, uint16_t seq, uint32_t rx_us)
+{
+    switch (buf[1])
+    {
+    case OP_DRONE_OFF:
+        if (!decode_drone_off(buf))
+            return 0;
+        send_ack(seq, rx_us);
+        tail_finish();
+        all_lights_off();
+        event_edge(EVENT_STARTED);
+        event_edge(EVENT_FINISHED);
+        return 1;
+    case OP_DRONE_ON:
+        if (!decode_drone_on(buf))
+            return 0;
+        send_ack(seq, rx_us);
+        event_edge(EVENT_STARTED);
+        drone_start();
+        return 1;
+    case OP_NOTE:
+    {
+        struct msg_note note;
+        uint64_t now, start;
+
+        if (!decode_note(buf, &note) || note.pitch_class > 11)
+            return 0;
+        send_ack(seq, rx_us);
+        note_color = map_cs_to_color[note.pitch_class];
+        note_duration_us = note.duration_us;
+        note_octave = -1;
+        note_pc = note.pitch_class;
+        note_level = 256;
+        start = latency_schedule(note_duration_us, NO_STEP);
+        now = micros64();
+        if (start > now)
+        {
+            exec_begin(EXEC_NOTE_WAIT, start - now);
+            return 1;
+        }
+        note_start();
+        return 1;
+    }
+    case OP_MIDI_NOTE:
+    {
+        struct msg_midi_note note;
+        uint64_t now, start;
+
+        if (!decode_midi_note(buf, &note) || note.note > 127 ||
+            note.velocity > 127)
+            return 0;
+        send_ack(seq, rx_us);
+        note_color = scale_color(map_cs_to_color[note.note % 12],
+                                 velocity_level[note.velocity]);
+        note_duration_us = note.duration_us;
+        note_octave = note.note / 12;
+        note_pc = note.note % 12;
+        note_level = velocity_level[note.velocity];
+        start = latency_schedule(note_duration_us, note.step);
+        now = micros64();
+        if (start > now)
+        {
+            exec_begin(EXEC_NOTE_WAIT, start - now);
+            return 1;
+        }
+        note_start();
+        return 1;
+    }
+    case OP_CHORD:
+    {
+        struct msg_chord chord;
+        uint64_t now, start;
+
+        if (!decode_chord(buf, &chord) || !chord_load(&chord))
+            return 0;
+        send_ack(seq, rx_us);
+        start = latency_schedule(chord_length_us(), NO_STEP);
+        now = micros64();
+        if (start > now)
+        {
+            exec_begin(EXEC_CHORD_WAIT, start - now);
+            return 1;
+        }
+        chord_start();
+        return 1;
+    }
+    case OP_TEMPO:
+    {
+        struct msg_tempo tempo;
+
+        if (!decode_tempo(buf, &tempo))
+            return 0;
+        send_ack(seq, rx_us);
+        tempo_set(&tempo);
+        return 1;
+    }
+    case OP_GET_TELEMETRY:
+        if (!decode_get_telemetry(buf))
+            return 0;
+        send_ack(seq, rx_us);
+        send_telemetry();
+        return 1;
+    case OP_AFTERGLOW:
+    {
+        struct msg_afterglow afterglow;
+
+        if (!decode_afterglow(buf, &afterglow))
+            return 0;
+        send_ack(seq, rx_us);
+        afterglow_set(&afterglow);
+        return 1;
+    }
+    case OP_LATENCY:
+    {
+        struct msg_latency latency;
+
+        if (!decode_latency(buf, &latency) || !latency_set(&latency))
+            return 0;
+        send_ack(seq, rx_us);
+        return 1;
+    }
+    case OP_CROSSFADE:
+    {
+        struct msg_crossfade crossfade;
+
+        if (!decode_crossfade(buf, &crossfade))
+            return 0;
+        send_ack(seq, rx_us);
+        xfade_us = crossfade.duration_us;
+        return 1;
+    }
+    case OP_PROGRAM_LOAD:
+    {
+        struct msg_program_load load;
+
+        if (!decode_program_load(buf, &load) || !vm_load(&load))
+            return 0;
+        send_ack(seq, rx_us);
+        return 1;
+    }
+    case OP_PROGRAM_RUN:
+    {
+        struct msg_program_run run;
+
+        if (!decode_program_run(buf, &run))
+            return 0;
+        send_ack(seq, rx_us);
+        vm_run(&run);
+        return 1;
+    }
+    case OP_GET_HASHES:
+        if (!decode_get_hashes(buf))
+            return 0;
+        send_ack(seq, rx_us);
+        send_hashes();
+        return 1;
+    case OP_NOTIFY:
+    {
+        struct msg_notify notify;
+
+        if (!decode_notify(buf, &notify))
+            return 0;
+        send_ack(seq, rx_us);
+        notify_enabled = (notify.enable != 0);
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+
+/*****************************************************************************
+ *  send_ack: Stages the "ack" frame for message `seq`, accepted at `rx_us`,
+ *            with the time it is taken off the queue and the current credit
+ *            limit. The message becomes the one being executed.
+ *****************************************************************************/
+void
+send_ack(uint16_t seq, uint32_t rx_us)
+{
+    uint8_t buf[MSG_ACK_LEN];
+    struct msg_ack ack = {seq, rx_us, micros(),
+                          (uint16_t) (rx_seq + CMD_QUEUE_LEN - cmd_count)};
+
+    exec_seq = seq;
+    tx_stage(buf, encode_ack(buf, &ack));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Transmit buffer. Frames sent to the Python program ("ack" and "event")
+//                   are staged in `tx_buf` and written with a single
+//                   `Serial.write()`, so that several of them share one USB
+//                   packet. The buffer is flushed at the end of every pass
+//                   of `loop()`, and before staging a frame that would not
+//                   fit; it is sized so that every frame fits on its own.
+//
+//                   "event" notifications are optional (see the "notify"
+//                   message): when enabled, the Python program learns when
+//                   the lights for each message actually started and
+//                   finished, rather than assuming it.
+///////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ *  tx_stage: Appends the `len`-byte frame `frame` to the transmit buffer,
+ *            flushing it first if the frame does not fit.
+ *****************************************************************************/
+void
+tx_stage(const uint8_t *frame, size_t len)
+{
+    if (tx_len + len > TX_BUF_SIZE)
+    {
+        tx_flush();
+    }
+    memcpy(&tx_buf[tx_len], frame, len);
+    tx_len += len;
+}
+
+
+/*****************************************************************************
+ *  tx_flush: Writes out the transmit buffer.
+ *****************************************************************************/
+void
+tx_flush(void)
+{
+    if (tx_len > 0)
+    {
+        Serial.write(tx_buf, tx_len);
+        Serial.send_now();
+        tx_len = 0;
+    }
+}
+
+
+/*****************************************************************************
+ *  event_edge: Stages an "event" notification for the message being
+ *              executed, if notifications are enabled. `edge` is
+ *              EVENT_STARTED or EVENT_FINISHED.
+ *****************************************************************************/
+void
+event_edge(uint8_t edge)
+{
+    event_edge_at(edge, micros());
+}
+
+
+/*****************************************************************************
+ *  event_edge_at: As `event_edge()`, with the edge at time `t_us`.
+ *****************************************************************************/
+void
+event_edge_at(uint8_t edge, uint32_t t_us)
+{
+    event_send(exec_seq, edge, t_us);
+}
+
+
+/*****************************************************************************
+ *  event_send: Stages an "event" notification for message `seq`, if
+ *              notifications are enabled.
+ *****************************************************************************/
+void
+event_send(uint16_t seq, uint8_t edge, uint32_t t_us)
+{
+    uint8_t buf[MSG_EVENT_LEN];
+    struct msg_event event = {seq, edge, t_us};
+
+    if (notify_enabled)
+    {
+        tx_stage(buf, encode_event(buf, &event));
+    }
+}
+
+
+/*****************************************************************************
+ *  edge_schedule: Schedules `edge` of the message being executed at time
+ *                 `t` (micros64()).
+ *****************************************************************************/
+void
+edge_schedule(uint8_t edge, uint64_t t)
+{
+    edge_t[edge] = t;
+    edge_pending |= 1 << edge;
+}
+
+
+/*****************************************************************************
+ *  edge_poll: Sends the scheduled edges that are due, the carried ones
+ *             first, and EVENT_STARTED before EVENT_FINISHED.
+ *****************************************************************************/
+void
+edge_poll(void)
+{
+    uint64_t now;
+
+    if (!edge_pending && !carry_pending)
+    {
+        return;
+    }
+    now = micros64();
+    carry_pending = edges_send(carry_seq, carry_t, carry_pending, now);
+    if (!carry_pending)
+    {
+        edge_pending = edges_send(exec_seq, edge_t, edge_pending, now);
+    }
+}
+
+
+/*****************************************************************************
+ *  edges_send: Sends the edges of message `seq`, scheduled at `t` and not
+ *              sent yet according to the bits of `pending`, that are due at
+ *              time `now`. Returns the bits of those still pending.
+ *****************************************************************************/
+uint8_t
+edges_send(uint16_t seq, const uint64_t *t, uint8_t pending, uint64_t now)
+{
+    for (uint8_t edge = EVENT_STARTED; edge <= EVENT_FINISHED; edge++)
+    {
+        if (!(pending & (1 << edge)))
+        {
+            continue;
+        }
+        if (t[edge] > now)
+        {
+            break;
+        }
+        event_send(seq, edge, (uint32_t) t[edge]);
+        pending &= ~(1 << edge);
+    }
+    return pending;
+}
+
+
+/*****************************************************************************
+ *  edge_carry: Carries the pending edges of the message being executed, if
+ *              the next message is a note or chord and none are carried
+ *              yet, so that it can start. Returns 1 if they were carried.
+ *****************************************************************************/
+int
+edge_carry(void)
+{
+    uint8_t op;
+
+    if (carry_pending || cmd_count == 0)
+    {
+        return 0;
+    }
+    op = cmd_queue[cmd_head].frame[1];
+    if (op != OP_NOTE && op != OP_MIDI_NOTE && op != OP_CHORD)
+    {
+        return 0;
+    }
+    carry_seq = exec_seq;
+    carry_t[EVENT_STARTED] = edge_t[EVENT_STARTED];
+    carry_t[EVENT_FINISHED] = edge_t[EVENT_FINISHED];
+    carry_pending = edge_pending;
+    edge_pending = 0;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Frame mailbox. For live visualizations a stale frame is worse than a
+//                 skipped one, so "stream_frame" messages do not go through
+//                 the command queue. The mailbox holds a single frame: a
+//                 newer frame replaces one that has not been shown yet
+//                 (counted in `frames_superseded`), and `loop()` shows the
+//                 frame in the mailbox whenever the executor is idle and no
+//                 command is queued. However far the Python program runs
+//                 ahead, the frame shown is therefore never older than one
+//                 frame period.
+//
+//                 Frames are neither sequenced, acked nor credited. Since
+//                 `parse()` keeps reading them while the queue is full (the
+//                 Python program sends no command beyond its credit) and
+//                 keeps nothing but the newest frame, streaming does not
+//                 build up in the USB buffers either. Commands and frames
+//                 can be mixed; queued commands are executed first.
+///////////////////////////////////////////////////////////////////////////////
+static struct msg_stream_frame mbox;     /* Newest frame not yet shown. */
+static uint8_t mbox_full = 0;            /* Does `mbox` hold a frame? */
+
+static uint32_t frames_received = 0;
+static uint32_t frames_shown = 0;
+static uint32_t frames_superseded = 0;
+
+
+/*****************************************************************************
+ *  mailbox_post: Replaces the frame in the mailbox with the complete
+ *                "stream_frame" frame in `buf`. Malformed frames are
+ *                dropped.
+ *****************************************************************************/
+void
+mailbox_post(const uint8_t *buf)
+{
+    if (!decode_stream_frame(buf, &mbox))
+    {
+        /* Malformed: dropped, leaving the mailbox as it was. */
+        return;
+    }
+    frames_received++;
+    if (mbox_full)
+    {
+        frames_superseded++;
+    }
+    mbox_full = 1;
+}
+
+
+/*****************************************************************************
+ *  mailbox_show: Shows the frame in the mailbox and empties it.
+ *****************************************************************************/
+void
+mailbox_show(void)
+{
+    fb_set_packed(mbox.rgb);
+    fb_commit();
+    mbox_full = 0;
+    frames_shown++;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Audio bands. The host follows the envelope of the audio actually played
+//               (the sampler's decays, the drone swell, the reverb tails) in
+//               BANDS_N frequency bands and sends their levels about every
+//               10 ms in "bands" messages (see `_envelope.py`). Each level
+//               sets the gain of the groups its band is mapped to
+//               (`band_of_group`), lowest band on the largest panels, and
+//               the frame on the LEDs is presented again at once with the
+//               new gains, so a level reaches the lights within the loop
+//               iteration that parses it. Like "stream_frame" messages, they
+//               bypass the command queue and only the newest counts; lights
+//               go back to full brightness BANDS_HOLD_US after the last one,
+//               should the host stop sending.
+///////////////////////////////////////////////////////////////////////////////
+/* Band of each group, in the order of the GROUP_* constants. */
+static const uint8_t band_of_group[7] = {0, 0, 1, 2, 2, 1, 3};
+
+static uint8_t bands_active = 0;         /* Is any gain below 256? */
+static uint32_t bands_t0 = 0;            /* micros() at the last "bands". */
+
+_Static_assert(BANDS_N == 4, "`band_of_group` maps 4 bands.");
+
+
+/*****************************************************************************
+ *  bands_post: Sets the group gains from the complete "bands" frame in
+ *              `buf`. Malformed frames are dropped.
+ *****************************************************************************/
+void
+bands_post(const uint8_t *buf)
+{
+    struct msg_bands bands;
+
+    if (!decode_bands(buf, &bands))
+    {
+        return;
+    }
+    for (size_t j = 0; j < 7; j++)
+    {
+        uint32_t cut = bands.depth * (255u - bands.level[band_of_group[j]]);
+
+        /* 256 * (1 - cut / 255^2), rounded. */
+        fb_gain[j] = 256 - (cut * 256 + 65025 / 2) / 65025;
+    }
+    bands_active = (bands.depth != 0);
+    bands_t0 = micros();
+    fb_gain_changed = 1;
+}
+
+
+/*****************************************************************************
+ *  bands_expire: Ends the modulation if no "bands" message has come for
+ *                BANDS_HOLD_US.
+ *****************************************************************************/
+void
+bands_expire(void)
+{
+    if (bands_active && (uint32_t) (micros() - bands_t0) >= BANDS_HOLD_US)
+    {
+        for (size_t j = 0; j < 7; j++)
+        {
+            fb_gain[j] = 256;
+        }
+        bands_active = 0;
+        fb_gain_changed = 1;
+    }
+}
+
+
+/*****************************************************************************
+ *  send_telemetry: Stages a "telemetry" frame with the streaming and
+ *                  refresh counters.
+ *****************************************************************************/
+void
+send_telemetry(void)
+{
+    uint8_t buf[MSG_TELEMETRY_LEN];
+    struct msg_telemetry telemetry = {frames_received, frames_shown,
+                                      frames_superseded, fb_commit_cycles,
+                                      fb_shows, fb_shows_skipped, fb_show_us};
+
+    tx_stage(buf, encode_telemetry(buf, &telemetry));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Setup
+///////////////////////////////////////////////////////////////////////////////
+/*****************************************************************************
+ *  setup: The setup() function will only run once, after each powerup or
+ *         reset of the Arduino board. Use it to initialize variables,
+ *         pin modes, start using libraries, etc. Called when a sketch
+ *         starts.
+ *****************************************************************************/
+void 
+setup() 
+{
+    /* Sets the speed (baud rate) for the serial communication. Strictly
+       speaking, with Teensy, this is a no-op. */
+    Serial.begin(57600);
+    /* Initialize the OctoWS2811 library. */
+    leds.begin();
+    /* Initiates an update of the LEDs. */
+    leds.show();
+
+    _init_TheNewArk();
+}
+
+
+/*****************************************************************************
+ *  _init_TheNewArk: Initialization code pertaining to the TheNewArk project.
+ *
+ *             Note: This must be called in `setup()`.
+ *****************************************************************************/
+void
+_init_TheNewArk(void)
+{
+    /* Initialize random number generator. */
+    srand(42);  // srand((unsigned) time(NULL));
+    /* Map each LED to its group, for the afterglow. */
+    fb_init_groups();
+    /* Build the table for the frame hashes. */
+    crc32_init();
+    /* Build the velocity -> brightness table for "midi_note". */
+    velocity_init();
+    /* Initialize an array of brightness levels for the drone. It should be
+       noted that free() is not actually called in this program on
+       `drone_brightness`. It will be deallocated automatically after the
+       Teensy resets due to power off and on. In retrospect, this should have
+       simply been a static array. */
+    drone_brightness = _create_quadratic_brightness(&drone_color,
+                                                    DRONE_BRIGHTNESS_N);
+    if (drone_brightness == NULL)
+    {
+        abort();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Loop
+///////////////////////////////////////////////////////////////////////////////
+/*****************************************************************************
+ *  loop: This function loops consecutively.
+ *****************************************************************************/
+void
+loop()
+{
+    micros64();  /* Keeps track of micros() wrapping around. */
+    parse();
+    tail_poll();
+    if (exec_state != EXEC_IDLE)
+    {
+        exec_step();
+    }
+    if (exec_state == EXEC_IDLE && cmd_count > 0)
+    {
+        execute_next();
+    }
+    if (exec_state == EXEC_IDLE && cmd_count == 0 && mbox_full &&
+        tail == TAIL_NONE)
+    {
+        mailbox_show();
+    }
+    if (afterglow_active &&
+        (uint32_t) (micros() - afterglow_t0) >= AFTERGLOW_FRAME_US)
+    {
+        fb_commit();
+    }
+    bands_expire();
+    if (fb_gain_changed)
+    {
+        fb_present(CYCLE_COUNT());
+    }
+    if ((uint32_t) (micros() - fb_show_t0) >= FB_KEEPALIVE_US)
+    {
+        fb_show();
+    }
+    tx_flush();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Drone On
+///////////////////////////////////////////////////////////////////////////////
+static size_t drone_k = 0;               /* Step within the breath. */
+static uint8_t drone_off = 0;            /* End after this breath? */
+static uint64_t drone_t0 = 0;            /* micros64() at breath start. */
+static uint64_t drone_breath_us = 0;     /* Length of the breath. */
+
+
+/*****************************************************************************
+ *  drone_start: The "50 bpm drone" is used. Paddy estimates that the
+ *               "50 bpm drone" peaks at 3.248 seconds and ends at 4.800
+ *               seconds. The "30 bpm drone" peaks at 2.730 seconds and
+ *               ends at 4.000 seconds. (3350000, 1450000) may also be good.
+ *
+ *               Given an interval [a, b], a < b, to divide the interval
+ *               into `n` equal parts, the parts must have length
+ *               L = (b - a) / n.
+ *
+ *               Each breath takes 2 * DRONE_BRIGHTNESS_N steps of
+ *               `drone_step()`. Once another command is queued, the drone
+ *               finishes its current breath and ends.
+ *****************************************************************************/
+void
+drone_start(void)
+{
+    uint64_t now = micros64();
+
+    /* Edge case: end right away */
+    if (cmd_count > 0)
+    {
+        event_edge(EVENT_FINISHED);
+        return;
+    }
+
+    drone_k = 0;
+    drone_off = 0;
+    xfade_from = NO_PC;
+    drone_breath(now);
+    exec_begin(EXEC_DRONE, drone_t0 - now);
+}
+
+
+/*****************************************************************************
+ *  drone_breath: Schedules a breath starting at time `t`. If the drone is
+ *                locked to the tempo clock, the breath instead starts on the
+ *                first beat at or after `t` (shifted by the latency offset,
+ *                see "Latency compensation") and lasts the whole number of
+ *                beats closest to DRONE_MICROSEC_ITERATION.
+ *****************************************************************************/
+void
+drone_breath(uint64_t t)
+{
+    uint64_t beat_us, n_beats, beat;
+
+    if (tempo_bpm_milli == 0 || !tempo_drone_sync)
+    {
+        drone_t0 = t;
+        drone_breath_us = DRONE_MICROSEC_ITERATION;
+        return;
+    }
+
+    beat_us = US_PER_MILLIBEAT / tempo_bpm_milli;
+    n_beats = (DRONE_MICROSEC_ITERATION + beat_us / 2) / beat_us;
+    if (n_beats == 0)
+    {
+        n_beats = 1;
+    }
+    /* The first beat whose breath, shifted by the latency offset, starts
+       no earlier than `t`. */
+    beat = tempo_next((latency_us < 0 || t > (uint64_t) latency_us) ?
+                      t - latency_us : 0, 1);
+    drone_t0 = beat + latency_us;
+    drone_breath_us = tempo_grid_time(tempo_grid_index(beat, 1) + n_beats,
+                                      1) - beat;
+}
+
+
+/*****************************************************************************
+ *  drone_boundary: Returns the time at which step `k` of the breath starts.
+ *                  Steps are computed from the start of the breath rather
+ *                  than from one another, so the breath does not drift.
+ *****************************************************************************/
+uint64_t
+drone_boundary(size_t k)
+{
+    uint64_t up = drone_breath_us * DRONE_MICROSEC_UP /
+                  DRONE_MICROSEC_ITERATION;
+    uint64_t down = drone_breath_us - up;
+
+    if (k <= DRONE_BRIGHTNESS_N)
+    {
+        return drone_t0 + k * up / DRONE_BRIGHTNESS_N;
+    }
+    return drone_t0 + up + (k - DRONE_BRIGHTNESS_N) * down /
+                           DRONE_BRIGHTNESS_N;
+}
+
+
+/*****************************************************************************
+ *  drone_step: Shows the next brightness level of the drone.
+ *****************************************************************************/
+void
+drone_step(void)
+{
+    size_t i;
+    uint64_t start, end;
+
+    if (drone_k == 2 * DRONE_BRIGHTNESS_N)
+    {
+        if (drone_off)
+        {
+            exec_state = EXEC_IDLE;
+            event_edge(EVENT_FINISHED);
+            return;
+        }
+        drone_breath(drone_t0 + drone_breath_us);
+        drone_k = 0;
+    }
+    if (cmd_count > 0)
+    {
+        drone_off = 1;
+    }
+
+    if (drone_k < DRONE_BRIGHTNESS_N)
+    {
+        /* Increase brightness quadratically with time over `_MICROSEC_UP`
+           microseconds. */
+        i = drone_k;
+    }
+    else
+    {
+        /* Decrease brightness over the same curve over ` _MICROSEC_DOWN`
+           microseconds. */
+        i = 2 * DRONE_BRIGHTNESS_N - 1 - drone_k;
+    }
+    tail_finish();
+    all_lights_RGB(drone_brightness[i].r, 0, 0);
+
+    start = drone_boundary(drone_k);
+    end = drone_boundary(drone_k + 1);
+    exec_t0 = (uint32_t) start;
+    exec_wait = end - start;
+    drone_k++;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Note On
+///////////////////////////////////////////////////////////////////////////////
+/*****************************************************************************
+ *  note_start: Lights the note being executed for its duration. A note
+ *              starting on the first beat of a bar (see "Tempo clock") is
+ *              accented by lighting all of "Top". A "midi_note" is placed
+ *              according to its octave (see "MIDI Note On"). If crossfades
+ *              are on, the note starts in the color of the previous note
+ *              (see "Crossfades"). Whatever was on the LEDs before is
+ *              cleared.
+ *
+ *              The note's step ends with its lights or, if the latency
+ *              offset delays them past its EVENT_FINISHED edge, at that
+ *              edge (see `note_finish()`).
+ *****************************************************************************/
+void
+note_start(void)
+{
+    uint64_t now = micros64();
+    uint32_t color;
+
+    tail_finish();
+    note_end_t = edge_t[EVENT_FINISHED] + (latency_us < 0 ? latency_us : 0);
+    if (note_end_t < now)
+    {
+        note_end_t = now;
+    }
+    color = xfade_begin();
+
+    /* Start from black, as chords do: a streamed frame or a program's
+       pixels may still be on the LEDs. */
+    fb_clear();
+    if (tempo_is_downbeat(edge_t[EVENT_STARTED]))
+    {
+        for (int j = 80; j < 88; j++)
+        {
+            fb_set_pixel(j, color);
+        }
+    }
+    if (note_octave < 0)
+    {
+        randomize_half_panels(color);
+    }
+    else
+    {
+        randomize_placed_panels(color, &octave_placement[note_octave]);
+    }
+    edge_poll();
+    if (xfade_n > 0)
+    {
+        exec_begin(EXEC_FADE, AFTERGLOW_FRAME_US);
+        return;
+    }
+    exec_begin(EXEC_NOTE, note_end_t - now);
+}
+
+
+/*****************************************************************************
+ *  note_finish: Ends the note being executed. Its lights go off now, or,
+ *               if the latency offset delays them, `latency_us` after its
+ *               EVENT_FINISHED edge, as a tail.
+ *****************************************************************************/
+void
+note_finish(void)
+{
+    if (latency_us > 0)
+    {
+        tail = TAIL_NOTE;
+        tail_t = edge_t[EVENT_FINISHED] + latency_us;
+    }
+    else
+    {
+        all_lights_off();
+    }
+    exec_end();
+}
+
+
+/*****************************************************************************
+ *  randomize_half_panels: The 11 panels are divided into 7 groups. Each of
+ *                         the 7 groups are themselves divided into 2-4
+ *                         groups of 4 LEDs.
+ *
+ *                         The 7 groups:
+ *                              "Front"      : P1, P10.
+ *                              "Back"       : P5, P6.
+ *                              "Left-left"  : P7, half of P8.
+ *                              "Left-right" : P9, half of P8.
+ *                              "Right-left" : P2, half of P3.
+ *                              "Right-right": P4, half of P3.
+ *                              "Top"        : P11.
+ *
+ *                         Within 6 out of the 7 groups (all except "Top"), one
+ *                         group of 4 LEDs is selected at random and lit.
+ *
+ *                         For "Top", the probability that exactly one group
+ *                         of four is lit is 50%; the other 50% of the time,
+ *                         no group of four is lit.
+ *
+ *                         The lights stay on until they are turned off by
+ *                         `exec_step()`.
+ *****************************************************************************/
+void
+randomize_half_panels(uint32_t color)
+{
+    /* Loop variable */
+    int j;
+
+    /* Choose which group of 4 is selected in each group except "Top" */
+    int f  = rand() % 4, b  = rand() % 4;
+    int ll = rand() % 3, lr = rand() % 3;
+    int rl = rand() % 3, rr = rand() % 3;
+
+    /* Randomize number per subgroup */
+    int n_f  = 1 + rand() % 4, n_b  = 1 + rand() % 4;
+    int n_ll = 1 + rand() % 4, n_lr = 1 + rand() % 4;
+    int n_rl = 1 + rand() % 4, n_rr = 1 + rand() % 4;
+
+    /* "Top" group handled separately */
+    if (rand() % 2) {
+        int t_base = (rand() % 2) ? 80 : 84;
+        int n_t = 1 + rand() % 4;
+
+        for (j = 0; j < n_t; j++) {
+            fb_set_pixel(t_base + j, color);
+        }
+    }
+
+    /* Probably should be rewritten but this should suffice */
+    for (j = 0; j < n_f; j++)
+        fb_set_pixel(group_f[f][j], color);
+    for (j = 0; j < n_b; j++)
+        fb_set_pixel(group_b[b][j], color);
+    for (j = 0; j < n_ll; j++)
+        fb_set_pixel(group_ll[ll][j], color);
+    for (j = 0; j < n_lr; j++)
+        fb_set_pixel(group_lr[lr][j], color);
+    for (j = 0; j < n_rl; j++)
+        fb_set_pixel(group_rl[rl][j], color);
+    for (j = 0; j < n_rr; j++)
+        fb_set_pixel(group_rr[rr][j], color);
+
+    fb_commit();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  MIDI Note On. A "midi_note" message carries the MIDI note number and
+//                velocity rather than just the pitch class. The color is
+//                still that of the pitch class, scaled by `velocity_level`.
+//                The octave selects a row of `octave_placement`: how many of
+//                the 6 lower groups of panels and how many of the 2 groups
+//                of 4 LEDs of "Top" are lit. Low notes stay on the lower
+//                panels; the higher the note, the fewer lower panels and the
+//                more of "Top".
+///////////////////////////////////////////////////////////////////////////////
+/*****************************************************************************
+ *  velocity_init: Initializes `velocity_level`.
+ *****************************************************************************/
+void
+velocity_init(void)
+{
+    velocity_level[0] = 0;
+    for (size_t v = 1; v < 128; v++)
+    {
+        double x = (double) (v - 1) / 126.0;
+
+        velocity_level[v] = VELOCITY_FLOOR + (256 - VELOCITY_FLOOR) * x * x +
+                            0.5;
+    }
+}
+
+
+/*****************************************************************************
+ *  scale_color: Returns `color` (0xRRGGBB) with each component multiplied
+ *               by `level` / 256.
+ *****************************************************************************/
+uint32_t
+scale_color(uint32_t color, uint16_t level)
+{
+    uint32_t r = ((color >> 16 & 0xFF) * level) >> 8;
+    uint32_t g = ((color >> 8 & 0xFF) * level) >> 8;
+    uint32_t b = ((color & 0xFF) * level) >> 8;
+
+    return (r << 16) | (g << 8) | b;
+}
+
+
+/*****************************************************************************
+ *  randomize_placed_panels: As `randomize_half_panels()`, but lights
+ *                           `place->n_lower` of the 6 lower groups of panels
+ *                           (chosen at random) and `place->n_top` of the 2
+ *                           groups of 4 LEDs of "Top". Each group lit has
+ *                           1-4 of the LEDs of one of its groups of 4 lit.
+ *****************************************************************************/
+void
+randomize_placed_panels(uint32_t color, const struct placement *place)
+{
+    /* Groups of 4 LEDs of each lower group of panels. */
+    static const uint8_t (*const lower[6])[4] = {
+        group_f, group_b, group_ll, group_lr, group_rl, group_rr
+    };
+    static const uint8_t n_quads[6] = {4, 4, 3, 3, 3, 3};
+    uint8_t order[6] = {0, 1, 2, 3, 4, 5};
+    size_t i, j;
+
+    /* Shuffle the lower groups (Fisher-Yates); light the first ones. */
+    for (i = 5; i > 0; i--)
+    {
+        uint8_t tmp;
+
+        j = rand() % (i + 1);
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for (i = 0; i < place->n_lower; i++)
+    {
+        const uint8_t *quad = lower[order[i]][rand() % n_quads[order[i]]];
+        int n = 1 + rand() % 4;
+
+        for (j = 0; j < (size_t) n; j++)
+        {
+            fb_set_pixel(quad[j], color);
+        }
+    }
+
+    /* "Top": one group of 4 at random, or both. */
+    j = rand() % 2;
+    for (i = 0; i < place->n_top; i++)
+    {
+        const uint8_t *quad = group_top[(i + j) % 2];
+        int n = 1 + rand() % 4;
+
+        for (int k = 0; k < n; k++)
+        {
+            fb_set_pixel(quad[k], color);
+        }
+    }
+
+    fb_commit();
+}
 
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Parser. The Python program sends USB-serial messages to the program
-//          uploaded on the microcontroller. By construction, every message
-//          consists of 11 bytes, starting with the character '%' and ending
-//          with the character '&':
-//              message[0] == '%'
-//              message[1] == either '0', '1', or '2'
-//                  '0' ==> "drone off" message
-//                  '1' ==> "drone on" message
-//                  '2' ==> "note" message
-//              message[2] == integer 0 (<==> '\0'), 1, ... , or 11
-//              message[3] == either '0', '1', ... , '9', or '\0'
-//              message[4] == either '0', '1', ... , '9', or '\0'
-//              ...
-//              message[9] == either '0', '1', ... , '9', or '\0'
-//              message[10] == '&'
-//
-//          In a "drone on" and "drone off" message, the eight characters
-//          from message[2] to message[9] are set to the null character '\0':
-//              "drone on" message  <==> "%1\0\0\0\0\0\0\0\0&"
-//              "drone off" message <==> "%0\0\0\0\0\0\0\0\0&"
-//
-//          In a "note" message, message[2] is an integer in [0, 11] giving
-//          the octave-independent note number (C corresponds to 0, Db to 1,
-//          and so on). message[3] through till message[9] are a string of
-//          character digits encoding how long lights corresponding to a
-//          an arbitrary note number should be lit.
-//
-//          The Python program sets a timeout of 0, which means that an
-//          attempt will be made to ask the OS to write the full message
-//          through the serial port but it is possible that the call fails to
-//          write the full message. Because the timeout is set to 0, the
-//          Python program does not attempt to write the rest of the message.
-//          The return value of the OS call the Python program makes ends up
-//          being the number of bytes actually written. The Python program
-//          can therefore detect in advance whether or not the write was
-//          fully successful. If it was not fully successful, the Python
-//          program will restart the computer (==> restarting the micro-contr.
-//          as well).
+//  Chord On. A "chord" message lights up to CHORD_MAX notes at once. The 22
+//            groups of 4 LEDs (6 + 2 per group of panels, see
+//            `randomize_half_panels()`) are shuffled and dealt out to the
+//            notes in turn, so no two notes share a group of 4, and each
+//            group lights 1-4 of its LEDs as for a single note. A lone note
+//            gets 7 groups of 4; larger chords share all 22.
 //
-//          The Python program expects a one-byte response from the
-//          microcontroller for every message. If it does not receive a
-//          response, the Python program will restart the computer.
-//
-//          In other words, if communication between the Python program and the
-//          microcontroller is ever not as expected, the computer restarts.
-//          However, the Python program has never had to restart the computer.
+//            The whole chord is drawn into the framebuffer and committed as
+//            one frame. `chord_owner` remembers which note lit each LED, so
+//            that when a note's duration is up only its LEDs go dark (one
+//            commit for all the notes ending at the same time).
 ///////////////////////////////////////////////////////////////////////////////
-int
-parse(void)
-{
-    int idx = 0;
-    char buf[11] = {0};
-    char *temp;
+#define CHORD_MAX  12   /* Maximum number of notes in a chord. */
+#define N_QUADS    22   /* Number of groups of 4 LEDs. */
+#define NO_NOTE  0xFF   /* `chord_owner` of an unlit LED. */
+
+static const uint8_t *const quads[N_QUADS] = {
+    group_f[0], group_f[1], group_f[2], group_f[3],
+    group_b[0], group_b[1], group_b[2], group_b[3],
+    group_ll[0], group_ll[1], group_ll[2],
+    group_lr[0], group_lr[1], group_lr[2],
+    group_rl[0], group_rl[1], group_rl[2],
+    group_rr[0], group_rr[1], group_rr[2],
+    group_top[0], group_top[1]
+};
 
-    /* Receive entire message into `buf`. */
-    while (idx < 11 && Serial.available() > 0 && buf[idx] != '&')
-        buf[idx++] = Serial.read();
+static uint8_t chord_n = 0;                   /* Notes in the chord. */
+static uint32_t chord_color[CHORD_MAX];
+static uint32_t chord_duration_us[CHORD_MAX];
+static uint64_t chord_end[CHORD_MAX];         /* micros64() at each end. */
+static uint16_t chord_lit = 0;                /* Bit i: note i is lit. */
+static uint8_t chord_owner[N_LEDS];
 
-    /* Flush */
-    while (Serial.available() > 0)
-        Serial.read();
 
-    /* Check if message is as expected. */
-    if (buf[0] == '%' && buf[10] == '&')
+/*****************************************************************************
+ *  chord_load: Validates a "chord" message and makes it the chord being
+ *              executed. Returns 0 if it is malformed.
+ *****************************************************************************/
+int
+chord_load(const struct msg_chord *chord)
+{
+    if (chord->n_notes < 1 || chord->n_notes > CHORD_MAX)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < chord->n_notes; i++)
     {
-        if (buf[1] == '0')
+        if (chord->pitch_class[i] > 11)
         {
-            Serial.write("1");
-            Serial.send_now();
-            /* "drone off" message */
-            all_lights_off();
+            return 0;
         }
-        else if (buf[1] == '1')
+    }
+
+    chord_n = chord->n_notes;
+    for (size_t i = 0; i < chord_n; i++)
+    {
+        chord_color[i] = map_cs_to_color[chord->pitch_class[i]];
+        chord_duration_us[i] = chord->duration_us[i];
+    }
+    return 1;
+}
+
+
+/*****************************************************************************
+ *  chord_length_us: Returns the duration of the longest note of the chord
+ *                   being executed.
+ *****************************************************************************/
+uint32_t
+chord_length_us(void)
+{
+    uint32_t longest = 0;
+
+    for (size_t i = 0; i < chord_n; i++)
+    {
+        if (chord_duration_us[i] > longest)
         {
-            Serial.write("1");
-            Serial.send_now();
-            /* "drone on" message */
-            drone_lights();
+            longest = chord_duration_us[i];
         }
-        else if (buf[1] == '2')
-        {
-            /* "note" message */
-            uint8_t note = buf[2];
-            uint32_t duration = (uint32_t) strtoull(&buf[3], &temp, 10);
+    }
+    return longest;
+}
 
-            if (*temp == '\0' || *temp == '&')
-            {
-                Serial.write("1");
-                Serial.send_now();
-                randomize_half_panels(map_cs_to_color[note], duration);
-            }
-            else
-            {
-                return 0;
-            }
+
+/*****************************************************************************
+ *  chord_start: Lights every note of the chord being executed in a single
+ *               frame. As for a note, a chord starting on the first beat of
+ *               a bar is accented by lighting all of "Top", in the color of
+ *               its first note.
+ *****************************************************************************/
+void
+chord_start(void)
+{
+    uint8_t order[N_QUADS];
+    size_t i, j, n_quads;
+    uint64_t on = edge_t[EVENT_STARTED] + latency_us;    /* Scheduled. */
+
+    tail_finish();
+
+    /* Shuffle the groups of 4 (Fisher-Yates). */
+    for (i = 0; i < N_QUADS; i++)
+    {
+        order[i] = i;
+    }
+    for (i = N_QUADS - 1; i > 0; i--)
+    {
+        uint8_t tmp;
+
+        j = rand() % (i + 1);
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    fb_clear();
+    memset(chord_owner, NO_NOTE, sizeof chord_owner);
+    xfade_from = NO_PC;
+
+    n_quads = 7 * chord_n < N_QUADS ? 7 * chord_n : N_QUADS;
+    for (i = 0; i < n_quads; i++)
+    {
+        const uint8_t *quad = quads[order[i]];
+        uint8_t note = i % chord_n;
+        int n = 1 + rand() % 4;
+
+        for (j = 0; j < (size_t) n; j++)
+        {
+            fb_set_pixel(quad[j], chord_color[note]);
+            chord_owner[quad[j]] = note;
         }
-        else
+    }
+    if (tempo_is_downbeat(edge_t[EVENT_STARTED]))
+    {
+        for (i = 80; i < 88; i++)
         {
-            return 0;
+            fb_set_pixel(i, chord_color[0]);
+            chord_owner[i] = 0;
         }
-
-        return 1;
     }
-    else
+
+    chord_lit = 0;
+    for (i = 0; i < chord_n; i++)
     {
-        return 0;
+        chord_lit |= 1 << i;
+        chord_end[i] = on + chord_duration_us[i];
     }
+
+    fb_commit();
+    edge_poll();
+    exec_begin(EXEC_CHORD, 0);
+    chord_step();
 }
 
 
-///////////////////////////////////////////////////////////////////////////////
-//  Setup
-///////////////////////////////////////////////////////////////////////////////
 /*****************************************************************************
- *  setup: The setup() function will only run once, after each powerup or
- *         reset of the Arduino board. Use it to initialize variables,
- *         pin modes, start using libraries, etc. Called when a sketch
- *         starts.
+ *  chord_lights_off: Turns off the notes of the chord whose duration is up
+ *                    at time `now`. Returns the time at which the next one
+ *                    ends, or UINT64_MAX if none is lit.
  *****************************************************************************/
-void 
-setup() 
+uint64_t
+chord_lights_off(uint64_t now)
 {
-    /* Sets the speed (baud rate) for the serial communication. Strictly
-       speaking, with Teensy, this is a no-op. */
-    Serial.begin(57600);
-    /* Initialize the OctoWS2811 library. */
-    leds.begin();
-    /* Initiates an update of the LEDs. */
-    leds.show();
+    uint16_t ended = 0;
+    uint64_t next = UINT64_MAX;
+    size_t i;
 
-    _init_TheNewArk();
+    /* Over every slot: a chord taken off the queue since may have fewer
+       notes than the one finishing as a tail. */
+    for (i = 0; i < CHORD_MAX; i++)
+    {
+        if (!(chord_lit & (1 << i)))
+        {
+            continue;
+        }
+        if (chord_end[i] <= now)
+        {
+            ended |= 1 << i;
+        }
+        else if (chord_end[i] < next)
+        {
+            next = chord_end[i];
+        }
+    }
+
+    if (ended)
+    {
+        for (i = 0; i < N_LEDS; i++)
+        {
+            if (chord_owner[i] != NO_NOTE && (ended & (1 << chord_owner[i])))
+            {
+                fb_set_pixel(i, BLACK);
+                chord_owner[i] = NO_NOTE;
+            }
+        }
+        fb_commit();
+        chord_lit &= ~ended;
+    }
+    return next;
 }
 
 
 /*****************************************************************************
- *  _init_TheNewArk: Initialization code pertaining to the TheNewArk project.
- *
- *             Note: This must be called in `setup()`.
+ *  chord_step: Turns off the notes whose duration is up, then waits for the
+ *              next one to end. Once every note is off, or at its
+ *              EVENT_FINISHED edge if the latency offset delays the lights
+ *              past it (the rest then go off as a tail), the chord has
+ *              finished.
  *****************************************************************************/
 void
-_init_TheNewArk(void)
+chord_step(void)
 {
-    /* Initialize random number generator. */
-    srand(42);  // srand((unsigned) time(NULL));
-    /* Initialize an array of brightness levels for the drone. It should be
-       noted that free() is not actually called in this program on
-       `drone_brightness`. It will be deallocated automatically after the
-       Teensy resets due to power off and on. In retrospect, this should have
-       simply been a static array. */
-    drone_brightness = _create_quadratic_brightness(&drone_color,
-                                                    DRONE_BRIGHTNESS_N);
-    if (drone_brightness == NULL)
+    uint64_t now = micros64();
+    uint64_t next = chord_lights_off(now);
+
+    if (!chord_lit)
     {
-        abort();
+        exec_end();
+        return;
+    }
+    if (now >= edge_t[EVENT_FINISHED])
+    {
+        tail = TAIL_CHORD;
+        tail_t = next;
+        exec_end();
+        return;
     }
+    if (next > edge_t[EVENT_FINISHED])
+    {
+        next = edge_t[EVENT_FINISHED];
+    }
+    exec_begin(EXEC_CHORD, next - now);
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Loop
+//  Light programs. New idle shows ship as data rather than as a reflash: the
+//                  Python program uploads a program for a small register VM
+//                  ("program_load", in chunks), and "program_run" runs it.
+//                  The instruction set (4-byte instructions: op, a, b, c,
+//                  over 16 32-bit registers) is defined by the VM_*
+//                  constants of `_protocol_schema.py`, and `_vmasm.py`
+//                  assembles programs for it.
+//
+//                  A program is verified once after it is loaded: its
+//                  length and CRC, every opcode, every register operand and
+//                  every jump target. `vm_step()` therefore runs it without
+//                  any check but the instruction budget. Dispatch is
+//                  threaded: each instruction ends with an indirect jump
+//                  (GCC's computed goto) to the code of the next, so there
+//                  is no central switch to return to and each jump is
+//                  predicted on its own.
+//
+//                  Programs draw into the framebuffer and show frames like
+//                  the other renderers, and yield with "wait" or "beat",
+//                  whose deadlines are kept by the executor. Between two
+//                  yields a program may run at most VM_BUDGET instructions,
+//                  or it is stopped. Like the drone, a program ends at its
+//                  next yield once another message is queued, and its
+//                  lights stay as they are.
 ///////////////////////////////////////////////////////////////////////////////
+#define VM_RA  1   /* Operand `a` is a register. */
+#define VM_RB  2   /* Operand `b` is a register. */
+#define VM_RC  4   /* Operand `c` is a register. */
+#define VM_TGT 8   /* b | c << 8 is a jump target. */
+
+struct vm_insn
+{
+    uint8_t op, a, b, c;
+};
+
+/* Operands of each opcode, in the order of the VM_* opcodes. */
+static const uint8_t vm_operands[] = {
+    0,                          /* halt */
+    VM_RA,                      /* ldi */
+    VM_RA,                      /* ldhi */
+    VM_RA | VM_RB,              /* mov */
+    VM_RA | VM_RB | VM_RC,      /* add */
+    VM_RA | VM_RB | VM_RC,      /* sub */
+    VM_RA | VM_RB | VM_RC,      /* mul */
+    VM_RA | VM_RB | VM_RC,      /* and */
+    VM_RA | VM_RB | VM_RC,      /* or */
+    VM_RA | VM_RB | VM_RC,      /* xor */
+    VM_RA | VM_RB | VM_RC,      /* shl */
+    VM_RA | VM_RB | VM_RC,      /* shr */
+    VM_RA | VM_RB | VM_RC,      /* mod */
+    VM_RA,                      /* addi */
+    VM_RA | VM_RB | VM_RC,      /* lt */
+    VM_RA | VM_RB | VM_RC,      /* eq */
+    VM_TGT,                     /* jmp */
+    VM_RA | VM_TGT,             /* jz */
+    VM_RA | VM_TGT,             /* jnz */
+    VM_RA | VM_TGT,             /* djnz */
+    VM_RA | VM_RB,              /* rand */
+    0,                          /* clear */
+    VM_RA | VM_RB,              /* pixel */
+    VM_RA | VM_RB,              /* panels */
+    VM_RA | VM_RB,              /* groups */
+    VM_RA | VM_RB,              /* note */
+    VM_RA | VM_RB | VM_RC,      /* scale */
+    VM_RA | VM_RB | VM_RC,      /* blend */
+    0,                          /* show */
+    VM_RA,                      /* wait */
+    VM_RA,                      /* beat */
+    VM_RA,                      /* time */
+};
+
+_Static_assert(sizeof vm_operands == VM_TIME + 1,
+               "vm_operands does not cover every opcode.");
+
+/* The program, followed by a "halt" so that it cannot run off its end. */
+static struct vm_insn vm_code[VM_CODE_MAX + 1];
+static uint8_t vm_verified = 0;          /* Verified since loaded? */
+static uint16_t vm_length = 0;           /* Length and CRC verified. */
+static uint32_t vm_crc = 0;
+
+static uint32_t vm_reg[VM_REGS];
+static uint16_t vm_pc = 0;
+static uint32_t vm_rng = 1;              /* xorshift32 state. */
+static uint32_t vm_t0 = 0;               /* micros() when it started. */
+
+
 /*****************************************************************************
- *  loop: This function loops consecutively.
+ *  vm_load: Executes a "program_load" message. Returns 0 if the chunk does
+ *           not start on an instruction within the program buffer.
  *****************************************************************************/
-void
-loop()
+int
+vm_load(const struct msg_program_load *load)
 {
-    if (Serial.available() > 0)
+    size_t n = sizeof load->code;
+
+    if (load->at % 4 != 0 || load->at >= 4 * VM_CODE_MAX)
     {
-        parse();
+        return 0;
+    }
+    if (n > (size_t) (4 * VM_CODE_MAX - load->at))
+    {
+        n = 4 * VM_CODE_MAX - load->at;
     }
+    memcpy((uint8_t *) vm_code + load->at, load->code, n);
+    vm_verified = 0;
+    return 1;
 }
 
 
-///////////////////////////////////////////////////////////////////////////////
-//  Drone On
-///////////////////////////////////////////////////////////////////////////////
 /*****************************************************************************
- *  drone_lights: The "50 bpm drone" is used. Paddy estimates that the
- *                "50 bpm drone" peaks at 3.248 seconds and ends at 4.800
- *                seconds. The "30 bpm drone" peaks at 2.730 seconds and
- *                ends at 4.000 seconds. (3350000, 1450000) may also be good.
- *
- *                Given an interval [a, b], a < b, to divide the interval
- *                into `n` equal parts, the parts must have length
- *                L = (b - a) / n.
+ *  vm_verify: Verifies the program loaded against the `length` and `crc` of
+ *             a "program_run" message, unless that program was already
+ *             verified. Returns VM_OK or the error, and the index of the
+ *             offending instruction in `*pc`.
  *****************************************************************************/
-void
-drone_lights(void)
+uint8_t
+vm_verify(uint16_t length, uint32_t crc, uint16_t *pc)
 {
-    int i;
-    uint8_t off = 0;
+    size_t n = length / 4;
 
-    /* Edge case: end right away */
-    if (Serial.available() > 0)
+    *pc = 0;
+    if (vm_verified && length == vm_length && crc == vm_crc)
     {
-        return;
+        return VM_OK;
     }
-
-    while (1)
+    vm_verified = 0;
+    if (length == 0 || length % 4 != 0 || n > VM_CODE_MAX)
     {
-        /* Increase brightness quadratically with time over `_MICROSEC_UP`
-           microseconds. */
-        for (i = 0; i < DRONE_BRIGHTNESS_N; i++)
+        return VM_BAD_LENGTH;
+    }
+    if (crc32((const uint8_t *) vm_code, length) != crc)
+    {
+        return VM_BAD_CRC;
+    }
+    for (*pc = 0; *pc < n; (*pc)++)
+    {
+        const struct vm_insn *in = &vm_code[*pc];
+        uint8_t kind;
+
+        if (in->op >= sizeof vm_operands)
         {
-            if (Serial.available() > 0 && off == 0)
-            {
-                off = 1;
-            }
-            all_lights_RGB(drone_brightness[i].r, 0, 0, drone_delay_up);
+            return VM_BAD_OPCODE;
         }
-        /* Decrease brightness over the same curve over ` _MICROSEC_DOWN`
-           microseconds. */
-        for (i = DRONE_BRIGHTNESS_N - 1; i >= 0; i--)
+        kind = vm_operands[in->op];
+        if (((kind & VM_RA) && in->a >= VM_REGS) ||
+            ((kind & VM_RB) && in->b >= VM_REGS) ||
+            ((kind & VM_RC) && in->c >= VM_REGS))
         {
-            if (Serial.available() > 0 && off == 0)
-            {
-                off = 1;
-            }
-            all_lights_RGB(drone_brightness[i].r, 0, 0, drone_delay_down);
+            return VM_BAD_REGISTER;
         }
-        if (off)
+        if ((kind & VM_TGT) && (size_t) (in->b | in->c << 8) > n)
         {
-            return;
+            return VM_BAD_TARGET;
         }
     }
+    *pc = 0;
+    memset(&vm_code[n], 0, sizeof vm_code[n]);  /* VM_HALT */
+    vm_verified = 1;
+    vm_length = length;
+    vm_crc = crc;
+    return VM_OK;
 }
 
 
-///////////////////////////////////////////////////////////////////////////////
-//  Note On
-///////////////////////////////////////////////////////////////////////////////
 /*****************************************************************************
- *  randomize_half_panels: The 11 panels are divided into 7 groups. Each of
- *                         the 7 groups are themselves divided into 2-4
- *                         groups of 4 LEDs.
- *
- *                         The 7 groups:
- *                              "Front"      : P1, P10.
- *                              "Back"       : P5, P6.
- *                              "Left-left"  : P7, half of P8.
- *                              "Left-right" : P9, half of P8.
- *                              "Right-left" : P2, half of P3.
- *                              "Right-right": P4, half of P3.
- *                              "Top"        : P11.
- *
- *                         Within 6 out of the 7 groups (all except "Top"), one
- *                         group of 4 LEDs is selected at random and lit.
- *
- *                         For "Top", the probability that exactly one group
- *                         of four is lit is 50%; the other 50% of the time,
- *                         no group of four is lit.
+ *  vm_run: Executes a "program_run" message: verifies the program, stages
+ *          the "program_status" frame, and starts the program if it passed.
  *****************************************************************************/
 void
-randomize_half_panels(uint32_t color, uint32_t microsec_delay)
+vm_run(const struct msg_program_run *run)
 {
-    /* Loop variable */
-    int j;
+    uint8_t buf[MSG_PROGRAM_STATUS_LEN];
+    struct msg_program_status status;
 
-    /* Choose which group of 4 is selected in each group except "Top" */
-    int f  = rand() % 4, b  = rand() % 4;
-    int ll = rand() % 3, lr = rand() % 3;
-    int rl = rand() % 3, rr = rand() % 3;
+    status.status = vm_verify(run->length, run->crc, &status.pc);
+    tx_stage(buf, encode_program_status(buf, &status));
+    event_edge(EVENT_STARTED);
+    if (status.status != VM_OK)
+    {
+        event_edge(EVENT_FINISHED);
+        return;
+    }
+    tail_finish();
+    memset(vm_reg, 0, sizeof vm_reg);
+    vm_pc = 0;
+    vm_rng = run->seed ? run->seed : 1;
+    vm_t0 = micros();
+    xfade_from = NO_PC;
+    exec_begin(EXEC_PROGRAM, 0);
+}
 
-    /* Randomize number per subgroup */
-    int n_f  = 1 + rand() % 4, n_b  = 1 + rand() % 4;
-    int n_ll = 1 + rand() % 4, n_lr = 1 + rand() % 4;
-    int n_rl = 1 + rand() % 4, n_rr = 1 + rand() % 4;
 
-    /* "Top" group handled separately */
-    if (rand() % 2) {
-        int t_base = (rand() % 2) ? 80 : 84;
-        int n_t = 1 + rand() % 4;
+/*****************************************************************************
+ *  vm_end: Ends the program.
+ *****************************************************************************/
+void
+vm_end(void)
+{
+    exec_state = EXEC_IDLE;
+    event_edge(EVENT_FINISHED);
+}
 
-        for (j = 0; j < n_t; j++) {
-            leds.setPixel(t_base + j, color);
-        }
+
+/*****************************************************************************
+ *  blend_color: Returns `from` moved `level` / 256 of the way to `to`, both
+ *               0xRRGGBB.
+ *****************************************************************************/
+uint32_t
+blend_color(uint32_t from, uint32_t to, uint16_t level)
+{
+    uint32_t out = 0;
+
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        int32_t a = from >> shift & 0xFF;
+        int32_t b = to >> shift & 0xFF;
+
+        out |= (uint32_t) (a + (b - a) * level / 256) << shift;
     }
+    return out;
+}
 
-    /* Probably should be rewritten but this should suffice */
-    for (j = 0; j < n_f; j++)
-        leds.setPixel(group_f[f][j], color);
-    for (j = 0; j < n_b; j++)
-        leds.setPixel(group_b[b][j], color);
-    for (j = 0; j < n_ll; j++)
-        leds.setPixel(group_ll[ll][j], color);
-    for (j = 0; j < n_lr; j++)
-        leds.setPixel(group_lr[lr][j], color);
-    for (j = 0; j < n_rl; j++)
-        leds.setPixel(group_rl[rl][j], color);
-    for (j = 0; j < n_rr; j++)
-        leds.setPixel(group_rr[rr][j], color);
 
-    leds.show();
-    delayMicroseconds(microsec_delay);
-    all_lights_off();
+/*****************************************************************************
+ *  vm_step: Runs the program from where it yielded until it yields again,
+ *           halts or exhausts its budget.
+ *****************************************************************************/
+void
+vm_step(void)
+{
+    /* In the order of the VM_* opcodes. */
+    static void *const labels[] = {
+        &&op_halt, &&op_ldi, &&op_ldhi, &&op_mov, &&op_add, &&op_sub,
+        &&op_mul, &&op_and, &&op_or, &&op_xor, &&op_shl, &&op_shr,
+        &&op_mod, &&op_addi, &&op_lt, &&op_eq, &&op_jmp, &&op_jz,
+        &&op_jnz, &&op_djnz, &&op_rand, &&op_clear, &&op_pixel,
+        &&op_panels, &&op_groups, &&op_note, &&op_scale, &&op_blend,
+        &&op_show, &&op_wait, &&op_beat, &&op_time,
+    };
+    uint32_t *r = vm_reg;
+    uint32_t budget = VM_BUDGET;
+    const struct vm_insn *in;
+    uint64_t now, next;
+    uint32_t x;
+
+    _Static_assert(sizeof labels / sizeof labels[0] == sizeof vm_operands,
+                   "vm_step() does not cover every opcode.");
+
+#define IMM (in->b | in->c << 8)
+#define LEVEL(v) ((uint16_t) ((v) < 256 ? (v) : 256))
+#define NEXT()                                                          \
+    do                                                                  \
+    {                                                                   \
+        if (budget-- == 0)                                              \
+            goto out_of_budget;                                         \
+        in = &vm_code[vm_pc++];                                         \
+        goto *labels[in->op];                                           \
+    } while (0)
+
+    NEXT();
+
+op_ldi:
+    r[in->a] = IMM;
+    NEXT();
+op_ldhi:
+    r[in->a] = (r[in->a] & 0xFFFF) | (uint32_t) IMM << 16;
+    NEXT();
+op_mov:
+    r[in->a] = r[in->b];
+    NEXT();
+op_add:
+    r[in->a] = r[in->b] + r[in->c];
+    NEXT();
+op_sub:
+    r[in->a] = r[in->b] - r[in->c];
+    NEXT();
+op_mul:
+    r[in->a] = r[in->b] * r[in->c];
+    NEXT();
+op_and:
+    r[in->a] = r[in->b] & r[in->c];
+    NEXT();
+op_or:
+    r[in->a] = r[in->b] | r[in->c];
+    NEXT();
+op_xor:
+    r[in->a] = r[in->b] ^ r[in->c];
+    NEXT();
+op_shl:
+    r[in->a] = r[in->b] << (r[in->c] & 31);
+    NEXT();
+op_shr:
+    r[in->a] = r[in->b] >> (r[in->c] & 31);
+    NEXT();
+op_mod:
+    r[in->a] = r[in->c] ? r[in->b] % r[in->c] : 0;
+    NEXT();
+op_addi:
+    r[in->a] += (uint32_t) (int32_t) (int16_t) IMM;
+    NEXT();
+op_lt:
+    r[in->a] = r[in->b] < r[in->c];
+    NEXT();
+op_eq:
+    r[in->a] = r[in->b] == r[in->c];
+    NEXT();
+op_jmp:
+    vm_pc = IMM;
+    NEXT();
+op_jz:
+    if (r[in->a] == 0)
+        vm_pc = IMM;
+    NEXT();
+op_jnz:
+    if (r[in->a] != 0)
+        vm_pc = IMM;
+    NEXT();
+op_djnz:
+    if (--r[in->a] != 0)
+        vm_pc = IMM;
+    NEXT();
+op_rand:
+    x = vm_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    vm_rng = x;
+    r[in->a] = r[in->b] ? (uint32_t) (((uint64_t) x * r[in->b]) >> 32) : x;
+    NEXT();
+op_clear:
+    fb_clear();
+    NEXT();
+op_pixel:
+    fb_set_pixel(r[in->a] % N_LEDS, r[in->b]);
+    NEXT();
+op_panels:
+    for (size_t i = 0; i < N_LEDS; i++)
+    {
+        if (r[in->a] >> (i / 8) & 1)
+            fb_set_pixel(i, r[in->b]);
+    }
+    NEXT();
+op_groups:
+    for (size_t i = 0; i < N_LEDS; i++)
+    {
+        if (r[in->a] >> led_group[i] & 1)
+            fb_set_pixel(i, r[in->b]);
+    }
+    NEXT();
+op_note:
+    r[in->a] = map_cs_to_color[r[in->b] % 12];
+    NEXT();
+op_scale:
+    r[in->a] = scale_color(r[in->b], LEVEL(r[in->c]));
+    NEXT();
+op_blend:
+    r[in->a] = blend_color(r[in->a], r[in->b], LEVEL(r[in->c]));
+    NEXT();
+op_show:
+    fb_commit();
+    NEXT();
+op_wait:
+    if (cmd_count > 0)
+        goto halt;
+    exec_t0 += exec_wait;
+    exec_wait = r[in->a];
+    return;
+op_beat:
+    if (cmd_count > 0)
+        goto halt;
+    now = micros64();
+    next = (tempo_bpm_milli && r[in->a]) ? tempo_next(now + 1, r[in->a])
+                                         : now + AFTERGLOW_FRAME_US;
+    exec_t0 = (uint32_t) now;
+    exec_wait = next - now;
+    return;
+op_time:
+    r[in->a] = micros() - vm_t0;
+    NEXT();
+
+out_of_budget:
+op_halt:
+halt:
+    vm_end();
+
+#undef IMM
+#undef LEVEL
+#undef NEXT
 }
 
 
@@ -661,25 +3182,21 @@ _create_exponential_brightness(struct color *col, size_t n)
 void
 all_lights_off(void)
 {
-    for (size_t i = 0; i < N_LEDS; i++) {
-        leds.setPixel(i, BLACK);
-    }
-    leds.show();
+    fb_clear();
+    fb_commit();
 }
 
 
 /*****************************************************************************
  *  all_lights_RGB: Turns on all LEDs with color
- *                  (R, G, B) = (`red`, `green`, `blue`) for time
- *                  `microsec_delay`. Does not turn off the lights.
+ *                  (R, G, B) = (`red`, `green`, `blue`). Does not turn off
+ *                  the lights.
  *****************************************************************************/
 void
-all_lights_RGB(uint8_t red, uint8_t green, uint8_t blue,
-               uint32_t microsec_delay)
+all_lights_RGB(uint8_t red, uint8_t green, uint8_t blue)
 {
     for (size_t i = 0; i < N_LEDS; i++) {
-        leds.setPixel(i, red, green, blue);
+        fb_set_pixel_rgb(i, red, green, blue);
     }
-    leds.show();
-    delayMicroseconds(microsec_delay);
+    fb_commit();
 }
@@ -0,0 +1,646 @@
+###############################################################################
+#   Imports
+###############################################################################
+import os
+import select
+import statistics
+import termios
+import zlib
+
+from time import perf_counter
+
+import _protocol as proto
+
+
+###############################################################################
+#   Logging
+###############################################################################
+import logging
+logger = logging.getLogger()
+
+
+###############################################################################
+#   Exceptions
+###############################################################################
+class LinkError(Exception):
+    pass
+
+
+###############################################################################
+#   Replies: device -> host frames sent in response to a request message,
+#            right after its ack.
+###############################################################################
+REPLIES = (proto.Telemetry, proto.Hashes, proto.ProgramStatus)
+
+
+def frame_crc(rgb):
+    """Returns the hash the microcontroller records for a shown frame whose
+    R, G, B bytes (in LED address order) are `rgb`."""
+    return zlib.crc32(bytes(rgb))
+
+
+def latency_from_skews(skews_us, offset_us=0):
+    """Returns the latency offset that aligns lights with sound, given
+    `skews_us`, a sequence of measured (sound onset - light onset) times in
+    microseconds, taken while the offset was `offset_us`. Onsets can be
+    measured, for example, with a photodiode and a microphone on two inputs
+    of the same sound card.
+
+    The median skew is used, after discarding skews more than 3 median
+    absolute deviations from it (e.g. a missed or doubled onset). The
+    result is clamped to LATENCY_MAX_US."""
+    skews = list(skews_us)
+    if not skews:
+        raise ValueError("No skews measured.")
+    median = statistics.median(skews)
+    mad = statistics.median(abs(x - median) for x in skews)
+    kept = [x for x in skews if abs(x - median) <= 3 * mad] or skews
+    offset = offset_us + round(statistics.median(kept))
+    return max(-proto.LATENCY_MAX_US, min(proto.LATENCY_MAX_US, offset))
+
+
+def refresh_rates(before, after, seconds):
+    """Returns `(shows_per_s, skipped_per_s, saved_us_per_s)` over
+    `seconds` between two `Telemetry` readings: the rate at which frames
+    were handed to the LED driver, the rate at which committed frames were
+    skipped because they were already on the LEDs, and the driver time
+    those skips saved, at the average cost of a show."""
+    shows = (after.shows - before.shows) & 0xFFFFFFFF
+    skipped = (after.shows_skipped - before.shows_skipped) & 0xFFFFFFFF
+    show_us = (after.show_us - before.show_us) & 0xFFFFFFFF
+    per_show = show_us / shows if shows else 0
+    return shows / seconds, skipped / seconds, skipped * per_show / seconds
+
+
+###############################################################################
+#   Link class: the host end of the USB-serial session with the
+#               microcontroller. Wraps an open `Serial` instance and replaces
+#               its `write(data)` / `read(size=1)` pair on the playback path.
+#
+#               Frames are encoded by the generated codec straight into a
+#               preallocated buffer, written with a single `os.write()`, and
+#               the acks are read with `os.readv()` into a second
+#               preallocated buffer, so the per-note path allocates nothing
+#               but the returned ack tuples. The port is switched to blocking
+#               reads that return as soon as anything has arrived, or after
+#               `READ_TICK` with nothing (VMIN 0, VTIME 1), so waiting for an
+#               ack is the `os.readv()` itself, with no `poll()` before it:
+#               a note costs one `os.write()` and one `os.readv()`, where
+#               the original path made a `write()`, a `select()` and a
+#               `read()`. Both release the GIL while they wait.
+#
+#               A batch of messages is written with one `os.write()` and its
+#               acks are usually collected by one `os.readv()`, since the
+#               microcontroller answers messages in order.
+#
+#               Per message, this costs the host less than the original
+#               `bytearray` builder with `Serial.write()` and a one-byte
+#               `Serial.read()` did (see the test below), even though each
+#               ack is now a checked frame, whose sequence number, credit
+#               and device timestamps keep the flow control, the events and
+#               `device_time()` below up to date.
+#
+#               Flow control is credit-based: `credits` is the number of
+#               messages the microcontroller's command queue is known to have
+#               room for. Every ack carries the microcontroller's credit
+#               limit, from which `credits` is recomputed; until the first
+#               ack, a single message may be outstanding. No send method ever
+#               writes beyond `credits`, so a long batch streams at the rate
+#               the lights are rendered without anything being lost or piling
+#               up in the USB buffers.
+#
+#               Once `set_notifications(True)` has been called, the
+#               microcontroller also reports when the lights for each message
+#               actually started and finished ("event" frames). Events are
+#               collected in `events`, keyed by `(seq, edge)`, as they arrive
+#               between acks, and `wait_event()` blocks until a given one has
+#               arrived. Events nobody waits for (e.g. EVENT_STARTED, or those
+#               of the drone) are discarded, oldest first, beyond
+#               `max_events`.
+#
+#               "stream_frame" messages (`send_frame()`) are fire-and-forget:
+#               the microcontroller keeps only the newest frame in a
+#               single-slot mailbox, so they take no credit and get no ack.
+#               How many were shown or superseded is reported by
+#               `get_telemetry()`. "bands" messages (`send_bands()`), the
+#               audio envelope levels of `_envelope.py`, are sent the same
+#               way.
+#
+#               `get_hashes()` reads back the CRC-32 of the last frames the
+#               microcontroller actually showed, to be compared with
+#               `frame_crc()` of the frames expected.
+#
+#               `set_latency()` shifts the lights of notes and chords
+#               relative to their events (and so to the sound the host starts
+#               on them); `calibrate_latency()` derives the shift from
+#               measured skews.
+#
+#               `device_time()` estimates the microcontroller's `micros()`
+#               from the latest ack, for messages that carry a device
+#               timestamp (e.g. the beat 0 of "tempo"). It pairs the time
+#               the read that brought the ack returned with the ack's
+#               `tx_us`, the time it was sent: an ack is sent when its
+#               message is taken off the queue, which may be seconds after
+#               `rx_us`, when it was accepted. A read only happens once every
+#               complete frame before it has been taken, so each frame taken
+#               came in with the latest read.
+#
+#               `post()` and `pump()` are the same session without blocking,
+#               for callers that multiplex many links on one thread (see
+#               `_arkd.py`): `post()` writes a prebuilt frame against a credit
+#               and returns at once, and `pump()` decodes whatever has
+#               arrived, returning the acks and storing events and replies as
+#               the blocking methods do. `fd` is then to be polled for
+#               reading by the caller.
+#
+#               As with `Serial`, a partial write or a missing response is
+#               treated as fatal: `LinkError` is raised and the caller is
+#               expected to restart the computer.
+###############################################################################
+class Link:
+    max_batch = 64      # Maximum number of messages in one `send_batch()`.
+    max_events = 256    # Maximum number of events kept in `events`.
+    READ_TICK = 0.1     # Longest blocking read with nothing received (s).
+
+    def __init__(self, ser, timeout=None):
+        self.ser = ser
+        self.fd = ser.fileno()
+        self.timeout = ser.timeout if timeout is None else timeout
+
+        # Blocking reads returning at the first byte, or after READ_TICK.
+        os.set_blocking(self.fd, True)
+        attrs = termios.tcgetattr(self.fd)
+        attrs[6][termios.VMIN] = 0
+        attrs[6][termios.VTIME] = round(self.READ_TICK * 10)
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+
+        self._out = bytearray(self.max_batch * proto.MAX_FRAME)
+        self._out_view = memoryview(self._out)
+        self._in = bytearray(64 * proto.MAX_FRAME)
+        self._in_view = memoryview(self._in)
+        self._start = 0     # First unconsumed byte in `_in`.
+        self._end = 0       # One past the last received byte in `_in`.
+
+        self._poll = select.poll()
+        self._poll.register(self.fd, select.POLLIN)
+
+        self.credits = 1    # Messages that may be sent before the next ack.
+        self._unacked = 0   # Messages sent but not yet acked.
+
+        self.notifications = False
+        self.events = {}    # (seq, edge) -> micros() on the microcontroller.
+        self._replies = {}  # Reply type -> latest unclaimed reply.
+        self._clock = None  # (perf_counter(), tx_us) of the latest ack.
+        self._rx_t = None   # perf_counter() as the latest read returned.
+        self.latency_us = 0  # Latency offset last sent.
+
+    def send(self, frame):
+        """Sends a prebuilt frame (e.g. `Drone.serial_on_message`). Returns
+        its ack."""
+        self._write(frame, len(frame), 1)
+        return self._await(1)[0]
+
+    def send_note(self, pitch_class, duration_us):
+        """Sends a "note" message. Returns its ack."""
+        n = proto.encode_note_into(self._out, 0, pitch_class, duration_us)
+        self._write(self._out_view, n, 1)
+        return self._await(1)[0]
+
+    def send_midi_note(self, note, velocity, duration_us,
+                       step=proto.NO_STEP):
+        """Sends a "midi_note" message, starting on grid point `step` of the
+        last tempo if given. Returns its ack."""
+        n = proto.encode_midi_note_into(self._out, 0, note, velocity,
+                                        duration_us, step)
+        self._write(self._out_view, n, 1)
+        return self._await(1)[0]
+
+    def send_chord(self, notes):
+        """Sends a "chord" message lighting up to 12 `(pitch_class,
+        duration_us)` pairs at once. Returns its ack."""
+        notes = list(notes)
+        if not 1 <= len(notes) <= 12:
+            raise proto.ProtocolError("A chord has 1 to 12 notes.")
+        pad = [(0, 0)] * (12 - len(notes))
+        pitch_classes, durations = zip(*(notes + pad))
+        n = proto.encode_chord_into(self._out, 0, len(notes), pitch_classes,
+                                    durations)
+        self._write(self._out_view, n, 1)
+        return self._await(1)[0]
+
+    def send_batch(self, notes):
+        """Streams a sequence of `(pitch_class, duration_us)` pairs as "note"
+        messages, each write carrying as many as there are credits for.
+        Returns their acks, in order. The microcontroller acks a note when it
+        starts rendering it, so this returns once the last note has
+        started."""
+        acks = []
+        i, n = 0, len(notes)
+        while i < n:
+            count = min(self.credits, self.max_batch, n - i)
+            if count == 0:
+                acks.extend(self._await(1))
+                continue
+            offset = 0
+            for pitch_class, duration_us in notes[i:i + count]:
+                offset = proto.encode_note_into(self._out, offset,
+                                                pitch_class, duration_us)
+            self._write(self._out_view, offset, count)
+            i += count
+        acks.extend(self._await(self._unacked))
+        return acks
+
+    def send_frame(self, rgb):
+        """Sends a "stream_frame" message; `rgb` holds the R, G and B of each
+        LED in address order. Returns as soon as it is written."""
+        n = proto.encode_stream_frame_into(self._out, 0, rgb)
+        self._write(self._out_view, n, 0)
+
+    def send_bands(self, levels, depth=255):
+        """Sends a "bands" message: the envelope level (0 to 255) of each of
+        the BANDS_N bands, lowest first, and the modulation depth. Returns
+        as soon as it is written."""
+        n = proto.encode_bands_into(self._out, 0, levels, depth)
+        self._write(self._out_view, n, 0)
+
+    def get_telemetry(self):
+        """Returns the microcontroller's streaming and refresh counters as a
+        `Telemetry`; see also `refresh_rates()`."""
+        self.send(proto.encode_get_telemetry())
+        return self._await_reply(proto.Telemetry)
+
+    def set_tempo(self, bpm, beat0_us=None, beats_per_bar=0, quantize=0,
+                  drone_sync=False):
+        """Sends a "tempo" message (see `_protocol_schema.py`). `bpm` may be
+        fractional; 0 stops the beat clock. Beat 0 defaults to now. Returns
+        the ack."""
+        if beat0_us is None:
+            beat0_us = self.device_time()
+        return self.send(proto.encode_tempo(
+            round(bpm * 1000), beat0_us & 0xFFFFFFFF, beats_per_bar,
+            quantize, 1 if drone_sync else 0))
+
+    def set_afterglow(self, decay):
+        """Sends an "afterglow" message. `decay` holds the decay factors (out
+        of 256) for R, G and B of each of the 7 panel groups, or a single
+        (R, G, B) triple used for every group. All 0 turns the afterglow off.
+        Returns the ack."""
+        decay = tuple(decay)
+        if len(decay) == 3:
+            decay *= 7
+        return self.send(proto.encode_afterglow(decay))
+
+    def set_latency(self, offset_us):
+        """Sends a "latency" message: the lights of notes and chords go on
+        and off `offset_us` microseconds after their events (before, if
+        negative). Returns the ack."""
+        ack = self.send(proto.encode_latency(offset_us))
+        self.latency_us = offset_us
+        return ack
+
+    def set_crossfade(self, duration_us):
+        """Sends a "crossfade" message: each note starts in the color of the
+        previous one and glides into its own over `duration_us`
+        microseconds. 0 turns crossfades off. Returns the ack."""
+        return self.send(proto.encode_crossfade(duration_us))
+
+    def calibrate_latency(self, skews_us):
+        """Sets the latency offset from skews (sound onset - light onset, in
+        microseconds) measured with the current offset; see
+        `latency_from_skews()`. Returns the new offset."""
+        offset = latency_from_skews(skews_us, self.latency_us)
+        self.set_latency(offset)
+        return offset
+
+    def device_time(self, t=None):
+        """Returns the estimated value of the microcontroller's `micros()`
+        at `perf_counter()` time `t` (default: now). Ignores the time acks
+        spend in transit, so the estimate is slightly early."""
+        if t is None:
+            t = perf_counter()
+        if self._clock is None:
+            raise LinkError("No ack received yet.")
+        host_t, tx_us = self._clock
+        return (tx_us + round((t - host_t) * 1_000_000)) & 0xFFFFFFFF
+
+    def load_program(self, code):
+        """Uploads the light program `code` (bytecode, e.g. from
+        `_vmasm.assemble()`) in "program_load" messages. Returns their
+        acks."""
+        chunk = 64      # Length of the `code` field of "program_load".
+        return [self.send(proto.encode_program_load(
+                    k, code[k:k + chunk].ljust(chunk, b"\0")))
+                for k in range(0, len(code), chunk)]
+
+    def run_program(self, code, seed=0):
+        """Sends a "program_run" message for `code`, which must have been
+        loaded with `load_program()`. The program runs until it halts or
+        the next message. Returns the ack; raises LinkError if the
+        microcontroller rejects the program."""
+        ack = self.send(proto.encode_program_run(len(code), zlib.crc32(code),
+                                                 seed))
+        status = self._await_reply(proto.ProgramStatus)
+        if status.status != proto.VM_OK:
+            raise LinkError(f"Program rejected: status {status.status} at "
+                            f"instruction {status.pc}.")
+        return ack
+
+    def get_hashes(self):
+        """Returns `(count, hashes)`: the number of frames shown since the
+        microcontroller powered up, and `(t_us, crc)` for each of the last
+        (at most FRAME_HASH_N) frames, newest first. Compare `crc` with
+        `frame_crc()` of the expected frame."""
+        self.send(proto.encode_get_hashes())
+        reply = self._await_reply(proto.Hashes)
+        n = min(reply.count, proto.FRAME_HASH_N)
+        return reply.count, list(zip(reply.t_us[:n], reply.crc[:n]))
+
+    def set_notifications(self, enable):
+        """Enables or disables "event" frames. Returns the ack."""
+        ack = self.send(proto.encode_notify(1 if enable else 0))
+        self.notifications = bool(enable)
+        return ack
+
+    def post(self, frame):
+        """Writes a prebuilt frame without waiting for its ack, which a
+        later `pump()` returns. Raises LinkError if there is no credit."""
+        self._write(frame, len(frame), 1)
+
+    def pump(self):
+        """Decodes every frame received so far, without blocking. Returns
+        the acks among them, in order; events and replies are stored for
+        `wait_event()` and the like, or to be looked up in `events`."""
+        acks = []
+        while True:
+            frame = self._take_frame()
+            if frame is None:
+                if not self._poll.poll(0):
+                    return acks
+                if not self._read():
+                    raise LinkError("USB-Serial connection closed.")
+            elif isinstance(frame, proto.Ack):
+                self._acked(frame)
+                acks.append(frame)
+            elif not self._dispatch(frame):
+                raise LinkError(f"Unexpected frame {frame!r}.")
+
+    def wait_event(self, seq, edge, timeout):
+        """Blocks until the microcontroller reports edge `edge` (e.g.
+        `EVENT_FINISHED`) of the message acked with sequence number `seq`.
+        Returns the `micros()` value at the edge."""
+        key = (seq, edge)
+        deadline = perf_counter() + timeout
+        while key not in self.events:
+            frame = self._read_frame(deadline)
+            if not self._dispatch(frame):
+                raise LinkError(f"Unexpected frame {frame!r}.")
+        return self.events.pop(key)
+
+    def _await_reply(self, cls):
+        """Returns the next reply of type `cls` (e.g. `Telemetry`)."""
+        deadline = perf_counter() + self.timeout
+        while cls not in self._replies:
+            frame = self._read_frame(deadline)
+            if not self._dispatch(frame):
+                raise LinkError(f"Unexpected frame {frame!r}.")
+        return self._replies.pop(cls)
+
+    def _dispatch(self, frame):
+        """Stores `frame` if it is an event or a reply. Returns whether it
+        was."""
+        if isinstance(frame, REPLIES):
+            self._replies[type(frame)] = frame
+            return True
+        if not isinstance(frame, proto.Event):
+            return False
+        events = self.events
+        events[(frame.seq, frame.edge)] = frame.t_us
+        if len(events) > self.max_events:
+            del events[next(iter(events))]
+        return True
+
+    def _write(self, data, n, count):
+        """Writes the first `n` bytes of `data`, holding `count` messages."""
+        if count > self.credits:
+            raise LinkError("Message sent without credit.")
+        try:
+            written = os.write(self.fd, data[:n])
+        except (BlockingIOError, InterruptedError):
+            written = 0
+        if written < n:
+            raise LinkError("Not all bytes written through USB-Serial.")
+        self.credits -= count
+        self._unacked += count
+
+    def _await(self, n):
+        """Returns the next `n` acks."""
+        deadline = perf_counter() + self.timeout
+        acks = []
+        while len(acks) < n:
+            frame = self._read_frame(deadline)
+            if isinstance(frame, proto.Ack):
+                self._acked(frame)
+                acks.append(frame)
+            elif not self._dispatch(frame):
+                raise LinkError(f"Unexpected frame {frame!r}.")
+        return acks
+
+    def _acked(self, ack):
+        # Messages still unacked follow this one in sequence.
+        self._unacked -= 1
+        self.credits = (ack.credit - ack.seq - 1 - self._unacked) & 0xFFFF
+        self._clock = (self._rx_t, ack.tx_us)
+
+    def _read_frame(self, deadline):
+        """Returns the next decoded frame, reading from the port as needed."""
+        while True:
+            frame = self._take_frame()
+            if frame is not None:
+                return frame
+            self._fill(deadline)
+
+    def _take_frame(self):
+        """Returns the next decoded frame in `_in`, or None if there is no
+        complete one."""
+        while True:
+            # Skip anything that cannot start a frame.
+            start, end = self._start, self._end
+            while start < end and self._in[start] != proto.SOF:
+                start += 1
+            self._start = start
+
+            if end - start < 2:
+                return None
+            n = proto.frame_len(self._in[start + 1])
+            if n == 0:
+                self._start = start + 1
+                continue
+            if end - start < n:
+                return None
+            self._start = start + n
+            try:
+                return proto.decode(self._in, start)
+            except proto.ProtocolError as err:
+                raise LinkError(f"Malformed frame: {err}") from None
+
+    def _fill(self, deadline):
+        while not self._read():
+            if perf_counter() >= deadline:
+                raise LinkError("No response from microcontroller.")
+
+    def _read(self):
+        """Reads what has arrived, waiting up to READ_TICK for anything.
+        Returns the number of bytes read."""
+        # Move the partial frame, if any, to the front of the buffer.
+        if self._start:
+            pending = self._end - self._start
+            self._in[:pending] = self._in[self._start:self._end]
+            self._start, self._end = 0, pending
+
+        n = os.readv(self.fd, [self._in_view[self._end:]])
+        self._rx_t = perf_counter()
+        self._end += n
+        return n
+
+
+###############################################################################
+#   Test: per-note host cost of the original path (bytearray builder,
+#         `Serial.write()`, `Serial.read(size=1)`) against `Link`. A child
+#         process on the master end of a pseudo-terminal plays the
+#         microcontroller, answering each frame immediately, so both paths
+#         pay for the same device; the host overhead is the CPU time of
+#         the host process.
+#         The system calls each path makes are counted in a second, shorter
+#         run: `send_note()` must make exactly one `os.write()` and one
+#         `os.readv()` per note.
+#
+#         Status: successful.
+###############################################################################
+if __name__ == '__main__':
+    import pty
+    import sys
+    import tty
+
+    from time import process_time
+
+    import serial
+
+    def legacy_builder(note, duration):
+        # Copy of the original `Composition.serial_message_builder()`.
+        duration = int(duration * 1_000_000)
+        message = bytearray(11)
+        message[0] = ord("%")
+        message[1] = ord("2")
+        message[2] = note
+        for idx, ch in enumerate(str(duration), start=3):
+            message[idx] = ord(ch)
+        message[10] = ord("&")
+        return message
+
+    def device(fd, legacy):
+        seq = 0
+        buf = b""
+        while True:
+            try:
+                data = os.read(fd, 4096)
+            except OSError:
+                return
+            if not data:
+                return
+            buf += data
+            out = b""
+            while len(buf) >= 2 and len(buf) >= proto.frame_len(buf[1]):
+                n = proto.frame_len(buf[1])
+                buf = buf[n:]
+                now = int(perf_counter() * 1e6) & 0xFFFFFFFF
+                out += b"1" if legacy else proto.encode_ack(
+                    seq, now, now, (seq + 1 + proto.CMD_QUEUE_LEN) & 0xFFFF)
+                seq = (seq + 1) & 0xFFFF
+            os.write(fd, out)
+
+    class Counted:
+        """Counts the calls to the system call wrappers the two paths use,
+        while in a `with` block."""
+        names = (("os", "write"), ("os", "read"), ("os", "readv"),
+                 ("select", "select"))
+
+        def __enter__(self):
+            self.calls = 0
+            self.saved = []
+            for module, name in self.names:
+                module = sys.modules[module]
+                call = getattr(module, name)
+                self.saved.append((module, name, call))
+                setattr(module, name, self.wrap(call))
+            return self
+
+        def __exit__(self, *exc):
+            for module, name, call in self.saved:
+                setattr(module, name, call)
+
+        def wrap(self, call):
+            def counted(*args, **kwargs):
+                self.calls += 1
+                return call(*args, **kwargs)
+            return counted
+
+    def bench(legacy, n):
+        master, slave = pty.openpty()
+        tty.setraw(master)
+        tty.setraw(slave)
+        pid = os.fork()
+        if pid == 0:
+            os.close(slave)
+            device(master, legacy)
+            os._exit(0)
+        os.close(master)
+        ser = serial.Serial(os.ttyname(slave), timeout=10, write_timeout=0)
+        os.close(slave)
+
+        if legacy:
+            def play(i):
+                message = legacy_builder(i % 12, 0.588235)
+                if ser.write(message) < len(message) or not ser.read(size=1):
+                    raise SystemExit("legacy path failed")
+        else:
+            link = Link(ser)
+
+            def play(i):
+                link.send_note(i % 12, 588235)
+            link._poll = None           # `send_note()` must not poll.
+
+        for i in range(100):            # Warm up.
+            play(i)
+        start, cpu = perf_counter(), process_time()
+        for i in range(n):
+            play(i)
+        elapsed = perf_counter() - start
+        cpu = process_time() - cpu
+        with Counted() as counted:
+            for i in range(100):
+                play(i)
+
+        batched = 0
+        if not legacy:
+            batch = [(i % 12, 588235) for i in range(16)]
+            start = perf_counter()
+            for _ in range(n // 16):
+                link.send_batch(batch)
+            batched = (perf_counter() - start) / (n // 16 * 16)
+
+        ser.close()
+        os.waitpid(pid, 0)
+        return elapsed / n, cpu / n, counted.calls / 100, batched
+
+    n = 20_000
+    t_legacy, cpu_legacy, calls_legacy, _ = bench(legacy=True, n=n)
+    t_link, cpu_link, calls_link, t_batch = bench(legacy=False, n=n)
+    print(f"original path   : {t_legacy * 1e6:6.1f} us/note "
+          f"({cpu_legacy * 1e6:4.1f} us host CPU), "
+          f"{calls_legacy:.1f} system calls/note")
+    print(f"Link.send_note  : {t_link * 1e6:6.1f} us/note "
+          f"({cpu_link * 1e6:4.1f} us host CPU), "
+          f"{calls_link:.1f} system calls/note")
+    print(f"Link.send_batch : {t_batch * 1e6:6.1f} us/note (16 per batch)")
+    if calls_link != 2:
+        raise SystemExit("FAILED: send_note() is not one write and one read.")
@@ -0,0 +1,398 @@
+###############################################################################
+#   Light-load Monte Carlo: estimates how hard compositions work the LEDs and
+#                           their power supply, which cannot be measured on
+#                           the sculpture. Random compositions are generated
+#                           as `Composition` does, each note is laid out on
+#                           the LEDs as `randomize_placed_panels()` in
+#                           `_lights.cpp` does for a "midi_note" message
+#                           (including the downbeat accent of "Top"), and
+#                           the lit LEDs are accumulated over time.
+#
+#                           Reported, with histograms:
+#                               - the duty cycle of each LED (fraction of the
+#                                 playing time it is lit);
+#                               - the number of LEDs lit at once;
+#                               - the supply current and power per note and
+#                                 averaged over each composition.
+#
+#                           Only one note is lit at a time and the drone
+#                           between compositions is not included. Times are
+#                           counted in sixths of a beat (the quantization
+#                           grid), so the results do not depend on the tempo.
+#
+#                           Compositions are simulated in chunks by a pool of
+#                           worker processes (one per core by default), with
+#                           the notes of a chunk laid out in vectorized
+#                           numpy. Each chunk draws from its own PRNG stream,
+#                           spawned from a single `SeedSequence`, so the
+#                           results depend on the seed but not on the number
+#                           of workers, and throughput scales with the cores.
+#
+#   Usage: python3 _loadsim.py [-n COMPOSITIONS] [-j WORKERS] [--seed SEED]
+#                              [--out FILE.npz] [--scaling]
+###############################################################################
+import argparse
+import multiprocessing
+import os
+import sys
+
+from time import perf_counter
+
+import numpy as np
+
+from _tonerow import N_TONEROW
+
+
+###############################################################################
+#   Constants. The layout tables mirror those of `_lights.cpp`.
+#
+#   MA_PER_CHANNEL : current drawn by one color channel of one LED at full
+#                    brightness (WS2811), in milliamperes.
+#
+#   SUPPLY_V       : supply voltage of the strips.
+###############################################################################
+N_LEDS = 88
+N_NOTES = 4 * N_TONEROW     # Notes in a composition.
+SIXTHS_PER_BAR = 6 * 4      # `Composition.beats_per_bar` beats.
+VELOCITY = 63               # `Composition.velocity`.
+VELOCITY_FLOOR = 48
+
+MA_PER_CHANNEL = 20.0
+SUPPLY_V = 5.0
+
+# `map_cs_to_color`.
+COLORS = (0xFF0000, 0xCE9AFF, 0xFFFF00, 0x656599, 0xE3FBFF, 0xAC1C00,
+          0x00CCFF, 0xFF6500, 0xFF00FF, 0x33CC33, 0x8C8A8C, 0x0000FE)
+
+# Groups of 4 LEDs of the 6 lower groups of panels ("Front", "Back",
+# "Left-left", "Left-right", "Right-left", "Right-right"), padded to 4.
+LOWER_QUADS = np.array((
+    ((72, 73, 74, 75), (76, 77, 78, 79), (0, 1, 2, 3), (4, 5, 6, 7)),
+    ((32, 33, 34, 35), (36, 37, 38, 39), (40, 41, 42, 43), (44, 45, 46, 47)),
+    ((48, 49, 50, 51), (52, 53, 54, 55), (56, 57, 58, 59), (0, 0, 0, 0)),
+    ((60, 61, 62, 63), (64, 65, 66, 67), (68, 69, 70, 71), (0, 0, 0, 0)),
+    ((8, 9, 10, 11), (12, 13, 14, 15), (16, 17, 18, 19), (0, 0, 0, 0)),
+    ((20, 21, 22, 23), (24, 25, 26, 27), (28, 29, 30, 31), (0, 0, 0, 0)),
+), dtype=np.intp)
+LOWER_N_QUADS = np.array((4, 4, 3, 3, 3, 3))
+
+# `octave_placement`: (lower groups lit, groups of 4 of "Top" lit), indexed
+# by MIDI note number // 12.
+PLACEMENT = np.array(((6, 0), (6, 0), (6, 0), (5, 0), (5, 1), (4, 1),
+                      (3, 1), (3, 2), (2, 2), (2, 2), (2, 2)))
+
+# Durations in sixths of a beat: `Composition.dur_o`, `dur_eov`, `dur_eoc`.
+DUR_O = (6, 3, 2)
+DUR_EOV = (12, 6)
+DUR_EOC = 24
+
+CURRENT_BIN_MA = 100        # Width of the current histogram bins.
+AVG_BIN_MA = 10             # Width of the average-current histogram bins.
+
+
+def velocity_level(v):
+    """`velocity_level[v]` of `_lights.cpp`."""
+    if v == 0:
+        return 0
+    x = (v - 1) / 126
+    return int(VELOCITY_FLOOR + (256 - VELOCITY_FLOOR) * x * x + 0.5)
+
+
+def note_current_ma(velocity):
+    """Returns the current drawn by one LED lit in the color of each pitch
+    class at `velocity`, in milliamperes, as a 12-element array."""
+    level = velocity_level(velocity)
+    ma = []
+    for color in COLORS:
+        channels = ((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF)
+        ma.append(sum((c * level) >> 8 for c in channels) / 255 *
+                  MA_PER_CHANNEL)
+    return np.array(ma)
+
+
+LED_MA = note_current_ma(VELOCITY)
+MAX_MA = N_LEDS * 3 * MA_PER_CHANNEL
+
+
+###############################################################################
+#   Compositions
+###############################################################################
+def gen_pitch_classes(rng, n):
+    """Returns the pitch classes of `n` compositions, as an (n, 48) array:
+    a random tone row followed by its retrograde, inversion and
+    retrograde-inversion in random order."""
+    rows = rng.permuted(np.tile(np.arange(N_TONEROW), (n, 1)), axis=1)
+    inv = (2 * rows[:, :1] - rows) % N_TONEROW
+    variations = np.stack((rows[:, ::-1], inv, inv[:, ::-1]), axis=1)
+    variations = rng.permuted(variations, axis=1)
+    return np.concatenate((rows, variations.reshape(n, -1)), axis=1)
+
+
+def gen_notes(rng, pitch_classes):
+    """Returns MIDI note numbers for `pitch_classes`, with octaves drawn as
+    in `Composition.randomize_octaves()`: one of the 6 lowest piano keys of
+    the pitch class, and for the first and last notes of a composition,
+    one of keys 1 to 3 (or 4, for pitch classes with 8 keys)."""
+    first_key = (pitch_classes + 3) % N_TONEROW
+    k = rng.integers(0, 6, pitch_classes.shape)
+    # Pitch classes whose lowest key is among the first 4 have 8 keys.
+    n_ends = np.where(first_key[:, [0, -1]] < 4, 4, 3)
+    k[:, [0, -1]] = 1 + (rng.random(n_ends.shape) * n_ends).astype(int)
+    return first_key + 12 * k + 21
+
+
+def gen_durations(rng, n):
+    """Returns the durations of the notes of `n` compositions, in sixths of
+    a beat, as an (n, 48) array, drawn as in `Composition._gen_durations()`
+    for all compositions at once: each row is split into groups of 1-3
+    notes (a quarter, two eighths or three triplet-eighths) up to its last
+    note, which is a half or quarter note (a whole note for the last
+    row)."""
+    dur_o = np.array(DUR_O)
+    durations = np.empty((n, N_NOTES), dtype=np.int64)
+    rows = np.arange(n)
+    for i in range(4):
+        base = i * N_TONEROW
+        cur = np.zeros(n, dtype=np.intp)
+        while True:
+            active = cur < N_TONEROW - 1
+            if not active.any():
+                break
+            if i == 0 and not cur.any():
+                # First note of a composition: a quarter or eighth note.
+                notes_per_beat = 2 - rng.integers(0, 2, n)
+            else:
+                high = np.minimum(N_TONEROW - 1 - cur, len(DUR_O))
+                notes_per_beat = 1 + (rng.random(n) * high).astype(np.intp)
+            for k in range(len(DUR_O)):
+                sel = active & (k < notes_per_beat)
+                durations[rows[sel], base + cur[sel] + k] = \
+                    dur_o[notes_per_beat[sel] - 1]
+            cur = np.where(active, cur + notes_per_beat, cur)
+        durations[:, base + N_TONEROW - 1] = \
+            DUR_EOC if i == 3 else np.array(DUR_EOV)[rng.integers(0, 2, n)]
+    return durations
+
+
+###############################################################################
+#   Layout: the LEDs lit by each note.
+###############################################################################
+def layout(rng, notes, downbeat):
+    """Returns an (n, 88) boolean array of the LEDs lit by the MIDI notes
+    `notes` (flattened), given which of them start on a downbeat."""
+    n = len(notes)
+    n_lower, n_top = PLACEMENT[notes // 12].T
+    lit = np.zeros((n, N_LEDS), dtype=bool)
+    rows = np.arange(n)
+
+    # The first `n_lower` lower groups in random order, each with 1-4 LEDs
+    # of one of its groups of 4.
+    rank = rng.random((n, 6)).argsort(axis=1).argsort(axis=1)
+    quad = (rng.random((n, 6)) * LOWER_N_QUADS).astype(np.intp)
+    count = rng.integers(1, 5, (n, 6))
+    leds = LOWER_QUADS[np.arange(6), quad]
+    sel = (rank < n_lower[:, None])[:, :, None] & \
+        (np.arange(4) < count[:, :, None])
+    lit[np.broadcast_to(rows[:, None, None], sel.shape)[sel], leds[sel]] = \
+        True
+
+    # "Top": `n_top` of its 2 groups of 4, starting with a random one.
+    j = rng.integers(0, 2, n)
+    count = rng.integers(1, 5, (n, 2))
+    for i in range(2):
+        base = 80 + 4 * ((i + j) % 2)
+        for k in range(4):
+            on = (i < n_top) & (k < count[:, i])
+            lit[rows[on], base[on] + k] = True
+
+    # Downbeat accent: all of "Top".
+    lit[downbeat, 80:88] = True
+    return lit
+
+
+###############################################################################
+#   Simulation
+###############################################################################
+def new_stats():
+    return {
+        "compositions": 0,
+        "notes": 0,
+        "time": 0,                                      # Sixths of a beat.
+        "lit_time": np.zeros(N_LEDS, dtype=np.int64),   # Per LED.
+        "lit_notes": np.zeros(N_LEDS + 1, dtype=np.int64),
+        "lit_weighted": np.zeros(N_LEDS + 1, dtype=np.int64),
+        "current": np.zeros(int(MAX_MA) // CURRENT_BIN_MA + 1,
+                            dtype=np.int64),
+        "avg_current": np.zeros(int(MAX_MA) // AVG_BIN_MA + 1,
+                                dtype=np.int64),
+        "peak_lit": 0,
+        "peak_ma": 0.0,
+        "charge": 0.0,                                  # mA * sixths.
+    }
+
+
+def merge(a, b):
+    for key, value in b.items():
+        if key.startswith("peak"):
+            a[key] = max(a[key], value)
+        else:
+            a[key] += value
+    return a
+
+
+def simulate(seed, n):
+    """Simulates `n` compositions drawing from the PRNG stream `seed` (a
+    `SeedSequence`). Returns their statistics."""
+    rng = np.random.default_rng(seed)
+    stats = new_stats()
+
+    pitch_classes = gen_pitch_classes(rng, n)
+    notes = gen_notes(rng, pitch_classes).ravel()
+    durations = gen_durations(rng, n)
+    starts = np.cumsum(durations, axis=1) - durations
+    downbeat = (starts % SIXTHS_PER_BAR == 0).ravel()
+    durations = durations.ravel()
+
+    lit = layout(rng, notes, downbeat)
+    n_lit = lit.sum(axis=1)
+    ma = n_lit * LED_MA[pitch_classes.ravel()]
+    charge = (ma * durations).reshape(n, N_NOTES).sum(axis=1)
+    avg_ma = charge / durations.reshape(n, N_NOTES).sum(axis=1)
+
+    stats["compositions"] = n
+    stats["notes"] = len(notes)
+    stats["time"] = int(durations.sum())
+    stats["lit_time"] += (lit * durations[:, None]).sum(axis=0)
+    stats["lit_notes"] += np.bincount(n_lit, minlength=N_LEDS + 1)
+    stats["lit_weighted"] += np.bincount(n_lit, weights=durations,
+                                         minlength=N_LEDS + 1).astype(np.int64)
+    stats["current"] += np.bincount((ma // CURRENT_BIN_MA).astype(np.intp),
+                                    minlength=len(stats["current"]))
+    stats["avg_current"] += np.bincount(
+        (avg_ma // AVG_BIN_MA).astype(np.intp),
+        minlength=len(stats["avg_current"]))
+    stats["peak_lit"] = int(n_lit.max())
+    stats["peak_ma"] = float(ma.max())
+    stats["charge"] = float(charge.sum())
+    return stats
+
+
+def _simulate(args):
+    return simulate(*args)
+
+
+def run(n_compositions, workers, seed, chunk=2000):
+    """Simulates `n_compositions` compositions in chunks of `chunk` on
+    `workers` processes. Returns the merged statistics."""
+    sizes = [chunk] * (n_compositions // chunk)
+    if n_compositions % chunk:
+        sizes.append(n_compositions % chunk)
+    streams = np.random.SeedSequence(seed).spawn(len(sizes))
+    tasks = list(zip(streams, sizes))
+
+    stats = new_stats()
+    if workers == 1:
+        for task in tasks:
+            merge(stats, _simulate(task))
+        return stats
+    with multiprocessing.Pool(workers) as pool:
+        for result in pool.imap_unordered(_simulate, tasks):
+            merge(stats, result)
+    return stats
+
+
+###############################################################################
+#   Report
+###############################################################################
+def print_histogram(title, labels, counts, width=50):
+    print(title)
+    top = max(counts.max(), 1)
+    total = max(counts.sum(), 1)
+    for label, count in zip(labels, counts):
+        bar = "#" * round(width * count / top)
+        print(f"  {label:>12} {100 * count / total:6.2f}% {bar}")
+
+
+def trim(counts):
+    """Returns the range of indices of `counts` from its first to its last
+    nonzero entry."""
+    nonzero = np.flatnonzero(counts)
+    if not len(nonzero):
+        return range(0)
+    return range(nonzero[0], nonzero[-1] + 1)
+
+
+def report(stats):
+    duty = stats["lit_time"] / stats["time"]
+    print(f"{stats['compositions']} compositions, {stats['notes']} notes.")
+    print(f"Duty cycle per LED: min {duty.min():.3f}, mean "
+          f"{duty.mean():.3f}, max {duty.max():.3f} (LED "
+          f"{duty.argmax()}).")
+    print(f"Peak LEDs lit at once: {stats['peak_lit']}. Peak current: "
+          f"{stats['peak_ma'] / 1000:.2f} A "
+          f"({stats['peak_ma'] * SUPPLY_V / 1000:.1f} W).")
+    avg_ma = stats["charge"] / stats["time"]
+    print(f"Average current: {avg_ma / 1000:.3f} A "
+          f"({avg_ma * SUPPLY_V / 1000:.2f} W at {SUPPLY_V:g} V).")
+    print()
+
+    edges = np.linspace(0, 1, 11)
+    counts, _ = np.histogram(duty, bins=edges)
+    print_histogram("Duty cycle (LEDs):",
+                    [f"{a:.1f}-{b:.1f}" for a, b in zip(edges, edges[1:])],
+                    counts)
+    idx = trim(stats["lit_weighted"])
+    print_histogram("LEDs lit at once (time):", list(idx),
+                    stats["lit_weighted"][idx.start:idx.stop])
+    idx = trim(stats["current"])
+    print_histogram("Current per note (notes):",
+                    [f"{i * CURRENT_BIN_MA} mA" for i in idx],
+                    stats["current"][idx.start:idx.stop])
+    idx = trim(stats["avg_current"])
+    print_histogram("Average current (compositions):",
+                    [f"{i * AVG_BIN_MA} mA" for i in idx],
+                    stats["avg_current"][idx.start:idx.stop])
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    parser = argparse.ArgumentParser(description="Light-load Monte Carlo.")
+    parser.add_argument("-n", "--compositions", type=int, default=100_000)
+    parser.add_argument("-j", "--workers", type=int, default=os.cpu_count())
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--out", help="Save the statistics to a .npz file.")
+    parser.add_argument("--scaling", action="store_true",
+                        help="Report the throughput for 1, 2, 4, ... "
+                             "workers instead.")
+    args = parser.parse_args(argv)
+
+    if args.scaling:
+        base = None
+        workers = 1
+        while workers <= args.workers:
+            start = perf_counter()
+            stats = run(args.compositions, workers, args.seed)
+            rate = stats["notes"] / (perf_counter() - start)
+            base = base or rate
+            print(f"{workers:3} workers: {rate / 1e6:6.2f} M notes/s "
+                  f"(x{rate / base:.2f})")
+            workers *= 2
+        return 0
+
+    start = perf_counter()
+    stats = run(args.compositions, args.workers, args.seed)
+    elapsed = perf_counter() - start
+    report(stats)
+    print(f"\n{stats['notes'] / elapsed / 1e6:.2f} M notes/s on "
+          f"{args.workers} workers.")
+    if args.out:
+        np.savez(args.out, duty=stats["lit_time"] / stats["time"],
+                 **{k: v for k, v in stats.items()
+                    if isinstance(v, np.ndarray)})
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -15,23 +15,24 @@ logger = logging.getLogger(__name__)
 #   Imports: violates PEP 8 (E402). Logging configuration appears before
 #            imports so as to also log any warnings that occur during import.
 ###############################################################################
-import datetime                                  # noqa: E402
 import http.client                               # noqa: E402
 import os                                        # noqa: E402
 import pickle                                    # noqa: E402
 import requests                                  # noqa: E402
 import sys                                       # noqa: E402
 
-from ast import literal_eval                     # noqa: E402
 from functools import partial                    # noqa: E402
 from math import floor                           # noqa: E402
 from random import randint, sample, shuffle      # noqa: E402
-from time import localtime, perf_counter, sleep  # noqa: E402
+from time import localtime, perf_counter         # noqa: E402
 
+from _clock import clock as real_clock           # noqa: E402
 from _composition import Composition, Drone      # noqa: E402
+from _composition import open_devices, send_or_restart  # noqa: E402
+from _eventlog import eventlog                   # noqa: E402
 from _macapps import MacApps                     # noqa: E402
-from _scheduler import Scheduler                 # noqa: E402
-from _tonerow import is_tonerow, _random         # noqa: E402
+from _scheduler import Deadline, Scheduler       # noqa: E402
+from _tonerow import parse_rows, _random         # noqa: E402
 
 
 ###############################################################################
@@ -73,12 +74,31 @@ payload_nce = {"id": -1}
 #
 #   n_max_time_break : number of compositions to play after `max_time_break`
 #                      seconds without a composition playing.
+#
+#   poll_interval    : seconds between requests to `GetNewToneRows` while
+#                      there is nothing to play.
+#
+#   retry_interval   : seconds between attempts to reach the web service
+#                      while there is no internet.
+#
+#   latency_us       : microseconds by which the lights of each note are
+#                      delayed relative to its sound being started, to make
+#                      up for the longer audio path. Measure the skew and
+#                      derive it with `Link.calibrate_latency()`.
+#
+#   crossfade_us     : microseconds over which each note's lights glide
+#                      from the previous note's color into its own; 0 for
+#                      hard cuts.
 ###############################################################################
 comp_break = 1
 max_time_break = 60 * 5
 bpm = 102
 n_max_time_break = 1
 timeout = (10, 15)
+poll_interval = 1
+retry_interval = 1
+latency_us = 0
+crossfade_us = 0
 
 
 ###############################################################################
@@ -93,7 +113,7 @@ def get(*, url, timeout, drone, session, scheduler):
             if not first:
                 logger.critical("TheNewArk should now be operating normally.")
 
-            return r.json()
+            return parse_rows(r.content)
         except requests.exceptions.RequestException as err:
             if first:
                 logger.critical("Please ensure there is internet.",
@@ -105,13 +125,13 @@ def get(*, url, timeout, drone, session, scheduler):
                     logger.critical(err, exc_info=True)
                     prev_e = err
             drone.on()
-        except requests.exceptions.JSONDecodeError as err:
-            # Raised if the response body does not contain valid json.
+        except ValueError as err:
+            # Raised if the response body is not a valid list of tone rows.
             logger.critical(err, exc_info=True)
 
             return []
 
-        scheduler.check()
+        scheduler.sleep(retry_interval)
 
 
 def post(*, url, json=None, params=None, timeout=None, drone, session,
@@ -133,25 +153,44 @@ def post(*, url, json=None, params=None, timeout=None, drone, session,
                     prev_e = err
             drone.on()
 
-        scheduler.check()
+        scheduler.sleep(retry_interval)
 
     if not first:
         logger.critical("TheNewArk should now be operating normally!")
 
 
-def restart_OBS(apps):
+def restart_OBS(apps, clock):
     apps.close()
-    sleep(3)
+    clock.sleep(3)
     apps.open()
 
 
 ###############################################################################
 #   Main Function
 ###############################################################################
-def main():
+def main(clock=real_clock):
+    # Every timer, sleep and timestamp of the session goes through `clock`,
+    # so that a day of operation can be replayed on a `SimClock` (see
+    # `_clock.py`).
+    Composition.set_clock(clock)
+    Drone.clock = clock
+
+    # Write the notes and drone events recorded during playback.
+    eventlog.start()
+
+    # Opens the MIDI port and the serial port.
+    open_devices()
+    link = Composition.link
+
     # If there is no internet, can still get past this next line.
     session = requests.Session()
 
+    # Have the microcontroller report when the lights for each note go off,
+    # so that notes end in sync with them.
+    send_or_restart(link.set_notifications, True)
+    send_or_restart(link.set_latency, latency_us)
+    send_or_restart(link.set_crossfade, crossfade_us)
+
     # This Drone instance will be used for the entire session.
     drone = Drone(channel=1, note=24, velocity=60)
 
@@ -159,11 +198,14 @@ def main():
     apps = MacApps(["OBS"])
     apps.open()
 
-    # Scheduled events.
-    is_time = partial(Composition.is_time, max_time_break)
+    # Scheduled events. The idle job is due `max_time_break` seconds after
+    # the last composition; the scheduler re-arms it whenever a composition
+    # has been played in the meantime.
+    is_time = Deadline(partial(Composition.idle_deadline, max_time_break))
     scheduler = Scheduler(every=[2 * 60 * 60, is_time],
                           callbacks=[restart_OBS, Composition.play_n],
-                          args=[[apps], [n_max_time_break, drone]])
+                          args=[[apps, clock], [n_max_time_break, drone]],
+                          clock=clock)
     while True:
         # GetNewToneRows.
         data = get(url=urls[0], timeout=timeout, drone=drone, session=session,
@@ -172,32 +214,24 @@ def main():
         if data:
             # Turn off drone.
             drone.off()
-            for e in data:
-                try:
-                    row = literal_eval(e["noteRow"])
-                except (ValueError, TypeError, SyntaxError, MemoryError,
-                        RecursionError):
-                    # If for whatever reason input from the Web Service is
-                    # malformed, create a random tonerow and use that.
-                    logger.critical("Invalid input. Creating random tr.",
-                                    exc_info=True)
-                    row = _random()
-
-                if not is_tonerow(row):
+            for ID, row in data:
+                # If for whatever reason input from the Web Service is
+                # malformed, create a random tonerow and use that.
+                if row is None:
                     logger.critical("Invalid tr. Creating random tr.")
                     row = _random()
 
                 # Create an instance of Composition.
-                comp = Composition(row, bpm=bpm, ID=e["id"])
+                comp = Composition(row, bpm=bpm, ID=ID)
 
                 # Before playing, let the web service know the composition ID,
                 # the time in ISO-8601 format, and the generated composition
                 # (defined by the 48 notes and 48 note durations).
-                payload[0]["id"] = e["id"]
-                payload[0]["playedOn"] = datetime.datetime.now().isoformat()
+                payload[0]["id"] = ID
+                payload[0]["playedOn"] = clock.wall().isoformat()
                 payload[0]["twelveToneMatrix"] = ("[" + repr(comp.notes) + ", "
                                                   + repr(comp.durations) + "]")
-                payload_nce["id"] = e["id"]
+                payload_nce["id"] = ID
 
                 # UpdateToneRowByIds.
                 post(url=urls[1], json=payload, timeout=timeout, drone=drone,
@@ -218,6 +252,10 @@ def main():
             # Turn on drone.
             drone.on()
 
+            # Nothing to play: block until the next request to the web
+            # service or the next scheduled job, whichever comes first.
+            scheduler.sleep(poll_interval)
+
 
 ###############################################################################
 #   Main
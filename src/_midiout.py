@@ -18,8 +18,10 @@ logger = logging.getLogger()
 #   MidiOut class
 ###############################################################################
 class MidiOut(rtmidi.MidiOut):
-    def __init__(self):
-        """Initializer"""
+    def __init__(self, port=None):
+        """Initializer. `port` is the name of the MIDI port to open, for a
+        computer that drives several instruments (see `_arkd.py`); by
+        default, the one port there should be is found."""
         try:
             rtmidi.MidiOut.__init__(self)
         except rtmidi.SystemError:
@@ -32,7 +34,12 @@ class MidiOut(rtmidi.MidiOut):
         # the port's "number".
         available_ports = self.get_ports()
 
-        if available_ports:
+        if port is not None:
+            if port not in available_ports:
+                logger.critical(f"No MIDI port named {port!r}!")
+                sys.exit()
+            self.open_port(available_ports.index(port))
+        elif available_ports:
             if len(available_ports) == 1:
                 # Open the MIDI input/output port with port number `0`.
                 # Only one port can be opened per MidiIn/MidiOut instance.
@@ -0,0 +1,2261 @@
+///////////////////////////////////////////////////////////////////////////////
+//  Generated by _codegen.py from _protocol_schema.py. Do not edit.
+//
+//  Header-only, allocation-free codec for the USB-serial protocol. Every
+//  `encode_*` function writes a complete frame into `buf` (which must hold
+//  at least `MSG_*_LEN` bytes) and returns its length, or 0 if a field is
+//  out of range. Every `decode_*` function reads a complete frame from
+//  `buf` and returns 1 on success, 0 if the frame is malformed.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef TNA_PROTOCOL_H
+#define TNA_PROTOCOL_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uintN_t, intN_t */
+#include <string.h>  /* memcpy, memset, memcmp */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Framing
+///////////////////////////////////////////////////////////////////////////////
+#define PROTO_SOF '%'
+#define PROTO_EOF '&'
+#define PROTO_MAX_FRAME 267
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Constants
+///////////////////////////////////////////////////////////////////////////////
+/* Number of frame hashes kept by the microcontroller. */
+#define FRAME_HASH_N 8
+/* Period of the afterglow decay, in microseconds. */
+#define AFTERGLOW_FRAME_US 10000
+/* "midi_note" `step` of a note placed as a "note". */
+#define NO_STEP 65535
+/* Largest latency offset, in microseconds. */
+#define LATENCY_MAX_US 500000
+/* Number of bands in a "bands" message. */
+#define BANDS_N 4
+/* The "bands" modulation ends this many microseconds after the last "bands"
+   message. */
+#define BANDS_HOLD_US 250000
+/* Number of slots in the microcontroller's command queue. */
+#define CMD_QUEUE_LEN 8
+/* "event" edge: the first frame of the message was shown. */
+#define EVENT_STARTED 0
+/* "event" edge: the message finished rendering (for a note, the lights were
+   turned off). */
+#define EVENT_FINISHED 1
+/* Largest program, in instructions. */
+#define VM_CODE_MAX 256
+/* Number of registers. */
+#define VM_REGS 16
+/* Most instructions run between two waits; a program that runs more is
+   stopped. */
+#define VM_BUDGET 4096
+/* "program_status": the program runs. */
+#define VM_OK 0
+/* "program_status": empty, too long, or not a whole number of instructions. */
+#define VM_BAD_LENGTH 1
+/* "program_status": the program loaded does not match the CRC. */
+#define VM_BAD_CRC 2
+/* "program_status": unknown opcode. */
+#define VM_BAD_OPCODE 3
+/* "program_status": register operand above r15. */
+#define VM_BAD_REGISTER 4
+/* "program_status": jump past the end of the program. */
+#define VM_BAD_TARGET 5
+/* halt: ends the program. */
+#define VM_HALT 0
+/* ldi a, imm: a = imm. */
+#define VM_LDI 1
+/* ldhi a, imm: bits 16-31 of a = imm. */
+#define VM_LDHI 2
+/* mov a, b: a = b. */
+#define VM_MOV 3
+/* add a, b, c: a = b + c. */
+#define VM_ADD 4
+/* sub a, b, c: a = b - c. */
+#define VM_SUB 5
+/* mul a, b, c: a = b * c. */
+#define VM_MUL 6
+/* and a, b, c: a = b & c. */
+#define VM_AND 7
+/* or a, b, c: a = b | c. */
+#define VM_OR 8
+/* xor a, b, c: a = b ^ c. */
+#define VM_XOR 9
+/* shl a, b, c: a = b << (c & 31). */
+#define VM_SHL 10
+/* shr a, b, c: a = b >> (c & 31). */
+#define VM_SHR 11
+/* mod a, b, c: a = b % c, or 0 if c is 0. */
+#define VM_MOD 12
+/* addi a, imm: a += imm, sign-extended. */
+#define VM_ADDI 13
+/* lt a, b, c: a = (b < c), unsigned. */
+#define VM_LT 14
+/* eq a, b, c: a = (b == c). */
+#define VM_EQ 15
+/* jmp imm: jumps to instruction imm. */
+#define VM_JMP 16
+/* jz a, imm: jumps to imm if a is 0. */
+#define VM_JZ 17
+/* jnz a, imm: jumps to imm if a is not 0. */
+#define VM_JNZ 18
+/* djnz a, imm: decrements a, then jumps to imm if it is not 0. */
+#define VM_DJNZ 19
+/* rand a, b: a = a random number below b (any, if b is 0). */
+#define VM_RAND 20
+/* clear: turns every LED of the frame off. */
+#define VM_CLEAR 21
+/* pixel a, b: LED a % 88 = color b. */
+#define VM_PIXEL 22
+/* panels a, b: the LEDs of the panels in mask a (bit 0 for P1) = color b. */
+#define VM_PANELS 23
+/* groups a, b: the LEDs of the groups in mask a (bit 0 for the front, then
+   back, LL, LR, RL, RR and Top) = color b. */
+#define VM_GROUPS 24
+/* note a, b: a = color of pitch class b % 12. */
+#define VM_NOTE 25
+/* scale a, b, c: a = color b at brightness c / 256 (c at most 256). */
+#define VM_SCALE 26
+/* blend a, b, c: a = color a moved c / 256 of the way to color b (c at most
+   256). */
+#define VM_BLEND 27
+/* show: shows the frame. */
+#define VM_SHOW 28
+/* wait a: yields until a microseconds after the previous wait ended. */
+#define VM_WAIT 29
+/* beat a: yields until the next point of a grid of a points per beat of the
+   tempo clock, or for AFTERGLOW_FRAME_US if it is stopped. */
+#define VM_BEAT 30
+/* time a: a = microseconds since the program started. */
+#define VM_TIME 31
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Field helpers
+///////////////////////////////////////////////////////////////////////////////
+static inline void
+proto_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+}
+
+
+static inline void
+proto_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+    p[2] = (uint8_t) (v >> 16);
+    p[3] = (uint8_t) (v >> 24);
+}
+
+
+static inline uint16_t
+proto_get_u16(const uint8_t *p)
+{
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+
+static inline uint32_t
+proto_get_u32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+           ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+
+/* Writes `v` as at most `width` ASCII digits padded with '\0'. Returns 0
+   if `v` does not fit. */
+static inline int
+proto_put_dec(uint8_t *p, uint32_t v, size_t width)
+{
+    uint8_t tmp[10];
+    size_t n = 0;
+
+    do {
+        tmp[n++] = (uint8_t) ('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (n > width)
+        return 0;
+    for (size_t i = 0; i < width; i++)
+        p[i] = (i < n) ? tmp[n - 1 - i] : '\0';
+    return 1;
+}
+
+
+/* Reads ASCII digits followed only by '\0' padding. Returns 0 on any other
+   byte. */
+static inline int
+proto_get_dec(const uint8_t *p, size_t width, uint32_t *v)
+{
+    uint32_t acc = 0;
+    size_t i = 0;
+
+    for (; i < width && p[i] >= '0' && p[i] <= '9'; i++)
+        acc = acc * 10 + (uint32_t) (p[i] - '0');
+    for (; i < width; i++)
+        if (p[i] != '\0')
+            return 0;
+    *v = acc;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  drone_off (host -> device): Turns off the drone (and all lights).
+///////////////////////////////////////////////////////////////////////////////
+#define OP_DRONE_OFF '0'
+#define MSG_DRONE_OFF_LEN 11
+
+static inline size_t
+encode_drone_off(uint8_t *buf)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_DRONE_OFF;
+    memset(&buf[2], 0, 8);
+    buf[10] = PROTO_EOF;
+    return MSG_DRONE_OFF_LEN;
+}
+
+
+static inline int
+decode_drone_off(const uint8_t *buf)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_DRONE_OFF ||
+        buf[10] != PROTO_EOF)
+        return 0;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  drone_on (host -> device): Turns on the drone. The drone runs until the
+//  next message.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_DRONE_ON '1'
+#define MSG_DRONE_ON_LEN 11
+
+static inline size_t
+encode_drone_on(uint8_t *buf)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_DRONE_ON;
+    memset(&buf[2], 0, 8);
+    buf[10] = PROTO_EOF;
+    return MSG_DRONE_ON_LEN;
+}
+
+
+static inline int
+decode_drone_on(const uint8_t *buf)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_DRONE_ON ||
+        buf[10] != PROTO_EOF)
+        return 0;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  note (host -> device): Lights a random half of the panels in the color of a
+//  note.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_NOTE '2'
+#define MSG_NOTE_LEN 11
+
+struct msg_note {
+    /* Octave-independent note number in [0, 11]; C is 0. */
+    uint8_t pitch_class;
+    /* How long the lights stay on, in microseconds. */
+    uint32_t duration_us;
+};
+
+static inline size_t
+encode_note(uint8_t *buf, const struct msg_note *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_NOTE;
+    buf[2] = (uint8_t) m->pitch_class;
+    if (!proto_put_dec(&buf[3], m->duration_us, 7))
+        return 0;
+    buf[10] = PROTO_EOF;
+    return MSG_NOTE_LEN;
+}
+
+
+static inline int
+decode_note(const uint8_t *buf, struct msg_note *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_NOTE ||
+        buf[10] != PROTO_EOF)
+        return 0;
+    m->pitch_class = (uint8_t) buf[2];
+    if (!proto_get_dec(&buf[3], 7, &m->duration_us))
+        return 0;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  midi_note (host -> device): Lights a note like "note", from its full MIDI
+//  note number and velocity: the octave decides which panels are lit (low
+//  notes on the lower panels, high notes on "Top") and the velocity how
+//  brightly.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_MIDI_NOTE 'M'
+#define MSG_MIDI_NOTE_LEN 11
+
+struct msg_midi_note {
+    /* MIDI note number in [0, 127]; 60 is C4. */
+    uint8_t note;
+    /* MIDI velocity in [0, 127]. 0 lights nothing. */
+    uint8_t velocity;
+    /* How long the lights stay on, in microseconds. */
+    uint32_t duration_us;
+    /* Point of the quantization grid of the last "tempo" (`quantize` points
+       per beat, counted from beat 0) at which the note starts, even if that
+       point has passed, so that a message arriving late does not shift the
+       notes after it. NO_STEP to start it as a "note". */
+    uint16_t step;
+};
+
+static inline size_t
+encode_midi_note(uint8_t *buf, const struct msg_midi_note *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_MIDI_NOTE;
+    buf[2] = (uint8_t) m->note;
+    buf[3] = (uint8_t) m->velocity;
+    proto_put_u32(&buf[4], (uint32_t) m->duration_us);
+    proto_put_u16(&buf[8], (uint16_t) m->step);
+    buf[10] = PROTO_EOF;
+    return MSG_MIDI_NOTE_LEN;
+}
+
+
+static inline int
+decode_midi_note(const uint8_t *buf, struct msg_midi_note *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_MIDI_NOTE ||
+        buf[10] != PROTO_EOF)
+        return 0;
+    m->note = (uint8_t) buf[2];
+    m->velocity = (uint8_t) buf[3];
+    m->duration_us = (uint32_t) proto_get_u32(&buf[4]);
+    m->step = (uint16_t) proto_get_u16(&buf[8]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  chord (host -> device): Lights up to 12 notes at once, each in its own
+//  panel groups, in a single frame. Each note goes dark after its own
+//  duration; the chord has finished when all have.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_CHORD 'C'
+#define MSG_CHORD_LEN 64
+
+struct msg_chord {
+    /* Number of notes, in [1, 12]. */
+    uint8_t n_notes;
+    /* Pitch class of each note, as in "note". Entries past `n_notes` are
+       ignored. */
+    uint8_t pitch_class[12];
+    /* How long each note stays on, in microseconds. */
+    uint32_t duration_us[12];
+};
+
+static inline size_t
+encode_chord(uint8_t *buf, const struct msg_chord *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_CHORD;
+    buf[2] = (uint8_t) m->n_notes;
+    memcpy(&buf[3], m->pitch_class, 12);
+    for (size_t i = 0; i < 12; i++)
+        proto_put_u32(&buf[15 + 4 * i], (uint32_t) m->duration_us[i]);
+    buf[63] = PROTO_EOF;
+    return MSG_CHORD_LEN;
+}
+
+
+static inline int
+decode_chord(const uint8_t *buf, struct msg_chord *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_CHORD ||
+        buf[63] != PROTO_EOF)
+        return 0;
+    m->n_notes = (uint8_t) buf[2];
+    memcpy(m->pitch_class, &buf[3], 12);
+    for (size_t i = 0; i < 12; i++)
+        m->duration_us[i] = (uint32_t) proto_get_u32(&buf[15 + 4 * i]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  ack (device -> host): Response to every well-formed host -> device message,
+//  sent when the message is taken off the command queue and executed.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_ACK 'K'
+#define MSG_ACK_LEN 15
+
+struct msg_ack {
+    /* Sequence number of the accepted message. Messages are numbered from 0 in
+       the order they are accepted, modulo 2**16. */
+    uint16_t seq;
+    /* Value of micros() when the message was accepted. */
+    uint32_t rx_us;
+    /* Value of micros() when the message was taken off the queue and this ack
+       was sent. The ack is written out by the end of the same pass of loop(),
+       so this is the time to pair with the time the host receives it. */
+    uint32_t tx_us;
+    /* Credit limit: the host may send messages up to, but not including,
+       sequence number `credit` (modulo 2**16). Equal to the number of messages
+       accepted so far plus the number of free slots in the command queue. */
+    uint16_t credit;
+};
+
+static inline size_t
+encode_ack(uint8_t *buf, const struct msg_ack *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_ACK;
+    proto_put_u16(&buf[2], (uint16_t) m->seq);
+    proto_put_u32(&buf[4], (uint32_t) m->rx_us);
+    proto_put_u32(&buf[8], (uint32_t) m->tx_us);
+    proto_put_u16(&buf[12], (uint16_t) m->credit);
+    buf[14] = PROTO_EOF;
+    return MSG_ACK_LEN;
+}
+
+
+static inline int
+decode_ack(const uint8_t *buf, struct msg_ack *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_ACK ||
+        buf[14] != PROTO_EOF)
+        return 0;
+    m->seq = (uint16_t) proto_get_u16(&buf[2]);
+    m->rx_us = (uint32_t) proto_get_u32(&buf[4]);
+    m->tx_us = (uint32_t) proto_get_u32(&buf[8]);
+    m->credit = (uint16_t) proto_get_u16(&buf[12]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  notify (host -> device): Enables or disables "event" notifications.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_NOTIFY 'N'
+#define MSG_NOTIFY_LEN 4
+
+struct msg_notify {
+    /* 1 to enable, 0 to disable. */
+    uint8_t enable;
+};
+
+static inline size_t
+encode_notify(uint8_t *buf, const struct msg_notify *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_NOTIFY;
+    buf[2] = (uint8_t) m->enable;
+    buf[3] = PROTO_EOF;
+    return MSG_NOTIFY_LEN;
+}
+
+
+static inline int
+decode_notify(const uint8_t *buf, struct msg_notify *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_NOTIFY ||
+        buf[3] != PROTO_EOF)
+        return 0;
+    m->enable = (uint8_t) buf[2];
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  event (device -> host): Notification that the lights for a message started
+//  or finished rendering. Sent only while enabled by "notify"; several are
+//  batched into one USB packet where possible.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_EVENT 'E'
+#define MSG_EVENT_LEN 10
+
+struct msg_event {
+    /* Sequence number of the message, as in its "ack". */
+    uint16_t seq;
+    /* EVENT_STARTED or EVENT_FINISHED. */
+    uint8_t edge;
+    /* Value of micros() at the edge. For notes and chords, the scheduled time
+       of the edge, before the "latency" offset; the event is sent at that
+       time. */
+    uint32_t t_us;
+};
+
+static inline size_t
+encode_event(uint8_t *buf, const struct msg_event *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_EVENT;
+    proto_put_u16(&buf[2], (uint16_t) m->seq);
+    buf[4] = (uint8_t) m->edge;
+    proto_put_u32(&buf[5], (uint32_t) m->t_us);
+    buf[9] = PROTO_EOF;
+    return MSG_EVENT_LEN;
+}
+
+
+static inline int
+decode_event(const uint8_t *buf, struct msg_event *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_EVENT ||
+        buf[9] != PROTO_EOF)
+        return 0;
+    m->seq = (uint16_t) proto_get_u16(&buf[2]);
+    m->edge = (uint8_t) buf[4];
+    m->t_us = (uint32_t) proto_get_u32(&buf[5]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  tempo (host -> device): Sets the tempo of the on-device beat clock. Beat n
+//  starts exactly beat0_us + n * 60e9 / bpm_milli microseconds; there is no
+//  per-beat message and no accumulated rounding.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_TEMPO 'B'
+#define MSG_TEMPO_LEN 14
+
+struct msg_tempo {
+    /* Beats per minute times 1000 (102 BPM is 102000). 0 stops the clock and
+       every effect below. */
+    uint32_t bpm_milli;
+    /* Value of micros() at beat 0, as estimated by the host from the acks. May
+       be in the past or the future. */
+    uint32_t beat0_us;
+    /* Notes starting on the first beat of a bar are accented (panel 11 fully
+       lit). 0 for no accents. */
+    uint8_t beats_per_bar;
+    /* Note starts are moved to the nearest point of a grid of this many points
+       per beat, never earlier than the note is taken off the queue, unless a
+       "midi_note" names its grid point. 0 for no quantization. */
+    uint8_t quantize;
+    /* 1 to start drone breaths on beats and stretch each to a whole number of
+       beats. */
+    uint8_t drone_sync;
+};
+
+static inline size_t
+encode_tempo(uint8_t *buf, const struct msg_tempo *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_TEMPO;
+    proto_put_u32(&buf[2], (uint32_t) m->bpm_milli);
+    proto_put_u32(&buf[6], (uint32_t) m->beat0_us);
+    buf[10] = (uint8_t) m->beats_per_bar;
+    buf[11] = (uint8_t) m->quantize;
+    buf[12] = (uint8_t) m->drone_sync;
+    buf[13] = PROTO_EOF;
+    return MSG_TEMPO_LEN;
+}
+
+
+static inline int
+decode_tempo(const uint8_t *buf, struct msg_tempo *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_TEMPO ||
+        buf[13] != PROTO_EOF)
+        return 0;
+    m->bpm_milli = (uint32_t) proto_get_u32(&buf[2]);
+    m->beat0_us = (uint32_t) proto_get_u32(&buf[6]);
+    m->beats_per_bar = (uint8_t) buf[10];
+    m->quantize = (uint8_t) buf[11];
+    m->drone_sync = (uint8_t) buf[12];
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  afterglow (host -> device): Configures the afterglow: instead of going dark
+//  at once, lights fade by a per-group, per-channel factor every
+//  AFTERGLOW_FRAME_US microseconds.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_AFTERGLOW 'G'
+#define MSG_AFTERGLOW_LEN 24
+
+struct msg_afterglow {
+    /* Decay factors, out of 256, for R, G and B of each panel group, in the
+       order front, back, left-left, left-right, right-left, right-right, top.
+       All 0 turns the afterglow off. */
+    uint8_t decay[21];
+};
+
+static inline size_t
+encode_afterglow(uint8_t *buf, const struct msg_afterglow *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_AFTERGLOW;
+    memcpy(&buf[2], m->decay, 21);
+    buf[23] = PROTO_EOF;
+    return MSG_AFTERGLOW_LEN;
+}
+
+
+static inline int
+decode_afterglow(const uint8_t *buf, struct msg_afterglow *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_AFTERGLOW ||
+        buf[23] != PROTO_EOF)
+        return 0;
+    memcpy(m->decay, &buf[2], 21);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  latency (host -> device): Sets the latency compensation. Notes and chords
+//  are scheduled as usual, and their "event" frames are sent on schedule, but
+//  their lights go on and off `offset_us` later, so that lights and sound
+//  (started by the host on the events) reach the audience together. The start
+//  of drone breaths locked to the beat is shifted by the same amount.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_LATENCY 'L'
+#define MSG_LATENCY_LEN 7
+
+struct msg_latency {
+    /* Offset in microseconds, in [-LATENCY_MAX_US, LATENCY_MAX_US]. Positive
+       delays the lights; negative advances them, by delaying the events
+       instead when nothing is scheduled ahead. */
+    int32_t offset_us;
+};
+
+static inline size_t
+encode_latency(uint8_t *buf, const struct msg_latency *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_LATENCY;
+    proto_put_u32(&buf[2], (uint32_t) m->offset_us);
+    buf[6] = PROTO_EOF;
+    return MSG_LATENCY_LEN;
+}
+
+
+static inline int
+decode_latency(const uint8_t *buf, struct msg_latency *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_LATENCY ||
+        buf[6] != PROTO_EOF)
+        return 0;
+    m->offset_us = (int32_t) proto_get_u32(&buf[2]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  crossfade (host -> device): Configures crossfades between consecutive
+//  notes: each note starts in the color of the previous one and glides to its
+//  own over `duration_us`, in steps of AFTERGLOW_FRAME_US, along a perceptual
+//  (OKLab) color ramp.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_CROSSFADE 'X'
+#define MSG_CROSSFADE_LEN 7
+
+struct msg_crossfade {
+    /* Length of a crossfade, in microseconds; at most half of the note is
+       spent fading. 0 turns crossfades off. */
+    uint32_t duration_us;
+};
+
+static inline size_t
+encode_crossfade(uint8_t *buf, const struct msg_crossfade *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_CROSSFADE;
+    proto_put_u32(&buf[2], (uint32_t) m->duration_us);
+    buf[6] = PROTO_EOF;
+    return MSG_CROSSFADE_LEN;
+}
+
+
+static inline int
+decode_crossfade(const uint8_t *buf, struct msg_crossfade *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_CROSSFADE ||
+        buf[6] != PROTO_EOF)
+        return 0;
+    m->duration_us = (uint32_t) proto_get_u32(&buf[2]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  program_load (host -> device): Writes a chunk of a light program (bytecode
+//  for the microcontroller's VM, see the VM_* constants) into the program
+//  buffer. The program is verified by the next "program_run".
+///////////////////////////////////////////////////////////////////////////////
+#define OP_PROGRAM_LOAD 'P'
+#define MSG_PROGRAM_LOAD_LEN 69
+
+struct msg_program_load {
+    /* Byte offset of the chunk in the program, a multiple of 4 below 4 *
+       VM_CODE_MAX. */
+    uint16_t at;
+    /* Up to 16 instructions of 4 bytes; bytes past the end of the program
+       buffer are ignored. */
+    uint8_t code[64];
+};
+
+static inline size_t
+encode_program_load(uint8_t *buf, const struct msg_program_load *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_PROGRAM_LOAD;
+    proto_put_u16(&buf[2], (uint16_t) m->at);
+    memcpy(&buf[4], m->code, 64);
+    buf[68] = PROTO_EOF;
+    return MSG_PROGRAM_LOAD_LEN;
+}
+
+
+static inline int
+decode_program_load(const uint8_t *buf, struct msg_program_load *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_PROGRAM_LOAD ||
+        buf[68] != PROTO_EOF)
+        return 0;
+    m->at = (uint16_t) proto_get_u16(&buf[2]);
+    memcpy(m->code, &buf[4], 64);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  program_run (host -> device): Verifies the program loaded (once per load)
+//  and runs it, replying with a "program_status" frame right after the ack. A
+//  program runs until it halts or, at a wait, until the next message.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_PROGRAM_RUN 'R'
+#define MSG_PROGRAM_RUN_LEN 13
+
+struct msg_program_run {
+    /* Length of the program, in bytes. */
+    uint16_t length;
+    /* CRC-32 (as computed by zlib.crc32()) of the program. */
+    uint32_t crc;
+    /* Seed of the program's PRNG; 0 is 1. */
+    uint32_t seed;
+};
+
+static inline size_t
+encode_program_run(uint8_t *buf, const struct msg_program_run *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_PROGRAM_RUN;
+    proto_put_u16(&buf[2], (uint16_t) m->length);
+    proto_put_u32(&buf[4], (uint32_t) m->crc);
+    proto_put_u32(&buf[8], (uint32_t) m->seed);
+    buf[12] = PROTO_EOF;
+    return MSG_PROGRAM_RUN_LEN;
+}
+
+
+static inline int
+decode_program_run(const uint8_t *buf, struct msg_program_run *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_PROGRAM_RUN ||
+        buf[12] != PROTO_EOF)
+        return 0;
+    m->length = (uint16_t) proto_get_u16(&buf[2]);
+    m->crc = (uint32_t) proto_get_u32(&buf[4]);
+    m->seed = (uint32_t) proto_get_u32(&buf[8]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  program_status (device -> host): Result of verifying a program.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_PROGRAM_STATUS 'p'
+#define MSG_PROGRAM_STATUS_LEN 6
+
+struct msg_program_status {
+    /* VM_OK or one of the VM_BAD_* errors. */
+    uint8_t status;
+    /* Index of the offending instruction, for VM_BAD_OPCODE, VM_BAD_REGISTER
+       and VM_BAD_TARGET. */
+    uint16_t pc;
+};
+
+static inline size_t
+encode_program_status(uint8_t *buf, const struct msg_program_status *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_PROGRAM_STATUS;
+    buf[2] = (uint8_t) m->status;
+    proto_put_u16(&buf[3], (uint16_t) m->pc);
+    buf[5] = PROTO_EOF;
+    return MSG_PROGRAM_STATUS_LEN;
+}
+
+
+static inline int
+decode_program_status(const uint8_t *buf, struct msg_program_status *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_PROGRAM_STATUS ||
+        buf[5] != PROTO_EOF)
+        return 0;
+    m->status = (uint8_t) buf[2];
+    m->pc = (uint16_t) proto_get_u16(&buf[3]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  get_hashes (host -> device): Requests a "hashes" frame, sent right after
+//  the ack.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_GET_HASHES 'H'
+#define MSG_GET_HASHES_LEN 3
+
+static inline size_t
+encode_get_hashes(uint8_t *buf)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_GET_HASHES;
+    buf[2] = PROTO_EOF;
+    return MSG_GET_HASHES_LEN;
+}
+
+
+static inline int
+decode_get_hashes(const uint8_t *buf)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_GET_HASHES ||
+        buf[2] != PROTO_EOF)
+        return 0;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  hashes (device -> host): CRC-32 (as computed by zlib.crc32()) of the R, G,
+//  B bytes of the last FRAME_HASH_N frames shown, newest first.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_HASHES 'h'
+#define MSG_HASHES_LEN 71
+
+struct msg_hashes {
+    /* Frames shown since power-up, modulo 2**32. Entries past `count` are 0.
+       */
+    uint32_t count;
+    /* CRC-32 of each frame. */
+    uint32_t crc[8];
+    /* Value of micros() when each frame was shown. */
+    uint32_t t_us[8];
+};
+
+static inline size_t
+encode_hashes(uint8_t *buf, const struct msg_hashes *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_HASHES;
+    proto_put_u32(&buf[2], (uint32_t) m->count);
+    for (size_t i = 0; i < 8; i++)
+        proto_put_u32(&buf[6 + 4 * i], (uint32_t) m->crc[i]);
+    for (size_t i = 0; i < 8; i++)
+        proto_put_u32(&buf[38 + 4 * i], (uint32_t) m->t_us[i]);
+    buf[70] = PROTO_EOF;
+    return MSG_HASHES_LEN;
+}
+
+
+static inline int
+decode_hashes(const uint8_t *buf, struct msg_hashes *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_HASHES ||
+        buf[70] != PROTO_EOF)
+        return 0;
+    m->count = (uint32_t) proto_get_u32(&buf[2]);
+    for (size_t i = 0; i < 8; i++)
+        m->crc[i] = (uint32_t) proto_get_u32(&buf[6 + 4 * i]);
+    for (size_t i = 0; i < 8; i++)
+        m->t_us[i] = (uint32_t) proto_get_u32(&buf[38 + 4 * i]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  stream_frame (host -> device): Full frame for streaming. Not queued,
+//  sequenced or acked: the microcontroller keeps only the latest frame
+//  received (superseding any not yet shown) and shows it when idle.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_STREAM_FRAME 'F'
+#define MSG_STREAM_FRAME_LEN 267
+
+struct msg_stream_frame {
+    /* R, G and B of each of the 88 LEDs, in address order. */
+    uint8_t rgb[264];
+};
+
+static inline size_t
+encode_stream_frame(uint8_t *buf, const struct msg_stream_frame *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_STREAM_FRAME;
+    memcpy(&buf[2], m->rgb, 264);
+    buf[266] = PROTO_EOF;
+    return MSG_STREAM_FRAME_LEN;
+}
+
+
+static inline int
+decode_stream_frame(const uint8_t *buf, struct msg_stream_frame *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_STREAM_FRAME ||
+        buf[266] != PROTO_EOF)
+        return 0;
+    memcpy(m->rgb, &buf[2], 264);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  bands (host -> device): Envelope levels of BANDS_N frequency bands of the
+//  audio being played, sent by the host about every 10 ms. Not queued,
+//  sequenced or acked, like "stream_frame": the newest levels modulate the
+//  brightness of every frame shown from then on, until BANDS_HOLD_US pass
+//  without any.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_BANDS 'A'
+#define MSG_BANDS_LEN 8
+
+struct msg_bands {
+    /* Level of each band, lowest first, from 0 (silent) to 255 (full scale).
+       Band 0 modulates the front and back groups, band 1 left-left and right-
+       right, band 2 left-right and right-left, and band 3 "Top". */
+    uint8_t level[4];
+    /* Modulation depth, out of 255: a group is shown at a fraction 1 - depth *
+       (1 - level / 255) / 255 of its brightness. 0 turns the modulation off.
+       */
+    uint8_t depth;
+};
+
+static inline size_t
+encode_bands(uint8_t *buf, const struct msg_bands *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_BANDS;
+    memcpy(&buf[2], m->level, 4);
+    buf[6] = (uint8_t) m->depth;
+    buf[7] = PROTO_EOF;
+    return MSG_BANDS_LEN;
+}
+
+
+static inline int
+decode_bands(const uint8_t *buf, struct msg_bands *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_BANDS ||
+        buf[7] != PROTO_EOF)
+        return 0;
+    memcpy(m->level, &buf[2], 4);
+    m->depth = (uint8_t) buf[6];
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  get_telemetry (host -> device): Requests a "telemetry" frame, sent right
+//  after the ack.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_GET_TELEMETRY 'T'
+#define MSG_GET_TELEMETRY_LEN 3
+
+static inline size_t
+encode_get_telemetry(uint8_t *buf)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_GET_TELEMETRY;
+    buf[2] = PROTO_EOF;
+    return MSG_GET_TELEMETRY_LEN;
+}
+
+
+static inline int
+decode_get_telemetry(const uint8_t *buf)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_GET_TELEMETRY ||
+        buf[2] != PROTO_EOF)
+        return 0;
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  telemetry (device -> host): Streaming and refresh counters since power-up,
+//  modulo 2**32, and the cost of the last frame.
+///////////////////////////////////////////////////////////////////////////////
+#define OP_TELEMETRY 't'
+#define MSG_TELEMETRY_LEN 31
+
+struct msg_telemetry {
+    /* "frame" messages received. */
+    uint32_t frames_received;
+    /* "frame" messages shown. */
+    uint32_t frames_shown;
+    /* "frame" messages replaced by a newer one before being shown. */
+    uint32_t frames_superseded;
+    /* CPU cycles spent computing the last frame shown, from the target frame
+       to the hand-off to the LED driver; 0 where there is no cycle counter. */
+    uint32_t commit_cycles;
+    /* Frames handed to the LED driver, keep-alives included. */
+    uint32_t shows;
+    /* Frames not handed to the LED driver because they were already on the
+       LEDs. */
+    uint32_t shows_skipped;
+    /* Microseconds spent handing frames to the LED driver. */
+    uint32_t show_us;
+};
+
+static inline size_t
+encode_telemetry(uint8_t *buf, const struct msg_telemetry *m)
+{
+    buf[0] = PROTO_SOF;
+    buf[1] = OP_TELEMETRY;
+    proto_put_u32(&buf[2], (uint32_t) m->frames_received);
+    proto_put_u32(&buf[6], (uint32_t) m->frames_shown);
+    proto_put_u32(&buf[10], (uint32_t) m->frames_superseded);
+    proto_put_u32(&buf[14], (uint32_t) m->commit_cycles);
+    proto_put_u32(&buf[18], (uint32_t) m->shows);
+    proto_put_u32(&buf[22], (uint32_t) m->shows_skipped);
+    proto_put_u32(&buf[26], (uint32_t) m->show_us);
+    buf[30] = PROTO_EOF;
+    return MSG_TELEMETRY_LEN;
+}
+
+
+static inline int
+decode_telemetry(const uint8_t *buf, struct msg_telemetry *m)
+{
+    if (buf[0] != PROTO_SOF || buf[1] != OP_TELEMETRY ||
+        buf[30] != PROTO_EOF)
+        return 0;
+    m->frames_received = (uint32_t) proto_get_u32(&buf[2]);
+    m->frames_shown = (uint32_t) proto_get_u32(&buf[6]);
+    m->frames_superseded = (uint32_t) proto_get_u32(&buf[10]);
+    m->commit_cycles = (uint32_t) proto_get_u32(&buf[14]);
+    m->shows = (uint32_t) proto_get_u32(&buf[18]);
+    m->shows_skipped = (uint32_t) proto_get_u32(&buf[22]);
+    m->show_us = (uint32_t) proto_get_u32(&buf[26]);
+    return 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Dispatch
+///////////////////////////////////////////////////////////////////////////////
+/* Returns the length of a frame with opcode `op`, or 0 if `op` is unknown. */
+static inline size_t
+proto_frame_len(uint8_t op)
+{
+    switch (op)
+    {
+    case OP_DRONE_OFF: return MSG_DRONE_OFF_LEN;
+    case OP_DRONE_ON: return MSG_DRONE_ON_LEN;
+    case OP_NOTE: return MSG_NOTE_LEN;
+    case OP_MIDI_NOTE: return MSG_MIDI_NOTE_LEN;
+    case OP_CHORD: return MSG_CHORD_LEN;
+    case OP_ACK: return MSG_ACK_LEN;
+    case OP_NOTIFY: return MSG_NOTIFY_LEN;
+    case OP_EVENT: return MSG_EVENT_LEN;
+    case OP_TEMPO: return MSG_TEMPO_LEN;
+    case OP_AFTERGLOW: return MSG_AFTERGLOW_LEN;
+    case OP_LATENCY: return MSG_LATENCY_LEN;
+    case OP_CROSSFADE: return MSG_CROSSFADE_LEN;
+    case OP_PROGRAM_LOAD: return MSG_PROGRAM_LOAD_LEN;
+    case OP_PROGRAM_RUN: return MSG_PROGRAM_RUN_LEN;
+    case OP_PROGRAM_STATUS: return MSG_PROGRAM_STATUS_LEN;
+    case OP_GET_HASHES: return MSG_GET_HASHES_LEN;
+    case OP_HASHES: return MSG_HASHES_LEN;
+    case OP_STREAM_FRAME: return MSG_STREAM_FRAME_LEN;
+    case OP_BANDS: return MSG_BANDS_LEN;
+    case OP_GET_TELEMETRY: return MSG_GET_TELEMETRY_LEN;
+    case OP_TELEMETRY: return MSG_TELEMETRY_LEN;
+    default: return 0;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Golden vectors produced by the schema's reference encoder. The
+//  generated Python codec is checked against the same bytes.
+//  Compile with -DPROTO_SELFTEST to include them.
+///////////////////////////////////////////////////////////////////////////////
+#ifdef PROTO_SELFTEST
+static const uint8_t proto_vec_drone_off_0[MSG_DRONE_OFF_LEN] = {
+    0x25, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const uint8_t proto_vec_drone_off_1[MSG_DRONE_OFF_LEN] = {
+    0x25, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const uint8_t proto_vec_drone_off_2[MSG_DRONE_OFF_LEN] = {
+    0x25, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+
+static const uint8_t proto_vec_drone_on_0[MSG_DRONE_ON_LEN] = {
+    0x25, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const uint8_t proto_vec_drone_on_1[MSG_DRONE_ON_LEN] = {
+    0x25, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const uint8_t proto_vec_drone_on_2[MSG_DRONE_ON_LEN] = {
+    0x25, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+
+static const uint8_t proto_vec_note_0[MSG_NOTE_LEN] = {
+    0x25, 0x32, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_note proto_val_note_0 = {0, 0};
+static const uint8_t proto_vec_note_1[MSG_NOTE_LEN] = {
+    0x25, 0x32, 0xFF, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x26,
+};
+static const struct msg_note proto_val_note_1 = {255, 9999999};
+static const uint8_t proto_vec_note_2[MSG_NOTE_LEN] = {
+    0x25, 0x32, 0x3F, 0x37, 0x31, 0x35, 0x34, 0x32, 0x39, 0x35, 0x26,
+};
+static const struct msg_note proto_val_note_2 = {63, 7154295};
+
+static const uint8_t proto_vec_midi_note_0[MSG_MIDI_NOTE_LEN] = {
+    0x25, 0x4D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_midi_note proto_val_midi_note_0 = {0, 0, 0, 0};
+static const uint8_t proto_vec_midi_note_1[MSG_MIDI_NOTE_LEN] = {
+    0x25, 0x4D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_midi_note proto_val_midi_note_1 =
+    {255, 255, 4294967295u, 65535};
+static const uint8_t proto_vec_midi_note_2[MSG_MIDI_NOTE_LEN] = {
+    0x25, 0x4D, 0x91, 0xDA, 0x4E, 0x0D, 0x92, 0xF8, 0x45, 0x4B, 0x26,
+};
+static const struct msg_midi_note proto_val_midi_note_2 =
+    {145, 218, 4170321230u, 19269};
+
+static const uint8_t proto_vec_chord_0[MSG_CHORD_LEN] = {
+    0x25, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_chord proto_val_chord_0 =
+    {0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0}};
+static const uint8_t proto_vec_chord_1[MSG_CHORD_LEN] = {
+    0x25, 0x43, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_chord proto_val_chord_1 =
+    {255, {255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+    {4294967295u, 4294967295u, 4294967295u, 4294967295u, 4294967295u,
+    4294967295u, 4294967295u, 4294967295u, 4294967295u, 4294967295u,
+    4294967295u, 4294967295u}};
+static const uint8_t proto_vec_chord_2[MSG_CHORD_LEN] = {
+    0x25, 0x43, 0x75, 0x32, 0x94, 0x11, 0x2A, 0x38, 0x55, 0x25, 0x6F, 0xA9,
+    0x58, 0x44, 0x4C, 0x07, 0x2F, 0xB9, 0xD4, 0x25, 0xDD, 0x44, 0xFB, 0x8C,
+    0x8C, 0x9B, 0x19, 0x6F, 0x3F, 0x40, 0x6D, 0x3B, 0xFC, 0x0E, 0xD8, 0x14,
+    0x39, 0x5C, 0x32, 0xEE, 0xD2, 0x76, 0x37, 0x2C, 0xD1, 0x34, 0x30, 0x50,
+    0x0A, 0xFA, 0xB3, 0xD4, 0xF0, 0x08, 0x99, 0xF9, 0xD7, 0xE3, 0xC5, 0x7D,
+    0x3C, 0xE7, 0x71, 0x26,
+};
+static const struct msg_chord proto_val_chord_2 =
+    {117, {50, 148, 17, 42, 56, 85, 37, 111, 169, 88, 68, 76}, {3568905991u,
+    4215594277u, 429624460, 1832927087, 3624860731u, 844904724, 930534126,
+    808767788, 3019508304u, 2567499988u, 3320043513u, 1910979709}};
+
+static const uint8_t proto_vec_ack_0[MSG_ACK_LEN] = {
+    0x25, 0x4B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x26,
+};
+static const struct msg_ack proto_val_ack_0 = {0, 0, 0, 0};
+static const uint8_t proto_vec_ack_1[MSG_ACK_LEN] = {
+    0x25, 0x4B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0x26,
+};
+static const struct msg_ack proto_val_ack_1 =
+    {65535, 4294967295u, 4294967295u, 65535};
+static const uint8_t proto_vec_ack_2[MSG_ACK_LEN] = {
+    0x25, 0x4B, 0xF3, 0xD5, 0x57, 0x50, 0x2B, 0xBA, 0x6B, 0x91, 0x27, 0xEB,
+    0xFE, 0x25, 0x26,
+};
+static const struct msg_ack proto_val_ack_2 =
+    {54771, 3123400791u, 3945238891u, 9726};
+
+static const uint8_t proto_vec_notify_0[MSG_NOTIFY_LEN] = {
+    0x25, 0x4E, 0x00, 0x26,
+};
+static const struct msg_notify proto_val_notify_0 = {0};
+static const uint8_t proto_vec_notify_1[MSG_NOTIFY_LEN] = {
+    0x25, 0x4E, 0xFF, 0x26,
+};
+static const struct msg_notify proto_val_notify_1 = {255};
+static const uint8_t proto_vec_notify_2[MSG_NOTIFY_LEN] = {
+    0x25, 0x4E, 0x8D, 0x26,
+};
+static const struct msg_notify proto_val_notify_2 = {141};
+
+static const uint8_t proto_vec_event_0[MSG_EVENT_LEN] = {
+    0x25, 0x45, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_event proto_val_event_0 = {0, 0, 0};
+static const uint8_t proto_vec_event_1[MSG_EVENT_LEN] = {
+    0x25, 0x45, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_event proto_val_event_1 = {65535, 255, 4294967295u};
+static const uint8_t proto_vec_event_2[MSG_EVENT_LEN] = {
+    0x25, 0x45, 0x4E, 0x63, 0x95, 0x2E, 0xCF, 0x5D, 0xEC, 0x26,
+};
+static const struct msg_event proto_val_event_2 = {25422, 149, 3965570862u};
+
+static const uint8_t proto_vec_tempo_0[MSG_TEMPO_LEN] = {
+    0x25, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x26,
+};
+static const struct msg_tempo proto_val_tempo_0 = {0, 0, 0, 0, 0};
+static const uint8_t proto_vec_tempo_1[MSG_TEMPO_LEN] = {
+    0x25, 0x42, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x26,
+};
+static const struct msg_tempo proto_val_tempo_1 =
+    {4294967295u, 4294967295u, 255, 255, 255};
+static const uint8_t proto_vec_tempo_2[MSG_TEMPO_LEN] = {
+    0x25, 0x42, 0x5B, 0xA9, 0x13, 0x91, 0x30, 0x33, 0xD2, 0x62, 0xA8, 0xAF,
+    0x51, 0x26,
+};
+static const struct msg_tempo proto_val_tempo_2 =
+    {2433984859u, 1657942832, 168, 175, 81};
+
+static const uint8_t proto_vec_afterglow_0[MSG_AFTERGLOW_LEN] = {
+    0x25, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_afterglow proto_val_afterglow_0 =
+    {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+static const uint8_t proto_vec_afterglow_1[MSG_AFTERGLOW_LEN] = {
+    0x25, 0x47, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_afterglow proto_val_afterglow_1 =
+    {{255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255}};
+static const uint8_t proto_vec_afterglow_2[MSG_AFTERGLOW_LEN] = {
+    0x25, 0x47, 0x59, 0x4D, 0x4A, 0x8F, 0x81, 0x12, 0x39, 0xCD, 0xB5, 0x21,
+    0x6C, 0xDD, 0xDE, 0xD2, 0xC1, 0x19, 0x36, 0x43, 0x07, 0xE9, 0x73, 0x26,
+};
+static const struct msg_afterglow proto_val_afterglow_2 =
+    {{89, 77, 74, 143, 129, 18, 57, 205, 181, 33, 108, 221, 222, 210, 193, 25,
+    54, 67, 7, 233, 115}};
+
+static const uint8_t proto_vec_latency_0[MSG_LATENCY_LEN] = {
+    0x25, 0x4C, 0x00, 0x00, 0x00, 0x80, 0x26,
+};
+static const struct msg_latency proto_val_latency_0 = {(-2147483647 - 1)};
+static const uint8_t proto_vec_latency_1[MSG_LATENCY_LEN] = {
+    0x25, 0x4C, 0xFF, 0xFF, 0xFF, 0x7F, 0x26,
+};
+static const struct msg_latency proto_val_latency_1 = {2147483647};
+static const uint8_t proto_vec_latency_2[MSG_LATENCY_LEN] = {
+    0x25, 0x4C, 0x86, 0xA6, 0x59, 0x79, 0x26,
+};
+static const struct msg_latency proto_val_latency_2 = {2035918470};
+
+static const uint8_t proto_vec_crossfade_0[MSG_CROSSFADE_LEN] = {
+    0x25, 0x58, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_crossfade proto_val_crossfade_0 = {0};
+static const uint8_t proto_vec_crossfade_1[MSG_CROSSFADE_LEN] = {
+    0x25, 0x58, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_crossfade proto_val_crossfade_1 = {4294967295u};
+static const uint8_t proto_vec_crossfade_2[MSG_CROSSFADE_LEN] = {
+    0x25, 0x58, 0xAD, 0xA2, 0x5F, 0xCE, 0x26,
+};
+static const struct msg_crossfade proto_val_crossfade_2 = {3462374061u};
+
+static const uint8_t proto_vec_program_load_0[MSG_PROGRAM_LOAD_LEN] = {
+    0x25, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_program_load proto_val_program_load_0 =
+    {0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+static const uint8_t proto_vec_program_load_1[MSG_PROGRAM_LOAD_LEN] = {
+    0x25, 0x50, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_program_load proto_val_program_load_1 =
+    {65535, {255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255}};
+static const uint8_t proto_vec_program_load_2[MSG_PROGRAM_LOAD_LEN] = {
+    0x25, 0x50, 0x95, 0xCC, 0xD5, 0x81, 0x56, 0xEA, 0xEB, 0xD3, 0x01, 0xBB,
+    0xF8, 0x52, 0xC6, 0x63, 0xA8, 0xA0, 0x6A, 0x6A, 0xDF, 0xDF, 0xF9, 0xA6,
+    0x02, 0xA3, 0xCB, 0x35, 0xDD, 0x99, 0x1F, 0xB7, 0xAD, 0x8F, 0x82, 0x1F,
+    0x4F, 0xD1, 0x6A, 0x87, 0x71, 0xB4, 0xFB, 0x9C, 0xD2, 0x9F, 0x23, 0xF1,
+    0xB1, 0x1B, 0x4D, 0x06, 0x9D, 0x5D, 0xA0, 0xE5, 0xF6, 0xC5, 0x9E, 0xA1,
+    0xC6, 0x44, 0xB0, 0x59, 0xB8, 0xFA, 0xDF, 0xB9, 0x26,
+};
+static const struct msg_program_load proto_val_program_load_2 =
+    {52373, {213, 129, 86, 234, 235, 211, 1, 187, 248, 82, 198, 99, 168, 160,
+    106, 106, 223, 223, 249, 166, 2, 163, 203, 53, 221, 153, 31, 183, 173, 143,
+    130, 31, 79, 209, 106, 135, 113, 180, 251, 156, 210, 159, 35, 241, 177, 27,
+    77, 6, 157, 93, 160, 229, 246, 197, 158, 161, 198, 68, 176, 89, 184, 250,
+    223, 185}};
+
+static const uint8_t proto_vec_program_run_0[MSG_PROGRAM_RUN_LEN] = {
+    0x25, 0x52, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x26,
+};
+static const struct msg_program_run proto_val_program_run_0 = {0, 0, 0};
+static const uint8_t proto_vec_program_run_1[MSG_PROGRAM_RUN_LEN] = {
+    0x25, 0x52, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x26,
+};
+static const struct msg_program_run proto_val_program_run_1 =
+    {65535, 4294967295u, 4294967295u};
+static const uint8_t proto_vec_program_run_2[MSG_PROGRAM_RUN_LEN] = {
+    0x25, 0x52, 0x9C, 0x57, 0x19, 0x0B, 0xBE, 0xE8, 0x1B, 0x23, 0x22, 0xC3,
+    0x26,
+};
+static const struct msg_program_run proto_val_program_run_2 =
+    {22428, 3904768793u, 3273794331u};
+
+static const uint8_t proto_vec_program_status_0[MSG_PROGRAM_STATUS_LEN] = {
+    0x25, 0x70, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_program_status proto_val_program_status_0 = {0, 0};
+static const uint8_t proto_vec_program_status_1[MSG_PROGRAM_STATUS_LEN] = {
+    0x25, 0x70, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_program_status proto_val_program_status_1 =
+    {255, 65535};
+static const uint8_t proto_vec_program_status_2[MSG_PROGRAM_STATUS_LEN] = {
+    0x25, 0x70, 0xB9, 0xA5, 0xD8, 0x26,
+};
+static const struct msg_program_status proto_val_program_status_2 =
+    {185, 55461};
+
+static const uint8_t proto_vec_get_hashes_0[MSG_GET_HASHES_LEN] = {
+    0x25, 0x48, 0x26,
+};
+static const uint8_t proto_vec_get_hashes_1[MSG_GET_HASHES_LEN] = {
+    0x25, 0x48, 0x26,
+};
+static const uint8_t proto_vec_get_hashes_2[MSG_GET_HASHES_LEN] = {
+    0x25, 0x48, 0x26,
+};
+
+static const uint8_t proto_vec_hashes_0[MSG_HASHES_LEN] = {
+    0x25, 0x68, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_hashes proto_val_hashes_0 =
+    {0, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, 0}};
+static const uint8_t proto_vec_hashes_1[MSG_HASHES_LEN] = {
+    0x25, 0x68, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_hashes proto_val_hashes_1 =
+    {4294967295u, {4294967295u, 4294967295u, 4294967295u, 4294967295u,
+    4294967295u, 4294967295u, 4294967295u, 4294967295u}, {4294967295u,
+    4294967295u, 4294967295u, 4294967295u, 4294967295u, 4294967295u,
+    4294967295u, 4294967295u}};
+static const uint8_t proto_vec_hashes_2[MSG_HASHES_LEN] = {
+    0x25, 0x68, 0x9F, 0x9E, 0x8A, 0x0F, 0x8C, 0x33, 0xB3, 0xB7, 0x5E, 0x75,
+    0x30, 0xD2, 0x3A, 0xFF, 0x83, 0xBE, 0xCF, 0x09, 0x39, 0x6F, 0x6E, 0x1E,
+    0x72, 0x20, 0xFD, 0x3C, 0x64, 0xDD, 0x03, 0xDD, 0xAB, 0x19, 0x77, 0xB6,
+    0xEF, 0xA0, 0x28, 0x9D, 0xC2, 0x82, 0x8C, 0x78, 0x74, 0xD8, 0x4A, 0x2A,
+    0x52, 0xF5, 0x6B, 0x7E, 0x19, 0x2C, 0xCE, 0x86, 0x04, 0x89, 0x3D, 0xF0,
+    0xB8, 0xB1, 0xBC, 0xB8, 0x74, 0xAA, 0x86, 0x3C, 0x30, 0x55, 0x26,
+};
+static const struct msg_hashes proto_val_hashes_2 =
+    {260742815, {3081974668u, 3526391134u, 3196321594u, 1866009039, 544349806,
+    3714333949u, 430693635, 2700064375u}, {2193792296u, 3631511692u,
+    4115802698u, 739868267, 2298775246u, 2981687357u, 2859776188u,
+    1429224582}};
+
+static const uint8_t proto_vec_stream_frame_0[MSG_STREAM_FRAME_LEN] = {
+    0x25, 0x46, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x26,
+};
+static const struct msg_stream_frame proto_val_stream_frame_0 =
+    {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+static const uint8_t proto_vec_stream_frame_1[MSG_STREAM_FRAME_LEN] = {
+    0x25, 0x46, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0x26,
+};
+static const struct msg_stream_frame proto_val_stream_frame_1 =
+    {{255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255}};
+static const uint8_t proto_vec_stream_frame_2[MSG_STREAM_FRAME_LEN] = {
+    0x25, 0x46, 0xA8, 0x7F, 0xCC, 0x9F, 0x17, 0x6A, 0xCA, 0x0A, 0x36, 0xD2,
+    0x2D, 0xE6, 0x45, 0xCC, 0xEE, 0xC2, 0xE1, 0x52, 0xEF, 0xAD, 0xD4, 0xC2,
+    0x6E, 0x79, 0x92, 0xF7, 0xF2, 0xA6, 0xE4, 0xDF, 0xC6, 0x73, 0xEC, 0xD9,
+    0xA4, 0x09, 0x45, 0xE6, 0x05, 0x94, 0x86, 0x26, 0x8B, 0xFC, 0xBF, 0xA3,
+    0x9E, 0xCA, 0x2E, 0x40, 0x9E, 0x03, 0x63, 0xBD, 0x3C, 0x7B, 0x8A, 0xB7,
+    0x70, 0xBC, 0x20, 0x69, 0xB0, 0xA5, 0x65, 0xCE, 0x49, 0x46, 0x83, 0x8A,
+    0x6E, 0x65, 0x29, 0x22, 0x66, 0x50, 0xD2, 0x4B, 0x31, 0x65, 0x45, 0xA1,
+    0x92, 0xDA, 0x1C, 0x24, 0x24, 0xDF, 0xBA, 0x3E, 0x9F, 0xFE, 0xEA, 0x6E,
+    0x95, 0xFC, 0xD1, 0xE6, 0xCD, 0x31, 0xF6, 0xD3, 0xAB, 0x83, 0x89, 0x2A,
+    0x48, 0xC1, 0x0F, 0x59, 0x8E, 0xC7, 0x50, 0xE8, 0x3C, 0xBF, 0xAC, 0x00,
+    0x18, 0x9C, 0x81, 0x8F, 0x29, 0x7D, 0xDF, 0x32, 0xA0, 0x41, 0xFD, 0x9F,
+    0x8B, 0xD1, 0xB0, 0x20, 0x62, 0x05, 0x18, 0x68, 0x0F, 0xD1, 0xDB, 0x44,
+    0xBB, 0xB9, 0x5E, 0x31, 0xA0, 0xD2, 0x63, 0xD9, 0x08, 0xC1, 0x32, 0xD5,
+    0xF1, 0xDC, 0x89, 0xAC, 0x9A, 0xE4, 0x1C, 0x6D, 0x97, 0xD4, 0xE2, 0x83,
+    0x25, 0xCC, 0xC2, 0x02, 0xB0, 0x83, 0x2B, 0x49, 0x20, 0x20, 0x05, 0x3A,
+    0xA7, 0x20, 0x10, 0x22, 0xE4, 0xA9, 0xB3, 0x40, 0xD0, 0x9A, 0x15, 0x30,
+    0x5E, 0x7A, 0xC2, 0x6B, 0x76, 0xE1, 0xE4, 0x9F, 0x11, 0x2D, 0xDB, 0x86,
+    0x01, 0x94, 0xCC, 0x76, 0xC5, 0x4F, 0xD4, 0x1F, 0xDA, 0x79, 0xE1, 0x48,
+    0x72, 0x40, 0x88, 0xA6, 0xF8, 0xB0, 0x39, 0x05, 0x23, 0xCC, 0xA6, 0x10,
+    0x0F, 0x15, 0xB0, 0x71, 0x53, 0x99, 0x2C, 0xC9, 0xDA, 0xC2, 0x8E, 0x81,
+    0xCE, 0xA7, 0x1F, 0xDE, 0x51, 0xEA, 0xA1, 0xF0, 0xE0, 0xE6, 0xF4, 0xD9,
+    0x9A, 0x08, 0xA0, 0x27, 0x53, 0x97, 0x54, 0x33, 0xF0, 0x1D, 0x37, 0xC2,
+    0x10, 0x4F, 0x26,
+};
+static const struct msg_stream_frame proto_val_stream_frame_2 =
+    {{168, 127, 204, 159, 23, 106, 202, 10, 54, 210, 45, 230, 69, 204, 238,
+    194, 225, 82, 239, 173, 212, 194, 110, 121, 146, 247, 242, 166, 228, 223,
+    198, 115, 236, 217, 164, 9, 69, 230, 5, 148, 134, 38, 139, 252, 191, 163,
+    158, 202, 46, 64, 158, 3, 99, 189, 60, 123, 138, 183, 112, 188, 32, 105,
+    176, 165, 101, 206, 73, 70, 131, 138, 110, 101, 41, 34, 102, 80, 210, 75,
+    49, 101, 69, 161, 146, 218, 28, 36, 36, 223, 186, 62, 159, 254, 234, 110,
+    149, 252, 209, 230, 205, 49, 246, 211, 171, 131, 137, 42, 72, 193, 15, 89,
+    142, 199, 80, 232, 60, 191, 172, 0, 24, 156, 129, 143, 41, 125, 223, 50,
+    160, 65, 253, 159, 139, 209, 176, 32, 98, 5, 24, 104, 15, 209, 219, 68,
+    187, 185, 94, 49, 160, 210, 99, 217, 8, 193, 50, 213, 241, 220, 137, 172,
+    154, 228, 28, 109, 151, 212, 226, 131, 37, 204, 194, 2, 176, 131, 43, 73,
+    32, 32, 5, 58, 167, 32, 16, 34, 228, 169, 179, 64, 208, 154, 21, 48, 94,
+    122, 194, 107, 118, 225, 228, 159, 17, 45, 219, 134, 1, 148, 204, 118, 197,
+    79, 212, 31, 218, 121, 225, 72, 114, 64, 136, 166, 248, 176, 57, 5, 35,
+    204, 166, 16, 15, 21, 176, 113, 83, 153, 44, 201, 218, 194, 142, 129, 206,
+    167, 31, 222, 81, 234, 161, 240, 224, 230, 244, 217, 154, 8, 160, 39, 83,
+    151, 84, 51, 240, 29, 55, 194, 16, 79}};
+
+static const uint8_t proto_vec_bands_0[MSG_BANDS_LEN] = {
+    0x25, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_bands proto_val_bands_0 = {{0, 0, 0, 0}, 0};
+static const uint8_t proto_vec_bands_1[MSG_BANDS_LEN] = {
+    0x25, 0x41, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_bands proto_val_bands_1 = {{255, 255, 255, 255}, 255};
+static const uint8_t proto_vec_bands_2[MSG_BANDS_LEN] = {
+    0x25, 0x41, 0x65, 0xEE, 0x87, 0x60, 0xC6, 0x26,
+};
+static const struct msg_bands proto_val_bands_2 = {{101, 238, 135, 96}, 198};
+
+static const uint8_t proto_vec_get_telemetry_0[MSG_GET_TELEMETRY_LEN] = {
+    0x25, 0x54, 0x26,
+};
+static const uint8_t proto_vec_get_telemetry_1[MSG_GET_TELEMETRY_LEN] = {
+    0x25, 0x54, 0x26,
+};
+static const uint8_t proto_vec_get_telemetry_2[MSG_GET_TELEMETRY_LEN] = {
+    0x25, 0x54, 0x26,
+};
+
+static const uint8_t proto_vec_telemetry_0[MSG_TELEMETRY_LEN] = {
+    0x25, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+};
+static const struct msg_telemetry proto_val_telemetry_0 =
+    {0, 0, 0, 0, 0, 0, 0};
+static const uint8_t proto_vec_telemetry_1[MSG_TELEMETRY_LEN] = {
+    0x25, 0x74, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x26,
+};
+static const struct msg_telemetry proto_val_telemetry_1 =
+    {4294967295u, 4294967295u, 4294967295u, 4294967295u, 4294967295u,
+    4294967295u, 4294967295u};
+static const uint8_t proto_vec_telemetry_2[MSG_TELEMETRY_LEN] = {
+    0x25, 0x74, 0xE5, 0xEB, 0xBD, 0x99, 0xBA, 0xC7, 0x5A, 0x90, 0x37, 0x19,
+    0xAC, 0xE5, 0xB0, 0x61, 0x37, 0x5B, 0xE0, 0x02, 0x4E, 0xFB, 0xEA, 0x9E,
+    0xC3, 0x59, 0x2D, 0x24, 0x00, 0x4F, 0x26,
+};
+static const struct msg_telemetry proto_val_telemetry_2 =
+    {2579360741u, 2421868474u, 3853261111u, 1530356144, 4216193760u,
+    1505992426, 1325409325};
+
+
+/*****************************************************************************
+ *  proto_selftest: Decodes every golden vector, compares the fields, then
+ *                  re-encodes them and compares the bytes. Returns the
+ *                  number of failures.
+ *****************************************************************************/
+static inline int
+proto_selftest(void)
+{
+    uint8_t buf[PROTO_MAX_FRAME];
+    int failures = 0;
+
+    if (!decode_drone_off(proto_vec_drone_off_0) ||
+        encode_drone_off(buf) != MSG_DRONE_OFF_LEN ||
+        memcmp(buf, proto_vec_drone_off_0, MSG_DRONE_OFF_LEN) != 0)
+        failures++;
+    if (!decode_drone_off(proto_vec_drone_off_1) ||
+        encode_drone_off(buf) != MSG_DRONE_OFF_LEN ||
+        memcmp(buf, proto_vec_drone_off_1, MSG_DRONE_OFF_LEN) != 0)
+        failures++;
+    if (!decode_drone_off(proto_vec_drone_off_2) ||
+        encode_drone_off(buf) != MSG_DRONE_OFF_LEN ||
+        memcmp(buf, proto_vec_drone_off_2, MSG_DRONE_OFF_LEN) != 0)
+        failures++;
+    if (!decode_drone_on(proto_vec_drone_on_0) ||
+        encode_drone_on(buf) != MSG_DRONE_ON_LEN ||
+        memcmp(buf, proto_vec_drone_on_0, MSG_DRONE_ON_LEN) != 0)
+        failures++;
+    if (!decode_drone_on(proto_vec_drone_on_1) ||
+        encode_drone_on(buf) != MSG_DRONE_ON_LEN ||
+        memcmp(buf, proto_vec_drone_on_1, MSG_DRONE_ON_LEN) != 0)
+        failures++;
+    if (!decode_drone_on(proto_vec_drone_on_2) ||
+        encode_drone_on(buf) != MSG_DRONE_ON_LEN ||
+        memcmp(buf, proto_vec_drone_on_2, MSG_DRONE_ON_LEN) != 0)
+        failures++;
+    {
+        struct msg_note m;
+        if (!decode_note(proto_vec_note_0, &m) ||
+            m.pitch_class != proto_val_note_0.pitch_class ||
+            m.duration_us != proto_val_note_0.duration_us)
+            failures++;
+        if (encode_note(buf, &proto_val_note_0) !=
+                MSG_NOTE_LEN ||
+            memcmp(buf, proto_vec_note_0, MSG_NOTE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_note m;
+        if (!decode_note(proto_vec_note_1, &m) ||
+            m.pitch_class != proto_val_note_1.pitch_class ||
+            m.duration_us != proto_val_note_1.duration_us)
+            failures++;
+        if (encode_note(buf, &proto_val_note_1) !=
+                MSG_NOTE_LEN ||
+            memcmp(buf, proto_vec_note_1, MSG_NOTE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_note m;
+        if (!decode_note(proto_vec_note_2, &m) ||
+            m.pitch_class != proto_val_note_2.pitch_class ||
+            m.duration_us != proto_val_note_2.duration_us)
+            failures++;
+        if (encode_note(buf, &proto_val_note_2) !=
+                MSG_NOTE_LEN ||
+            memcmp(buf, proto_vec_note_2, MSG_NOTE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_midi_note m;
+        if (!decode_midi_note(proto_vec_midi_note_0, &m) ||
+            m.note != proto_val_midi_note_0.note ||
+            m.velocity != proto_val_midi_note_0.velocity ||
+            m.duration_us != proto_val_midi_note_0.duration_us ||
+            m.step != proto_val_midi_note_0.step)
+            failures++;
+        if (encode_midi_note(buf, &proto_val_midi_note_0) !=
+                MSG_MIDI_NOTE_LEN ||
+            memcmp(buf, proto_vec_midi_note_0, MSG_MIDI_NOTE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_midi_note m;
+        if (!decode_midi_note(proto_vec_midi_note_1, &m) ||
+            m.note != proto_val_midi_note_1.note ||
+            m.velocity != proto_val_midi_note_1.velocity ||
+            m.duration_us != proto_val_midi_note_1.duration_us ||
+            m.step != proto_val_midi_note_1.step)
+            failures++;
+        if (encode_midi_note(buf, &proto_val_midi_note_1) !=
+                MSG_MIDI_NOTE_LEN ||
+            memcmp(buf, proto_vec_midi_note_1, MSG_MIDI_NOTE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_midi_note m;
+        if (!decode_midi_note(proto_vec_midi_note_2, &m) ||
+            m.note != proto_val_midi_note_2.note ||
+            m.velocity != proto_val_midi_note_2.velocity ||
+            m.duration_us != proto_val_midi_note_2.duration_us ||
+            m.step != proto_val_midi_note_2.step)
+            failures++;
+        if (encode_midi_note(buf, &proto_val_midi_note_2) !=
+                MSG_MIDI_NOTE_LEN ||
+            memcmp(buf, proto_vec_midi_note_2, MSG_MIDI_NOTE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_chord m;
+        if (!decode_chord(proto_vec_chord_0, &m) ||
+            m.n_notes != proto_val_chord_0.n_notes ||
+            memcmp(m.pitch_class, proto_val_chord_0.pitch_class,
+                   sizeof m.pitch_class) != 0 ||
+            memcmp(m.duration_us, proto_val_chord_0.duration_us,
+                   sizeof m.duration_us) != 0)
+            failures++;
+        if (encode_chord(buf, &proto_val_chord_0) !=
+                MSG_CHORD_LEN ||
+            memcmp(buf, proto_vec_chord_0, MSG_CHORD_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_chord m;
+        if (!decode_chord(proto_vec_chord_1, &m) ||
+            m.n_notes != proto_val_chord_1.n_notes ||
+            memcmp(m.pitch_class, proto_val_chord_1.pitch_class,
+                   sizeof m.pitch_class) != 0 ||
+            memcmp(m.duration_us, proto_val_chord_1.duration_us,
+                   sizeof m.duration_us) != 0)
+            failures++;
+        if (encode_chord(buf, &proto_val_chord_1) !=
+                MSG_CHORD_LEN ||
+            memcmp(buf, proto_vec_chord_1, MSG_CHORD_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_chord m;
+        if (!decode_chord(proto_vec_chord_2, &m) ||
+            m.n_notes != proto_val_chord_2.n_notes ||
+            memcmp(m.pitch_class, proto_val_chord_2.pitch_class,
+                   sizeof m.pitch_class) != 0 ||
+            memcmp(m.duration_us, proto_val_chord_2.duration_us,
+                   sizeof m.duration_us) != 0)
+            failures++;
+        if (encode_chord(buf, &proto_val_chord_2) !=
+                MSG_CHORD_LEN ||
+            memcmp(buf, proto_vec_chord_2, MSG_CHORD_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_ack m;
+        if (!decode_ack(proto_vec_ack_0, &m) ||
+            m.seq != proto_val_ack_0.seq ||
+            m.rx_us != proto_val_ack_0.rx_us ||
+            m.tx_us != proto_val_ack_0.tx_us ||
+            m.credit != proto_val_ack_0.credit)
+            failures++;
+        if (encode_ack(buf, &proto_val_ack_0) !=
+                MSG_ACK_LEN ||
+            memcmp(buf, proto_vec_ack_0, MSG_ACK_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_ack m;
+        if (!decode_ack(proto_vec_ack_1, &m) ||
+            m.seq != proto_val_ack_1.seq ||
+            m.rx_us != proto_val_ack_1.rx_us ||
+            m.tx_us != proto_val_ack_1.tx_us ||
+            m.credit != proto_val_ack_1.credit)
+            failures++;
+        if (encode_ack(buf, &proto_val_ack_1) !=
+                MSG_ACK_LEN ||
+            memcmp(buf, proto_vec_ack_1, MSG_ACK_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_ack m;
+        if (!decode_ack(proto_vec_ack_2, &m) ||
+            m.seq != proto_val_ack_2.seq ||
+            m.rx_us != proto_val_ack_2.rx_us ||
+            m.tx_us != proto_val_ack_2.tx_us ||
+            m.credit != proto_val_ack_2.credit)
+            failures++;
+        if (encode_ack(buf, &proto_val_ack_2) !=
+                MSG_ACK_LEN ||
+            memcmp(buf, proto_vec_ack_2, MSG_ACK_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_notify m;
+        if (!decode_notify(proto_vec_notify_0, &m) ||
+            m.enable != proto_val_notify_0.enable)
+            failures++;
+        if (encode_notify(buf, &proto_val_notify_0) !=
+                MSG_NOTIFY_LEN ||
+            memcmp(buf, proto_vec_notify_0, MSG_NOTIFY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_notify m;
+        if (!decode_notify(proto_vec_notify_1, &m) ||
+            m.enable != proto_val_notify_1.enable)
+            failures++;
+        if (encode_notify(buf, &proto_val_notify_1) !=
+                MSG_NOTIFY_LEN ||
+            memcmp(buf, proto_vec_notify_1, MSG_NOTIFY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_notify m;
+        if (!decode_notify(proto_vec_notify_2, &m) ||
+            m.enable != proto_val_notify_2.enable)
+            failures++;
+        if (encode_notify(buf, &proto_val_notify_2) !=
+                MSG_NOTIFY_LEN ||
+            memcmp(buf, proto_vec_notify_2, MSG_NOTIFY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_event m;
+        if (!decode_event(proto_vec_event_0, &m) ||
+            m.seq != proto_val_event_0.seq ||
+            m.edge != proto_val_event_0.edge ||
+            m.t_us != proto_val_event_0.t_us)
+            failures++;
+        if (encode_event(buf, &proto_val_event_0) !=
+                MSG_EVENT_LEN ||
+            memcmp(buf, proto_vec_event_0, MSG_EVENT_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_event m;
+        if (!decode_event(proto_vec_event_1, &m) ||
+            m.seq != proto_val_event_1.seq ||
+            m.edge != proto_val_event_1.edge ||
+            m.t_us != proto_val_event_1.t_us)
+            failures++;
+        if (encode_event(buf, &proto_val_event_1) !=
+                MSG_EVENT_LEN ||
+            memcmp(buf, proto_vec_event_1, MSG_EVENT_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_event m;
+        if (!decode_event(proto_vec_event_2, &m) ||
+            m.seq != proto_val_event_2.seq ||
+            m.edge != proto_val_event_2.edge ||
+            m.t_us != proto_val_event_2.t_us)
+            failures++;
+        if (encode_event(buf, &proto_val_event_2) !=
+                MSG_EVENT_LEN ||
+            memcmp(buf, proto_vec_event_2, MSG_EVENT_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_tempo m;
+        if (!decode_tempo(proto_vec_tempo_0, &m) ||
+            m.bpm_milli != proto_val_tempo_0.bpm_milli ||
+            m.beat0_us != proto_val_tempo_0.beat0_us ||
+            m.beats_per_bar != proto_val_tempo_0.beats_per_bar ||
+            m.quantize != proto_val_tempo_0.quantize ||
+            m.drone_sync != proto_val_tempo_0.drone_sync)
+            failures++;
+        if (encode_tempo(buf, &proto_val_tempo_0) !=
+                MSG_TEMPO_LEN ||
+            memcmp(buf, proto_vec_tempo_0, MSG_TEMPO_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_tempo m;
+        if (!decode_tempo(proto_vec_tempo_1, &m) ||
+            m.bpm_milli != proto_val_tempo_1.bpm_milli ||
+            m.beat0_us != proto_val_tempo_1.beat0_us ||
+            m.beats_per_bar != proto_val_tempo_1.beats_per_bar ||
+            m.quantize != proto_val_tempo_1.quantize ||
+            m.drone_sync != proto_val_tempo_1.drone_sync)
+            failures++;
+        if (encode_tempo(buf, &proto_val_tempo_1) !=
+                MSG_TEMPO_LEN ||
+            memcmp(buf, proto_vec_tempo_1, MSG_TEMPO_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_tempo m;
+        if (!decode_tempo(proto_vec_tempo_2, &m) ||
+            m.bpm_milli != proto_val_tempo_2.bpm_milli ||
+            m.beat0_us != proto_val_tempo_2.beat0_us ||
+            m.beats_per_bar != proto_val_tempo_2.beats_per_bar ||
+            m.quantize != proto_val_tempo_2.quantize ||
+            m.drone_sync != proto_val_tempo_2.drone_sync)
+            failures++;
+        if (encode_tempo(buf, &proto_val_tempo_2) !=
+                MSG_TEMPO_LEN ||
+            memcmp(buf, proto_vec_tempo_2, MSG_TEMPO_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_afterglow m;
+        if (!decode_afterglow(proto_vec_afterglow_0, &m) ||
+            memcmp(m.decay, proto_val_afterglow_0.decay, sizeof m.decay) != 0)
+            failures++;
+        if (encode_afterglow(buf, &proto_val_afterglow_0) !=
+                MSG_AFTERGLOW_LEN ||
+            memcmp(buf, proto_vec_afterglow_0, MSG_AFTERGLOW_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_afterglow m;
+        if (!decode_afterglow(proto_vec_afterglow_1, &m) ||
+            memcmp(m.decay, proto_val_afterglow_1.decay, sizeof m.decay) != 0)
+            failures++;
+        if (encode_afterglow(buf, &proto_val_afterglow_1) !=
+                MSG_AFTERGLOW_LEN ||
+            memcmp(buf, proto_vec_afterglow_1, MSG_AFTERGLOW_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_afterglow m;
+        if (!decode_afterglow(proto_vec_afterglow_2, &m) ||
+            memcmp(m.decay, proto_val_afterglow_2.decay, sizeof m.decay) != 0)
+            failures++;
+        if (encode_afterglow(buf, &proto_val_afterglow_2) !=
+                MSG_AFTERGLOW_LEN ||
+            memcmp(buf, proto_vec_afterglow_2, MSG_AFTERGLOW_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_latency m;
+        if (!decode_latency(proto_vec_latency_0, &m) ||
+            m.offset_us != proto_val_latency_0.offset_us)
+            failures++;
+        if (encode_latency(buf, &proto_val_latency_0) !=
+                MSG_LATENCY_LEN ||
+            memcmp(buf, proto_vec_latency_0, MSG_LATENCY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_latency m;
+        if (!decode_latency(proto_vec_latency_1, &m) ||
+            m.offset_us != proto_val_latency_1.offset_us)
+            failures++;
+        if (encode_latency(buf, &proto_val_latency_1) !=
+                MSG_LATENCY_LEN ||
+            memcmp(buf, proto_vec_latency_1, MSG_LATENCY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_latency m;
+        if (!decode_latency(proto_vec_latency_2, &m) ||
+            m.offset_us != proto_val_latency_2.offset_us)
+            failures++;
+        if (encode_latency(buf, &proto_val_latency_2) !=
+                MSG_LATENCY_LEN ||
+            memcmp(buf, proto_vec_latency_2, MSG_LATENCY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_crossfade m;
+        if (!decode_crossfade(proto_vec_crossfade_0, &m) ||
+            m.duration_us != proto_val_crossfade_0.duration_us)
+            failures++;
+        if (encode_crossfade(buf, &proto_val_crossfade_0) !=
+                MSG_CROSSFADE_LEN ||
+            memcmp(buf, proto_vec_crossfade_0, MSG_CROSSFADE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_crossfade m;
+        if (!decode_crossfade(proto_vec_crossfade_1, &m) ||
+            m.duration_us != proto_val_crossfade_1.duration_us)
+            failures++;
+        if (encode_crossfade(buf, &proto_val_crossfade_1) !=
+                MSG_CROSSFADE_LEN ||
+            memcmp(buf, proto_vec_crossfade_1, MSG_CROSSFADE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_crossfade m;
+        if (!decode_crossfade(proto_vec_crossfade_2, &m) ||
+            m.duration_us != proto_val_crossfade_2.duration_us)
+            failures++;
+        if (encode_crossfade(buf, &proto_val_crossfade_2) !=
+                MSG_CROSSFADE_LEN ||
+            memcmp(buf, proto_vec_crossfade_2, MSG_CROSSFADE_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_load m;
+        if (!decode_program_load(proto_vec_program_load_0, &m) ||
+            m.at != proto_val_program_load_0.at ||
+            memcmp(m.code, proto_val_program_load_0.code, sizeof m.code) != 0)
+            failures++;
+        if (encode_program_load(buf, &proto_val_program_load_0) !=
+                MSG_PROGRAM_LOAD_LEN ||
+            memcmp(buf, proto_vec_program_load_0, MSG_PROGRAM_LOAD_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_load m;
+        if (!decode_program_load(proto_vec_program_load_1, &m) ||
+            m.at != proto_val_program_load_1.at ||
+            memcmp(m.code, proto_val_program_load_1.code, sizeof m.code) != 0)
+            failures++;
+        if (encode_program_load(buf, &proto_val_program_load_1) !=
+                MSG_PROGRAM_LOAD_LEN ||
+            memcmp(buf, proto_vec_program_load_1, MSG_PROGRAM_LOAD_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_load m;
+        if (!decode_program_load(proto_vec_program_load_2, &m) ||
+            m.at != proto_val_program_load_2.at ||
+            memcmp(m.code, proto_val_program_load_2.code, sizeof m.code) != 0)
+            failures++;
+        if (encode_program_load(buf, &proto_val_program_load_2) !=
+                MSG_PROGRAM_LOAD_LEN ||
+            memcmp(buf, proto_vec_program_load_2, MSG_PROGRAM_LOAD_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_run m;
+        if (!decode_program_run(proto_vec_program_run_0, &m) ||
+            m.length != proto_val_program_run_0.length ||
+            m.crc != proto_val_program_run_0.crc ||
+            m.seed != proto_val_program_run_0.seed)
+            failures++;
+        if (encode_program_run(buf, &proto_val_program_run_0) !=
+                MSG_PROGRAM_RUN_LEN ||
+            memcmp(buf, proto_vec_program_run_0, MSG_PROGRAM_RUN_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_run m;
+        if (!decode_program_run(proto_vec_program_run_1, &m) ||
+            m.length != proto_val_program_run_1.length ||
+            m.crc != proto_val_program_run_1.crc ||
+            m.seed != proto_val_program_run_1.seed)
+            failures++;
+        if (encode_program_run(buf, &proto_val_program_run_1) !=
+                MSG_PROGRAM_RUN_LEN ||
+            memcmp(buf, proto_vec_program_run_1, MSG_PROGRAM_RUN_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_run m;
+        if (!decode_program_run(proto_vec_program_run_2, &m) ||
+            m.length != proto_val_program_run_2.length ||
+            m.crc != proto_val_program_run_2.crc ||
+            m.seed != proto_val_program_run_2.seed)
+            failures++;
+        if (encode_program_run(buf, &proto_val_program_run_2) !=
+                MSG_PROGRAM_RUN_LEN ||
+            memcmp(buf, proto_vec_program_run_2, MSG_PROGRAM_RUN_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_status m;
+        if (!decode_program_status(proto_vec_program_status_0, &m) ||
+            m.status != proto_val_program_status_0.status ||
+            m.pc != proto_val_program_status_0.pc)
+            failures++;
+        if (encode_program_status(buf, &proto_val_program_status_0) !=
+                MSG_PROGRAM_STATUS_LEN ||
+            memcmp(buf, proto_vec_program_status_0,
+                   MSG_PROGRAM_STATUS_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_status m;
+        if (!decode_program_status(proto_vec_program_status_1, &m) ||
+            m.status != proto_val_program_status_1.status ||
+            m.pc != proto_val_program_status_1.pc)
+            failures++;
+        if (encode_program_status(buf, &proto_val_program_status_1) !=
+                MSG_PROGRAM_STATUS_LEN ||
+            memcmp(buf, proto_vec_program_status_1,
+                   MSG_PROGRAM_STATUS_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_program_status m;
+        if (!decode_program_status(proto_vec_program_status_2, &m) ||
+            m.status != proto_val_program_status_2.status ||
+            m.pc != proto_val_program_status_2.pc)
+            failures++;
+        if (encode_program_status(buf, &proto_val_program_status_2) !=
+                MSG_PROGRAM_STATUS_LEN ||
+            memcmp(buf, proto_vec_program_status_2,
+                   MSG_PROGRAM_STATUS_LEN) != 0)
+            failures++;
+    }
+    if (!decode_get_hashes(proto_vec_get_hashes_0) ||
+        encode_get_hashes(buf) != MSG_GET_HASHES_LEN ||
+        memcmp(buf, proto_vec_get_hashes_0, MSG_GET_HASHES_LEN) != 0)
+        failures++;
+    if (!decode_get_hashes(proto_vec_get_hashes_1) ||
+        encode_get_hashes(buf) != MSG_GET_HASHES_LEN ||
+        memcmp(buf, proto_vec_get_hashes_1, MSG_GET_HASHES_LEN) != 0)
+        failures++;
+    if (!decode_get_hashes(proto_vec_get_hashes_2) ||
+        encode_get_hashes(buf) != MSG_GET_HASHES_LEN ||
+        memcmp(buf, proto_vec_get_hashes_2, MSG_GET_HASHES_LEN) != 0)
+        failures++;
+    {
+        struct msg_hashes m;
+        if (!decode_hashes(proto_vec_hashes_0, &m) ||
+            m.count != proto_val_hashes_0.count ||
+            memcmp(m.crc, proto_val_hashes_0.crc, sizeof m.crc) != 0 ||
+            memcmp(m.t_us, proto_val_hashes_0.t_us, sizeof m.t_us) != 0)
+            failures++;
+        if (encode_hashes(buf, &proto_val_hashes_0) !=
+                MSG_HASHES_LEN ||
+            memcmp(buf, proto_vec_hashes_0, MSG_HASHES_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_hashes m;
+        if (!decode_hashes(proto_vec_hashes_1, &m) ||
+            m.count != proto_val_hashes_1.count ||
+            memcmp(m.crc, proto_val_hashes_1.crc, sizeof m.crc) != 0 ||
+            memcmp(m.t_us, proto_val_hashes_1.t_us, sizeof m.t_us) != 0)
+            failures++;
+        if (encode_hashes(buf, &proto_val_hashes_1) !=
+                MSG_HASHES_LEN ||
+            memcmp(buf, proto_vec_hashes_1, MSG_HASHES_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_hashes m;
+        if (!decode_hashes(proto_vec_hashes_2, &m) ||
+            m.count != proto_val_hashes_2.count ||
+            memcmp(m.crc, proto_val_hashes_2.crc, sizeof m.crc) != 0 ||
+            memcmp(m.t_us, proto_val_hashes_2.t_us, sizeof m.t_us) != 0)
+            failures++;
+        if (encode_hashes(buf, &proto_val_hashes_2) !=
+                MSG_HASHES_LEN ||
+            memcmp(buf, proto_vec_hashes_2, MSG_HASHES_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_stream_frame m;
+        if (!decode_stream_frame(proto_vec_stream_frame_0, &m) ||
+            memcmp(m.rgb, proto_val_stream_frame_0.rgb, sizeof m.rgb) != 0)
+            failures++;
+        if (encode_stream_frame(buf, &proto_val_stream_frame_0) !=
+                MSG_STREAM_FRAME_LEN ||
+            memcmp(buf, proto_vec_stream_frame_0, MSG_STREAM_FRAME_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_stream_frame m;
+        if (!decode_stream_frame(proto_vec_stream_frame_1, &m) ||
+            memcmp(m.rgb, proto_val_stream_frame_1.rgb, sizeof m.rgb) != 0)
+            failures++;
+        if (encode_stream_frame(buf, &proto_val_stream_frame_1) !=
+                MSG_STREAM_FRAME_LEN ||
+            memcmp(buf, proto_vec_stream_frame_1, MSG_STREAM_FRAME_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_stream_frame m;
+        if (!decode_stream_frame(proto_vec_stream_frame_2, &m) ||
+            memcmp(m.rgb, proto_val_stream_frame_2.rgb, sizeof m.rgb) != 0)
+            failures++;
+        if (encode_stream_frame(buf, &proto_val_stream_frame_2) !=
+                MSG_STREAM_FRAME_LEN ||
+            memcmp(buf, proto_vec_stream_frame_2, MSG_STREAM_FRAME_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_bands m;
+        if (!decode_bands(proto_vec_bands_0, &m) ||
+            memcmp(m.level, proto_val_bands_0.level, sizeof m.level) != 0 ||
+            m.depth != proto_val_bands_0.depth)
+            failures++;
+        if (encode_bands(buf, &proto_val_bands_0) !=
+                MSG_BANDS_LEN ||
+            memcmp(buf, proto_vec_bands_0, MSG_BANDS_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_bands m;
+        if (!decode_bands(proto_vec_bands_1, &m) ||
+            memcmp(m.level, proto_val_bands_1.level, sizeof m.level) != 0 ||
+            m.depth != proto_val_bands_1.depth)
+            failures++;
+        if (encode_bands(buf, &proto_val_bands_1) !=
+                MSG_BANDS_LEN ||
+            memcmp(buf, proto_vec_bands_1, MSG_BANDS_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_bands m;
+        if (!decode_bands(proto_vec_bands_2, &m) ||
+            memcmp(m.level, proto_val_bands_2.level, sizeof m.level) != 0 ||
+            m.depth != proto_val_bands_2.depth)
+            failures++;
+        if (encode_bands(buf, &proto_val_bands_2) !=
+                MSG_BANDS_LEN ||
+            memcmp(buf, proto_vec_bands_2, MSG_BANDS_LEN) != 0)
+            failures++;
+    }
+    if (!decode_get_telemetry(proto_vec_get_telemetry_0) ||
+        encode_get_telemetry(buf) != MSG_GET_TELEMETRY_LEN ||
+        memcmp(buf, proto_vec_get_telemetry_0, MSG_GET_TELEMETRY_LEN) != 0)
+        failures++;
+    if (!decode_get_telemetry(proto_vec_get_telemetry_1) ||
+        encode_get_telemetry(buf) != MSG_GET_TELEMETRY_LEN ||
+        memcmp(buf, proto_vec_get_telemetry_1, MSG_GET_TELEMETRY_LEN) != 0)
+        failures++;
+    if (!decode_get_telemetry(proto_vec_get_telemetry_2) ||
+        encode_get_telemetry(buf) != MSG_GET_TELEMETRY_LEN ||
+        memcmp(buf, proto_vec_get_telemetry_2, MSG_GET_TELEMETRY_LEN) != 0)
+        failures++;
+    {
+        struct msg_telemetry m;
+        if (!decode_telemetry(proto_vec_telemetry_0, &m) ||
+            m.frames_received != proto_val_telemetry_0.frames_received ||
+            m.frames_shown != proto_val_telemetry_0.frames_shown ||
+            m.frames_superseded != proto_val_telemetry_0.frames_superseded ||
+            m.commit_cycles != proto_val_telemetry_0.commit_cycles ||
+            m.shows != proto_val_telemetry_0.shows ||
+            m.shows_skipped != proto_val_telemetry_0.shows_skipped ||
+            m.show_us != proto_val_telemetry_0.show_us)
+            failures++;
+        if (encode_telemetry(buf, &proto_val_telemetry_0) !=
+                MSG_TELEMETRY_LEN ||
+            memcmp(buf, proto_vec_telemetry_0, MSG_TELEMETRY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_telemetry m;
+        if (!decode_telemetry(proto_vec_telemetry_1, &m) ||
+            m.frames_received != proto_val_telemetry_1.frames_received ||
+            m.frames_shown != proto_val_telemetry_1.frames_shown ||
+            m.frames_superseded != proto_val_telemetry_1.frames_superseded ||
+            m.commit_cycles != proto_val_telemetry_1.commit_cycles ||
+            m.shows != proto_val_telemetry_1.shows ||
+            m.shows_skipped != proto_val_telemetry_1.shows_skipped ||
+            m.show_us != proto_val_telemetry_1.show_us)
+            failures++;
+        if (encode_telemetry(buf, &proto_val_telemetry_1) !=
+                MSG_TELEMETRY_LEN ||
+            memcmp(buf, proto_vec_telemetry_1, MSG_TELEMETRY_LEN) != 0)
+            failures++;
+    }
+    {
+        struct msg_telemetry m;
+        if (!decode_telemetry(proto_vec_telemetry_2, &m) ||
+            m.frames_received != proto_val_telemetry_2.frames_received ||
+            m.frames_shown != proto_val_telemetry_2.frames_shown ||
+            m.frames_superseded != proto_val_telemetry_2.frames_superseded ||
+            m.commit_cycles != proto_val_telemetry_2.commit_cycles ||
+            m.shows != proto_val_telemetry_2.shows ||
+            m.shows_skipped != proto_val_telemetry_2.shows_skipped ||
+            m.show_us != proto_val_telemetry_2.show_us)
+            failures++;
+        if (encode_telemetry(buf, &proto_val_telemetry_2) !=
+                MSG_TELEMETRY_LEN ||
+            memcmp(buf, proto_vec_telemetry_2, MSG_TELEMETRY_LEN) != 0)
+            failures++;
+    }
+
+    return failures;
+}
+#endif  /* PROTO_SELFTEST */
+
+#endif  /* TNA_PROTOCOL_H */
@@ -0,0 +1,1570 @@
+###############################################################################
+#   Generated by _codegen.py from _protocol_schema.py. Do not edit.
+#
+#   Python codec for the USB-serial protocol; `_protocol.h` is the matching
+#   C++ codec. `encode_*` returns a complete frame as `bytes`,
+#   `encode_*_into` writes it into a preallocated buffer, and `decode_*`
+#   returns the fields as a namedtuple. Malformed frames and out-of-range
+#   fields raise `ProtocolError`.
+###############################################################################
+###############################################################################
+#   Imports
+###############################################################################
+import struct
+
+from collections import namedtuple
+
+
+###############################################################################
+#   Exceptions
+###############################################################################
+class ProtocolError(Exception):
+    pass
+
+
+###############################################################################
+#   Framing
+###############################################################################
+SOF = 0x25
+EOF = 0x26
+MAX_FRAME = 267
+
+
+###############################################################################
+#   Constants
+###############################################################################
+# Number of frame hashes kept by the microcontroller.
+FRAME_HASH_N = 8
+# Period of the afterglow decay, in microseconds.
+AFTERGLOW_FRAME_US = 10000
+# "midi_note" `step` of a note placed as a "note".
+NO_STEP = 65535
+# Largest latency offset, in microseconds.
+LATENCY_MAX_US = 500000
+# Number of bands in a "bands" message.
+BANDS_N = 4
+# The "bands" modulation ends this many microseconds after the last "bands"
+# message.
+BANDS_HOLD_US = 250000
+# Number of slots in the microcontroller's command queue.
+CMD_QUEUE_LEN = 8
+# "event" edge: the first frame of the message was shown.
+EVENT_STARTED = 0
+# "event" edge: the message finished rendering (for a note, the lights were
+# turned off).
+EVENT_FINISHED = 1
+# Largest program, in instructions.
+VM_CODE_MAX = 256
+# Number of registers.
+VM_REGS = 16
+# Most instructions run between two waits; a program that runs more is stopped.
+VM_BUDGET = 4096
+# "program_status": the program runs.
+VM_OK = 0
+# "program_status": empty, too long, or not a whole number of instructions.
+VM_BAD_LENGTH = 1
+# "program_status": the program loaded does not match the CRC.
+VM_BAD_CRC = 2
+# "program_status": unknown opcode.
+VM_BAD_OPCODE = 3
+# "program_status": register operand above r15.
+VM_BAD_REGISTER = 4
+# "program_status": jump past the end of the program.
+VM_BAD_TARGET = 5
+# halt: ends the program.
+VM_HALT = 0
+# ldi a, imm: a = imm.
+VM_LDI = 1
+# ldhi a, imm: bits 16-31 of a = imm.
+VM_LDHI = 2
+# mov a, b: a = b.
+VM_MOV = 3
+# add a, b, c: a = b + c.
+VM_ADD = 4
+# sub a, b, c: a = b - c.
+VM_SUB = 5
+# mul a, b, c: a = b * c.
+VM_MUL = 6
+# and a, b, c: a = b & c.
+VM_AND = 7
+# or a, b, c: a = b | c.
+VM_OR = 8
+# xor a, b, c: a = b ^ c.
+VM_XOR = 9
+# shl a, b, c: a = b << (c & 31).
+VM_SHL = 10
+# shr a, b, c: a = b >> (c & 31).
+VM_SHR = 11
+# mod a, b, c: a = b % c, or 0 if c is 0.
+VM_MOD = 12
+# addi a, imm: a += imm, sign-extended.
+VM_ADDI = 13
+# lt a, b, c: a = (b < c), unsigned.
+VM_LT = 14
+# eq a, b, c: a = (b == c).
+VM_EQ = 15
+# jmp imm: jumps to instruction imm.
+VM_JMP = 16
+# jz a, imm: jumps to imm if a is 0.
+VM_JZ = 17
+# jnz a, imm: jumps to imm if a is not 0.
+VM_JNZ = 18
+# djnz a, imm: decrements a, then jumps to imm if it is not 0.
+VM_DJNZ = 19
+# rand a, b: a = a random number below b (any, if b is 0).
+VM_RAND = 20
+# clear: turns every LED of the frame off.
+VM_CLEAR = 21
+# pixel a, b: LED a % 88 = color b.
+VM_PIXEL = 22
+# panels a, b: the LEDs of the panels in mask a (bit 0 for P1) = color b.
+VM_PANELS = 23
+# groups a, b: the LEDs of the groups in mask a (bit 0 for the front, then
+# back, LL, LR, RL, RR and Top) = color b.
+VM_GROUPS = 24
+# note a, b: a = color of pitch class b % 12.
+VM_NOTE = 25
+# scale a, b, c: a = color b at brightness c / 256 (c at most 256).
+VM_SCALE = 26
+# blend a, b, c: a = color a moved c / 256 of the way to color b (c at most
+# 256).
+VM_BLEND = 27
+# show: shows the frame.
+VM_SHOW = 28
+# wait a: yields until a microseconds after the previous wait ended.
+VM_WAIT = 29
+# beat a: yields until the next point of a grid of a points per beat of the
+# tempo clock, or for AFTERGLOW_FRAME_US if it is stopped.
+VM_BEAT = 30
+# time a: a = microseconds since the program started.
+VM_TIME = 31
+
+
+def _put_dec(value, width):
+    digits = str(value).encode()
+    if value < 0 or len(digits) > width:
+        raise ProtocolError(f"{value} does not fit in {width} digits.")
+    return digits
+
+
+def _get_dec(raw):
+    digits, _, rest = raw.partition(b"\0")
+    if (digits and not digits.isdigit()) or rest.count(0) != len(rest):
+        raise ProtocolError(f"Invalid decimal field {raw!r}.")
+    return int(digits) if digits else 0
+
+
+###############################################################################
+#   drone_off (host -> device)
+#
+#       reserved      : pad8    Always '\0'.
+###############################################################################
+OP_DRONE_OFF = 0x30
+DRONE_OFF_LEN = 11
+DroneOff = namedtuple("DroneOff", "")
+_drone_off = struct.Struct("<BB8xB")
+
+
+def encode_drone_off():
+    """Returns the frame for: Turns off the drone (and all lights)."""
+    try:
+        return _drone_off.pack(SOF, OP_DRONE_OFF, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_drone_off_into(buf, offset):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _drone_off.pack_into(buf, offset, SOF, OP_DRONE_OFF, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + DRONE_OFF_LEN
+
+
+def decode_drone_off(frame, offset=0):
+    """Returns the fields of a `drone_off` frame as a `DroneOff`."""
+    try:
+        v = _drone_off.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_DRONE_OFF or v[-1] != EOF:
+        raise ProtocolError("Malformed `drone_off` frame.")
+    return DroneOff()
+
+
+###############################################################################
+#   drone_on (host -> device)
+#
+#       reserved      : pad8    Always '\0'.
+###############################################################################
+OP_DRONE_ON = 0x31
+DRONE_ON_LEN = 11
+DroneOn = namedtuple("DroneOn", "")
+_drone_on = struct.Struct("<BB8xB")
+
+
+def encode_drone_on():
+    """Returns the frame for: Turns on the drone. The drone runs until the next
+    message."""
+    try:
+        return _drone_on.pack(SOF, OP_DRONE_ON, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_drone_on_into(buf, offset):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _drone_on.pack_into(buf, offset, SOF, OP_DRONE_ON, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + DRONE_ON_LEN
+
+
+def decode_drone_on(frame, offset=0):
+    """Returns the fields of a `drone_on` frame as a `DroneOn`."""
+    try:
+        v = _drone_on.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_DRONE_ON or v[-1] != EOF:
+        raise ProtocolError("Malformed `drone_on` frame.")
+    return DroneOn()
+
+
+###############################################################################
+#   note (host -> device)
+#
+#       pitch_class   : u8      Octave-independent note number in [0, 11]; C is
+#                               0.
+#       duration_us   : dec7    How long the lights stay on, in microseconds.
+###############################################################################
+OP_NOTE = 0x32
+NOTE_LEN = 11
+Note = namedtuple("Note", "pitch_class duration_us")
+_note = struct.Struct("<BBB7sB")
+
+
+def encode_note(pitch_class, duration_us):
+    """Returns the frame for: Lights a random half of the panels in the color
+    of a note."""
+    try:
+        return _note.pack(SOF, OP_NOTE, pitch_class, _put_dec(duration_us, 7),
+                          EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_note_into(buf, offset, pitch_class, duration_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _note.pack_into(buf, offset, SOF, OP_NOTE, pitch_class,
+                        _put_dec(duration_us, 7), EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + NOTE_LEN
+
+
+def decode_note(frame, offset=0):
+    """Returns the fields of a `note` frame as a `Note`."""
+    try:
+        v = _note.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_NOTE or v[-1] != EOF:
+        raise ProtocolError("Malformed `note` frame.")
+    return Note(v[2], _get_dec(v[3]))
+
+
+###############################################################################
+#   midi_note (host -> device)
+#
+#       note          : u8      MIDI note number in [0, 127]; 60 is C4.
+#       velocity      : u8      MIDI velocity in [0, 127]. 0 lights nothing.
+#       duration_us   : u32     How long the lights stay on, in microseconds.
+#       step          : u16     Point of the quantization grid of the last
+#                               "tempo" (`quantize` points per beat, counted
+#                               from beat 0) at which the note starts, even if
+#                               that point has passed, so that a message
+#                               arriving late does not shift the notes after
+#                               it. NO_STEP to start it as a "note".
+###############################################################################
+OP_MIDI_NOTE = 0x4D
+MIDI_NOTE_LEN = 11
+MidiNote = namedtuple("MidiNote", "note velocity duration_us step")
+_midi_note = struct.Struct("<BBBBIHB")
+
+
+def encode_midi_note(note, velocity, duration_us, step):
+    """Returns the frame for: Lights a note like "note", from its full MIDI
+    note number and velocity: the octave decides which panels are lit (low
+    notes on the lower panels, high notes on "Top") and the velocity how
+    brightly."""
+    try:
+        return _midi_note.pack(SOF, OP_MIDI_NOTE, note, velocity, duration_us,
+                               step, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_midi_note_into(buf, offset, note, velocity, duration_us, step):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _midi_note.pack_into(buf, offset, SOF, OP_MIDI_NOTE, note, velocity,
+                             duration_us, step, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + MIDI_NOTE_LEN
+
+
+def decode_midi_note(frame, offset=0):
+    """Returns the fields of a `midi_note` frame as a `MidiNote`."""
+    try:
+        v = _midi_note.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_MIDI_NOTE or v[-1] != EOF:
+        raise ProtocolError("Malformed `midi_note` frame.")
+    return MidiNote(v[2], v[3], v[4], v[5])
+
+
+###############################################################################
+#   chord (host -> device)
+#
+#       n_notes       : u8      Number of notes, in [1, 12].
+#       pitch_class   : u8[12]  Pitch class of each note, as in "note". Entries
+#                               past `n_notes` are ignored.
+#       duration_us   : u32[12] How long each note stays on, in microseconds.
+###############################################################################
+OP_CHORD = 0x43
+CHORD_LEN = 64
+Chord = namedtuple("Chord", "n_notes pitch_class duration_us")
+_chord = struct.Struct("<BBB12s12IB")
+
+
+def encode_chord(n_notes, pitch_class, duration_us):
+    """Returns the frame for: Lights up to 12 notes at once, each in its own
+    panel groups, in a single frame. Each note goes dark after its own
+    duration; the chord has finished when all have."""
+    if len(pitch_class) != 12:
+        raise ProtocolError("`pitch_class` must have 12 elements.")
+    try:
+        return _chord.pack(SOF, OP_CHORD, n_notes, bytes(pitch_class),
+                           *duration_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_chord_into(buf, offset, n_notes, pitch_class, duration_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    if len(pitch_class) != 12:
+        raise ProtocolError("`pitch_class` must have 12 elements.")
+    try:
+        _chord.pack_into(buf, offset, SOF, OP_CHORD, n_notes,
+                         bytes(pitch_class), *duration_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + CHORD_LEN
+
+
+def decode_chord(frame, offset=0):
+    """Returns the fields of a `chord` frame as a `Chord`."""
+    try:
+        v = _chord.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_CHORD or v[-1] != EOF:
+        raise ProtocolError("Malformed `chord` frame.")
+    return Chord(v[2], v[3], v[4:16])
+
+
+###############################################################################
+#   ack (device -> host)
+#
+#       seq           : u16     Sequence number of the accepted message.
+#                               Messages are numbered from 0 in the order they
+#                               are accepted, modulo 2**16.
+#       rx_us         : u32     Value of micros() when the message was
+#                               accepted.
+#       tx_us         : u32     Value of micros() when the message was taken
+#                               off the queue and this ack was sent. The ack is
+#                               written out by the end of the same pass of
+#                               loop(), so this is the time to pair with the
+#                               time the host receives it.
+#       credit        : u16     Credit limit: the host may send messages up to,
+#                               but not including, sequence number `credit`
+#                               (modulo 2**16). Equal to the number of messages
+#                               accepted so far plus the number of free slots
+#                               in the command queue.
+###############################################################################
+OP_ACK = 0x4B
+ACK_LEN = 15
+Ack = namedtuple("Ack", "seq rx_us tx_us credit")
+_ack = struct.Struct("<BBHIIHB")
+
+
+def encode_ack(seq, rx_us, tx_us, credit):
+    """Returns the frame for: Response to every well-formed host -> device
+    message, sent when the message is taken off the command queue and
+    executed."""
+    try:
+        return _ack.pack(SOF, OP_ACK, seq, rx_us, tx_us, credit, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_ack_into(buf, offset, seq, rx_us, tx_us, credit):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _ack.pack_into(buf, offset, SOF, OP_ACK, seq, rx_us, tx_us, credit,
+                       EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + ACK_LEN
+
+
+def decode_ack(frame, offset=0):
+    """Returns the fields of a `ack` frame as a `Ack`."""
+    try:
+        v = _ack.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_ACK or v[-1] != EOF:
+        raise ProtocolError("Malformed `ack` frame.")
+    return Ack(v[2], v[3], v[4], v[5])
+
+
+###############################################################################
+#   notify (host -> device)
+#
+#       enable        : u8      1 to enable, 0 to disable.
+###############################################################################
+OP_NOTIFY = 0x4E
+NOTIFY_LEN = 4
+Notify = namedtuple("Notify", "enable")
+_notify = struct.Struct("<BBBB")
+
+
+def encode_notify(enable):
+    """Returns the frame for: Enables or disables "event" notifications."""
+    try:
+        return _notify.pack(SOF, OP_NOTIFY, enable, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_notify_into(buf, offset, enable):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _notify.pack_into(buf, offset, SOF, OP_NOTIFY, enable, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + NOTIFY_LEN
+
+
+def decode_notify(frame, offset=0):
+    """Returns the fields of a `notify` frame as a `Notify`."""
+    try:
+        v = _notify.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_NOTIFY or v[-1] != EOF:
+        raise ProtocolError("Malformed `notify` frame.")
+    return Notify(v[2])
+
+
+###############################################################################
+#   event (device -> host)
+#
+#       seq           : u16     Sequence number of the message, as in its
+#                               "ack".
+#       edge          : u8      EVENT_STARTED or EVENT_FINISHED.
+#       t_us          : u32     Value of micros() at the edge. For notes and
+#                               chords, the scheduled time of the edge, before
+#                               the "latency" offset; the event is sent at that
+#                               time.
+###############################################################################
+OP_EVENT = 0x45
+EVENT_LEN = 10
+Event = namedtuple("Event", "seq edge t_us")
+_event = struct.Struct("<BBHBIB")
+
+
+def encode_event(seq, edge, t_us):
+    """Returns the frame for: Notification that the lights for a message
+    started or finished rendering. Sent only while enabled by "notify"; several
+    are batched into one USB packet where possible."""
+    try:
+        return _event.pack(SOF, OP_EVENT, seq, edge, t_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_event_into(buf, offset, seq, edge, t_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _event.pack_into(buf, offset, SOF, OP_EVENT, seq, edge, t_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + EVENT_LEN
+
+
+def decode_event(frame, offset=0):
+    """Returns the fields of a `event` frame as a `Event`."""
+    try:
+        v = _event.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_EVENT or v[-1] != EOF:
+        raise ProtocolError("Malformed `event` frame.")
+    return Event(v[2], v[3], v[4])
+
+
+###############################################################################
+#   tempo (host -> device)
+#
+#       bpm_milli     : u32     Beats per minute times 1000 (102 BPM is
+#                               102000). 0 stops the clock and every effect
+#                               below.
+#       beat0_us      : u32     Value of micros() at beat 0, as estimated by
+#                               the host from the acks. May be in the past or
+#                               the future.
+#       beats_per_bar : u8      Notes starting on the first beat of a bar are
+#                               accented (panel 11 fully lit). 0 for no
+#                               accents.
+#       quantize      : u8      Note starts are moved to the nearest point of a
+#                               grid of this many points per beat, never
+#                               earlier than the note is taken off the queue,
+#                               unless a "midi_note" names its grid point. 0
+#                               for no quantization.
+#       drone_sync    : u8      1 to start drone breaths on beats and stretch
+#                               each to a whole number of beats.
+###############################################################################
+OP_TEMPO = 0x42
+TEMPO_LEN = 14
+Tempo = namedtuple("Tempo", "bpm_milli beat0_us beats_per_bar quantize "
+                            "drone_sync")
+_tempo = struct.Struct("<BBIIBBBB")
+
+
+def encode_tempo(bpm_milli, beat0_us, beats_per_bar, quantize, drone_sync):
+    """Returns the frame for: Sets the tempo of the on-device beat clock. Beat
+    n starts exactly beat0_us + n * 60e9 / bpm_milli microseconds; there is no
+    per-beat message and no accumulated rounding."""
+    try:
+        return _tempo.pack(SOF, OP_TEMPO, bpm_milli, beat0_us, beats_per_bar,
+                           quantize, drone_sync, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_tempo_into(buf, offset, bpm_milli, beat0_us, beats_per_bar,
+                      quantize, drone_sync):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _tempo.pack_into(buf, offset, SOF, OP_TEMPO, bpm_milli, beat0_us,
+                         beats_per_bar, quantize, drone_sync, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + TEMPO_LEN
+
+
+def decode_tempo(frame, offset=0):
+    """Returns the fields of a `tempo` frame as a `Tempo`."""
+    try:
+        v = _tempo.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_TEMPO or v[-1] != EOF:
+        raise ProtocolError("Malformed `tempo` frame.")
+    return Tempo(v[2], v[3], v[4], v[5], v[6])
+
+
+###############################################################################
+#   afterglow (host -> device)
+#
+#       decay         : u8[21]  Decay factors, out of 256, for R, G and B of
+#                               each panel group, in the order front, back,
+#                               left-left, left-right, right-left, right-right,
+#                               top. All 0 turns the afterglow off.
+###############################################################################
+OP_AFTERGLOW = 0x47
+AFTERGLOW_LEN = 24
+Afterglow = namedtuple("Afterglow", "decay")
+_afterglow = struct.Struct("<BB21sB")
+
+
+def encode_afterglow(decay):
+    """Returns the frame for: Configures the afterglow: instead of going dark
+    at once, lights fade by a per-group, per-channel factor every
+    AFTERGLOW_FRAME_US microseconds."""
+    if len(decay) != 21:
+        raise ProtocolError("`decay` must have 21 elements.")
+    try:
+        return _afterglow.pack(SOF, OP_AFTERGLOW, bytes(decay), EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_afterglow_into(buf, offset, decay):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    if len(decay) != 21:
+        raise ProtocolError("`decay` must have 21 elements.")
+    try:
+        _afterglow.pack_into(buf, offset, SOF, OP_AFTERGLOW, bytes(decay), EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + AFTERGLOW_LEN
+
+
+def decode_afterglow(frame, offset=0):
+    """Returns the fields of a `afterglow` frame as a `Afterglow`."""
+    try:
+        v = _afterglow.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_AFTERGLOW or v[-1] != EOF:
+        raise ProtocolError("Malformed `afterglow` frame.")
+    return Afterglow(v[2])
+
+
+###############################################################################
+#   latency (host -> device)
+#
+#       offset_us     : i32     Offset in microseconds, in [-LATENCY_MAX_US,
+#                               LATENCY_MAX_US]. Positive delays the lights;
+#                               negative advances them, by delaying the events
+#                               instead when nothing is scheduled ahead.
+###############################################################################
+OP_LATENCY = 0x4C
+LATENCY_LEN = 7
+Latency = namedtuple("Latency", "offset_us")
+_latency = struct.Struct("<BBiB")
+
+
+def encode_latency(offset_us):
+    """Returns the frame for: Sets the latency compensation. Notes and chords
+    are scheduled as usual, and their "event" frames are sent on schedule, but
+    their lights go on and off `offset_us` later, so that lights and sound
+    (started by the host on the events) reach the audience together. The start
+    of drone breaths locked to the beat is shifted by the same amount."""
+    try:
+        return _latency.pack(SOF, OP_LATENCY, offset_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_latency_into(buf, offset, offset_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _latency.pack_into(buf, offset, SOF, OP_LATENCY, offset_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + LATENCY_LEN
+
+
+def decode_latency(frame, offset=0):
+    """Returns the fields of a `latency` frame as a `Latency`."""
+    try:
+        v = _latency.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_LATENCY or v[-1] != EOF:
+        raise ProtocolError("Malformed `latency` frame.")
+    return Latency(v[2])
+
+
+###############################################################################
+#   crossfade (host -> device)
+#
+#       duration_us   : u32     Length of a crossfade, in microseconds; at most
+#                               half of the note is spent fading. 0 turns
+#                               crossfades off.
+###############################################################################
+OP_CROSSFADE = 0x58
+CROSSFADE_LEN = 7
+Crossfade = namedtuple("Crossfade", "duration_us")
+_crossfade = struct.Struct("<BBIB")
+
+
+def encode_crossfade(duration_us):
+    """Returns the frame for: Configures crossfades between consecutive notes:
+    each note starts in the color of the previous one and glides to its own
+    over `duration_us`, in steps of AFTERGLOW_FRAME_US, along a perceptual
+    (OKLab) color ramp."""
+    try:
+        return _crossfade.pack(SOF, OP_CROSSFADE, duration_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_crossfade_into(buf, offset, duration_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _crossfade.pack_into(buf, offset, SOF, OP_CROSSFADE, duration_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + CROSSFADE_LEN
+
+
+def decode_crossfade(frame, offset=0):
+    """Returns the fields of a `crossfade` frame as a `Crossfade`."""
+    try:
+        v = _crossfade.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_CROSSFADE or v[-1] != EOF:
+        raise ProtocolError("Malformed `crossfade` frame.")
+    return Crossfade(v[2])
+
+
+###############################################################################
+#   program_load (host -> device)
+#
+#       at            : u16     Byte offset of the chunk in the program, a
+#                               multiple of 4 below 4 * VM_CODE_MAX.
+#       code          : u8[64]  Up to 16 instructions of 4 bytes; bytes past
+#                               the end of the program buffer are ignored.
+###############################################################################
+OP_PROGRAM_LOAD = 0x50
+PROGRAM_LOAD_LEN = 69
+ProgramLoad = namedtuple("ProgramLoad", "at code")
+_program_load = struct.Struct("<BBH64sB")
+
+
+def encode_program_load(at, code):
+    """Returns the frame for: Writes a chunk of a light program (bytecode for
+    the microcontroller's VM, see the VM_* constants) into the program buffer.
+    The program is verified by the next "program_run"."""
+    if len(code) != 64:
+        raise ProtocolError("`code` must have 64 elements.")
+    try:
+        return _program_load.pack(SOF, OP_PROGRAM_LOAD, at, bytes(code), EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_program_load_into(buf, offset, at, code):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    if len(code) != 64:
+        raise ProtocolError("`code` must have 64 elements.")
+    try:
+        _program_load.pack_into(buf, offset, SOF, OP_PROGRAM_LOAD, at,
+                                bytes(code), EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + PROGRAM_LOAD_LEN
+
+
+def decode_program_load(frame, offset=0):
+    """Returns the fields of a `program_load` frame as a `ProgramLoad`."""
+    try:
+        v = _program_load.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_PROGRAM_LOAD or v[-1] != EOF:
+        raise ProtocolError("Malformed `program_load` frame.")
+    return ProgramLoad(v[2], v[3])
+
+
+###############################################################################
+#   program_run (host -> device)
+#
+#       length        : u16     Length of the program, in bytes.
+#       crc           : u32     CRC-32 (as computed by zlib.crc32()) of the
+#                               program.
+#       seed          : u32     Seed of the program's PRNG; 0 is 1.
+###############################################################################
+OP_PROGRAM_RUN = 0x52
+PROGRAM_RUN_LEN = 13
+ProgramRun = namedtuple("ProgramRun", "length crc seed")
+_program_run = struct.Struct("<BBHIIB")
+
+
+def encode_program_run(length, crc, seed):
+    """Returns the frame for: Verifies the program loaded (once per load) and
+    runs it, replying with a "program_status" frame right after the ack. A
+    program runs until it halts or, at a wait, until the next message."""
+    try:
+        return _program_run.pack(SOF, OP_PROGRAM_RUN, length, crc, seed, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_program_run_into(buf, offset, length, crc, seed):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _program_run.pack_into(buf, offset, SOF, OP_PROGRAM_RUN, length, crc,
+                               seed, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + PROGRAM_RUN_LEN
+
+
+def decode_program_run(frame, offset=0):
+    """Returns the fields of a `program_run` frame as a `ProgramRun`."""
+    try:
+        v = _program_run.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_PROGRAM_RUN or v[-1] != EOF:
+        raise ProtocolError("Malformed `program_run` frame.")
+    return ProgramRun(v[2], v[3], v[4])
+
+
+###############################################################################
+#   program_status (device -> host)
+#
+#       status        : u8      VM_OK or one of the VM_BAD_* errors.
+#       pc            : u16     Index of the offending instruction, for
+#                               VM_BAD_OPCODE, VM_BAD_REGISTER and
+#                               VM_BAD_TARGET.
+###############################################################################
+OP_PROGRAM_STATUS = 0x70
+PROGRAM_STATUS_LEN = 6
+ProgramStatus = namedtuple("ProgramStatus", "status pc")
+_program_status = struct.Struct("<BBBHB")
+
+
+def encode_program_status(status, pc):
+    """Returns the frame for: Result of verifying a program."""
+    try:
+        return _program_status.pack(SOF, OP_PROGRAM_STATUS, status, pc, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_program_status_into(buf, offset, status, pc):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _program_status.pack_into(buf, offset, SOF, OP_PROGRAM_STATUS, status,
+                                  pc, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + PROGRAM_STATUS_LEN
+
+
+def decode_program_status(frame, offset=0):
+    """Returns the fields of a `program_status` frame as a `ProgramStatus`."""
+    try:
+        v = _program_status.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_PROGRAM_STATUS or v[-1] != EOF:
+        raise ProtocolError("Malformed `program_status` frame.")
+    return ProgramStatus(v[2], v[3])
+
+
+###############################################################################
+#   get_hashes (host -> device)
+#
+###############################################################################
+OP_GET_HASHES = 0x48
+GET_HASHES_LEN = 3
+GetHashes = namedtuple("GetHashes", "")
+_get_hashes = struct.Struct("<BBB")
+
+
+def encode_get_hashes():
+    """Returns the frame for: Requests a "hashes" frame, sent right after the
+    ack."""
+    try:
+        return _get_hashes.pack(SOF, OP_GET_HASHES, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_get_hashes_into(buf, offset):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _get_hashes.pack_into(buf, offset, SOF, OP_GET_HASHES, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + GET_HASHES_LEN
+
+
+def decode_get_hashes(frame, offset=0):
+    """Returns the fields of a `get_hashes` frame as a `GetHashes`."""
+    try:
+        v = _get_hashes.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_GET_HASHES or v[-1] != EOF:
+        raise ProtocolError("Malformed `get_hashes` frame.")
+    return GetHashes()
+
+
+###############################################################################
+#   hashes (device -> host)
+#
+#       count         : u32     Frames shown since power-up, modulo 2**32.
+#                               Entries past `count` are 0.
+#       crc           : u32[8]  CRC-32 of each frame.
+#       t_us          : u32[8]  Value of micros() when each frame was shown.
+###############################################################################
+OP_HASHES = 0x68
+HASHES_LEN = 71
+Hashes = namedtuple("Hashes", "count crc t_us")
+_hashes = struct.Struct("<BBI8I8IB")
+
+
+def encode_hashes(count, crc, t_us):
+    """Returns the frame for: CRC-32 (as computed by zlib.crc32()) of the R, G,
+    B bytes of the last FRAME_HASH_N frames shown, newest first."""
+    try:
+        return _hashes.pack(SOF, OP_HASHES, count, *crc, *t_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_hashes_into(buf, offset, count, crc, t_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _hashes.pack_into(buf, offset, SOF, OP_HASHES, count, *crc, *t_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + HASHES_LEN
+
+
+def decode_hashes(frame, offset=0):
+    """Returns the fields of a `hashes` frame as a `Hashes`."""
+    try:
+        v = _hashes.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_HASHES or v[-1] != EOF:
+        raise ProtocolError("Malformed `hashes` frame.")
+    return Hashes(v[2], v[3:11], v[11:19])
+
+
+###############################################################################
+#   stream_frame (host -> device)
+#
+#       rgb           : u8[264] R, G and B of each of the 88 LEDs, in address
+#                               order.
+###############################################################################
+OP_STREAM_FRAME = 0x46
+STREAM_FRAME_LEN = 267
+StreamFrame = namedtuple("StreamFrame", "rgb")
+_stream_frame = struct.Struct("<BB264sB")
+
+
+def encode_stream_frame(rgb):
+    """Returns the frame for: Full frame for streaming. Not queued, sequenced
+    or acked: the microcontroller keeps only the latest frame received
+    (superseding any not yet shown) and shows it when idle."""
+    if len(rgb) != 264:
+        raise ProtocolError("`rgb` must have 264 elements.")
+    try:
+        return _stream_frame.pack(SOF, OP_STREAM_FRAME, bytes(rgb), EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_stream_frame_into(buf, offset, rgb):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    if len(rgb) != 264:
+        raise ProtocolError("`rgb` must have 264 elements.")
+    try:
+        _stream_frame.pack_into(buf, offset, SOF, OP_STREAM_FRAME, bytes(rgb),
+                                EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + STREAM_FRAME_LEN
+
+
+def decode_stream_frame(frame, offset=0):
+    """Returns the fields of a `stream_frame` frame as a `StreamFrame`."""
+    try:
+        v = _stream_frame.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_STREAM_FRAME or v[-1] != EOF:
+        raise ProtocolError("Malformed `stream_frame` frame.")
+    return StreamFrame(v[2])
+
+
+###############################################################################
+#   bands (host -> device)
+#
+#       level         : u8[4]   Level of each band, lowest first, from 0
+#                               (silent) to 255 (full scale). Band 0 modulates
+#                               the front and back groups, band 1 left-left and
+#                               right-right, band 2 left-right and right-left,
+#                               and band 3 "Top".
+#       depth         : u8      Modulation depth, out of 255: a group is shown
+#                               at a fraction 1 - depth * (1 - level / 255) /
+#                               255 of its brightness. 0 turns the modulation
+#                               off.
+###############################################################################
+OP_BANDS = 0x41
+BANDS_LEN = 8
+Bands = namedtuple("Bands", "level depth")
+_bands = struct.Struct("<BB4sBB")
+
+
+def encode_bands(level, depth):
+    """Returns the frame for: Envelope levels of BANDS_N frequency bands of the
+    audio being played, sent by the host about every 10 ms. Not queued,
+    sequenced or acked, like "stream_frame": the newest levels modulate the
+    brightness of every frame shown from then on, until BANDS_HOLD_US pass
+    without any."""
+    if len(level) != 4:
+        raise ProtocolError("`level` must have 4 elements.")
+    try:
+        return _bands.pack(SOF, OP_BANDS, bytes(level), depth, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_bands_into(buf, offset, level, depth):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    if len(level) != 4:
+        raise ProtocolError("`level` must have 4 elements.")
+    try:
+        _bands.pack_into(buf, offset, SOF, OP_BANDS, bytes(level), depth, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + BANDS_LEN
+
+
+def decode_bands(frame, offset=0):
+    """Returns the fields of a `bands` frame as a `Bands`."""
+    try:
+        v = _bands.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_BANDS or v[-1] != EOF:
+        raise ProtocolError("Malformed `bands` frame.")
+    return Bands(v[2], v[3])
+
+
+###############################################################################
+#   get_telemetry (host -> device)
+#
+###############################################################################
+OP_GET_TELEMETRY = 0x54
+GET_TELEMETRY_LEN = 3
+GetTelemetry = namedtuple("GetTelemetry", "")
+_get_telemetry = struct.Struct("<BBB")
+
+
+def encode_get_telemetry():
+    """Returns the frame for: Requests a "telemetry" frame, sent right after
+    the ack."""
+    try:
+        return _get_telemetry.pack(SOF, OP_GET_TELEMETRY, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_get_telemetry_into(buf, offset):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _get_telemetry.pack_into(buf, offset, SOF, OP_GET_TELEMETRY, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + GET_TELEMETRY_LEN
+
+
+def decode_get_telemetry(frame, offset=0):
+    """Returns the fields of a `get_telemetry` frame as a `GetTelemetry`."""
+    try:
+        v = _get_telemetry.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_GET_TELEMETRY or v[-1] != EOF:
+        raise ProtocolError("Malformed `get_telemetry` frame.")
+    return GetTelemetry()
+
+
+###############################################################################
+#   telemetry (device -> host)
+#
+#       frames_received: u32     "frame" messages received.
+#       frames_shown  : u32     "frame" messages shown.
+#       frames_superseded: u32     "frame" messages replaced by a newer one
+#                               before being shown.
+#       commit_cycles : u32     CPU cycles spent computing the last frame
+#                               shown, from the target frame to the hand-off to
+#                               the LED driver; 0 where there is no cycle
+#                               counter.
+#       shows         : u32     Frames handed to the LED driver, keep-alives
+#                               included.
+#       shows_skipped : u32     Frames not handed to the LED driver because
+#                               they were already on the LEDs.
+#       show_us       : u32     Microseconds spent handing frames to the LED
+#                               driver.
+###############################################################################
+OP_TELEMETRY = 0x74
+TELEMETRY_LEN = 31
+Telemetry = namedtuple("Telemetry", "frames_received frames_shown "
+                                    "frames_superseded commit_cycles shows "
+                                    "shows_skipped show_us")
+_telemetry = struct.Struct("<BBIIIIIIIB")
+
+
+def encode_telemetry(frames_received, frames_shown, frames_superseded,
+                     commit_cycles, shows, shows_skipped, show_us):
+    """Returns the frame for: Streaming and refresh counters since power-up,
+    modulo 2**32, and the cost of the last frame."""
+    try:
+        return _telemetry.pack(SOF, OP_TELEMETRY, frames_received,
+                               frames_shown, frames_superseded, commit_cycles,
+                               shows, shows_skipped, show_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+
+
+def encode_telemetry_into(buf, offset, frames_received, frames_shown,
+                          frames_superseded, commit_cycles, shows,
+                          shows_skipped, show_us):
+    """Writes the frame into `buf` at `offset`. Returns the offset
+    just past the frame."""
+    try:
+        _telemetry.pack_into(buf, offset, SOF, OP_TELEMETRY, frames_received,
+                             frames_shown, frames_superseded, commit_cycles,
+                             shows, shows_skipped, show_us, EOF)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    return offset + TELEMETRY_LEN
+
+
+def decode_telemetry(frame, offset=0):
+    """Returns the fields of a `telemetry` frame as a `Telemetry`."""
+    try:
+        v = _telemetry.unpack_from(frame, offset)
+    except struct.error as err:
+        raise ProtocolError(err) from None
+    if v[0] != SOF or v[1] != OP_TELEMETRY or v[-1] != EOF:
+        raise ProtocolError("Malformed `telemetry` frame.")
+    return Telemetry(v[2], v[3], v[4], v[5], v[6], v[7], v[8])
+
+
+###############################################################################
+#   Dispatch
+###############################################################################
+FRAME_LEN = {
+    OP_DRONE_OFF: DRONE_OFF_LEN,
+    OP_DRONE_ON: DRONE_ON_LEN,
+    OP_NOTE: NOTE_LEN,
+    OP_MIDI_NOTE: MIDI_NOTE_LEN,
+    OP_CHORD: CHORD_LEN,
+    OP_ACK: ACK_LEN,
+    OP_NOTIFY: NOTIFY_LEN,
+    OP_EVENT: EVENT_LEN,
+    OP_TEMPO: TEMPO_LEN,
+    OP_AFTERGLOW: AFTERGLOW_LEN,
+    OP_LATENCY: LATENCY_LEN,
+    OP_CROSSFADE: CROSSFADE_LEN,
+    OP_PROGRAM_LOAD: PROGRAM_LOAD_LEN,
+    OP_PROGRAM_RUN: PROGRAM_RUN_LEN,
+    OP_PROGRAM_STATUS: PROGRAM_STATUS_LEN,
+    OP_GET_HASHES: GET_HASHES_LEN,
+    OP_HASHES: HASHES_LEN,
+    OP_STREAM_FRAME: STREAM_FRAME_LEN,
+    OP_BANDS: BANDS_LEN,
+    OP_GET_TELEMETRY: GET_TELEMETRY_LEN,
+    OP_TELEMETRY: TELEMETRY_LEN,
+}
+
+_decoders = {
+    OP_DRONE_OFF: decode_drone_off,
+    OP_DRONE_ON: decode_drone_on,
+    OP_NOTE: decode_note,
+    OP_MIDI_NOTE: decode_midi_note,
+    OP_CHORD: decode_chord,
+    OP_ACK: decode_ack,
+    OP_NOTIFY: decode_notify,
+    OP_EVENT: decode_event,
+    OP_TEMPO: decode_tempo,
+    OP_AFTERGLOW: decode_afterglow,
+    OP_LATENCY: decode_latency,
+    OP_CROSSFADE: decode_crossfade,
+    OP_PROGRAM_LOAD: decode_program_load,
+    OP_PROGRAM_RUN: decode_program_run,
+    OP_PROGRAM_STATUS: decode_program_status,
+    OP_GET_HASHES: decode_get_hashes,
+    OP_HASHES: decode_hashes,
+    OP_STREAM_FRAME: decode_stream_frame,
+    OP_BANDS: decode_bands,
+    OP_GET_TELEMETRY: decode_get_telemetry,
+    OP_TELEMETRY: decode_telemetry,
+}
+
+
+def frame_len(op):
+    """Returns the length of a frame with opcode `op`, or 0 if
+    `op` is unknown."""
+    return FRAME_LEN.get(op, 0)
+
+
+def decode(frame, offset=0):
+    """Decodes the frame at `offset`, whatever its opcode."""
+    try:
+        decoder = _decoders[frame[offset + 1]]
+    except (KeyError, IndexError):
+        raise ProtocolError("Unknown opcode.") from None
+    return decoder(frame, offset)
+
+
+###############################################################################
+#   Test: golden vectors shared with `_protocol.h`, followed by encode/
+#         decode benchmarks.
+###############################################################################
+if __name__ == '__main__':
+    from time import perf_counter
+
+    VECTORS = (
+        ("drone_off", (),
+         b'%0\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("drone_off", (),
+         b'%0\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("drone_off", (),
+         b'%0\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("drone_on", (),
+         b'%1\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("drone_on", (),
+         b'%1\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("drone_on", (),
+         b'%1\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("note", (0, 0,),
+         b'%2\x000\x00\x00\x00\x00\x00\x00&'),
+        ("note", (255, 9999999,),
+         b'%2\xff9999999&'),
+        ("note", (63, 7154295,),
+         b'%2?7154295&'),
+        ("midi_note", (0, 0, 0, 0,),
+         b'%M\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("midi_note", (255, 255, 4294967295, 65535,),
+         b'%M\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("midi_note", (145, 218, 4170321230, 19269,),
+         b'%M\x91\xdaN\r\x92\xf8EK&'),
+        ("chord",
+         (0, (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), (0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0),),
+         b'%C\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("chord",
+         (255, (255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255),
+         (4294967295, 4294967295, 4294967295, 4294967295, 4294967295,
+         4294967295, 4294967295, 4294967295, 4294967295, 4294967295,
+         4294967295, 4294967295),),
+         b'%C\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("chord",
+         (117, (50, 148, 17, 42, 56, 85, 37, 111, 169, 88, 68, 76),
+         (3568905991, 4215594277, 429624460, 1832927087, 3624860731, 844904724,
+         930534126, 808767788, 3019508304, 2567499988, 3320043513,
+         1910979709),),
+         b'%Cu2\x94\x11*8U%o\xa9XDL\x07'
+         b'/\xb9\xd4%\xddD\xfb\x8c\x8c\x9b\x19o?@m;'
+         b'\xfc\x0e\xd8\x149\\2\xee\xd2v7,\xd140P'
+         b'\n\xfa\xb3\xd4\xf0\x08\x99\xf9\xd7\xe3\xc5}<\xe7q&'),
+        ("ack", (0, 0, 0, 0,),
+         b'%K\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("ack", (65535, 4294967295, 4294967295, 65535,),
+         b'%K\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("ack", (54771, 3123400791, 3945238891, 9726,),
+         b"%K\xf3\xd5WP+\xbak\x91'\xeb\xfe%&"),
+        ("notify", (0,),
+         b'%N\x00&'),
+        ("notify", (255,),
+         b'%N\xff&'),
+        ("notify", (141,),
+         b'%N\x8d&'),
+        ("event", (0, 0, 0,),
+         b'%E\x00\x00\x00\x00\x00\x00\x00&'),
+        ("event", (65535, 255, 4294967295,),
+         b'%E\xff\xff\xff\xff\xff\xff\xff&'),
+        ("event", (25422, 149, 3965570862,),
+         b'%ENc\x95.\xcf]\xec&'),
+        ("tempo", (0, 0, 0, 0, 0,),
+         b'%B\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("tempo", (4294967295, 4294967295, 255, 255, 255,),
+         b'%B\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("tempo", (2433984859, 1657942832, 168, 175, 81,),
+         b'%B[\xa9\x13\x9103\xd2b\xa8\xafQ&'),
+        ("afterglow",
+         ((0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0),),
+         b'%G\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00&'),
+        ("afterglow",
+         ((255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255),),
+         b'%G\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff&'),
+        ("afterglow",
+         ((89, 77, 74, 143, 129, 18, 57, 205, 181, 33, 108, 221, 222, 210, 193,
+         25, 54, 67, 7, 233, 115),),
+         b'%GYMJ\x8f\x81\x129\xcd\xb5!l\xdd\xde\xd2'
+         b'\xc1\x196C\x07\xe9s&'),
+        ("latency", (-2147483648,),
+         b'%L\x00\x00\x00\x80&'),
+        ("latency", (2147483647,),
+         b'%L\xff\xff\xff\x7f&'),
+        ("latency", (2035918470,),
+         b'%L\x86\xa6Yy&'),
+        ("crossfade", (0,),
+         b'%X\x00\x00\x00\x00&'),
+        ("crossfade", (4294967295,),
+         b'%X\xff\xff\xff\xff&'),
+        ("crossfade", (3462374061,),
+         b'%X\xad\xa2_\xce&'),
+        ("program_load",
+         (0, (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0),),
+         b'%P\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00&'),
+        ("program_load",
+         (65535, (255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255),),
+         b'%P\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff&'),
+        ("program_load",
+         (52373, (213, 129, 86, 234, 235, 211, 1, 187, 248, 82, 198, 99, 168,
+         160, 106, 106, 223, 223, 249, 166, 2, 163, 203, 53, 221, 153, 31, 183,
+         173, 143, 130, 31, 79, 209, 106, 135, 113, 180, 251, 156, 210, 159,
+         35, 241, 177, 27, 77, 6, 157, 93, 160, 229, 246, 197, 158, 161, 198,
+         68, 176, 89, 184, 250, 223, 185),),
+         b'%P\x95\xcc\xd5\x81V\xea\xeb\xd3\x01\xbb\xf8R\xc6c'
+         b'\xa8\xa0jj\xdf\xdf\xf9\xa6\x02\xa3\xcb5\xdd\x99\x1f\xb7'
+         b'\xad\x8f\x82\x1fO\xd1j\x87q\xb4\xfb\x9c\xd2\x9f#\xf1'
+         b'\xb1\x1bM\x06\x9d]\xa0\xe5\xf6\xc5\x9e\xa1\xc6D\xb0Y'
+         b'\xb8\xfa\xdf\xb9&'),
+        ("program_run", (0, 0, 0,),
+         b'%R\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("program_run", (65535, 4294967295, 4294967295,),
+         b'%R\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("program_run", (22428, 3904768793, 3273794331,),
+         b'%R\x9cW\x19\x0b\xbe\xe8\x1b#"\xc3&'),
+        ("program_status", (0, 0,),
+         b'%p\x00\x00\x00&'),
+        ("program_status", (255, 65535,),
+         b'%p\xff\xff\xff&'),
+        ("program_status", (185, 55461,),
+         b'%p\xb9\xa5\xd8&'),
+        ("get_hashes", (),
+         b'%H&'),
+        ("get_hashes", (),
+         b'%H&'),
+        ("get_hashes", (),
+         b'%H&'),
+        ("hashes", (0, (0, 0, 0, 0, 0, 0, 0, 0), (0, 0, 0, 0, 0, 0, 0, 0),),
+         b'%h\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00&'),
+        ("hashes",
+         (4294967295, (4294967295, 4294967295, 4294967295, 4294967295,
+         4294967295, 4294967295, 4294967295, 4294967295), (4294967295,
+         4294967295, 4294967295, 4294967295, 4294967295, 4294967295,
+         4294967295, 4294967295),),
+         b'%h\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff&'),
+        ("hashes",
+         (260742815, (3081974668, 3526391134, 3196321594, 1866009039,
+         544349806, 3714333949, 430693635, 2700064375), (2193792296,
+         3631511692, 4115802698, 739868267, 2298775246, 2981687357, 2859776188,
+         1429224582),),
+         b'%h\x9f\x9e\x8a\x0f\x8c3\xb3\xb7^u0\xd2:\xff'
+         b'\x83\xbe\xcf\t9on\x1er \xfd<d\xdd\x03\xdd'
+         b'\xab\x19w\xb6\xef\xa0(\x9d\xc2\x82\x8cxt\xd8J*'
+         b'R\xf5k~\x19,\xce\x86\x04\x89=\xf0\xb8\xb1\xbc\xb8'
+         b't\xaa\x86<0U&'),
+        ("stream_frame",
+         ((0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0),),
+         b'%F\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("stream_frame",
+         ((255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255),),
+         b'%F\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("stream_frame",
+         ((168, 127, 204, 159, 23, 106, 202, 10, 54, 210, 45, 230, 69, 204,
+         238, 194, 225, 82, 239, 173, 212, 194, 110, 121, 146, 247, 242, 166,
+         228, 223, 198, 115, 236, 217, 164, 9, 69, 230, 5, 148, 134, 38, 139,
+         252, 191, 163, 158, 202, 46, 64, 158, 3, 99, 189, 60, 123, 138, 183,
+         112, 188, 32, 105, 176, 165, 101, 206, 73, 70, 131, 138, 110, 101, 41,
+         34, 102, 80, 210, 75, 49, 101, 69, 161, 146, 218, 28, 36, 36, 223,
+         186, 62, 159, 254, 234, 110, 149, 252, 209, 230, 205, 49, 246, 211,
+         171, 131, 137, 42, 72, 193, 15, 89, 142, 199, 80, 232, 60, 191, 172,
+         0, 24, 156, 129, 143, 41, 125, 223, 50, 160, 65, 253, 159, 139, 209,
+         176, 32, 98, 5, 24, 104, 15, 209, 219, 68, 187, 185, 94, 49, 160, 210,
+         99, 217, 8, 193, 50, 213, 241, 220, 137, 172, 154, 228, 28, 109, 151,
+         212, 226, 131, 37, 204, 194, 2, 176, 131, 43, 73, 32, 32, 5, 58, 167,
+         32, 16, 34, 228, 169, 179, 64, 208, 154, 21, 48, 94, 122, 194, 107,
+         118, 225, 228, 159, 17, 45, 219, 134, 1, 148, 204, 118, 197, 79, 212,
+         31, 218, 121, 225, 72, 114, 64, 136, 166, 248, 176, 57, 5, 35, 204,
+         166, 16, 15, 21, 176, 113, 83, 153, 44, 201, 218, 194, 142, 129, 206,
+         167, 31, 222, 81, 234, 161, 240, 224, 230, 244, 217, 154, 8, 160, 39,
+         83, 151, 84, 51, 240, 29, 55, 194, 16, 79),),
+         b'%F\xa8\x7f\xcc\x9f\x17j\xca\n6\xd2-\xe6E\xcc'
+         b'\xee\xc2\xe1R\xef\xad\xd4\xc2ny\x92\xf7\xf2\xa6\xe4\xdf'
+         b'\xc6s\xec\xd9\xa4\tE\xe6\x05\x94\x86&\x8b\xfc\xbf\xa3'
+         b'\x9e\xca.@\x9e\x03c\xbd<{\x8a\xb7p\xbc i'
+         b'\xb0\xa5e\xceIF\x83\x8ane)"fP\xd2K'
+         b'1eE\xa1\x92\xda\x1c$$\xdf\xba>\x9f\xfe\xean'
+         b'\x95\xfc\xd1\xe6\xcd1\xf6\xd3\xab\x83\x89*H\xc1\x0fY'
+         b'\x8e\xc7P\xe8<\xbf\xac\x00\x18\x9c\x81\x8f)}\xdf2'
+         b'\xa0A\xfd\x9f\x8b\xd1\xb0 b\x05\x18h\x0f\xd1\xdbD'
+         b'\xbb\xb9^1\xa0\xd2c\xd9\x08\xc12\xd5\xf1\xdc\x89\xac'
+         b'\x9a\xe4\x1cm\x97\xd4\xe2\x83%\xcc\xc2\x02\xb0\x83+I'
+         b'  \x05:\xa7 \x10"\xe4\xa9\xb3@\xd0\x9a\x150'
+         b'^z\xc2kv\xe1\xe4\x9f\x11-\xdb\x86\x01\x94\xccv'
+         b'\xc5O\xd4\x1f\xday\xe1Hr@\x88\xa6\xf8\xb09\x05'
+         b'#\xcc\xa6\x10\x0f\x15\xb0qS\x99,\xc9\xda\xc2\x8e\x81'
+         b"\xce\xa7\x1f\xdeQ\xea\xa1\xf0\xe0\xe6\xf4\xd9\x9a\x08\xa0'"
+         b'S\x97T3\xf0\x1d7\xc2\x10O&'),
+        ("bands", ((0, 0, 0, 0), 0,),
+         b'%A\x00\x00\x00\x00\x00&'),
+        ("bands", ((255, 255, 255, 255), 255,),
+         b'%A\xff\xff\xff\xff\xff&'),
+        ("bands", ((101, 238, 135, 96), 198,),
+         b'%Ae\xee\x87`\xc6&'),
+        ("get_telemetry", (),
+         b'%T&'),
+        ("get_telemetry", (),
+         b'%T&'),
+        ("get_telemetry", (),
+         b'%T&'),
+        ("telemetry", (0, 0, 0, 0, 0, 0, 0,),
+         b'%t\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+         b'\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00&'),
+        ("telemetry",
+         (4294967295, 4294967295, 4294967295, 4294967295, 4294967295,
+         4294967295, 4294967295,),
+         b'%t\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff'
+         b'\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff&'),
+        ("telemetry",
+         (2579360741, 2421868474, 3853261111, 1530356144, 4216193760,
+         1505992426, 1325409325,),
+         b'%t\xe5\xeb\xbd\x99\xba\xc7Z\x907\x19\xac\xe5\xb0a'
+         b'7[\xe0\x02N\xfb\xea\x9e\xc3Y-$\x00O&'),
+    )
+
+    failures = 0
+    for name, values, frame in VECTORS:
+        encode = globals()["encode_" + name]
+        got = tuple(tuple(v) if isinstance(v, bytes) else v
+                    for v in decode(frame))
+        if got != values or encode(*values) != frame:
+            print(f"FAIL: {name} {values}")
+            failures += 1
+    print(f"{len(VECTORS) - failures}/{len(VECTORS)} vectors passed.")
+
+    n = 100_000
+    buf = bytearray(MAX_FRAME)
+    for name, values, frame in VECTORS[2::3]:
+        encode_into = globals()["encode_" + name + "_into"]
+        decoder = globals()["decode_" + name]
+        start = perf_counter()
+        for _ in range(n):
+            encode_into(buf, 0, *values)
+        t_enc = (perf_counter() - start) / n
+        start = perf_counter()
+        for _ in range(n):
+            decoder(frame)
+        t_dec = (perf_counter() - start) / n
+        print(f"{name:<16} encode {t_enc * 1e9:7.0f} ns   "
+              f"decode {t_dec * 1e9:7.0f} ns")
+
+    raise SystemExit(1 if failures else 0)
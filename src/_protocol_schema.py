@@ -0,0 +1,417 @@
+###############################################################################
+#   Serial protocol schema: the single description of every message that is
+#                           exchanged between the Python program and the
+#                           program uploaded on the microcontroller.
+#
+#   `_codegen.py` reads this module and generates
+#
+#       _protocol.h : header-only, allocation-free C++ codec, included by
+#                     `_lights.cpp` (and by any native host tool);
+#       _protocol.py: the matching Python codec.
+#
+#   Named field values are listed in `CONSTANTS` and emitted into both codecs.
+#
+#   Edit this file, then run `python3 _codegen.py` to regenerate both. Do not
+#   edit the generated files by hand.
+#
+#   Framing: every message is a fixed-length frame
+#
+#       frame[0]          == SOF ('%')
+#       frame[1]          == opcode (one byte; the ASCII digits are kept for
+#                            the original messages)
+#       frame[2:-1]       == payload, laid out field by field as below
+#       frame[-1]         == EOF ('&')
+#
+#   The length of a frame is fully determined by its opcode, so a receiver
+#   knows how many bytes to expect as soon as it has seen frame[1].
+#
+#   Flow control: the microcontroller queues up to CMD_QUEUE_LEN messages and
+#   executes them in order. Every "ack" carries a credit limit, and the host
+#   never sends a message whose sequence number is not below the latest one,
+#   so the queue cannot overflow and nothing piles up in the USB buffers.
+#
+#   Field types:
+#       u8, u16, u32      : unsigned integers, little-endian.
+#       i8, i16, i32      : signed integers, two's complement, little-endian.
+#       decN              : unsigned integer written as up to N ASCII decimal
+#                           digits, padded with '\0'. Only used by the
+#                           original "note" message.
+#       padN              : N bytes set to '\0'.
+#       T[N]              : array of N elements of type T (T one of the
+#                           integer types above).
+###############################################################################
+from collections import namedtuple
+
+
+Message = namedtuple("Message", "name opcode direction doc fields")
+Field = namedtuple("Field", "name type doc")
+Constant = namedtuple("Constant", "name value doc")
+
+SOF = "%"
+EOF = "&"
+
+HOST_TO_DEVICE = "host -> device"
+DEVICE_TO_HOST = "device -> host"
+
+
+###############################################################################
+#   Messages
+###############################################################################
+MESSAGES = (
+    Message(
+        name="drone_off", opcode="0", direction=HOST_TO_DEVICE,
+        doc="Turns off the drone (and all lights).",
+        fields=(
+            Field("reserved", "pad8", "Always '\\0'."),
+        )),
+    Message(
+        name="drone_on", opcode="1", direction=HOST_TO_DEVICE,
+        doc="Turns on the drone. The drone runs until the next message.",
+        fields=(
+            Field("reserved", "pad8", "Always '\\0'."),
+        )),
+    Message(
+        name="note", opcode="2", direction=HOST_TO_DEVICE,
+        doc="Lights a random half of the panels in the color of a note.",
+        fields=(
+            Field("pitch_class", "u8",
+                  "Octave-independent note number in [0, 11]; C is 0."),
+            Field("duration_us", "dec7",
+                  "How long the lights stay on, in microseconds."),
+        )),
+    Message(
+        name="midi_note", opcode="M", direction=HOST_TO_DEVICE,
+        doc="Lights a note like \"note\", from its full MIDI note number "
+            "and velocity: the octave decides which panels are lit (low "
+            "notes on the lower panels, high notes on \"Top\") and the "
+            "velocity how brightly.",
+        fields=(
+            Field("note", "u8", "MIDI note number in [0, 127]; 60 is C4."),
+            Field("velocity", "u8",
+                  "MIDI velocity in [0, 127]. 0 lights nothing."),
+            Field("duration_us", "u32",
+                  "How long the lights stay on, in microseconds."),
+            Field("step", "u16",
+                  "Point of the quantization grid of the last \"tempo\" "
+                  "(`quantize` points per beat, counted from beat 0) at "
+                  "which the note starts, even if that point has passed, "
+                  "so that a message arriving late does not shift the "
+                  "notes after it. NO_STEP to start it as a \"note\"."),
+        )),
+    Message(
+        name="chord", opcode="C", direction=HOST_TO_DEVICE,
+        doc="Lights up to 12 notes at once, each in its own panel groups, "
+            "in a single frame. Each note goes dark after its own "
+            "duration; the chord has finished when all have.",
+        fields=(
+            Field("n_notes", "u8", "Number of notes, in [1, 12]."),
+            Field("pitch_class", "u8[12]",
+                  "Pitch class of each note, as in \"note\". Entries past "
+                  "`n_notes` are ignored."),
+            Field("duration_us", "u32[12]",
+                  "How long each note stays on, in microseconds."),
+        )),
+    Message(
+        name="ack", opcode="K", direction=DEVICE_TO_HOST,
+        doc="Response to every well-formed host -> device message, sent "
+            "when the message is taken off the command queue and executed.",
+        fields=(
+            Field("seq", "u16",
+                  "Sequence number of the accepted message. Messages are "
+                  "numbered from 0 in the order they are accepted, modulo "
+                  "2**16."),
+            Field("rx_us", "u32",
+                  "Value of micros() when the message was accepted."),
+            Field("tx_us", "u32",
+                  "Value of micros() when the message was taken off the "
+                  "queue and this ack was sent. The ack is written out by "
+                  "the end of the same pass of loop(), so this is the time "
+                  "to pair with the time the host receives it."),
+            Field("credit", "u16",
+                  "Credit limit: the host may send messages up to, but not "
+                  "including, sequence number `credit` (modulo 2**16). "
+                  "Equal to the number of messages accepted so far plus the "
+                  "number of free slots in the command queue."),
+        )),
+    Message(
+        name="notify", opcode="N", direction=HOST_TO_DEVICE,
+        doc="Enables or disables \"event\" notifications.",
+        fields=(
+            Field("enable", "u8", "1 to enable, 0 to disable."),
+        )),
+    Message(
+        name="event", opcode="E", direction=DEVICE_TO_HOST,
+        doc="Notification that the lights for a message started or finished "
+            "rendering. Sent only while enabled by \"notify\"; several are "
+            "batched into one USB packet where possible.",
+        fields=(
+            Field("seq", "u16",
+                  "Sequence number of the message, as in its \"ack\"."),
+            Field("edge", "u8", "EVENT_STARTED or EVENT_FINISHED."),
+            Field("t_us", "u32",
+                  "Value of micros() at the edge. For notes and chords, "
+                  "the scheduled time of the edge, before the \"latency\" "
+                  "offset; the event is sent at that time."),
+        )),
+    Message(
+        name="tempo", opcode="B", direction=HOST_TO_DEVICE,
+        doc="Sets the tempo of the on-device beat clock. Beat n starts "
+            "exactly beat0_us + n * 60e9 / bpm_milli microseconds; there is "
+            "no per-beat message and no accumulated rounding.",
+        fields=(
+            Field("bpm_milli", "u32",
+                  "Beats per minute times 1000 (102 BPM is 102000). 0 stops "
+                  "the clock and every effect below."),
+            Field("beat0_us", "u32",
+                  "Value of micros() at beat 0, as estimated by the host "
+                  "from the acks. May be in the past or the future."),
+            Field("beats_per_bar", "u8",
+                  "Notes starting on the first beat of a bar are accented "
+                  "(panel 11 fully lit). 0 for no accents."),
+            Field("quantize", "u8",
+                  "Note starts are moved to the nearest point of a grid of "
+                  "this many points per beat, never earlier than the note "
+                  "is taken off the queue, unless a \"midi_note\" names "
+                  "its grid point. 0 for no quantization."),
+            Field("drone_sync", "u8",
+                  "1 to start drone breaths on beats and stretch each to a "
+                  "whole number of beats."),
+        )),
+    Message(
+        name="afterglow", opcode="G", direction=HOST_TO_DEVICE,
+        doc="Configures the afterglow: instead of going dark at once, "
+            "lights fade by a per-group, per-channel factor every "
+            "AFTERGLOW_FRAME_US microseconds.",
+        fields=(
+            Field("decay", "u8[21]",
+                  "Decay factors, out of 256, for R, G and B of each panel "
+                  "group, in the order front, back, left-left, left-right, "
+                  "right-left, right-right, top. All 0 turns the afterglow "
+                  "off."),
+        )),
+    Message(
+        name="latency", opcode="L", direction=HOST_TO_DEVICE,
+        doc="Sets the latency compensation. Notes and chords are scheduled "
+            "as usual, and their \"event\" frames are sent on schedule, "
+            "but their lights go on and off `offset_us` later, so that "
+            "lights and sound (started by the host on the events) reach "
+            "the audience together. The start of drone breaths locked to "
+            "the beat is shifted by the same amount.",
+        fields=(
+            Field("offset_us", "i32",
+                  "Offset in microseconds, in [-LATENCY_MAX_US, "
+                  "LATENCY_MAX_US]. Positive delays the lights; negative "
+                  "advances them, by delaying the events instead when "
+                  "nothing is scheduled ahead."),
+        )),
+    Message(
+        name="crossfade", opcode="X", direction=HOST_TO_DEVICE,
+        doc="Configures crossfades between consecutive notes: each note "
+            "starts in the color of the previous one and glides to its own "
+            "over `duration_us`, in steps of AFTERGLOW_FRAME_US, along a "
+            "perceptual (OKLab) color ramp.",
+        fields=(
+            Field("duration_us", "u32",
+                  "Length of a crossfade, in microseconds; at most half of "
+                  "the note is spent fading. 0 turns crossfades off."),
+        )),
+    Message(
+        name="program_load", opcode="P", direction=HOST_TO_DEVICE,
+        doc="Writes a chunk of a light program (bytecode for the "
+            "microcontroller's VM, see the VM_* constants) into the program "
+            "buffer. The program is verified by the next \"program_run\".",
+        fields=(
+            Field("at", "u16",
+                  "Byte offset of the chunk in the program, a multiple of 4 "
+                  "below 4 * VM_CODE_MAX."),
+            Field("code", "u8[64]",
+                  "Up to 16 instructions of 4 bytes; bytes past the end of "
+                  "the program buffer are ignored."),
+        )),
+    Message(
+        name="program_run", opcode="R", direction=HOST_TO_DEVICE,
+        doc="Verifies the program loaded (once per load) and runs it, "
+            "replying with a \"program_status\" frame right after the ack. "
+            "A program runs until it halts or, at a wait, until the next "
+            "message.",
+        fields=(
+            Field("length", "u16", "Length of the program, in bytes."),
+            Field("crc", "u32",
+                  "CRC-32 (as computed by zlib.crc32()) of the program."),
+            Field("seed", "u32", "Seed of the program's PRNG; 0 is 1."),
+        )),
+    Message(
+        name="program_status", opcode="p", direction=DEVICE_TO_HOST,
+        doc="Result of verifying a program.",
+        fields=(
+            Field("status", "u8", "VM_OK or one of the VM_BAD_* errors."),
+            Field("pc", "u16",
+                  "Index of the offending instruction, for VM_BAD_OPCODE, "
+                  "VM_BAD_REGISTER and VM_BAD_TARGET."),
+        )),
+    Message(
+        name="get_hashes", opcode="H", direction=HOST_TO_DEVICE,
+        doc="Requests a \"hashes\" frame, sent right after the ack.",
+        fields=()),
+    Message(
+        name="hashes", opcode="h", direction=DEVICE_TO_HOST,
+        doc="CRC-32 (as computed by zlib.crc32()) of the R, G, B bytes of "
+            "the last FRAME_HASH_N frames shown, newest first.",
+        fields=(
+            Field("count", "u32",
+                  "Frames shown since power-up, modulo 2**32. Entries past "
+                  "`count` are 0."),
+            Field("crc", "u32[8]", "CRC-32 of each frame."),
+            Field("t_us", "u32[8]",
+                  "Value of micros() when each frame was shown."),
+        )),
+    Message(
+        name="stream_frame", opcode="F", direction=HOST_TO_DEVICE,
+        doc="Full frame for streaming. Not queued, sequenced or acked: "
+            "the microcontroller keeps only the latest frame received "
+            "(superseding any not yet shown) and shows it when idle.",
+        fields=(
+            Field("rgb", "u8[264]",
+                  "R, G and B of each of the 88 LEDs, in address order."),
+        )),
+    Message(
+        name="bands", opcode="A", direction=HOST_TO_DEVICE,
+        doc="Envelope levels of BANDS_N frequency bands of the audio being "
+            "played, sent by the host about every 10 ms. Not queued, "
+            "sequenced or acked, like \"stream_frame\": the newest levels "
+            "modulate the brightness of every frame shown from then on, "
+            "until BANDS_HOLD_US pass without any.",
+        fields=(
+            Field("level", "u8[4]",
+                  "Level of each band, lowest first, from 0 (silent) to 255 "
+                  "(full scale). Band 0 modulates the front and back "
+                  "groups, band 1 left-left and right-right, band 2 "
+                  "left-right and right-left, and band 3 \"Top\"."),
+            Field("depth", "u8",
+                  "Modulation depth, out of 255: a group is shown at a "
+                  "fraction 1 - depth * (1 - level / 255) / 255 of its "
+                  "brightness. 0 turns the modulation off."),
+        )),
+    Message(
+        name="get_telemetry", opcode="T", direction=HOST_TO_DEVICE,
+        doc="Requests a \"telemetry\" frame, sent right after the ack.",
+        fields=()),
+    Message(
+        name="telemetry", opcode="t", direction=DEVICE_TO_HOST,
+        doc="Streaming and refresh counters since power-up, modulo 2**32, "
+            "and the cost of the last frame.",
+        fields=(
+            Field("frames_received", "u32", "\"frame\" messages received."),
+            Field("frames_shown", "u32", "\"frame\" messages shown."),
+            Field("frames_superseded", "u32",
+                  "\"frame\" messages replaced by a newer one before being "
+                  "shown."),
+            Field("commit_cycles", "u32",
+                  "CPU cycles spent computing the last frame shown, from "
+                  "the target frame to the hand-off to the LED driver; 0 "
+                  "where there is no cycle counter."),
+            Field("shows", "u32",
+                  "Frames handed to the LED driver, keep-alives included."),
+            Field("shows_skipped", "u32",
+                  "Frames not handed to the LED driver because they were "
+                  "already on the LEDs."),
+            Field("show_us", "u32",
+                  "Microseconds spent handing frames to the LED driver."),
+        )),
+)
+
+
+###############################################################################
+#   Constants
+###############################################################################
+CONSTANTS = (
+    Constant("FRAME_HASH_N", 8,
+             "Number of frame hashes kept by the microcontroller."),
+    Constant("AFTERGLOW_FRAME_US", 10000,
+             "Period of the afterglow decay, in microseconds."),
+    Constant("NO_STEP", 0xFFFF,
+             "\"midi_note\" `step` of a note placed as a \"note\"."),
+    Constant("LATENCY_MAX_US", 500000,
+             "Largest latency offset, in microseconds."),
+    Constant("BANDS_N", 4, "Number of bands in a \"bands\" message."),
+    Constant("BANDS_HOLD_US", 250000,
+             "The \"bands\" modulation ends this many microseconds after "
+             "the last \"bands\" message."),
+    Constant("CMD_QUEUE_LEN", 8,
+             "Number of slots in the microcontroller's command queue."),
+    Constant("EVENT_STARTED", 0,
+             "\"event\" edge: the first frame of the message was shown."),
+    Constant("EVENT_FINISHED", 1,
+             "\"event\" edge: the message finished rendering (for a note, "
+             "the lights were turned off)."),
+
+    # Light programs: a VM instruction is 4 bytes, (op, a, b, c). `a`, `b`
+    # and `c` name registers r0 to r15 (32-bit, 0 when a program starts);
+    # `imm` is the 16-bit immediate b | c << 8. Jump targets are instruction
+    # indices; jumping to the end of the program halts.
+    Constant("VM_CODE_MAX", 256, "Largest program, in instructions."),
+    Constant("VM_REGS", 16, "Number of registers."),
+    Constant("VM_BUDGET", 4096,
+             "Most instructions run between two waits; a program that runs "
+             "more is stopped."),
+    Constant("VM_OK", 0, "\"program_status\": the program runs."),
+    Constant("VM_BAD_LENGTH", 1,
+             "\"program_status\": empty, too long, or not a whole number "
+             "of instructions."),
+    Constant("VM_BAD_CRC", 2,
+             "\"program_status\": the program loaded does not match the "
+             "CRC."),
+    Constant("VM_BAD_OPCODE", 3, "\"program_status\": unknown opcode."),
+    Constant("VM_BAD_REGISTER", 4,
+             "\"program_status\": register operand above r15."),
+    Constant("VM_BAD_TARGET", 5,
+             "\"program_status\": jump past the end of the program."),
+    Constant("VM_HALT", 0, "halt: ends the program."),
+    Constant("VM_LDI", 1, "ldi a, imm: a = imm."),
+    Constant("VM_LDHI", 2, "ldhi a, imm: bits 16-31 of a = imm."),
+    Constant("VM_MOV", 3, "mov a, b: a = b."),
+    Constant("VM_ADD", 4, "add a, b, c: a = b + c."),
+    Constant("VM_SUB", 5, "sub a, b, c: a = b - c."),
+    Constant("VM_MUL", 6, "mul a, b, c: a = b * c."),
+    Constant("VM_AND", 7, "and a, b, c: a = b & c."),
+    Constant("VM_OR", 8, "or a, b, c: a = b | c."),
+    Constant("VM_XOR", 9, "xor a, b, c: a = b ^ c."),
+    Constant("VM_SHL", 10, "shl a, b, c: a = b << (c & 31)."),
+    Constant("VM_SHR", 11, "shr a, b, c: a = b >> (c & 31)."),
+    Constant("VM_MOD", 12, "mod a, b, c: a = b % c, or 0 if c is 0."),
+    Constant("VM_ADDI", 13, "addi a, imm: a += imm, sign-extended."),
+    Constant("VM_LT", 14, "lt a, b, c: a = (b < c), unsigned."),
+    Constant("VM_EQ", 15, "eq a, b, c: a = (b == c)."),
+    Constant("VM_JMP", 16, "jmp imm: jumps to instruction imm."),
+    Constant("VM_JZ", 17, "jz a, imm: jumps to imm if a is 0."),
+    Constant("VM_JNZ", 18, "jnz a, imm: jumps to imm if a is not 0."),
+    Constant("VM_DJNZ", 19,
+             "djnz a, imm: decrements a, then jumps to imm if it is not 0."),
+    Constant("VM_RAND", 20,
+             "rand a, b: a = a random number below b (any, if b is 0)."),
+    Constant("VM_CLEAR", 21, "clear: turns every LED of the frame off."),
+    Constant("VM_PIXEL", 22, "pixel a, b: LED a % 88 = color b."),
+    Constant("VM_PANELS", 23,
+             "panels a, b: the LEDs of the panels in mask a (bit 0 for P1) "
+             "= color b."),
+    Constant("VM_GROUPS", 24,
+             "groups a, b: the LEDs of the groups in mask a (bit 0 for the "
+             "front, then back, LL, LR, RL, RR and Top) = color b."),
+    Constant("VM_NOTE", 25, "note a, b: a = color of pitch class b % 12."),
+    Constant("VM_SCALE", 26,
+             "scale a, b, c: a = color b at brightness c / 256 (c at most "
+             "256)."),
+    Constant("VM_BLEND", 27,
+             "blend a, b, c: a = color a moved c / 256 of the way to color "
+             "b (c at most 256)."),
+    Constant("VM_SHOW", 28, "show: shows the frame."),
+    Constant("VM_WAIT", 29,
+             "wait a: yields until a microseconds after the previous "
+             "wait ended."),
+    Constant("VM_BEAT", 30,
+             "beat a: yields until the next point of a grid of a points per "
+             "beat of the tempo clock, or for AFTERGLOW_FRAME_US if it is "
+             "stopped."),
+    Constant("VM_TIME", 31,
+             "time a: a = microseconds since the program started."),
+)
@@ -0,0 +1,254 @@
+###############################################################################
+#   Offline renderer: rasterizes frame logs into preview video of the Ark's
+#                     11 panels, laid out as in the diagram at the top of
+#                     `_lights.cpp`:
+#
+#                                        P11
+#                               P9       P8       P7
+#                       P10                                P6
+#                       P1                                 P5
+#                               P2       P3       P4
+#
+#                     Each panel is drawn as 2 rows of 4 LEDs, each LED a
+#                     soft glow in its color.
+#
+#   Frame logs: a frame log is a file of fixed-size records, one per frame
+#               shown: the time at which it was shown, in seconds (f64),
+#               followed by the R, G and B of each of the 88 LEDs in address
+#               order (the payload of a "stream_frame" message). Logs can be
+#               captured with `FrameLog` (e.g. alongside `Link.send_frame()`)
+#               or simulated from a random composition with `simulate`.
+#
+#   Rendering: video frames are sampled at a fixed rate; each shows the
+#              latest logged frame at its time. Consecutive video frames
+#              showing the same logged frame are rasterized once. Every
+#              panel's glow is precomputed as an (8, pixels) weight matrix,
+#              so rasterizing a panel is one float32 matrix product (BLAS,
+#              vectorized) of its 8 colors with the weights, which is also
+#              where overlapping glows blend. Rasterization runs on a pool of
+#              threads pulling frames from a shared queue (numpy releases
+#              the GIL in the products), with a bounded number in flight, and
+#              the frames are streamed in order as raw rgb24, ready for an
+#              encoder:
+#
+#                  ffmpeg -f rawvideo -pix_fmt rgb24 -s 640x360 -r 30 \
+#                         -i out.rgb out.mp4
+#
+#   Usage: python3 _render.py simulate LOG [--seed SEED] [--bpm BPM]
+#          python3 _render.py render LOG [-o OUT] [--fps FPS]
+#                                        [--size WxH] [-j THREADS]
+###############################################################################
+import argparse
+import os
+import struct
+import sys
+
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+from time import perf_counter
+
+import numpy as np
+
+
+###############################################################################
+#   Frame logs
+###############################################################################
+N_LEDS = 88
+FRAME_BYTES = 3 * N_LEDS
+RECORD = struct.Struct(f"<d{FRAME_BYTES}s")
+
+
+class FrameLog:
+    """Appends frames to a frame log."""
+    def __init__(self, path):
+        self.fp = open(path, "wb")
+
+    def write(self, t, rgb):
+        """Records that the frame `rgb` (264 bytes) was shown at time `t`,
+        in seconds."""
+        self.fp.write(RECORD.pack(t, bytes(rgb)))
+
+    def close(self):
+        self.fp.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def read_log(path):
+    """Returns `(times, frames)`: the times of the frames of a frame log,
+    relative to the first, and the frames, as an (n, 88, 3) uint8 array."""
+    data = np.fromfile(path, dtype=np.dtype([("t", "<f8"),
+                                             ("rgb", "u1", FRAME_BYTES)]))
+    if not len(data):
+        raise ValueError(f"{path}: empty frame log.")
+    times = data["t"] - data["t"][0]
+    return times, data["rgb"].reshape(-1, N_LEDS, 3)
+
+
+def simulate(path, seed=0, bpm=102):
+    """Writes the frame log of a random composition at `bpm`: one frame per
+    note, laid out as by the microcontroller (see `_loadsim.py`), and a
+    black frame at the end. Returns the length of the composition, in
+    seconds."""
+    import _loadsim as sim
+
+    rng = np.random.default_rng(seed)
+    pitch_classes = sim.gen_pitch_classes(rng, 1)
+    notes = sim.gen_notes(rng, pitch_classes).ravel()
+    durations = sim.gen_durations(rng, 1).ravel()
+    starts = np.cumsum(durations) - durations
+    lit = sim.layout(rng, notes, starts % sim.SIXTHS_PER_BAR == 0)
+
+    level = sim.velocity_level(sim.VELOCITY)
+    colors = np.array([((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF)
+                       for c in sim.COLORS]) * level >> 8
+    seconds = 10 / bpm      # Sixth of a beat.
+    with FrameLog(path) as log:
+        for start, pc, mask in zip(starts, pitch_classes.ravel(), lit):
+            frame = np.zeros((N_LEDS, 3), dtype=np.uint8)
+            frame[mask] = colors[pc]
+            log.write(start * seconds, frame.tobytes())
+        end = (starts[-1] + durations[-1]) * seconds
+        log.write(end, bytes(FRAME_BYTES))
+    return end
+
+
+###############################################################################
+#   Raster class: precomputed geometry of the panels at a given size.
+###############################################################################
+# Panel: (first LED address, column, row) on a 5 x 5 grid of cells.
+PANELS = (
+    (80, 2, 0),                                 # P11
+    (64, 1, 1), (56, 2, 1), (48, 3, 1),         # P9, P8, P7
+    (72, 0, 2), (40, 4, 2),                     # P10, P6
+    (0, 0, 3), (32, 4, 3),                      # P1, P5
+    (8, 1, 4), (16, 2, 4), (24, 3, 4),          # P2, P3, P4
+)
+
+
+class Raster:
+    glow = 0.22         # Radius of a glow, relative to the LED spacing.
+    panel_rgb = (18, 18, 22)    # Unlit panel.
+
+    def __init__(self, width, height):
+        self.width = width
+        self.height = height
+        self.cw = width // 5    # Cell size.
+        self.ch = height // 5
+
+        # Weights of the 8 LEDs of a panel over the pixels of its cell.
+        pitch = min(self.cw / 4, self.ch / 2)
+        x0 = (self.cw - 4 * pitch) / 2 + pitch / 2
+        y0 = (self.ch - 2 * pitch) / 2 + pitch / 2
+        yy, xx = np.mgrid[0:self.ch, 0:self.cw].astype(np.float32)
+        weights = []
+        for j in range(8):
+            cx = x0 + (j % 4) * pitch
+            cy = y0 + (j // 4) * pitch
+            d2 = ((xx - cx) ** 2 + (yy - cy) ** 2) / (self.glow * pitch) ** 2
+            weights.append(np.exp(-d2 / 2))
+        self.weights = np.array(weights, dtype=np.float32).reshape(8, -1)
+
+        # Background: unlit panels on black.
+        self.background = np.zeros((height, width, 3), dtype=np.float32)
+        inset = pitch / 8
+        for _, col, row in PANELS:
+            y, x = row * self.ch, col * self.cw
+            self.background[
+                int(y + y0 - pitch / 2 + inset):
+                int(y + y0 + 1.5 * pitch - inset),
+                int(x + x0 - pitch / 2 + inset):
+                int(x + x0 + 3.5 * pitch - inset)] = self.panel_rgb
+
+    def render(self, frame):
+        """Returns the rgb24 bytes of the video frame showing `frame`, an
+        (88, 3) array of LED colors."""
+        image = self.background.copy()
+        colors = frame.astype(np.float32)
+        for base, col, row in PANELS:
+            if not colors[base:base + 8].any():
+                continue
+            glow = colors[base:base + 8].T @ self.weights
+            y, x = row * self.ch, col * self.cw
+            image[y:y + self.ch, x:x + self.cw] += \
+                glow.T.reshape(self.ch, self.cw, 3)
+        np.clip(image, 0, 255, out=image)
+        return image.astype(np.uint8).tobytes()
+
+
+###############################################################################
+#   Rendering
+###############################################################################
+def render(times, frames, out, fps=30, size=(640, 360), threads=None):
+    """Writes the video of the frame log `(times, frames)` to the binary
+    file `out` as raw rgb24. Returns the number of video frames."""
+    raster = Raster(*size)
+    threads = threads or os.cpu_count()
+    n_video = int(times[-1] * fps) + 1
+    shown = np.searchsorted(times, np.arange(n_video) / fps, side="right") - 1
+
+    # Runs of video frames showing the same logged frame.
+    starts = np.flatnonzero(np.diff(shown, prepend=-2))
+    counts = np.diff(starts, append=n_video)
+
+    with ThreadPoolExecutor(threads) as pool:
+        pending = deque()
+        for start, count in zip(starts, counts):
+            pending.append((pool.submit(raster.render, frames[shown[start]]),
+                            count))
+            if len(pending) >= 4 * threads:
+                future, count = pending.popleft()
+                out.write(future.result() * int(count))
+        while pending:
+            future, count = pending.popleft()
+            out.write(future.result() * int(count))
+    return n_video
+
+
+###############################################################################
+#   Main
+###############################################################################
+def main(argv):
+    parser = argparse.ArgumentParser(description="Offline renderer.")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("simulate", help="Simulate a composition's frame log.")
+    p.add_argument("log")
+    p.add_argument("--seed", type=int, default=0)
+    p.add_argument("--bpm", type=float, default=102)
+    p = sub.add_parser("render", help="Render a frame log to raw rgb24.")
+    p.add_argument("log")
+    p.add_argument("-o", "--out", default="-",
+                   help="Output file, or - for standard output.")
+    p.add_argument("--fps", type=int, default=30)
+    p.add_argument("--size", default="640x360")
+    p.add_argument("-j", "--threads", type=int, default=os.cpu_count())
+    args = parser.parse_args(argv)
+
+    if args.command == "simulate":
+        length = simulate(args.log, args.seed, args.bpm)
+        print(f"{args.log}: {length:.1f} s.", file=sys.stderr)
+        return 0
+
+    width, height = map(int, args.size.split("x"))
+    times, frames = read_log(args.log)
+    start = perf_counter()
+    if args.out == "-":
+        n = render(times, frames, sys.stdout.buffer, args.fps,
+                   (width, height), args.threads)
+    else:
+        with open(args.out, "wb") as out:
+            n = render(times, frames, out, args.fps, (width, height),
+                       args.threads)
+    elapsed = perf_counter() - start
+    print(f"{n} frames of {width}x{height} at {args.fps} fps "
+          f"({times[-1]:.1f} s) rendered in {elapsed:.2f} s.",
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -1,8 +1,180 @@
 ###############################################################################
 #   Imports
 ###############################################################################
+import threading
+
 from time import perf_counter
 
+from _clock import clock
+
+
+###############################################################################
+#   Timer class: an entry in a `TimerWheel`.
+###############################################################################
+class Timer:
+    __slots__ = ("deadline", "item", "level", "slot")
+
+    def __init__(self, deadline, item):
+        self.deadline = deadline
+        self.item = item
+        self.level = None   # Position in the wheel; None once expired or
+        self.slot = None    # cancelled.
+
+
+###############################################################################
+#   TimerWheel class: hierarchical timing wheel with `n_levels` levels of
+#                     2**`bits` slots each. Time is divided into ticks of
+#                     `tick` seconds.
+#
+#                     A timer due during tick `due` is stored at the lowest level
+#                     L such that `due` and the current tick agree on every
+#                     bit above the lowest `bits * (L + 1)` bits, in slot
+#                     `(due >> (bits * L)) & mask`. Every timer at level 0 is
+#                     therefore due before every timer at level 1, and so on.
+#                     Whenever the current tick crosses a slot boundary of
+#                     level L, the timers in the next slot of level L + 1 are
+#                     moved down ("cascaded").
+#
+#                     `insert()` and `cancel()` are O(1). `advance()` is O(1)
+#                     per expired or cascaded timer, and skips over empty
+#                     stretches of time a whole slot of the lowest non-empty
+#                     level at a time. Deadlines further away than the wheel
+#                     spans (2**(bits * n_levels) ticks, about 46 hours with
+#                     the defaults) are parked in the top level and re-placed
+#                     when they are cascaded.
+###############################################################################
+class TimerWheel:
+    def __init__(self, tick=0.01, bits=6, n_levels=4, start=0.0):
+        self.tick = tick
+        self.bits = bits
+        self.mask = (1 << bits) - 1
+        self.n_levels = n_levels
+        self.wheels = [[{} for _ in range(1 << bits)]
+                       for _ in range(n_levels)]
+        self.counts = [0] * n_levels
+        self.current = int(start / tick)
+        # Farthest tick a timer can be placed at without aliasing a slot of
+        # the top level that is about to be cascaded.
+        self.span = (1 << (bits * n_levels)) - (1 << (bits * (n_levels - 1)))
+
+    def __len__(self):
+        return sum(self.counts)
+
+    def insert(self, deadline, item):
+        """Schedules `item` to expire at time `deadline`. Returns a `Timer`
+        that can be passed to `cancel()`."""
+        timer = Timer(deadline, item)
+        self._place(timer)
+        return timer
+
+    def cancel(self, timer):
+        if timer.level is not None:
+            del self.wheels[timer.level][timer.slot][timer]
+            self.counts[timer.level] -= 1
+            timer.level = timer.slot = None
+
+    def _place(self, timer):
+        due = max(int(timer.deadline / self.tick), self.current)
+        due = min(due, self.current + self.span)
+        level = 0
+        while level < self.n_levels - 1 and \
+                (due >> (self.bits * (level + 1))) != \
+                (self.current >> (self.bits * (level + 1))):
+            level += 1
+        slot = (due >> (self.bits * level)) & self.mask
+        self.wheels[level][slot][timer] = None
+        self.counts[level] += 1
+        timer.level, timer.slot = level, slot
+
+    def _cascade(self):
+        """Called when `current` has just crossed a level-0 slot boundary."""
+        levels = [1]
+        while levels[-1] < self.n_levels - 1 and \
+                (self.current >> (self.bits * levels[-1])) & self.mask == 0:
+            levels.append(levels[-1] + 1)
+        for level in reversed(levels):
+            idx = (self.current >> (self.bits * level)) & self.mask
+            slot = self.wheels[level][idx]
+            if slot:
+                self.wheels[level][idx] = {}
+                self.counts[level] -= len(slot)
+                for timer in slot:
+                    self._place(timer)
+
+    def advance(self, now):
+        """Moves the wheel to time `now`. Returns the expired timers (every
+        timer whose deadline is at most `now`), earliest first."""
+        target = int(now / self.tick)
+        expired = []
+        while True:
+            idx = self.current & self.mask
+            slot = self.wheels[0][idx]
+            if slot:
+                self.wheels[0][idx] = {}
+                self.counts[0] -= len(slot)
+                due = []
+                for timer in slot:
+                    if timer.deadline <= now:
+                        timer.level = timer.slot = None
+                        due.append(timer)
+                    else:
+                        # Due later within the current tick.
+                        self._place(timer)
+                expired.extend(sorted(due, key=lambda t: t.deadline))
+            if self.current >= target:
+                break
+
+            # Skip to the next slot boundary of the lowest non-empty level.
+            level = next((i for i, c in enumerate(self.counts) if c), None)
+            if level is None:
+                self.current = target
+                break
+            step = self.current | ((1 << (self.bits * level)) - 1)
+            self.current = min(target, step + 1)
+            if self.current & self.mask == 0:
+                self._cascade()
+        return expired
+
+    def next_deadline(self):
+        """Returns the earliest deadline in the wheel, or None if it is
+        empty."""
+        for level, count in enumerate(self.counts):
+            if not count:
+                continue
+            if level == self.n_levels - 1:
+                # The top level also holds parked timers, whose slots do not
+                # reflect their deadlines.
+                return min(t.deadline for slot in self.wheels[level]
+                           for t in slot)
+            start = (self.current >> (self.bits * level)) & self.mask
+            if level:
+                start += 1
+            for i in range(self.mask + 1):
+                slot = self.wheels[level][(start + i) & self.mask]
+                if slot:
+                    return min(t.deadline for t in slot)
+        return None
+
+
+###############################################################################
+#   Deadline class: marks a predicate-style job whose state can say when it
+#                   will next be due. `fn()` returns that time, in the
+#                   scheduler's clock units. The job is re-armed at the new
+#                   deadline whenever it is reached, so it only fires once
+#                   `fn()` is actually in the past; for example
+#
+#                       Deadline(partial(Composition.idle_deadline, 300))
+#
+#                   fires 300 seconds after the last composition, however
+#                   often compositions are played in between.
+###############################################################################
+class Deadline:
+    def __init__(self, fn):
+        self.fn = fn
+
+    def __call__(self):
+        return self.fn()
+
 
 ###############################################################################
 #   Scheduler Class
@@ -11,45 +183,125 @@ class Scheduler:
     """
     Simple utility to schedule jobs periodically.
 
-    Appropriate for synchronous code where high precision is not needed.
+    Every entry of `every` is one of:
+        - a number of seconds: the job is periodic;
+        - a `Deadline`: the job fires once its deadline has passed;
+        - any other callable predicate: the job fires when the predicate
+          returns True. Plain predicates cannot say when they will become
+          true, so they are evaluated every `poll` seconds and whenever
+          `notify()` is called.
+
+    Jobs are kept in a `TimerWheel`, so `check()` only touches jobs that are
+    due. `sleep()` blocks (without polling) until the next job is due, the
+    requested time has elapsed, or `notify()` is called from any thread.
+
+    Time is read from `clock` (see `_clock.py`), the real clock unless
+    another is given.
     """
-    timer = perf_counter
+    clock = clock
+    tick = 0.01     # Resolution of the timer wheel, in seconds.
+    poll = 1.0      # Evaluation period of plain predicates, in seconds.
 
-    def __init__(self, *, every, callbacks, args, debug=False):
+    def __init__(self, *, every, callbacks, args, debug=False, clock=None):
         self.every = every
         self.callbacks = callbacks
         self.args = args
         self.debug = debug
+        if clock is not None:
+            self.clock = clock
 
-        ctime = self.timer()
+        ctime = self.clock.now()
 
         if self.debug:
             self.start_time = ctime
 
-        self.next_events = [x if callable(x) else ctime + x for x in
-                            self.every]
+        self._event = threading.Event()
+        self.wheel = TimerWheel(self.tick, start=ctime)
+        self.timers = [self.wheel.insert(self._first_deadline(x, ctime), idx)
+                       for idx, x in enumerate(self.every)]
+
+    @staticmethod
+    def _first_deadline(job, ctime):
+        if isinstance(job, Deadline):
+            return job()
+        if callable(job):
+            return ctime
+        return ctime + job
 
     def check(self):
-        time = self.__class__.timer()
-        for idx, event_time in enumerate(self.next_events):
-            if callable(self.every[idx]):
-                if self.every[idx]():
+        """Runs every job that is due."""
+        if self._event.is_set():
+            self._event.clear()
+            self._reevaluate()
 
-                    if self.debug:
-                        self.print_debug()
+        time = self.clock.now()
+        for timer in self.wheel.advance(time):
+            idx = timer.item
+            job = self.every[idx]
 
-                    self.callbacks[idx](*self.args[idx])
+            if isinstance(job, Deadline):
+                deadline = job()
+                if deadline > time:
+                    # The state moved on since the job was armed.
+                    self.timers[idx] = self.wheel.insert(deadline, idx)
+                    continue
+                self._fire(idx)
+                # If the callback did not move the deadline, check again
+                # after `poll` seconds rather than on every call.
+                deadline = job()
+                if deadline <= time:
+                    deadline = time + self.poll
+            elif callable(job):
+                if job():
+                    self._fire(idx)
+                deadline = time + self.poll
             else:
-                if time >= event_time:
+                self._fire(idx)
+                # Keep to the original period unless a whole period was
+                # missed (e.g. while a composition was playing).
+                deadline = timer.deadline + job
+                if deadline <= time:
+                    deadline = time + job
+
+            self.timers[idx] = self.wheel.insert(deadline, idx)
+
+    def next_deadline(self):
+        """Returns the time at which the next job is due, in `clock`
+        units."""
+        return self.wheel.next_deadline()
+
+    def notify(self):
+        """Signals that the state observed by predicate-style jobs has
+        changed. Safe to call from any thread; wakes up `sleep()`."""
+        self._event.set()
+
+    def sleep(self, seconds):
+        """Blocks for `seconds` seconds, running jobs as they become due."""
+        end = self.clock.now() + seconds
+        while True:
+            self.check()
+            time = self.clock.now()
+            if time >= end:
+                return
+            deadline = self.next_deadline()
+            wake = end if deadline is None else min(end, deadline)
+            self.clock.wait(self._event, max(0.0, wake - time))
 
-                    if self.debug:
-                        self.print_debug()
+    def _reevaluate(self):
+        time = self.clock.now()
+        for idx, job in enumerate(self.every):
+            if callable(job):
+                self.wheel.cancel(self.timers[idx])
+                self.timers[idx] = self.wheel.insert(time, idx)
 
-                    self.callbacks[idx](*self.args[idx])
-                    self.next_events[idx] = time + self.every[idx]
+    def _fire(self, idx):
+        if self.debug:
+            self.print_debug()
+
+        self.callbacks[idx](*self.args[idx])
 
     def print_debug(self):
-        print(f"Elapsed: {self.timer() - self.start_time}")
+        print(f"Elapsed: {self.clock.now() - self.start_time}")
 
 
 ###############################################################################
@@ -88,24 +340,56 @@ class Test_2:
     def __init__(self):
         self.last_update = self.timer()
 
-    def is_time(self, seconds) -> bool:
-        return self.timer() - self.last_update >= seconds
+    def deadline(self, seconds):
+        return self.last_update + seconds
 
     def callback(self, message):
         print(f"\t{message}")
         self.last_update = self.timer()
 
 
+def test_wheel():
+    """Randomized check of `TimerWheel` against a sorted list."""
+    from random import Random
+
+    rng = Random(0)
+    wheel = TimerWheel(tick=0.01, bits=2, n_levels=3)
+    pending = {}
+    now = 0.0
+    for _ in range(20_000):
+        r = rng.random()
+        if r < 0.5:
+            deadline = now + rng.choice((0.0, 0.03, 0.7, 3.0, 40.0)) * \
+                rng.random()
+            pending[wheel.insert(deadline, None)] = deadline
+        elif r < 0.6 and pending:
+            timer = rng.choice(list(pending))
+            wheel.cancel(timer)
+            del pending[timer]
+        else:
+            expected = min(pending.values(), default=None)
+            assert wheel.next_deadline() == expected
+            now += rng.random() * 0.5
+            fired = wheel.advance(now)
+            due = [t for t, d in pending.items() if d <= now]
+            assert set(fired) == set(due)
+            for timer in fired:
+                del pending[timer]
+            assert len(wheel) == len(pending)
+    print("TimerWheel: OK")
+
+
 if __name__ == '__main__':
     from functools import partial
+    test_wheel()
     t1 = Test_1()
     t2 = Test_2()
     scheduler = Scheduler(every=[5, 10, partial(t1.is_time, 15),
-                                 partial(t2.is_time, 20)],
+                                 Deadline(partial(t2.deadline, 20))],
                           callbacks=[foo, bar, t1.callback,
                                      t2.callback],
                           args=[["Foo"], [], ["Cool"], ["Phew"]],
                           debug=True)
 
     while True:
-        scheduler.check()
+        scheduler.sleep(60)
@@ -0,0 +1,593 @@
+###############################################################################
+#   Serial stress generator: drives the microcontroller, or a simulation of
+#                            it, with a configurable mix of messages at a
+#                            configurable rate, and measures what the link
+#                            sustains:
+#
+#                              - loss: messages that could not be written
+#                                (the port was full) and messages written
+#                                but never acked;
+#                              - ack round trip times (write to ack), as
+#                                percentiles;
+#                              - achieved commands per second (acked
+#                                messages over the time they took).
+#
+#   Messages are written in bursts of `--burst` frames (one `os.write()`
+#   each), spaced so as to average `--rate` messages per second, or back to
+#   back with `--rate 0`. With `--flow credit` (the default), a burst only
+#   goes out as far as the device's credits allow, as with `Link`; with
+#   `--flow none`, it goes out regardless, which finds the point where the
+#   port starts refusing bytes. A frame cut by a partial write is completed
+#   and the rest of its burst counted as not written. "stream_frame" and
+#   "bands" messages are never acked and take no credit; they only count
+#   towards what was written.
+#
+#   Round trip times are matched to messages in order, so they are exact
+#   only when nothing is lost.
+#
+#   Simulated device (`--sim`): a thread on a pseudo-terminal plays the
+#   microcontroller's command path as in `_lights.cpp`: `parse()` takes
+#   commands only while the command queue (CMD_QUEUE_LEN) has room, with a
+#   bounded USB receive buffer in front of it, so a host that ignores
+#   credits fills the port; "bands" levels are kept with their time of
+#   arrival. The executor is `_hostfw.ExecutorModel`: a command is taken
+#   off the queue and acked when the firmware would take it, and after
+#   "notify", events are sent at their edges, on the beat clock's grid and
+#   with the latency offset; "get_telemetry" and "get_hashes" are
+#   answered. Its timings are those of Python, not of the microcontroller:
+#   use it to check the host side and the protocol logic, and the real
+#   device for numbers.
+#
+#   Usage:
+#       python3 _stress.py [--port PORT | --sim] [--mix KIND=WEIGHT,...]
+#                          [--count N] [--rate R] [--burst B]
+#                          [--flow credit|none] [--note-us US]
+#                          [--seed SEED] [--json]
+#       python3 _stress.py --test     Runs three scenarios on the simulated
+#                                     device and checks the accounting, then
+#                                     checks `Link.device_time()` and the
+#                                     events of notes on the beat grid.
+#
+#   KIND is one of the keys of `BUILDERS` (default: note=1).
+###############################################################################
+import argparse
+import heapq
+import json
+import os
+import pty
+import random
+import select
+import sys
+import threading
+import tty
+
+from collections import deque
+from time import perf_counter
+
+import _protocol as proto
+
+from _hostfw import ExecutorModel
+
+
+###############################################################################
+#   Messages
+###############################################################################
+def build_chord(rng, note_us):
+    n = rng.randint(1, 12)
+    pitch_classes = rng.sample(range(12), n) + [0] * (12 - n)
+    return proto.encode_chord(n, pitch_classes, [note_us] * n +
+                              [0] * (12 - n))
+
+
+# Kind -> function of (rng, note_us) returning a random frame of that kind.
+BUILDERS = {
+    "note": lambda rng, us: proto.encode_note(rng.randrange(12), us),
+    "midi_note": lambda rng, us: proto.encode_midi_note(
+        rng.randrange(21, 109), rng.randrange(1, 128), us, proto.NO_STEP),
+    "chord": build_chord,
+    "stream_frame": lambda rng, us: proto.encode_stream_frame(
+        rng.randbytes(3 * 88)),
+    "bands": lambda rng, us: proto.encode_bands(
+        rng.randbytes(proto.BANDS_N), 255),
+    "get_telemetry": lambda rng, us: proto.encode_get_telemetry(),
+    "get_hashes": lambda rng, us: proto.encode_get_hashes(),
+    "latency": lambda rng, us: proto.encode_latency(0),
+    "crossfade": lambda rng, us: proto.encode_crossfade(0),
+}
+UNACKED = {proto.OP_STREAM_FRAME, proto.OP_BANDS}
+
+
+def parse_mix(text):
+    """Returns `{kind: weight}` from "KIND=WEIGHT,..." (weight default 1)."""
+    mix = {}
+    for item in text.split(","):
+        kind, _, weight = item.partition("=")
+        if kind not in BUILDERS:
+            raise ValueError(f"Unknown message kind {kind!r}.")
+        mix[kind] = float(weight or 1)
+    return mix
+
+
+def gen_frames(mix, count, note_us=0, seed=0, pool=64):
+    """Returns `count` frames drawn from `mix`, each one of `pool`
+    prebuilt random frames of its kind."""
+    rng = random.Random(seed)
+    pools = {kind: [BUILDERS[kind](rng, note_us) for _ in range(pool)]
+             for kind in mix}
+    kinds = rng.choices(list(mix), weights=list(mix.values()), k=count)
+    return [rng.choice(pools[kind]) for kind in kinds]
+
+
+###############################################################################
+#   FrameReader class: splits received bytes into decoded frames, as
+#                      `Link._read_frame()` does.
+###############################################################################
+class FrameReader:
+    def __init__(self):
+        self.buf = bytearray()
+        self.bad = 0    # Malformed frames.
+
+    def feed(self, data):
+        """Appends `data`. Returns the frames completed by it."""
+        buf = self.buf
+        buf += data
+        frames, start = [], 0
+        while True:
+            while start < len(buf) and buf[start] != proto.SOF:
+                start += 1
+            if len(buf) - start < 2:
+                break
+            n = proto.frame_len(buf[start + 1])
+            if n == 0:
+                start += 1
+                continue
+            if len(buf) - start < n:
+                break
+            try:
+                frames.append(proto.decode(buf, start))
+            except proto.ProtocolError:
+                self.bad += 1
+            start += n
+        del buf[:start]
+        return frames
+
+
+###############################################################################
+#   Stress run
+###############################################################################
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return None
+    k = min(len(sorted_values) - 1, int(p / 100 * len(sorted_values)))
+    return sorted_values[k]
+
+
+def run(fd, frames, rate=0, burst=1, flow="credit", timeout=1.0):
+    """Writes `frames` to `fd` and collects the acks. Returns the results as
+    a dict (see `report()`)."""
+    os.set_blocking(fd, False)
+    poll = select.poll()
+    poll.register(fd, select.POLLIN)
+    reader = FrameReader()
+
+    in_flight = deque()     # Write times of unacked messages, in order.
+    rtts = []
+    credits, unacked = 1, 0
+    written = dropped = replies = expected = 0
+    period = burst / rate if rate else 0.0
+    n, i = len(frames), 0
+
+    tail = b""      # Rest of a frame cut by a partial write.
+    start = perf_counter()
+    next_t = last = start
+    while True:
+        now = perf_counter()
+        if tail:
+            tail = tail[write(fd, tail):]
+        elif i < n and now >= next_t:
+            # The burst, trimmed to the credits if need be.
+            j, need = i, 0
+            while j < min(n, i + burst):
+                acked = frames[j][1] not in UNACKED
+                if flow == "credit" and acked and need == credits:
+                    break
+                need += acked
+                j += 1
+            if j > i:
+                t = perf_counter()
+                sent, tail = write_frames(fd, frames[i:j])
+                for frame in frames[i:i + sent]:
+                    if frame[1] not in UNACKED:
+                        in_flight.append(t)
+                        expected += 1
+                        credits -= 1
+                        unacked += 1
+                written += sent
+                dropped += j - i - sent
+                i = j
+                last = t
+                next_t = next_t + period if rate else t
+
+        if i >= n and not in_flight:
+            break
+        if perf_counter() - last > timeout:
+            break       # The rest is lost.
+
+        if tail:
+            poll.modify(fd, select.POLLIN | select.POLLOUT)
+            wait = timeout
+        elif i < n and (flow != "credit" or credits > 0 or
+                        frames[i][1] in UNACKED):
+            poll.modify(fd, select.POLLIN)
+            wait = max(0.0, next_t - perf_counter())
+        else:
+            poll.modify(fd, select.POLLIN)
+            wait = timeout      # For acks.
+        if not any(e & select.POLLIN for _, e in poll.poll(wait * 1000)):
+            continue
+        try:
+            data = os.read(fd, 65536)
+        except BlockingIOError:
+            continue
+        t = perf_counter()
+        for frame in reader.feed(data):
+            if isinstance(frame, proto.Ack):
+                if in_flight:
+                    rtts.append(t - in_flight.popleft())
+                unacked = max(0, unacked - 1)
+                credits = (frame.credit - frame.seq - 1 - unacked) & 0xFFFF
+                last = t
+            else:
+                replies += 1
+    elapsed = (last if rtts else perf_counter()) - start
+
+    rtts.sort()
+    return {
+        "messages": n,
+        "written": written,
+        "not_written": dropped,
+        "acked": len(rtts),
+        "lost": len(in_flight),
+        "expected_acks": expected,     # Acked messages written.
+        "replies": replies,
+        "malformed": reader.bad,
+        "seconds": elapsed,
+        "cmd_per_s": len(rtts) / elapsed if elapsed else 0.0,
+        "written_per_s": written / elapsed if elapsed else 0.0,
+        "rtt_us": {f"p{p}": (None if not rtts else
+                             round(percentile(rtts, p) * 1e6, 1))
+                   for p in (50, 90, 99, 100)},
+    }
+
+
+def write(fd, data):
+    """Writes what it can of `data` without blocking. Returns the number of
+    bytes written."""
+    try:
+        return os.write(fd, data)
+    except BlockingIOError:
+        return 0
+
+
+def write_frames(fd, frames):
+    """Writes `frames` in one go. Returns `(k, tail)`: the first `k` frames
+    went out, whole or but for `tail`, the rest of the last one, which is
+    still to be written; the following ones were not written."""
+    n = write(fd, b"".join(frames))
+    k = 0
+    while k < len(frames) and n >= len(frames[k]):
+        n -= len(frames[k])
+        k += 1
+    if n:
+        return k + 1, frames[k][n:]
+    return k, b""
+
+
+def report(r, label=""):
+    rtt = r["rtt_us"]
+    print(f"{label}{r['messages']} messages in {r['seconds']:.3f} s: "
+          f"{r['cmd_per_s']:,.0f} cmd/s acked, {r['written_per_s']:,.0f} "
+          f"msg/s written.")
+    print(f"    not written {r['not_written']}, lost {r['lost']} of "
+          f"{r['expected_acks']} acked messages, {r['replies']} replies, "
+          f"{r['malformed']} malformed.")
+    if rtt["p50"] is not None:
+        print(f"    ack RTT: p50 {rtt['p50']} us, p90 {rtt['p90']} us, "
+              f"p99 {rtt['p99']} us, max {rtt['p100']} us.")
+
+
+###############################################################################
+#   Simulated device
+###############################################################################
+class SimDevice:
+    rx_buffer = 512     # Bytes the USB stack holds ahead of `parse()`.
+
+    def __init__(self, fd):
+        self.fd = fd
+        self.pending = bytearray()      # Received, not yet parsed.
+        self.queue = deque()            # (frame, seq, micros64() at rx)
+        self.rx_seq = 0
+        self.model = ExecutorModel()
+        self.step = None                # Of the message at the head.
+        self.due = []                   # Heap of (sent_us, k, event frame).
+        self.streamed = 0
+        self.bands = deque(maxlen=4096)  # (perf_counter(), levels)
+        self.notify = False
+        self._k = 0
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+
+    def start(self):
+        self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+        self._thread.join()
+
+    @staticmethod
+    def micros64():
+        return int(perf_counter() * 1e6)
+
+    @classmethod
+    def micros(cls):
+        return cls.micros64() & 0xFFFFFFFF
+
+    def _run(self):
+        poll = select.poll()
+        poll.register(self.fd, select.POLLIN)
+        while not self._stop.is_set():
+            self._plan()
+            wait = 0.01
+            if self.step is not None or self.due:
+                wait = max(0.0, (self._next() - self.micros64()) / 1e6)
+            if len(self.pending) < self.rx_buffer:
+                if poll.poll(wait * 1000):
+                    try:
+                        self.pending += os.read(
+                            self.fd, self.rx_buffer - len(self.pending))
+                    except OSError:
+                        return
+            elif wait:
+                self._stop.wait(wait)
+            self._parse()
+            out = bytearray()
+            while True:
+                self._plan()
+                if self._next() > self.micros64():
+                    break
+                if self.due and (self.step is None or
+                                 self.due[0][0] <= self.step.taken):
+                    out += heapq.heappop(self.due)[2]
+                else:
+                    out += self._execute()
+            if out:
+                os.write(self.fd, out)
+
+    def _next(self):
+        """Returns when the next frame is due: the ack of the message at
+        the head of the queue, or an event."""
+        t = self.step.taken if self.step is not None else float("inf")
+        return min(t, self.due[0][0]) if self.due else t
+
+    def _parse(self):
+        buf, k = self.pending, 0
+        while True:
+            while k < len(buf) and buf[k] != proto.SOF:
+                k += 1
+            if len(buf) - k < 2:
+                break
+            n = proto.frame_len(buf[k + 1])
+            if n == 0:
+                k += 1
+                continue
+            # As `parse()`: a full queue holds back commands, not
+            # "stream_frame" or "bands".
+            if buf[k + 1] not in UNACKED and \
+                    len(self.queue) >= proto.CMD_QUEUE_LEN:
+                break
+            if len(buf) - k < n:
+                break
+            frame = bytes(buf[k:k + n])
+            k += n
+            if frame[1] == proto.OP_STREAM_FRAME:
+                self.streamed += 1
+                continue
+            if frame[1] == proto.OP_BANDS:
+                self.bands.append((perf_counter(),
+                                   frame[2:2 + proto.BANDS_N]))
+                continue
+            self.queue.append((frame, self.rx_seq, self.micros64()))
+            self.rx_seq = (self.rx_seq + 1) & 0xFFFF
+        del buf[:k]
+
+    def _plan(self):
+        """Plays the message at the head of the queue on the executor
+        model, once the one before it is taken, and schedules its events.
+        A message that does not decode is dropped unacked, as by
+        `execute()`."""
+        while self.step is None and self.queue:
+            frame, seq, rx = self.queue[0]
+            try:
+                msg = proto.decode(frame)
+            except proto.ProtocolError:
+                self.queue.popleft()
+                continue
+            self.step = self.model.submit(msg, seq, rx)
+            if self.notify:
+                for s, edge, t_us, sent_us in self.step.events:
+                    heapq.heappush(self.due, (sent_us, self._k,
+                                              proto.encode_event(
+                                                  s, edge,
+                                                  t_us & 0xFFFFFFFF)))
+                    self._k += 1
+
+    def _execute(self):
+        """Takes the message at the head of the queue and returns its ack
+        and reply."""
+        frame, seq, rx = self.queue.popleft()
+        self.step = None
+        credit = (self.rx_seq + proto.CMD_QUEUE_LEN - len(self.queue)) & \
+            0xFFFF
+        out = proto.encode_ack(seq, rx & 0xFFFFFFFF, self.micros(), credit)
+        if frame[1] == proto.OP_GET_TELEMETRY:
+            out += proto.encode_telemetry(self.streamed, self.streamed, 0, 0,
+                                          0, 0, 0)
+        elif frame[1] == proto.OP_GET_HASHES:
+            out += proto.encode_hashes(0, [0] * proto.FRAME_HASH_N,
+                                       [0] * proto.FRAME_HASH_N)
+        elif frame[1] == proto.OP_NOTIFY:
+            self.notify = bool(proto.decode(frame).enable)
+        return out
+
+
+def open_sim():
+    """Returns `(fd, device)`: the host end of a pseudo-terminal and the
+    started `SimDevice` on the other end."""
+    master, slave = pty.openpty()
+    tty.setraw(master)
+    tty.setraw(slave)
+    device = SimDevice(master)
+    device.start()
+    return slave, device
+
+
+###############################################################################
+#   Main
+###############################################################################
+def run_test():
+    failures = []
+
+    def scenario(label, mix, count, **kwargs):
+        fd, device = open_sim()
+        try:
+            r = run(fd, gen_frames(mix, count), **kwargs)
+        finally:
+            device.stop()
+            os.close(fd)
+            os.close(device.fd)
+        report(r, label + ": ")
+        if r["written"] + r["not_written"] != count:
+            failures.append(f"{label}: messages unaccounted for.")
+        if r["acked"] + r["lost"] != r["expected_acks"]:
+            failures.append(f"{label}: acks unaccounted for.")
+        return r
+
+    r = scenario("Notes, credit flow, unpaced", {"note": 1}, 20_000)
+    if r["lost"] or r["not_written"] or r["acked"] != 20_000:
+        failures.append("Credit flow lost messages.")
+
+    mix = {"note": 8, "midi_note": 4, "chord": 2, "stream_frame": 1,
+           "get_telemetry": 1}
+    r = scenario("Mix, credit flow, 2000/s in bursts of 8", mix, 10_000,
+                 rate=2000, burst=8)
+    if r["lost"] or r["not_written"] or r["acked"] != r["expected_acks"]:
+        failures.append("Paced mix lost messages.")
+    if not 1800 <= r["written_per_s"] <= 2200:
+        failures.append(f"Paced mix written at {r['written_per_s']:.0f}/s.")
+
+    r = scenario("Notes, no flow control, unpaced, bursts of 64",
+                 {"note": 1}, 200_000, burst=64, flow="none")
+    if r["lost"]:
+        failures.append("Written messages lost without flow control.")
+
+    # An ack is sent when its message is taken off the queue, here after a
+    # 300 ms note: `Link.device_time()` must pair its arrival with the time
+    # it was sent, not the time its message was accepted.
+    from serial import Serial
+    from _link import Link
+
+    fd, device = open_sim()
+    try:
+        link = Link(Serial(os.ttyname(fd), timeout=2, write_timeout=0))
+        link.send_note(0, 300_000)
+        link.send_note(1, 1000)
+        err_us = (link.device_time() - device.micros() + 2**31) % 2**32 - \
+            2**31
+        link.ser.close()
+    finally:
+        device.stop()
+        os.close(fd)
+        os.close(device.fd)
+    print(f"device_time() after a queued ack: {err_us / 1000:+.1f} ms")
+    if abs(err_us) > 20_000:
+        failures.append(f"device_time() off by {err_us / 1000:.1f} ms.")
+
+    # Notes of 50 ms naming grid points of a tempo of 600 bpm, each sent
+    # once the one before has started: each reports EVENT_STARTED at its
+    # point, and when it is reached, not when the note is taken (50 ms
+    # before).
+    fd, device = open_sim()
+    try:
+        link = Link(Serial(os.ttyname(fd), timeout=2, write_timeout=0))
+        link.set_notifications(True)
+        beat0 = (link.device_time() + 50_000) & 0xFFFFFFFF
+        link.set_tempo(600, beat0, 4, 1)
+        late = []
+        for k in range(1, 4):
+            ack = link.send_midi_note(60 + k, 100, 50_000, k)
+            t_us = link.wait_event(ack.seq, proto.EVENT_STARTED, 1)
+            late.append(((t_us - beat0 - k * 100_000 + 2**31) % 2**32 -
+                         2**31, (device.micros() - t_us) % 2**32))
+        link.ser.close()
+    finally:
+        device.stop()
+        os.close(fd)
+        os.close(device.fd)
+    print(f"Notes on the grid: (event off the grid, received after) "
+          f"{late} us")
+    if any(off or not 0 <= after < 20_000 for off, after in late):
+        failures.append("Events not sent at their edges on the grid.")
+
+    if failures:
+        print("FAILED:\n    " + "\n    ".join(failures))
+        return 1
+    print("OK.")
+    return 0
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Serial stress generator.")
+    parser.add_argument("--port")
+    parser.add_argument("--sim", action="store_true")
+    parser.add_argument("--mix", default="note=1")
+    parser.add_argument("--count", type=int, default=10_000)
+    parser.add_argument("--rate", type=float, default=0,
+                        help="Messages per second, or 0 for unpaced.")
+    parser.add_argument("--burst", type=int, default=1)
+    parser.add_argument("--flow", choices=("credit", "none"),
+                        default="credit")
+    parser.add_argument("--note-us", type=int, default=0,
+                        help="Duration of notes and chords.")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--json", action="store_true")
+    parser.add_argument("--test", action="store_true")
+    args = parser.parse_args(argv)
+
+    if args.test:
+        return run_test()
+
+    frames = gen_frames(parse_mix(args.mix), args.count, args.note_us,
+                        args.seed)
+    device = None
+    if args.sim:
+        fd, device = open_sim()
+    else:
+        from _serial import Serial
+        ser = Serial(port=args.port, baudrate=57_600, timeout=10,
+                     write_timeout=0)
+        fd = ser.fileno()
+    try:
+        r = run(fd, frames, args.rate, args.burst, args.flow)
+    finally:
+        if device is not None:
+            device.stop()
+    r.update(mix=args.mix, rate=args.rate, burst=args.burst, flow=args.flow)
+    if args.json:
+        print(json.dumps(r))
+    else:
+        report(r)
+    return 0 if not r["lost"] else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -1,11 +1,21 @@
 ###############################################################################
 #   Imports.
 ###############################################################################
+import json
+import re
+
 from collections.abc import Sequence
 from random import shuffle
 from typing import List, Tuple
 
 
+###############################################################################
+#   Logging.
+###############################################################################
+import logging
+logger = logging.getLogger()
+
+
 ###############################################################################
 #   Constants.
 ###############################################################################
@@ -258,6 +268,79 @@ def is_tonerow(tr):
     return all(x in valid_values for x in tr)
 
 
+###############################################################################
+#   Parsing: tone rows as received from the web service. `GetNewToneRows`
+#            returns a JSON list of objects, each with an integer "id" and a
+#            "noteRow" holding a tone row written as a Python tuple, e.g.
+#            "(0, 11, 3, 4, 8, 7, 9, 5, 6, 1, 2, 10)", or as a list,
+#            "[0, 11, 3, ...]".
+#
+#            `parse_tonerow()` decodes a "noteRow" with one match of a
+#            compiled pattern, which only accepts a parenthesized or
+#            bracketed list of 12 decimal integers in [0, 11] (no leading
+#            zeros, signs, mismatched or nested brackets; whitespace and a
+#            trailing comma as in Python), and checks that every pitch class
+#            appears once with a 12-bit set. Inputs longer than MAX_ROW_LEN
+#            are rejected before matching, so the cost is bounded whatever
+#            the web service sends, unlike `literal_eval()`. Rows are
+#            returned as 12-byte `bytes`.
+#
+#            `parse_rows()` bounds the whole response to MAX_RESPONSE bytes
+#            before decoding it, and checks that it is a list. Each entry is
+#            then checked on its own, so one malformed entry costs only its
+#            own row: a bad "noteRow" is returned as None (for the caller to
+#            replace with a random row), and an entry without an integer
+#            "id", which cannot be reported back, is logged and skipped.
+###############################################################################
+MAX_ROW_LEN = 128       # Longest accepted "noteRow", in characters.
+MAX_RESPONSE = 256 << 10    # Longest accepted response, in bytes.
+ALL_PITCH_CLASSES = (1 << N_TONEROW) - 1
+
+_PC = r"\s*(1[01]|\d)\s*"
+_row_pattern = re.compile(r"\s*([(\[])" + ",".join([_PC] * N_TONEROW) +
+                          r",?\s*([)\]])\s*", re.ASCII)
+_closing = {"(": ")", "[": "]"}
+
+
+def parse_tonerow(text):
+    """Returns the tone row written in `text` (e.g. "(0, 11, 3, ...)" or
+    "[0, 11, 3, ...]") as 12 bytes, or None if `text` is not a tone
+    row."""
+    if not isinstance(text, str) or len(text) > MAX_ROW_LEN:
+        return None
+    m = _row_pattern.fullmatch(text)
+    if m is None or _closing[m.group(1)] != m.group(N_TONEROW + 2):
+        return None
+    row = bytes(map(int, m.groups()[1:-1]))
+    seen = 0
+    for pc in row:
+        seen |= 1 << pc
+    return row if seen == ALL_PITCH_CLASSES else None
+
+
+def parse_rows(content):
+    """Returns `[(id, row)]` for the body `content` (bytes) of a
+    `GetNewToneRows` response, where `row` is as returned by
+    `parse_tonerow()`. Raises ValueError if the body is too long or is not
+    a JSON list. Entries without an integer "id" are skipped."""
+    if len(content) > MAX_RESPONSE:
+        raise ValueError(f"Response of {len(content)} bytes.")
+    try:
+        data = json.loads(content)
+    except RecursionError:
+        raise ValueError("Response nested too deeply.") from None
+    if not isinstance(data, list):
+        raise ValueError("Response is not a list.")
+    rows = []
+    for e in data:
+        ID = e.get("id") if isinstance(e, dict) else None
+        if type(ID) is not int:
+            logger.critical(f"Skipping entry {str(e)[:80]!r}: no id.")
+            continue
+        rows.append((ID, parse_tonerow(e.get("noteRow"))))
+    return rows
+
+
 ###############################################################################
 #   Private helpers.
 ###############################################################################
@@ -272,3 +355,122 @@ def _transpose_2d_matrix(a: List[list]) -> List[list]:
     """Given a 2D matrix `a` implemented as a list of lists, returns the
     transpose of the matrix as a list of lists."""
     return [list(j) for j in zip(*a)]
+
+
+###############################################################################
+#   Test: `parse_tonerow()` against the original path (`literal_eval()` and
+#         `is_tonerow()`) on valid, invalid and hostile rows, followed by a
+#         benchmark of both on a response of 100 rows.
+###############################################################################
+if __name__ == '__main__':
+    import random
+    import sys
+
+    from ast import literal_eval
+    from time import perf_counter
+
+    def legacy(text):
+        try:
+            row = literal_eval(text)
+        except (ValueError, TypeError, SyntaxError, MemoryError,
+                RecursionError):
+            return None
+        # `is_tonerow()` only takes tuples; rows written as lists are
+        # compared as tuples.
+        if isinstance(row, list):
+            row = tuple(row)
+        return row if is_tonerow(row) else None
+
+    rng = random.Random(0)
+    rows = [tuple(rng.sample(range(12), 12)) for _ in range(1000)]
+    cases = [(repr(row), True) for row in rows]
+    cases += [
+        ("(0,1,2,3,4,5,6,7,8,9,10,11)", True),
+        (" ( 0 , 1 , 2 , 3 , 4 , 5 , 6 , 7 , 8 , 9 , 10 , 11 , ) ", True),
+        ("(0,\n1, 2, 3, 4, 5, 6, 7, 8, 9, 10,\t11)", True),
+        ("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]", True),
+        ("[11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,]", True),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]", False),
+        ("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11)", False),
+        ("[[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]]", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10)", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10)", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0)", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12)", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, -11)", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11.0)", False),
+        ("((0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11))", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11", False),
+        ("", False),
+        ("(" * 100_000, False),
+        ("(" + "0, " * 100_000 + ")", False),
+        ("9" * 10_000, False),
+        # Valid Python, but not how rows are written: rejected.
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 1_0, 11)", False),
+        ("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 0xB)", False),
+        ("(+0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11)", False),
+        ("(00, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11)", False),
+    ]
+    failures = 0
+    for text, valid in cases:
+        row = parse_tonerow(text)
+        if (row is not None) != valid or (
+                row is not None and tuple(row) != legacy(text)):
+            print(f"FAILED: {text[:60]!r}")
+            failures += 1
+    if parse_tonerow(b"(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11)") is not None:
+        print("FAILED: bytes accepted.")
+        failures += 1
+    for bad in (b"{}", b'{"id": 1}', b"[" * 100_000,
+                b" " * (MAX_RESPONSE + 1)):
+        try:
+            parse_rows(bad)
+            print(f"FAILED: response {bad[:20]!r} accepted.")
+            failures += 1
+        except ValueError:
+            pass
+    # Malformed entries cost only their own row.
+    mixed = json.dumps([
+        {"id": 1, "noteRow": repr(rows[0])},
+        {"id": "2", "noteRow": repr(rows[1])},
+        {"id": 3, "noteRow": 7},
+        {"id": 4, "noteRow": "(0, 1)"},
+        {"id": True, "noteRow": repr(rows[2])},
+        [5],
+        {"noteRow": repr(rows[3])},
+        {"id": 6, "noteRow": repr(rows[4])},
+    ]).encode()
+    logger.disabled = True
+    got = parse_rows(mixed)
+    logger.disabled = False
+    if got != [(1, bytes(rows[0])), (3, None), (4, None),
+               (6, bytes(rows[4]))]:
+        print(f"FAILED: mixed response parsed as {got}.")
+        failures += 1
+    print(f"{len(cases)} rows: {'OK' if not failures else 'FAILED'}.")
+
+    # A typical response.
+    content = json.dumps([{"id": k, "noteRow": repr(row)}
+                          for k, row in enumerate(rows[:100])]).encode()
+    n = 200
+    start = perf_counter()
+    for _ in range(n):
+        out = [(e["id"], legacy(e["noteRow"])) for e in json.loads(content)]
+    t_legacy = (perf_counter() - start) / n
+    start = perf_counter()
+    for _ in range(n):
+        out = parse_rows(content)
+    t_parse = (perf_counter() - start) / n
+    print(f"100-row response: literal_eval path {t_legacy * 1e6:.0f} us, "
+          f"parse_rows {t_parse * 1e6:.0f} us ({t_legacy / t_parse:.1f}x).")
+
+    hostile = "(" * 100_000
+    start = perf_counter()
+    legacy(hostile)
+    t_legacy = perf_counter() - start
+    start = perf_counter()
+    parse_tonerow(hostile)
+    t_parse = perf_counter() - start
+    print(f"100000 nested brackets: literal_eval path "
+          f"{t_legacy * 1e6:.0f} us, parse_tonerow {t_parse * 1e6:.1f} us.")
+    sys.exit(1 if failures else 0)
@@ -0,0 +1,235 @@
+###############################################################################
+#   Light program assembler: turns the text of a light program into bytecode
+#                            for the microcontroller's VM (see "Light
+#                            programs" in `_lights.cpp`), to be uploaded with
+#                            `Link.load_program()` and started with
+#                            `Link.run_program()`.
+#
+#   The instruction set is defined by the VM_* constants of
+#   `_protocol_schema.py`. Each instruction is 4 bytes, (op, a, b, c); `a`,
+#   `b` and `c` name registers r0 to r15, and a 16-bit immediate or jump
+#   target is stored as b | c << 8.
+#
+#   Syntax, one statement per line:
+#
+#       label:                  Names the next instruction.
+#       op operand, ...         An instruction, e.g. `add r1, r2, r3`.
+#       ; comment               Anywhere on a line.
+#
+#   Operands are registers (`r0` to `r15`), integers (decimal or 0x hex;
+#   `addi` takes negative ones) or, for jumps, labels. The pseudo-instruction
+#   `li a, imm` loads any 32-bit value, as `ldi` followed by `ldhi` if
+#   needed.
+#
+#   Usage:
+#       python3 _vmasm.py FILE [-o OUT]   Assemble FILE (default output:
+#                                         FILE with the extension .bin).
+#       python3 _vmasm.py --test          Assemble `TWINKLE`, disassemble it
+#                                         and check the round trip.
+###############################################################################
+import argparse
+import os
+import sys
+import zlib
+
+import _protocol as proto
+
+
+###############################################################################
+#   Instruction set
+###############################################################################
+# Operands of each instruction: r (register), i (immediate), l (label).
+FORMATS = {
+    "halt": "", "ldi": "ri", "ldhi": "ri", "mov": "rr",
+    "add": "rrr", "sub": "rrr", "mul": "rrr", "and": "rrr", "or": "rrr",
+    "xor": "rrr", "shl": "rrr", "shr": "rrr", "mod": "rrr", "addi": "ri",
+    "lt": "rrr", "eq": "rrr", "jmp": "l", "jz": "rl", "jnz": "rl",
+    "djnz": "rl", "rand": "rr", "clear": "", "pixel": "rr", "panels": "rr",
+    "groups": "rr", "note": "rr", "scale": "rrr", "blend": "rrr",
+    "show": "", "wait": "r", "beat": "r", "time": "r",
+}
+OPCODES = {op: getattr(proto, "VM_" + op.upper()) for op in FORMATS}
+MNEMONICS = {code: op for op, code in OPCODES.items()}
+
+
+class AsmError(Exception):
+    pass
+
+
+# Every 50 ms, a random LED lights in a random note color at a random
+# brightness; every 40 frames, the frame is cleared.
+TWINKLE = """
+        li    r1, 88            ; LEDs
+        li    r2, 12            ; Pitch classes
+        li    r3, 257           ; Brightness levels
+        li    r4, 50000         ; Frame period, in microseconds
+loop:   li    r5, 40
+frame:  rand  r6, r1
+        rand  r7, r2
+        note  r8, r7
+        rand  r9, r3
+        scale r8, r8, r9
+        pixel r6, r8
+        show
+        wait  r4
+        djnz  r5, frame
+        clear
+        jmp   loop
+"""
+
+
+###############################################################################
+#   Assembler
+###############################################################################
+def parse_int(text, line):
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise AsmError(f"line {line}: bad number {text!r}.") from None
+
+
+def parse_reg(text, line):
+    if text[:1] != "r" or not text[1:].isdigit() or \
+            int(text[1:]) >= proto.VM_REGS:
+        raise AsmError(f"line {line}: bad register {text!r}.")
+    return int(text[1:])
+
+
+def statements(source):
+    """Yields `(line, labels, op, operands)` for each line of `source`."""
+    for line, text in enumerate(source.splitlines(), 1):
+        text = text.split(";")[0].strip()
+        labels = []
+        while ":" in text:
+            label, text = text.split(":", 1)
+            labels.append(label.strip())
+            text = text.strip()
+        op, _, rest = text.partition(" ")
+        operands = [x.strip() for x in rest.split(",")] if rest.strip() \
+            else []
+        yield line, labels, op.lower(), operands
+
+
+def expand(line, op, operands):
+    """Returns the instructions `(op, operands)` of one statement, with the
+    pseudo-instruction `li` expanded."""
+    if op != "li":
+        return [(op, operands)]
+    if len(operands) != 2:
+        raise AsmError(f"line {line}: li takes 2 operands.")
+    value = parse_int(operands[1], line) & 0xFFFFFFFF
+    out = [("ldi", [operands[0], str(value & 0xFFFF)])]
+    if value >> 16:
+        out.append(("ldhi", [operands[0], str(value >> 16)]))
+    return out
+
+
+def assemble(source):
+    """Returns the bytecode of the light program `source`."""
+    program, labels = [], {}
+    for line, names, op, operands in statements(source):
+        for name in names:
+            if name in labels:
+                raise AsmError(f"line {line}: label {name!r} redefined.")
+            labels[name] = len(program)
+        if op:
+            program += [(line, *insn) for insn in expand(line, op, operands)]
+
+    code = bytearray()
+    for line, op, operands in program:
+        if op not in FORMATS:
+            raise AsmError(f"line {line}: unknown instruction {op!r}.")
+        fmt = FORMATS[op]
+        if len(operands) != len(fmt):
+            raise AsmError(f"line {line}: {op} takes {len(fmt)} operands.")
+        fields = []
+        for kind, text in zip(fmt, operands):
+            if kind == "r":
+                fields.append(parse_reg(text, line))
+            elif kind == "l":
+                if text not in labels:
+                    raise AsmError(f"line {line}: unknown label {text!r}.")
+                fields += [labels[text] & 0xFF, labels[text] >> 8]
+            else:
+                value = parse_int(text, line)
+                if not -0x8000 <= value <= 0xFFFF:
+                    raise AsmError(f"line {line}: {value} is not 16-bit.")
+                value &= 0xFFFF
+                fields += [value & 0xFF, value >> 8]
+        if fmt == "l":
+            fields.insert(0, 0)
+        code += bytes([OPCODES[op]] + fields + [0] * (3 - len(fields)))
+
+    if not code or len(code) > 4 * proto.VM_CODE_MAX:
+        raise AsmError(f"A program has 1 to {proto.VM_CODE_MAX} "
+                       f"instructions.")
+    return bytes(code)
+
+
+def disassemble(code):
+    """Returns the text of the bytecode `code`, one instruction per line,
+    jump targets as `@index`."""
+    lines = []
+    for k in range(0, len(code), 4):
+        opcode, a, b, c = code[k:k + 4]
+        op = MNEMONICS.get(opcode, f"?{opcode}")
+        fmt = FORMATS.get(op, "")
+        operands = []
+        regs = iter((a, b, c))
+        for kind in fmt:
+            if kind == "r":
+                operands.append(f"r{next(regs)}")
+            else:
+                imm = b | c << 8
+                operands.append(f"@{imm}" if kind == "l" else str(imm))
+        lines.append(f"{op} {', '.join(operands)}".rstrip())
+    return "\n".join(lines)
+
+
+###############################################################################
+#   Main
+###############################################################################
+def run_test():
+    code = assemble(TWINKLE)
+    text = disassemble(code)
+    # Labels come back as @index; resolve them the way the assembler would.
+    again = assemble("\n".join(f"L{k}: {line}" for k, line in
+                               enumerate(text.replace("@", "L")
+                                         .splitlines())))
+    print(f"TWINKLE: {len(code) // 4} instructions, CRC-32 "
+          f"0x{zlib.crc32(code):08X}.")
+    print(text)
+    if again != code:
+        print("FAILED: the disassembly does not assemble back.")
+        return 1
+    print("OK.")
+    return 0
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Light program assembler.")
+    parser.add_argument("file", nargs="?")
+    parser.add_argument("-o", "--out")
+    parser.add_argument("--test", action="store_true")
+    args = parser.parse_args(argv)
+
+    if args.test:
+        return run_test()
+    if not args.file:
+        parser.error("no input file.")
+    with open(args.file) as fp:
+        try:
+            code = assemble(fp.read())
+        except AsmError as err:
+            print(f"{args.file}: {err}", file=sys.stderr)
+            return 1
+    out = args.out or os.path.splitext(args.file)[0] + ".bin"
+    with open(out, "wb") as fp:
+        fp.write(code)
+    print(f"{out}: {len(code) // 4} instructions, CRC-32 "
+          f"0x{zlib.crc32(code):08X}.")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))